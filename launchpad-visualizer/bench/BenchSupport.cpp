@@ -0,0 +1,17 @@
+#include "BenchSupport.h"
+#include <chrono>
+#include <thread>
+
+namespace BenchSupport {
+
+void waitUntil(uint64_t deadlineNs)
+{
+    uint64_t nowNs = MidiEvent::now();
+    if (deadlineNs > nowNs + 1000000) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(deadlineNs - nowNs - 1000000));
+    }
+    while (MidiEvent::now() < deadlineNs) {
+    }
+}
+
+} // namespace BenchSupport
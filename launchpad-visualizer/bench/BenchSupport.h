@@ -0,0 +1,56 @@
+#ifndef BENCH_SUPPORT_H
+#define BENCH_SUPPORT_H
+
+#include <cstdint>
+#include <cstdio>
+#include "midi/MidiEvent.h"
+#include "diag/LatencyHistogram.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+/**
+ * @brief ベンチマーク共通の小さな補助関数
+ */
+namespace BenchSupport {
+
+/**
+ * @brief プロセスの最大常駐メモリ (KB、取得できない環境では0)
+ */
+inline long peakRssKb()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;  // macOSはバイト単位
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief 指定時刻まで待つ（1ms以上先なら眠り、残りは空回りで合わせる）
+ */
+void waitUntil(uint64_t deadlineNs);
+
+/**
+ * @brief 分布の要約を1行で表示
+ * @param label 表示名
+ * @param histogram 分布
+ */
+inline void printLatency(const char* label, const LatencyHistogram::Snapshot& histogram)
+{
+    std::printf("%-28s n=%llu  p50=%.2fus  p99=%.2fus  p99.9=%.2fus  max=%.2fus\n", label,
+                static_cast<unsigned long long>(histogram.count),
+                histogram.percentile(50.0) / 1e3, histogram.percentile(99.0) / 1e3,
+                histogram.percentile(99.9) / 1e3, histogram.maxNs / 1e3);
+}
+
+} // namespace BenchSupport
+
+#endif // BENCH_SUPPORT_H
@@ -0,0 +1,124 @@
+#include "BenchSupport.h"
+#include "LaunchpadVisualizer.h"
+#include "net/OscBridge.h"
+#include "net/OscCodec.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QUdpSocket>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// 1回のバーストで全パッドの色と押下・離上を送る
+static constexpr int MESSAGES_PER_BURST = PadStateModel::PAD_COUNT * 2;
+
+/**
+ * @brief ループバックで受け取ったOSCの量
+ */
+struct Received {
+    uint64_t datagrams = 0;
+    uint64_t messages = 0;
+    uint64_t bytes = 0;
+    uint64_t malformed = 0;  // 解析できなかったデータグラム
+};
+
+/**
+ * @brief 届いているデータグラムをすべて読み、メッセージを数える
+ */
+static void drain(QUdpSocket& receiver, std::vector<unsigned char>& datagram, Received& received)
+{
+    while (receiver.hasPendingDatagrams()) {
+        const qint64 size = receiver.readDatagram(reinterpret_cast<char*>(datagram.data()),
+                                                  static_cast<qint64>(datagram.size()));
+        if (size <= 0) {
+            continue;
+        }
+        ++received.datagrams;
+        received.bytes += static_cast<uint64_t>(size);
+        const bool valid = OscReader::parse(datagram.data(), static_cast<std::size_t>(size),
+                                            [&](const OscMessage&) { ++received.messages; });
+        if (!valid) {
+            ++received.malformed;
+        }
+    }
+}
+
+/**
+ * @brief 押下・色のバーストをOscBridge経由でループバックのQUdpSocketに送り、
+ * メッセージ/秒・データグラム/秒・バイト/秒とバーストごとの送信処理の時間を表示する
+ * OscBench [バースト数 (2000)]
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int bursts = argc > 1 ? std::atoi(argv[1]) : 2000;
+    if (bursts <= 0) {
+        std::fprintf(stderr, "usage: OscBench [bursts]\n");
+        return 1;
+    }
+
+    LaunchpadVisualizer visualizer;
+    OscBridge bridge(&visualizer);
+
+    QUdpSocket receiver;
+    if (!receiver.bind(QHostAddress::LocalHost, 0)) {
+        std::fprintf(stderr, "cannot bind: %s\n", qPrintable(receiver.errorString()));
+        return 1;
+    }
+    receiver.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 4 * 1024 * 1024);
+    bridge.addTarget(QHostAddress::LocalHost, receiver.localPort());
+
+    // シークでの状態の復元と同じ経路で、全パッドの色と押下・離上をまとめて発生させる。
+    // バンドルが一杯になるたびにその場で送り、残りは次のバーストに続けて詰める
+    std::vector<unsigned char> datagram(OscBridge::MAX_RECEIVE_SIZE);
+    Received received;
+    LatencyHistogram burstCost;
+    PadStateModel state;
+    QElapsedTimer elapsed;
+    elapsed.start();
+    for (int burst = 0; burst < bursts; ++burst) {
+        for (int y = 0; y < PadStateModel::GRID_SIZE; ++y) {
+            for (int x = 0; x < PadStateModel::GRID_SIZE; ++x) {
+                const int index = PadStateModel::index(x, y);
+                if ((index + burst) % 2 == 0) {
+                    state.press(x, y, static_cast<uint8_t>(1 + (index + burst) % 127));
+                } else {
+                    state.release(x, y);
+                }
+                state.setColor(x, y, static_cast<uint32_t>(index * 0x030507 + burst * 0x010101) & 0xFFFFFFu);
+            }
+        }
+
+        const uint64_t startNs = MidiEvent::now();
+        visualizer.onPadStateRestored(state);
+        burstCost.record(MidiEvent::now() - startNs);
+
+        // 受信側のバッファがあふれないよう、バーストごとに読み出す
+        drain(receiver, datagram, received);
+    }
+
+    // 最後のバンドルはFLUSH_INTERVAL_MS後に送られる
+    const uint64_t expected = static_cast<uint64_t>(bursts) * MESSAGES_PER_BURST;
+    QElapsedTimer timeout;
+    timeout.start();
+    while (received.messages < expected && timeout.elapsed() < 1000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        drain(receiver, datagram, received);
+    }
+    const double seconds = elapsed.nsecsElapsed() / 1e9;
+
+    const uint64_t sent = bridge.messagesSent();
+    std::printf("bursts: %d x %d messages in %.2fs\n", bursts, MESSAGES_PER_BURST, seconds);
+    std::printf("sent: %llu messages  received: %llu messages  lost: %llu  malformed datagrams: %llu\n",
+                static_cast<unsigned long long>(sent), static_cast<unsigned long long>(received.messages),
+                static_cast<unsigned long long>(sent - received.messages),
+                static_cast<unsigned long long>(received.malformed));
+    std::printf("messages/s: %.0f\n", received.messages / seconds);
+    std::printf("datagrams/s: %.0f (%.1f messages/datagram)\n", received.datagrams / seconds,
+                received.datagrams ? static_cast<double>(received.messages) / received.datagrams : 0.0);
+    std::printf("bytes/s: %.0f (%.1f bytes/datagram)\n", received.bytes / seconds,
+                received.datagrams ? static_cast<double>(received.bytes) / received.datagrams : 0.0);
+    BenchSupport::printLatency("burst (encode + send)", burstCost.snapshot());
+    std::printf("peak RSS: %ld KB\n", BenchSupport::peakRssKb());
+    return sent == expected && received.messages == sent && received.malformed == 0 ? 0 : 1;
+}
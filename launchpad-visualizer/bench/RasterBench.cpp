@@ -0,0 +1,133 @@
+#include "BenchSupport.h"
+#include "gui/PadLayout.h"
+#include "gui/PadRasterizer.h"
+#include "gui/PadSpriteCache.h"
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * @brief 描画方式
+ */
+enum class Backend {
+    Painter,       // パッドごとにQPainterで描画
+    PainterCache,  // パッド画像キャッシュを転送
+    Raster         // PadRasterizerでバックバッファへ直接書き込み
+};
+
+/**
+ * @brief パッドの表示内容（フレームごとに一部のパッドの明るさが変わる）
+ */
+static void padState(int index, int frame, QColor& color, int& glow)
+{
+    color = QColor::fromRgb(PadStateModel::velocityToRgb(1 + (index * 37) % 127));
+    glow = (index % 8 == frame % 8) ? 255 - (frame * 16) % 256 : 0;
+}
+
+/**
+ * @brief 指定した表面のサイズと描画方式で全パッドを描き直し、1フレームの描画時間の分布を返す
+ * @param dirtyEvery 0なら毎フレーム全パッド、それ以外はこの数に1つのパッドだけを描き直す
+ */
+static LatencyHistogram::Snapshot measure(int gridSize, const QSize& size, Backend backend, int dirtyEvery,
+                                          int frames)
+{
+    PadLayout layout(gridSize);
+    layout.setSize(size);
+    const QColor borderColor(64, 64, 64);
+    const QColor background(Qt::black);
+
+    PadRasterizer rasterizer;
+    rasterizer.resize(size, 1.0);
+    rasterizer.fill(background);
+    QImage target(size, QImage::Format_ARGB32_Premultiplied);
+    target.fill(background);
+    PadSpriteCache cache;
+    LatencyHistogram histogram;
+
+    for (int frame = 0; frame < frames; ++frame) {
+        const uint64_t startNs = MidiEvent::now();
+        if (backend == Backend::Raster) {
+            for (int index = 0; index < layout.padCount(); ++index) {
+                if (dirtyEvery && (index + frame) % dirtyEvery != 0) {
+                    continue;
+                }
+                QColor color;
+                int glow;
+                padState(index, frame, color, glow);
+                const QRect& padRect = layout.padRect(index);
+                rasterizer.clearRect(padRect.adjusted(-PadSpriteCache::MARGIN, -PadSpriteCache::MARGIN,
+                                                      PadSpriteCache::MARGIN, PadSpriteCache::MARGIN), background);
+                rasterizer.drawPad(padRect, color, glow, borderColor, layout.isRound(index));
+            }
+        } else {
+            QPainter painter(&target);
+            painter.setRenderHint(QPainter::Antialiasing);
+            for (int index = 0; index < layout.padCount(); ++index) {
+                if (dirtyEvery && (index + frame) % dirtyEvery != 0) {
+                    continue;
+                }
+                QColor color;
+                int glow;
+                padState(index, frame, color, glow);
+                const QRect& padRect = layout.padRect(index);
+                if (backend == Backend::PainterCache) {
+                    const QPixmap& sprite = cache.sprite(color, glow, borderColor, layout.isRound(index),
+                                                         padRect.width(), 1.0);
+                    painter.drawPixmap(padRect.topLeft() - QPoint(PadSpriteCache::MARGIN, PadSpriteCache::MARGIN),
+                                       sprite);
+                } else {
+                    PadSpriteCache::renderPad(painter, padRect, color, glow, borderColor, layout.isRound(index));
+                }
+            }
+        }
+        histogram.record(MidiEvent::now() - startNs);
+    }
+    return histogram.snapshot();
+}
+
+/**
+ * @brief 表面のパッド数に対する1フレームの描画時間を描画方式ごとに表示する
+ * RasterBench [フレームの幅 (1080)] [フレーム数 (200)]
+ * 表示のない環境でも動くよう、QT_QPA_PLATFORMが未設定ならoffscreenを使う
+ */
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+
+    const int width = argc > 1 ? std::atoi(argv[1]) : 1080;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : 200;
+    if (width <= 0 || frames <= 0) {
+        std::fprintf(stderr, "usage: RasterBench [width] [frames]\n");
+        return 1;
+    }
+    const QSize size(width, width);
+    std::printf("%dx%d, %d frames per case, platform %s\n", width, width, frames,
+                qPrintable(QGuiApplication::platformName()));
+    std::printf("%6s %6s %-14s %12s %12s %12s %12s\n", "grid", "pads", "backend", "full mean", "full p99",
+                "1/8 mean", "1/8 p99");
+
+    const struct {
+        const char* name;
+        Backend backend;
+    } backends[] = {
+        {"painter", Backend::Painter},
+        {"painter+cache", Backend::PainterCache},
+        {"raster", Backend::Raster},
+    };
+    const int gridSizes[] = {9, 16, 32, 48, 64};
+    for (int gridSize : gridSizes) {
+        for (const auto& backend : backends) {
+            const LatencyHistogram::Snapshot full = measure(gridSize, size, backend.backend, 0, frames);
+            const LatencyHistogram::Snapshot partial = measure(gridSize, size, backend.backend, 8, frames);
+            std::printf("%6d %6d %-14s %10.1fus %10.1fus %10.1fus %10.1fus\n", gridSize, gridSize * gridSize,
+                        backend.name, full.meanNs() / 1e3, full.percentile(99.0) / 1e3,
+                        partial.meanNs() / 1e3, partial.percentile(99.0) / 1e3);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "BenchSupport.h"
+#include "record/SessionRecorder.h"
+#include "record/SessionWriter.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFileInfo>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+/**
+ * @brief 書き込みスレッドでキャプチャからエンコードまでの遅れを計測する記録先
+ */
+class LatencyMeasuringWriter : public RecordingWriter {
+public:
+    explicit LatencyMeasuringWriter(std::unique_ptr<SessionWriter> writer)
+        : m_writer(std::move(writer))
+    {
+    }
+
+    bool writeEvent(const MidiEvent& event, uint64_t timeUs) override
+    {
+        m_latency.record(MidiEvent::now() - event.timestampNs);
+        return m_writer->writeEvent(event, timeUs);
+    }
+
+    bool close() override { return m_writer->close(); }
+
+    const LatencyHistogram& latency() const { return m_latency; }
+
+private:
+    std::unique_ptr<SessionWriter> m_writer;
+    LatencyHistogram m_latency;
+};
+
+/**
+ * @brief 一定レートのイベントをSessionRecorderのリングバッファに流し、
+ * キャプチャ側の負荷・破棄数・書き込みまでの遅れ・ファイルサイズを表示する
+ * RecorderBench [イベント/秒 (50000)] [秒 (10)] [出力ファイル]
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int rate = argc > 1 ? std::atoi(argv[1]) : 50000;
+    const int seconds = argc > 2 ? std::atoi(argv[2]) : 10;
+    if (rate <= 0 || seconds <= 0) {
+        std::fprintf(stderr, "usage: RecorderBench [events/s] [seconds] [output]\n");
+        return 1;
+    }
+
+    const QString path = argc > 3 ? QString(argv[3]) : QString("lpv_recorder_bench.lpvs");
+    std::unique_ptr<SessionWriter> sessionWriter(new SessionWriter());
+    if (!sessionWriter->open(path, QDateTime::currentMSecsSinceEpoch())) {
+        std::fprintf(stderr, "cannot open %s\n", qPrintable(path));
+        return 1;
+    }
+    LatencyMeasuringWriter* writer = new LatencyMeasuringWriter(std::move(sessionWriter));
+
+    SessionRecorder recorder;
+    recorder.start(std::unique_ptr<RecordingWriter>(writer));
+
+    // キャプチャスレッドの代わりに、一定間隔でイベントを追加する
+    const uint64_t total = static_cast<uint64_t>(rate) * seconds;
+    const uint64_t intervalNs = 1000000000ULL / rate;
+    LatencyHistogram captureCost;
+    uint64_t captureTotalNs = 0;
+    uint32_t random = 1;
+    const uint64_t startNs = MidiEvent::now();
+    for (uint64_t i = 0; i < total; ++i) {
+        BenchSupport::waitUntil(startNs + i * intervalNs);
+
+        random = random * 1664525u + 1013904223u;
+        MidiEvent event;
+        event.data[0] = (i & 1) ? 0x80 : 0x90;
+        event.data[1] = static_cast<unsigned char>(11 + (random >> 24) % 89);
+        event.data[2] = static_cast<unsigned char>(1 + (random >> 8) % 127);
+        event.size = 3;
+        event.timestampNs = MidiEvent::now();
+        recorder.midiEventCaptured(event);
+        const uint64_t costNs = MidiEvent::now() - event.timestampNs;
+        captureCost.record(costNs);
+        captureTotalNs += costNs;
+    }
+    const uint64_t elapsedNs = MidiEvent::now() - startNs;
+    const std::size_t highWater = recorder.queueHighWater();
+    const uint64_t dropped = recorder.droppedEventCount();
+    recorder.stop();
+
+    const qint64 fileSize = QFileInfo(path).size();
+    std::printf("events: %llu in %.2fs (%.0f/s)\n", static_cast<unsigned long long>(total), elapsedNs / 1e9,
+                total / (elapsedNs / 1e9));
+    std::printf("recorded: %llu  dropped: %llu  queue high water: %zu\n",
+                static_cast<unsigned long long>(recorder.recordedEventCount()),
+                static_cast<unsigned long long>(dropped), highWater);
+    std::printf("capture path cost: %.3f%% of wall time\n", 100.0 * captureTotalNs / elapsedNs);
+    BenchSupport::printLatency("capture call", captureCost.snapshot());
+    BenchSupport::printLatency("capture -> encode", writer->latency().snapshot());
+    std::printf("file: %lld bytes (%.2f bytes/event, %.1f MB/hour at this rate)\n",
+                static_cast<long long>(fileSize), static_cast<double>(fileSize) / total,
+                static_cast<double>(fileSize) / seconds * 3600 / 1e6);
+    std::printf("peak RSS: %ld KB\n", BenchSupport::peakRssKb());
+    QFile::remove(path);
+    return dropped == 0 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include "BenchSupport.h"
+#include "record/SmfReader.h"
+#include "record/SmfWriter.h"
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @brief 指定サイズのSMFを書き出す（1ms間隔のNote On/Offをランニングステータスで約3バイト/イベント）
+ */
+static bool generateFile(const QString& path, uint64_t targetBytes)
+{
+    SmfWriter writer;
+    if (!writer.open(path, SmfWriter::Format::MultiTrack)) {
+        return false;
+    }
+
+    const uint64_t eventCount = targetBytes / 3;
+    MidiEvent event;
+    event.size = 3;
+    event.data[0] = 0x90;
+    for (uint64_t i = 0; i < eventCount; ++i) {
+        event.data[1] = static_cast<unsigned char>(11 + (i / 2) % 89);
+        event.data[2] = (i & 1) ? 0 : 100;
+        if (!writer.writeEvent(event, i * 1000)) {
+            return false;
+        }
+    }
+    return writer.close();
+}
+
+/**
+ * @brief SMFを開いて全イベントを読み出し、所要時間と最大常駐メモリを表示する
+ * SmfBench [MB (100)]       指定サイズのファイルを生成して計測
+ * SmfBench --file <path>    既存のファイルを計測
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QString path;
+    bool generated = false;
+    if (argc > 2 && std::strcmp(argv[1], "--file") == 0) {
+        path = QString(argv[2]);
+    } else {
+        const long megabytes = argc > 1 ? std::atol(argv[1]) : 100;
+        if (megabytes <= 0) {
+            std::fprintf(stderr, "usage: SmfBench [MB] | --file <path>\n");
+            return 1;
+        }
+        path = QString("lpv_smf_bench.mid");
+        const uint64_t startNs = MidiEvent::now();
+        if (!generateFile(path, static_cast<uint64_t>(megabytes) * 1000 * 1000)) {
+            std::fprintf(stderr, "cannot write %s\n", qPrintable(path));
+            return 1;
+        }
+        std::printf("generate: %.2fs\n", (MidiEvent::now() - startNs) / 1e9);
+        generated = true;
+    }
+
+    const double fileMb = QFileInfo(path).size() / 1e6;
+    const long rssBeforeKb = BenchSupport::peakRssKb();
+
+    SmfReader reader;
+    uint64_t startNs = MidiEvent::now();
+    if (!reader.open(path)) {
+        std::fprintf(stderr, "cannot open %s\n", qPrintable(path));
+        return 1;
+    }
+    const uint64_t openNs = MidiEvent::now() - startNs;
+
+    // チェックサムで読み出し結果が最適化で消えないようにする
+    MidiEvent event;
+    uint64_t events = 0;
+    uint64_t checksum = 0;
+    startNs = MidiEvent::now();
+    while (reader.readNext(event)) {
+        checksum += event.timestampNs ^ event.data[1];
+        ++events;
+    }
+    const uint64_t readNs = MidiEvent::now() - startNs;
+
+    std::printf("file: %.1f MB, %d tracks, %.1fs long\n", fileMb, reader.trackCount(), reader.durationNs() / 1e9);
+    std::printf("open (scan): %.3fs  (%.0f MB/s)\n", openNs / 1e9, fileMb / (openNs / 1e9));
+    std::printf("read: %llu events in %.3fs  (%.1f ns/event, %.0f MB/s)  checksum %llx\n",
+                static_cast<unsigned long long>(events), readNs / 1e9,
+                events ? static_cast<double>(readNs) / events : 0.0, fileMb / (readNs / 1e9),
+                static_cast<unsigned long long>(checksum));
+    std::printf("peak RSS: %ld KB before open, %ld KB after read (mapped file pages included)\n",
+                rssBeforeKb, BenchSupport::peakRssKb());
+
+    reader.close();
+    if (generated) {
+        QFile::remove(path);
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "BenchSupport.h"
+#include "gui/PadLayout.h"
+#include "gui/PadSpriteCache.h"
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * @brief 描画する場面
+ */
+struct Scene {
+    const char* name;
+    int activePads;   // 押されて光っているパッド数
+    int glowStep;     // 1フレームあたりの明るさの減衰量 (0は一定)
+};
+
+/**
+ * @brief 1フレーム分の全パッドを描画（LaunchpadGrid::paintPadと同じ処理）
+ */
+static void paintFrame(QPainter& painter, const PadLayout& layout, PadSpriteCache* cache,
+                       const Scene& scene, int frame, qreal devicePixelRatio)
+{
+    const QColor borderColor(64, 64, 64);
+    for (int index = 0; index < layout.padCount(); ++index) {
+        const QRect& padRect = layout.padRect(index);
+        const bool round = layout.isRound(index);
+        const QColor color = QColor::fromRgb(PadStateModel::velocityToRgb(1 + (index * 37) % 127));
+        // 押されたパッドを表面全体に均等に散らす
+        int glow = 0;
+        if ((index * scene.activePads) % layout.padCount() < scene.activePads) {
+            glow = scene.glowStep ? 255 - (frame * scene.glowStep + index) % 256 : 255;
+        }
+
+        if (cache) {
+            const QPixmap& sprite = cache->sprite(color, glow, borderColor, round, padRect.width(), devicePixelRatio);
+            painter.drawPixmap(padRect.topLeft() - QPoint(PadSpriteCache::MARGIN, PadSpriteCache::MARGIN), sprite);
+        } else {
+            PadSpriteCache::renderPad(painter, padRect, color, glow, borderColor, round);
+        }
+    }
+}
+
+/**
+ * @brief 指定条件で全パッドの描画を繰り返し、1フレームの描画時間の分布を返す
+ */
+static LatencyHistogram::Snapshot measure(const PadLayout& layout, const QSize& size, qreal devicePixelRatio,
+                                          const Scene& scene, bool useCache, int frames)
+{
+    QImage target(size * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    target.setDevicePixelRatio(devicePixelRatio);
+    PadSpriteCache cache;
+    LatencyHistogram histogram;
+
+    for (int frame = 0; frame < frames; ++frame) {
+        target.fill(Qt::black);
+        const uint64_t startNs = MidiEvent::now();
+        {
+            QPainter painter(&target);
+            painter.setRenderHint(QPainter::Antialiasing);
+            paintFrame(painter, layout, useCache ? &cache : nullptr, scene, frame, devicePixelRatio);
+        }
+        histogram.record(MidiEvent::now() - startNs);
+    }
+    return histogram.snapshot();
+}
+
+/**
+ * @brief パッド画像キャッシュの有無による1フレームの描画時間を比較する
+ * SpriteCacheBench [ウィジェットの幅 (600)] [デバイスピクセル比 (1)] [フレーム数 (600)]
+ * 表示のない環境でも動くよう、QT_QPA_PLATFORMが未設定ならoffscreenを使う
+ */
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+
+    const int width = argc > 1 ? std::atoi(argv[1]) : 600;
+    const qreal devicePixelRatio = argc > 2 ? std::atof(argv[2]) : 1.0;
+    const int frames = argc > 3 ? std::atoi(argv[3]) : 600;
+    if (width <= 0 || devicePixelRatio <= 0 || frames <= 0) {
+        std::fprintf(stderr, "usage: SpriteCacheBench [width] [devicePixelRatio] [frames]\n");
+        return 1;
+    }
+
+    const QSize size(width, width);
+    PadLayout layout;
+    layout.setSize(size);
+    std::printf("%dx%d @%.1fx, pad %dpx, %d frames, platform %s\n", width, width, devicePixelRatio,
+                layout.padSize(), frames, qPrintable(QGuiApplication::platformName()));
+
+    const Scene scenes[] = {
+        {"idle (no glow)", 0, 0},
+        {"8 pads held", 8, 0},
+        {"16 pads decaying", 16, 4},
+        {"81 pads decaying", PadStateModel::PAD_COUNT, 4},
+    };
+    for (const Scene& scene : scenes) {
+        const LatencyHistogram::Snapshot direct = measure(layout, size, devicePixelRatio, scene, false, frames);
+        const LatencyHistogram::Snapshot cached = measure(layout, size, devicePixelRatio, scene, true, frames);
+        std::printf("\n%s\n", scene.name);
+        BenchSupport::printLatency("  without cache", direct);
+        BenchSupport::printLatency("  with cache", cached);
+        std::printf("  mean %.1fus -> %.1fus (x%.2f)\n", direct.meanNs() / 1e3, cached.meanNs() / 1e3,
+                    cached.meanNs() ? static_cast<double>(direct.meanNs()) / cached.meanNs() : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include "BenchSupport.h"
+#include "analysis/TempoEstimator.h"
+#include "record/SessionReader.h"
+#include <QCoreApplication>
+#include <cmath>
+#include <cstdio>
+
+/**
+ * @brief 再現可能な疑似乱数 (0.0-1.0)
+ */
+class BenchRandom {
+public:
+    explicit BenchRandom(uint32_t seed) : m_state(seed) {}
+
+    double next()
+    {
+        m_state = m_state * 1664525u + 1013904223u;
+        return (m_state >> 8) / static_cast<double>(1u << 24);
+    }
+
+private:
+    uint32_t m_state;
+};
+
+/**
+ * @brief 合成する演奏パターン
+ */
+struct Pattern {
+    const char* name;
+    int subdivision;      // 1拍あたりの打鍵位置数
+    double hitChance;     // 各位置で打鍵する確率
+    double jitterMs;      // 打鍵時刻の揺れ (±ミリ秒)
+    int chordSize;        // 同時に押すパッド数
+};
+
+/**
+ * @brief 推定範囲 (1オクターブ) に折り畳んだBPM
+ */
+static double foldBpm(double bpm)
+{
+    while (bpm < TempoEstimator::MIN_BPM) {
+        bpm *= 2;
+    }
+    while (bpm >= TempoEstimator::MAX_BPM) {
+        bpm /= 2;
+    }
+    return bpm;
+}
+
+/**
+ * @brief 既知のテンポで合成した打鍵列を与え、推定誤差と収束までの拍数を表示する
+ */
+static void runAccuracy(const Pattern& pattern, double bpm, int beats)
+{
+    TempoEstimator estimator;
+    BenchRandom random(static_cast<uint32_t>(bpm * 1000) + pattern.subdivision);
+    const double beatNs = 60e9 / bpm;
+    const double expected = foldBpm(bpm);
+    int convergedBeat = -1;
+    uint64_t onsets = 0;
+
+    for (int beat = 0; beat < beats; ++beat) {
+        for (int step = 0; step < pattern.subdivision; ++step) {
+            if (random.next() >= pattern.hitChance) {
+                continue;
+            }
+            const double jitterNs = (random.next() * 2 - 1) * pattern.jitterMs * 1e6;
+            const uint64_t timeNs = static_cast<uint64_t>(1e9 + (beat + static_cast<double>(step) / pattern.subdivision)
+                                                          * beatNs + jitterNs);
+            for (int pad = 0; pad < pattern.chordSize; ++pad) {
+                estimator.addOnset(timeNs + pad * 3000000ULL);
+                ++onsets;
+            }
+        }
+
+        const double error = std::fabs(estimator.bpm() - expected) / expected;
+        if (error <= 0.01) {
+            if (convergedBeat < 0) {
+                convergedBeat = beat + 1;
+            }
+        } else {
+            convergedBeat = -1;
+        }
+    }
+
+    const double estimate = estimator.bpm();
+    std::printf("%-18s %6.1f BPM -> %6.2f (expected %6.2f, error %5.2f%%, confidence %.2f, ",
+                pattern.name, bpm, estimate, expected, 100.0 * std::fabs(estimate - expected) / expected,
+                estimator.confidence());
+    if (convergedBeat > 0) {
+        std::printf("within 1%% after %d beats, %llu onsets)\n", convergedBeat,
+                    static_cast<unsigned long long>(onsets));
+    } else {
+        std::printf("not converged)\n");
+    }
+}
+
+/**
+ * @brief 1打鍵あたりの処理時間を計測
+ */
+static void runCost()
+{
+    const int onsetCount = 2000000;
+    TempoEstimator estimator;
+    BenchRandom random(1);
+    const double beatNs = 60e9 / 123.0;
+
+    MidiEvent event;
+    event.size = 3;
+    event.data[0] = 0x90;
+    event.data[2] = 100;
+
+    LatencyHistogram cost;
+    uint64_t totalNs = 0;
+    for (int i = 0; i < onsetCount; ++i) {
+        event.data[1] = static_cast<unsigned char>(11 + i % 89);
+        event.timestampNs = static_cast<uint64_t>(i * beatNs / 2 + random.next() * 10e6);
+        const uint64_t startNs = MidiEvent::now();
+        estimator.midiEventCaptured(event);
+        const uint64_t elapsedNs = MidiEvent::now() - startNs;
+        cost.record(elapsedNs);
+        totalNs += elapsedNs;
+    }
+
+    std::printf("\nper-event cost over %d Note On events: mean %.1f ns (clock overhead included)\n",
+                onsetCount, static_cast<double>(totalNs) / onsetCount);
+    BenchSupport::printLatency("midiEventCaptured", cost.snapshot());
+}
+
+/**
+ * @brief 記録ファイルを再生して最終的な推定値を表示
+ */
+static void runSession(const QString& path)
+{
+    SessionReader reader;
+    if (!reader.open(path)) {
+        return;
+    }
+
+    TempoEstimator estimator;
+    MidiEvent event;
+    uint64_t events = 0;
+    const uint64_t startNs = MidiEvent::now();
+    while (reader.readNext(event)) {
+        estimator.midiEventCaptured(event);
+        ++events;
+    }
+    const uint64_t elapsedNs = MidiEvent::now() - startNs;
+    std::printf("%s: %.2f BPM (confidence %.2f), %llu events, %.1f ns/event including decode\n",
+                qPrintable(path), estimator.bpm(), estimator.confidence(),
+                static_cast<unsigned long long>(events), events ? static_cast<double>(elapsedNs) / events : 0.0);
+}
+
+/**
+ * @brief TempoEstimatorの精度と1イベントあたりの処理時間を表示する
+ * TempoBench [session.lpvs ...]   記録ファイルを与えると各ファイルの推定値も表示
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const Pattern patterns[] = {
+        {"quarters", 1, 1.0, 0.0, 1},
+        {"quarters +-15ms", 1, 1.0, 15.0, 1},
+        {"eighths 70%", 2, 0.7, 10.0, 1},
+        {"sixteenths 50%", 4, 0.5, 8.0, 1},
+        {"chords of 3", 1, 0.9, 10.0, 3},
+    };
+    const double tempos[] = {72.0, 90.0, 100.0, 120.0, 128.0, 140.0, 174.0};
+    for (const Pattern& pattern : patterns) {
+        for (double bpm : tempos) {
+            runAccuracy(pattern, bpm, 64);
+        }
+    }
+
+    runCost();
+
+    if (argc > 1) {
+        std::printf("\n");
+        for (int i = 1; i < argc; ++i) {
+            runSession(QString(argv[i]));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#!/usr/bin/env bash
+# lpvd と GUI版の起動時間・最大常駐メモリを比較する
+#
+# 使い方: bench/compare_footprint.sh [ビルドディレクトリ] [常駐させる秒数] [lpvdの入力デバイス]
+#
+# 各プログラムを /usr/bin/time -v の下で
+#   1. --help だけを実行（ライブラリの読み込みと引数解析まで）
+#   2. 指定秒数だけ動かしてから SIGINT で終了（イベントループに入った状態）
+# の2通りで起動し、経過時間と最大常駐メモリ (Maximum resident set size) を表にする。
+# GUI版は表示のない環境でも動くよう offscreen プラットフォームで起動する。
+# lpvd は入力デバイスがないと起動時に終了するため、Launchpad がない環境では
+# "Midi Through" などの仮想ポートを名前または番号で指定する（既定は 0 番）。
+# どの実行も timeout の下で起動し、--help が終わらない場合も HELP_TIMEOUT 秒で打ち切って表に印を付ける。
+
+set -euo pipefail
+
+BUILD_DIR="${1:-build}"
+SECONDS_TO_RUN="${2:-5}"
+DEVICE="${3:-0}"
+HELP_TIMEOUT=10
+
+LPVD="${BUILD_DIR}/lpvd"
+GUI="${BUILD_DIR}/LaunchpadVisualizer"
+
+if [[ ! -x /usr/bin/time ]]; then
+    echo "/usr/bin/time が見つかりません（GNU time が必要です）" >&2
+    exit 1
+fi
+
+for binary in "${LPVD}" "${GUI}"; do
+    if [[ ! -x "${binary}" ]]; then
+        echo "実行ファイルが見つかりません: ${binary}" >&2
+        exit 1
+    fi
+done
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "${WORK_DIR}"' EXIT
+
+# /usr/bin/time -v の出力から経過時間（秒）と最大常駐メモリ（KB）を取り出す
+# 使い方: measure once|run ラベル コマンド...
+#   once: 自分で終了するはずの実行（HELP_TIMEOUT 秒で打ち切った場合は失敗として印を付ける）
+#   run:  SECONDS_TO_RUN 秒動かしてから SIGINT で終了させる実行
+measure() {
+    local mode="$1"
+    local label="$2"
+    shift 2
+    local report="${WORK_DIR}/time.txt"
+    local limit="${SECONDS_TO_RUN}"
+    if [[ "${mode}" == once ]]; then
+        limit="${HELP_TIMEOUT}"
+    fi
+
+    # SIGINT で終わらない場合も5秒後に SIGKILL で止める
+    local status=0
+    /usr/bin/time -v -o "${report}" timeout -k 5 -s INT "${limit}" "$@" > /dev/null 2>&1 || status=$?
+
+    local elapsed rss
+    elapsed="$(awk -F': ' '/Elapsed \(wall clock\) time/ {
+        n = split($2, t, ":"); s = 0
+        for (i = 1; i <= n; i++) s = s * 60 + t[i]
+        printf "%.3f", s
+    }' "${report}")"
+    rss="$(awk -F': ' '/Maximum resident set size/ { print $2 }' "${report}")"
+
+    # run の終了コード（timeout による SIGINT 終了を含む）は比較に関係しない
+    if [[ "${mode}" == once && ( "${status}" -eq 124 || "${status}" -eq 137 ) ]]; then
+        echo "${label}: ${limit}秒で終了しなかったため打ち切りました" >&2
+        label="${label} (打ち切り)"
+    fi
+
+    printf "| %-28s | %10s | %14s |\n" "${label}" "${elapsed}" "${rss}"
+}
+
+echo "| 実行 | 経過時間 (s) | 最大常駐 (KB) |"
+echo "|---|---:|---:|"
+
+measure once "lpvd --help" "${LPVD}" --help
+measure once "LaunchpadVisualizer --help" env QT_QPA_PLATFORM=offscreen "${GUI}" --help
+
+measure run "lpvd (${SECONDS_TO_RUN}s)" "${LPVD}" --device "${DEVICE}" --stats "${WORK_DIR}/stats.csv"
+measure run "LaunchpadVisualizer (${SECONDS_TO_RUN}s)" env QT_QPA_PLATFORM=offscreen "${GUI}"
@@ -0,0 +1,195 @@
+/**
+ * @file shm_reader.c
+ * @brief 共有メモリからパッドの状態を読む例
+ *
+ * lpv_shm_reader [名前]
+ *     1kHzで状態を読み、変化したパッドを表示する
+ * lpv_shm_reader --stress [秒]
+ *     専用のセグメントを作り、子プロセスで全力で書き込みながら読み続けて、
+ *     ちぎれた読み出し（チェックサムの不一致）がないことを確かめる。不一致があれば終了コード1
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "lpv_shm.h"
+
+static volatile sig_atomic_t s_stop = 0;
+
+static void handle_signal(int signal)
+{
+    (void)signal;
+    s_stop = 1;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 書き込み側が作ったセグメントを読み取り専用でマップする
+ */
+static const lpv_shm_segment* map_reader(const char* name)
+{
+    const int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        perror("shm_open");
+        return NULL;
+    }
+    void* mapped = mmap(NULL, sizeof(lpv_shm_segment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        perror("mmap");
+        return NULL;
+    }
+    return (const lpv_shm_segment*)mapped;
+}
+
+/**
+ * @brief 1kHzで読み、変化したパッドを表示する
+ */
+static int watch(const char* name)
+{
+    const lpv_shm_segment* segment = map_reader(name);
+    if (!segment) {
+        return 1;
+    }
+    if (!lpv_shm_is_valid(segment)) {
+        fprintf(stderr, "%s は対応する形式ではないか、書き込み側が終了しています\n", name);
+        return 1;
+    }
+    printf("書き込み側 pid %u を読んでいます (Ctrl+Cで終了)\n", segment->writer_pid);
+
+    lpv_shm_snapshot previous;
+    memset(&previous, 0, sizeof(previous));
+    const struct timespec interval = {0, 1000000};
+    while (!s_stop) {
+        lpv_shm_snapshot snapshot;
+        if (!lpv_shm_is_valid(segment)) {
+            fprintf(stderr, "書き込み側が終了しました\n");
+            break;
+        }
+        if (lpv_shm_read(segment, &snapshot, 100) && snapshot.updates != previous.updates) {
+            for (int i = 0; i < LPV_SHM_PAD_COUNT; ++i) {
+                const uint32_t value = snapshot.pads[i];
+                if (value != previous.pads[i]) {
+                    printf("pad %d,%d %s vel=%3u rgb=#%06X\n", i % LPV_SHM_GRID_SIZE, i / LPV_SHM_GRID_SIZE,
+                           LPV_SHM_PAD_ACTIVE(value) ? "on " : "off", LPV_SHM_PAD_VELOCITY(value),
+                           LPV_SHM_PAD_RGB(value));
+                }
+            }
+            previous = snapshot;
+        }
+        nanosleep(&interval, NULL);
+    }
+    munmap((void*)segment, sizeof(lpv_shm_segment));
+    return 0;
+}
+
+/**
+ * @brief 書き込み側: 乱数でパッドを更新し続ける
+ */
+static void stress_writer(lpv_shm_segment* segment)
+{
+    uint32_t pads[LPV_SHM_PAD_COUNT];
+    memcpy(pads, segment->pads, sizeof(pads));
+    uint32_t random = 12345u;
+    while (!s_stop) {
+        lpv_shm_write_begin(segment);
+        // 1回の更新で複数のパッドを書き換え、ちぎれやすくする
+        for (int n = 0; n < 8; ++n) {
+            random = random * 1664525u + 1013904223u;
+            const int index = (int)((random >> 8) % LPV_SHM_PAD_COUNT);
+            pads[index] = LPV_SHM_PAD_VALUE(random & 1u, random >> 25, random);
+            lpv_shm_write_pad(segment, index, pads[index]);
+        }
+        lpv_shm_write_end(segment, lpv_shm_checksum(pads), now_ns());
+
+        // 更新の間隔をばらつかせ、読み出しが更新の途中と重なる場面を作る
+        for (volatile uint32_t spin = 0; spin < (random & 0x3FFu); ++spin) {
+        }
+    }
+}
+
+/**
+ * @brief 書き込みと並行して読み、チェックサムを確かめる
+ */
+static int stress(int seconds)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "/lpv-padstate-stress-%d", (int)getpid());
+
+    const int fd = shm_open(name, O_CREAT | O_RDWR | O_EXCL, 0600);
+    if (fd < 0 || ftruncate(fd, sizeof(lpv_shm_segment)) != 0) {
+        perror("shm_open");
+        return 1;
+    }
+    lpv_shm_segment* segment = (lpv_shm_segment*)mmap(NULL, sizeof(lpv_shm_segment), PROT_READ | PROT_WRITE,
+                                                      MAP_SHARED, fd, 0);
+    close(fd);
+    shm_unlink(name);
+    if (segment == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    segment->version = LPV_SHM_VERSION;
+    segment->size = (uint32_t)sizeof(lpv_shm_segment);
+    segment->writer_pid = (uint32_t)getpid();
+    segment->checksum = lpv_shm_checksum(segment->pads);
+    __atomic_store_n(&segment->magic, LPV_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    const pid_t writer = fork();
+    if (writer < 0) {
+        perror("fork");
+        return 1;
+    }
+    if (writer == 0) {
+        stress_writer(segment);
+        _exit(0);
+    }
+
+    uint64_t reads = 0;
+    uint64_t failed = 0;
+    uint64_t torn = 0;
+    const uint64_t end_ns = now_ns() + (uint64_t)seconds * 1000000000u;
+    while (!s_stop && now_ns() < end_ns) {
+        lpv_shm_snapshot snapshot;
+        if (!lpv_shm_read(segment, &snapshot, 1000)) {
+            ++failed;
+            continue;
+        }
+        ++reads;
+        if (lpv_shm_checksum(snapshot.pads) != snapshot.checksum) {
+            ++torn;
+        }
+    }
+    kill(writer, SIGTERM);
+    waitpid(writer, NULL, 0);
+
+    printf("更新 %llu 回 / 読み出し %llu 回 / 読めなかった %llu 回 / ちぎれた読み出し %llu 回\n",
+           (unsigned long long)segment->updates, (unsigned long long)reads,
+           (unsigned long long)failed, (unsigned long long)torn);
+    munmap(segment, sizeof(lpv_shm_segment));
+    return torn == 0 && reads > 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+
+    if (argc > 1 && strcmp(argv[1], "--stress") == 0) {
+        return stress(argc > 2 ? atoi(argv[2]) : 5);
+    }
+    return watch(argc > 1 ? argv[1] : LPV_SHM_DEFAULT_NAME);
+}
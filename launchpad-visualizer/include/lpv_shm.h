@@ -0,0 +1,160 @@
+/**
+ * @file lpv_shm.h
+ * @brief Launchpad Visualizer のパッドの状態を共有メモリから読むためのCヘッダー
+ *
+ * LaunchpadVisualizer / lpvd は POSIX 共有メモリ (既定の名前は LPV_SHM_DEFAULT_NAME) に
+ * 9x9のパッドの状態を書き込む。書き込み側は1つで、seqlock で更新を囲む。
+ * sequence が奇数の間は更新中で、読み出しの前後で sequence が同じ偶数なら一貫した状態が読めている。
+ * 読み出しはシステムコールを使わず、lpv_shm_read() だけで行える。
+ *
+ * 使い方:
+ * @code
+ *   int fd = shm_open(LPV_SHM_DEFAULT_NAME, O_RDONLY, 0);
+ *   const lpv_shm_segment* seg = mmap(NULL, sizeof(lpv_shm_segment), PROT_READ, MAP_SHARED, fd, 0);
+ *   lpv_shm_snapshot snap;
+ *   if (lpv_shm_is_valid(seg) && lpv_shm_read(seg, &snap, 100)) { ... }
+ * @endcode
+ *
+ * GCC / Clang の __atomic 組み込み関数を使う（C99 以降、C++ からも利用可）
+ */
+#ifndef LPV_SHM_H
+#define LPV_SHM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LPV_SHM_DEFAULT_NAME "/lpv-padstate"  /* shm_open に渡す既定の名前 */
+#define LPV_SHM_MAGIC 0x4D56504Cu             /* "LPVM" (リトルエンディアン) */
+#define LPV_SHM_VERSION 1u
+#define LPV_SHM_GRID_SIZE 9                    /* 1辺のパッド数 */
+#define LPV_SHM_PAD_COUNT 81                   /* パッド数 (インデックスは y * 9 + x、y=0が最下段) */
+
+/* パッドの値: ビット31が押下中、ビット30-24がベロシティ、ビット23-0が色 (0xRRGGBB) */
+#define LPV_SHM_PAD_ACTIVE(v) (((v) >> 31) & 1u)
+#define LPV_SHM_PAD_VELOCITY(v) (((v) >> 24) & 0x7Fu)
+#define LPV_SHM_PAD_RGB(v) ((v) & 0xFFFFFFu)
+#define LPV_SHM_PAD_VALUE(active, velocity, rgb) \
+    (((uint32_t)((active) ? 1u : 0u) << 31) | ((uint32_t)((velocity) & 0x7Fu) << 24) | ((uint32_t)(rgb) & 0xFFFFFFu))
+
+/**
+ * @brief 共有メモリの配置
+ * sequence 以降のフィールドは seqlock の中でのみ書き換えられる
+ */
+typedef struct lpv_shm_segment {
+    uint32_t magic;        /* LPV_SHM_MAGIC */
+    uint32_t version;      /* LPV_SHM_VERSION */
+    uint32_t size;         /* sizeof(lpv_shm_segment) */
+    uint32_t writer_pid;   /* 書き込み側のプロセスID */
+    uint32_t sequence;     /* 更新中は奇数 */
+    uint32_t checksum;     /* pads のチェックサム (lpv_shm_checksum) */
+    uint64_t update_ns;    /* 最後に更新した時刻 (書き込み側の単調時計、ナノ秒) */
+    uint64_t updates;      /* 更新の回数 */
+    uint32_t pads[LPV_SHM_PAD_COUNT];
+} lpv_shm_segment;
+
+/**
+ * @brief 一貫した状態のコピー
+ */
+typedef struct lpv_shm_snapshot {
+    uint32_t sequence;
+    uint32_t checksum;
+    uint64_t update_ns;
+    uint64_t updates;
+    uint32_t pads[LPV_SHM_PAD_COUNT];
+} lpv_shm_snapshot;
+
+/**
+ * @brief パッドの値のチェックサム (FNV-1a)
+ * 読み出した状態がちぎれていないことの確認に使える
+ */
+static inline uint32_t lpv_shm_checksum(const uint32_t* pads)
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < LPV_SHM_PAD_COUNT; ++i) {
+        hash = (hash ^ pads[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief 書き込み側が初期化を終えた、対応する版のセグメントか確かめる
+ * @return 読める場合1
+ */
+static inline int lpv_shm_is_valid(const lpv_shm_segment* segment)
+{
+    return __atomic_load_n(&segment->magic, __ATOMIC_ACQUIRE) == LPV_SHM_MAGIC
+        && segment->version == LPV_SHM_VERSION
+        && segment->size == (uint32_t)sizeof(lpv_shm_segment);
+}
+
+/**
+ * @brief 一貫した状態を読み出す
+ * @param segment 共有メモリ
+ * @param snapshot 出力先
+ * @param max_attempts 更新と重なったときに読み直す回数の上限
+ * @return 読めた場合1、更新が続いて読めなかった場合0
+ */
+static inline int lpv_shm_read(const lpv_shm_segment* segment, lpv_shm_snapshot* snapshot, int max_attempts)
+{
+    for (int attempt = 0; attempt < max_attempts; ++attempt) {
+        const uint32_t begin = __atomic_load_n(&segment->sequence, __ATOMIC_ACQUIRE);
+        if (begin & 1u) {
+            continue;
+        }
+        snapshot->checksum = __atomic_load_n(&segment->checksum, __ATOMIC_RELAXED);
+        snapshot->update_ns = __atomic_load_n(&segment->update_ns, __ATOMIC_RELAXED);
+        snapshot->updates = __atomic_load_n(&segment->updates, __ATOMIC_RELAXED);
+        for (int i = 0; i < LPV_SHM_PAD_COUNT; ++i) {
+            snapshot->pads[i] = __atomic_load_n(&segment->pads[i], __ATOMIC_RELAXED);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&segment->sequence, __ATOMIC_RELAXED) == begin) {
+            snapshot->sequence = begin;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 更新を開始（書き込み側のみ）
+ */
+static inline void lpv_shm_write_begin(lpv_shm_segment* segment)
+{
+    const uint32_t sequence = __atomic_load_n(&segment->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&segment->sequence, sequence + 1u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief パッドの値を書き込む（lpv_shm_write_begin と lpv_shm_write_end の間で）
+ */
+static inline void lpv_shm_write_pad(lpv_shm_segment* segment, int index, uint32_t value)
+{
+    __atomic_store_n(&segment->pads[index], value, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 更新を終える（書き込み側のみ）
+ * @param segment 共有メモリ
+ * @param checksum 更新後のパッドの値のチェックサム
+ * @param update_ns 更新した時刻
+ */
+static inline void lpv_shm_write_end(lpv_shm_segment* segment, uint32_t checksum, uint64_t update_ns)
+{
+    __atomic_store_n(&segment->checksum, checksum, __ATOMIC_RELAXED);
+    __atomic_store_n(&segment->update_ns, update_ns, __ATOMIC_RELAXED);
+    __atomic_store_n(&segment->updates, __atomic_load_n(&segment->updates, __ATOMIC_RELAXED) + 1u,
+                     __ATOMIC_RELAXED);
+    __atomic_store_n(&segment->sequence, __atomic_load_n(&segment->sequence, __ATOMIC_RELAXED) + 1u,
+                     __ATOMIC_RELEASE);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPV_SHM_H */
@@ -1,24 +1,77 @@
 #include "LaunchpadVisualizer.h"
 #include <QDebug>
-#include <QColor>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QDateTime>
+#include "record/SessionWriter.h"
+#include "record/SmfWriter.h"
+#include "diag/TraceRecorder.h"
 
 LaunchpadVisualizer::LaunchpadVisualizer(QObject *parent)
     : QObject(parent)
+    , m_latencyTracker(std::make_unique<LatencyTracker>())
+    , m_telemetry(std::make_unique<Telemetry>())
+    , m_tempoEstimator(std::make_unique<TempoEstimator>())
+    , m_recorder(std::make_unique<SessionRecorder>())
+    , m_eventTap(std::make_unique<MidiEventTap>())
     , m_midiManager(std::make_unique<MidiManager>())
+    , m_player(std::make_unique<SessionPlayer>(m_midiManager.get()))
     , m_isRunning(false)
+    , m_publishedBpm(0.0)
+    , m_publishedConfidence(0.0)
 {
+    // レコーダー・テンポ推定・イベント配信のキューはキャプチャスレッドで直接イベントを受け取る
+    m_midiManager->addInputListener(m_recorder.get());
+    m_midiManager->addInputListener(m_tempoEstimator.get());
+    m_midiManager->addInputListener(m_eventTap.get());
+    m_midiManager->setLatencyTracker(m_latencyTracker.get());
+    m_midiManager->setTelemetry(m_telemetry.get());
+    
     // MIDIマネージャーからのシグナルを接続
     connect(m_midiManager.get(), &MidiManager::noteOnReceived, 
             this, &LaunchpadVisualizer::onNoteOn);
     connect(m_midiManager.get(), &MidiManager::noteOffReceived, 
             this, &LaunchpadVisualizer::onNoteOff);
+    connect(m_midiManager.get(), &MidiManager::controlChangeReceived,
+            this, &LaunchpadVisualizer::onControlChange);
     connect(m_midiManager.get(), &MidiManager::sysExReceived, 
             this, &LaunchpadVisualizer::onSysEx);
+    connect(m_midiManager.get(), &MidiManager::clockRunningChanged,
+            this, &LaunchpadVisualizer::clockRunningChanged);
+    
+    // 再生終了を通知
+    connect(m_player.get(), &SessionPlayer::playbackFinished,
+            this, &LaunchpadVisualizer::playbackFinished);
+    connect(m_player.get(), &SessionPlayer::stateRestored,
+            this, &LaunchpadVisualizer::onPadStateRestored);
+    
+    // 入力がない間も統計のスライディングウィンドウを減衰させる
+    m_statisticsTimer.setInterval(1000);
+    connect(&m_statisticsTimer, &QTimer::timeout,
+            this, &LaunchpadVisualizer::advanceStatistics);
+    m_statisticsTimer.start();
+    
+    // デバイス操作の結果はGUIスレッドで受け取る
+    connect(&m_listWatcher, &QFutureWatcher<QStringList>::finished,
+            this, &LaunchpadVisualizer::onDevicesListed);
+    connect(&m_connectWatcher, &QFutureWatcher<bool>::finished,
+            this, &LaunchpadVisualizer::onDeviceConnected);
+    connect(&m_disconnectWatcher, &QFutureWatcher<void>::finished,
+            this, &LaunchpadVisualizer::onDeviceDisconnected);
+    connect(&m_playbackCloseWatcher, &QFutureWatcher<void>::finished,
+            this, &LaunchpadVisualizer::onInputClosedForPlayback);
 }
 
 LaunchpadVisualizer::~LaunchpadVisualizer()
 {
     stopVisualization();
+    cancelPlayback();
+    
+    // 切断もデバイス操作用のスレッドで行い、先行する操作を含めて終わるまで待つ
+    m_midiManager->closeInputDeviceAsync();
+    m_midiManager->waitForDeviceOperations();
+    m_recorder->stop();
 }
 
 QStringList LaunchpadVisualizer::getAvailableMidiDevices() const
@@ -32,13 +85,45 @@ bool LaunchpadVisualizer::connectToDevice(int deviceIndex)
         stopVisualization();
     }
     
-    return m_midiManager->openInputDevice(deviceIndex);
+    // 再生とライブ入力は同時に扱わない
+    cancelPlayback();
+    
+    // 接続はデバイス操作用のスレッドで行い、先行する操作を含めて終わるまで待つ
+    QFuture<bool> result = m_midiManager->openInputDeviceAsync(deviceIndex);
+    m_midiManager->waitForDeviceOperations();
+    return result.result();
 }
 
 void LaunchpadVisualizer::disconnectDevice()
 {
     stopVisualization();
-    m_midiManager->closeInputDevice();
+    cancelPlayback();
+    m_midiManager->closeInputDeviceAsync();
+    m_midiManager->waitForDeviceOperations();
+}
+
+void LaunchpadVisualizer::listDevicesAsync()
+{
+    m_listWatcher.setFuture(m_midiManager->getAvailableInputDevicesAsync());
+}
+
+void LaunchpadVisualizer::connectToDeviceAsync(int deviceIndex)
+{
+    stopVisualization();
+    cancelPlayback();
+    m_connectWatcher.setFuture(m_midiManager->openInputDeviceAsync(deviceIndex));
+}
+
+void LaunchpadVisualizer::disconnectDeviceAsync()
+{
+    stopVisualization();
+    cancelPlayback();
+    m_disconnectWatcher.setFuture(m_midiManager->closeInputDeviceAsync());
+}
+
+bool LaunchpadVisualizer::isDeviceConnected() const
+{
+    return m_midiManager->isInputDeviceOpen();
 }
 
 bool LaunchpadVisualizer::startVisualization()
@@ -68,32 +153,248 @@ bool LaunchpadVisualizer::isRunning() const
     return m_isRunning;
 }
 
+bool LaunchpadVisualizer::startRecording(const QString& filePath)
+{
+    std::unique_ptr<RecordingWriter> writer;
+    if (isMidiFile(filePath)) {
+        auto smfWriter = std::make_unique<SmfWriter>();
+        if (!smfWriter->open(filePath, SmfWriter::Format::MultiTrack)) {
+            return false;
+        }
+        writer = std::move(smfWriter);
+    } else {
+        auto sessionWriter = std::make_unique<SessionWriter>();
+        if (!sessionWriter->open(filePath, QDateTime::currentMSecsSinceEpoch())) {
+            return false;
+        }
+        writer = std::move(sessionWriter);
+    }
+    
+    return m_recorder->start(std::move(writer));
+}
+
+void LaunchpadVisualizer::stopRecording()
+{
+    m_recorder->stop();
+}
+
+bool LaunchpadVisualizer::isRecording() const
+{
+    return m_recorder->isRecording();
+}
+
+bool LaunchpadVisualizer::startPlayback(const QString& filePath)
+{
+    std::unique_ptr<PlaybackSource> source = SessionPlayer::openSource(filePath);
+    if (!source) {
+        return false;
+    }
+    
+    // キャプチャスレッドと再生スレッドが同時にイベントを入力しないよう、
+    // デバイス操作用のスレッドでライブ入力を閉じてから再生を始める
+    cancelPlayback();
+    m_pendingPlayback = std::move(source);
+    m_pendingPlaybackPath = filePath;
+    m_playbackCloseWatcher.setFuture(m_midiManager->closeInputDeviceAsync());
+    return true;
+}
+
+void LaunchpadVisualizer::stopPlayback()
+{
+    cancelPlayback();
+    
+    // 再生のみで可視化していた場合は可視化も停止
+    if (m_isRunning && !m_midiManager->isInputDeviceOpen()) {
+        stopVisualization();
+    }
+}
+
+bool LaunchpadVisualizer::isPlaying() const
+{
+    return m_pendingPlayback || m_player->isPlaying();
+}
+
+void LaunchpadVisualizer::setPlaybackSpeed(double speed)
+{
+    m_player->setSpeed(speed);
+}
+
+void LaunchpadVisualizer::setPlaybackPaused(bool paused)
+{
+    m_player->setPaused(paused);
+}
+
+void LaunchpadVisualizer::seekPlayback(uint64_t positionNs)
+{
+    m_player->seek(positionNs);
+}
+
+uint64_t LaunchpadVisualizer::playbackPositionNs() const
+{
+    return m_player->positionNs();
+}
+
+uint64_t LaunchpadVisualizer::playbackDurationNs() const
+{
+    return m_player->durationNs();
+}
+
+LatencyTracker* LaunchpadVisualizer::latencyTracker() const
+{
+    return m_latencyTracker.get();
+}
+
+Telemetry* LaunchpadVisualizer::telemetry() const
+{
+    return m_telemetry.get();
+}
+
+std::size_t LaunchpadVisualizer::recordingQueueDepth() const
+{
+    return m_recorder->queuedEventCount();
+}
+
+std::size_t LaunchpadVisualizer::recordingQueueHighWater() const
+{
+    return m_recorder->queueHighWater();
+}
+
+uint64_t LaunchpadVisualizer::droppedEventCount() const
+{
+    return m_recorder->droppedEventCount();
+}
+
+const PadStateModel& LaunchpadVisualizer::padState() const
+{
+    return m_padState;
+}
+
+MidiEventTap* LaunchpadVisualizer::eventTap()
+{
+    return m_eventTap.get();
+}
+
+bool LaunchpadVisualizer::applyPadColors(const LaunchpadProtocol::PadColor* colors, std::size_t count)
+{
+    // フレーム分の色を1つのSysExにまとめて送る
+    const std::vector<unsigned char> message = m_protocol.createRgbColorMessage(colors, count);
+    const bool sent = !message.empty() && m_midiManager->sendMessage(message);
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        const LaunchpadProtocol::PadColor& pad = colors[i];
+        if (!PadStateModel::isValidCoordinate(pad.x, pad.y)) {
+            continue;
+        }
+        m_padState.setColor(pad.x, pad.y, pad.rgb);
+        emit padColorChanged(pad.x, pad.y, pad.rgb);
+    }
+    return sent;
+}
+
+const PadStatistics& LaunchpadVisualizer::padStatistics() const
+{
+    return m_statistics;
+}
+
+void LaunchpadVisualizer::resetStatistics()
+{
+    m_statistics.reset();
+    emit statisticsUpdated();
+}
+
+bool LaunchpadVisualizer::exportStatistics(const QString& filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "使用統計を保存できません:" << filePath;
+        return false;
+    }
+    
+    QTextStream out(&file);
+    out << "note,x,y,hits,mean_velocity,max_velocity,mean_hold_ms,max_hold_ms,"
+           "hits_per_minute,hits_last_10s,hits_last_60s\n";
+    for (int y = 0; y < PadStateModel::GRID_SIZE; ++y) {
+        for (int x = 0; x < PadStateModel::GRID_SIZE; ++x) {
+            if (m_statistics.hitCount(x, y) == 0) {
+                continue;
+            }
+            out << (y + 1) * 10 + (x + 1) << ',' << x << ',' << y << ','
+                << m_statistics.hitCount(x, y) << ','
+                << QString::number(m_statistics.meanVelocity(x, y), 'f', 1) << ','
+                << static_cast<int>(m_statistics.maxVelocity(x, y)) << ','
+                << QString::number(m_statistics.meanHoldNs(x, y) / 1e6, 'f', 1) << ','
+                << QString::number(m_statistics.maxHoldNs(x, y) / 1e6, 'f', 1) << ','
+                << QString::number(m_statistics.hitsPerMinute(x, y), 'f', 1) << ','
+                << m_statistics.hitCount(x, y, PadStatistics::Window::Last10s) << ','
+                << m_statistics.hitCount(x, y, PadStatistics::Window::Last60s) << '\n';
+        }
+    }
+    return true;
+}
+
+double LaunchpadVisualizer::tempoBpm() const
+{
+    return m_tempoEstimator->bpm();
+}
+
+double LaunchpadVisualizer::tempoConfidence() const
+{
+    return m_tempoEstimator->confidence();
+}
+
+const MidiClockTracker& LaunchpadVisualizer::clockTracker() const
+{
+    return m_midiManager->clockTracker();
+}
+
 void LaunchpadVisualizer::onNoteOn(unsigned char note, unsigned char velocity)
 {
+    TRACE_SCOPE("visualizer.noteOn");
+    m_telemetry->eventHandled();
     if (!m_isRunning) {
         return;
     }
     
     int x, y;
     if (noteToCoordinates(note, x, y)) {
-        emit padPressed(x, y, velocity);
-        
-        // ベロシティ値から色を決定（仮実装）
-        // 後でLaunchpadProtocolによる適切な色変換に置き換える
-        QColor color = QColor::fromHsv(velocity * 2, 255, 255);
-        emit padColorChanged(x, y, color);
+        pressPad(x, y, velocity);
     }
+    
+    // 推定はキャプチャスレッドで更新済みなので、打鍵のたびに結果だけを確認する
+    publishTempo();
 }
 
 void LaunchpadVisualizer::onNoteOff(unsigned char note)
 {
+    TRACE_SCOPE("visualizer.noteOff");
+    m_telemetry->eventHandled();
     if (!m_isRunning) {
         return;
     }
     
     int x, y;
     if (noteToCoordinates(note, x, y)) {
-        emit padReleased(x, y);
+        releasePad(x, y);
+    }
+}
+
+void LaunchpadVisualizer::onControlChange(unsigned char controller, unsigned char value)
+{
+    TRACE_SCOPE("visualizer.controlChange");
+    m_telemetry->eventHandled();
+    if (!m_isRunning) {
+        return;
+    }
+    
+    // 上段・右端のボタンはコントロールチェンジを送る（値0で離上）
+    int x, y;
+    if (!PadStateModel::controlToXY(controller, x, y)) {
+        return;
+    }
+    if (value > 0) {
+        pressPad(x, y, value);
+    } else {
+        releasePad(x, y);
     }
 }
 
@@ -109,29 +410,119 @@ void LaunchpadVisualizer::onSysEx(const std::vector<unsigned char>& data)
     // TODO: SysExメッセージから色情報を抽出し、padColorChangedシグナルを発行する
 }
 
-bool LaunchpadVisualizer::noteToCoordinates(unsigned char note, int& x, int& y) const
+void LaunchpadVisualizer::onPadStateRestored(const PadStateModel& state)
 {
-    // Launchpad Xのノート番号からグリッド座標へのマッピング
-    // 詳細なマッピングはLaunchpad Xのプログラマーリファレンスに基づいて実装する必要がある
-    // 以下は仮実装
+    m_padState = state;
     
-    // 11 12 13 14 15 16 17 18
-    // 21 22 23 24 25 26 27 28
-    // ...
-    // 81 82 83 84 85 86 87 88
+    // 表示中のパッドをすべて復元後の状態に揃える
+    for (int y = 0; y < PadStateModel::GRID_SIZE; ++y) {
+        for (int x = 0; x < PadStateModel::GRID_SIZE; ++x) {
+            emit padColorChanged(x, y, state.color(x, y));
+            if (state.isActive(x, y)) {
+                emit padPressed(x, y, state.velocity(x, y));
+            } else {
+                emit padReleased(x, y);
+            }
+        }
+    }
+}
+
+void LaunchpadVisualizer::pressPad(int x, int y, unsigned char velocity)
+{
+    m_padState.press(x, y, velocity);
+    m_statistics.notePressed(x, y, velocity, MidiEvent::now());
+    m_latencyTracker->eventApplied(x, y);
+    emit padPressed(x, y, velocity);
+    
+    // ベロシティ値から色を決定（仮実装）
+    // 後でLaunchpadProtocolによる適切な色変換に置き換える
+    emit padColorChanged(x, y, m_padState.color(x, y));
+}
+
+void LaunchpadVisualizer::releasePad(int x, int y)
+{
+    m_padState.release(x, y);
+    m_statistics.noteReleased(x, y, MidiEvent::now());
+    m_latencyTracker->eventApplied(x, y);
+    emit padReleased(x, y);
+}
+
+void LaunchpadVisualizer::advanceStatistics()
+{
+    m_statistics.advance(MidiEvent::now());
+    emit statisticsUpdated();
+}
+
+void LaunchpadVisualizer::onDevicesListed()
+{
+    emit devicesListed(m_listWatcher.result());
+}
+
+void LaunchpadVisualizer::onDeviceConnected()
+{
+    emit deviceConnected(m_connectWatcher.result());
+}
+
+void LaunchpadVisualizer::onDeviceDisconnected()
+{
+    emit deviceDisconnected();
+}
+
+void LaunchpadVisualizer::onInputClosedForPlayback()
+{
+    // 切断を待つ間に再生が取り消されていれば何もしない
+    if (!m_pendingPlayback) {
+        return;
+    }
+    
+    std::unique_ptr<PlaybackSource> source = std::move(m_pendingPlayback);
+    m_padState.reset();
+    m_tempoEstimator->reset();
     
-    if (note < 11 || note > 88) {
-        return false; // 有効な範囲外
+    if (!m_player->start(std::move(source))) {
+        qWarning() << "セッションの再生を開始できませんでした:" << m_pendingPlaybackPath;
+        emit playbackStarted(false);
+        return;
     }
     
-    int row = (note / 10) - 1;
-    int col = (note % 10) - 1;
+    m_isRunning = true;
+    qInfo() << "セッションの再生を開始しました:" << m_pendingPlaybackPath;
+    emit playbackStarted(true);
+}
+
+void LaunchpadVisualizer::cancelPlayback()
+{
+    m_pendingPlayback.reset();
+    m_player->stop();
+}
+
+void LaunchpadVisualizer::publishTempo()
+{
+    const double bpm = m_tempoEstimator->bpm();
+    const double confidence = m_tempoEstimator->confidence();
     
-    if (row < 0 || row > 7 || col < 0 || col > 7) {
-        return false; // 8x8グリッド外
+    // 細かな揺れでシグナルを乱発しない
+    if (qAbs(bpm - m_publishedBpm) < 0.1 && qAbs(confidence - m_publishedConfidence) < 0.01) {
+        return;
     }
     
-    x = col;
-    y = row;
-    return true;
+    m_publishedBpm = bpm;
+    m_publishedConfidence = confidence;
+    emit tempoChanged(bpm, confidence);
+}
+
+bool LaunchpadVisualizer::isMidiFile(const QString& filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    return suffix == "mid" || suffix == "midi";
+}
+
+bool LaunchpadVisualizer::noteToCoordinates(unsigned char note, int& x, int& y) const
+{
+    // Launchpad Xのノート番号からグリッド座標へのマッピング
+    // 91 92 ... 98 | 99 (ロゴ)
+    // 81 82 ... 88 | 89
+    // ...
+    // 11 12 ... 18 | 19
+    return PadStateModel::noteToXY(note, x, y);
 }
\ No newline at end of file
@@ -2,9 +2,19 @@
 #define LAUNCHPAD_VISUALIZER_H
 
 #include <QObject>
-#include <QColor>  // QColorクラスをインクルード
+#include <QTimer>
+#include <QFutureWatcher>
 #include <memory>
 #include "midi/MidiManager.h"
+#include "midi/LaunchpadProtocol.h"
+#include "midi/MidiEventTap.h"
+#include "record/SessionRecorder.h"
+#include "record/SessionPlayer.h"
+#include "model/PadStateModel.h"
+#include "model/PadStatistics.h"
+#include "diag/LatencyTracker.h"
+#include "diag/Telemetry.h"
+#include "analysis/TempoEstimator.h"
 
 /**
  * @brief Launchpad X の操作と色情報を可視化するメインアプリケーションクラス
@@ -17,23 +27,50 @@ public:
     ~LaunchpadVisualizer();
 
     /**
-     * @brief 利用可能なMIDIデバイスのリストを取得
+     * @brief 利用可能なMIDIデバイスのリストを取得（呼び出し元のスレッドで実行）
+     * 非同期のデバイス操作と同時に呼び出さないこと
      * @return デバイス名のリスト
      */
     QStringList getAvailableMidiDevices() const;
 
     /**
-     * @brief MIDIデバイスを選択して接続
+     * @brief MIDIデバイスを選択して接続（呼び出し元のスレッドで実行）
+     * 実行中の非同期のデバイス操作が終わるまで待つ
      * @param deviceIndex デバイスインデックス
      * @return 接続が成功したかどうか
      */
     bool connectToDevice(int deviceIndex);
 
     /**
-     * @brief 現在接続中のデバイスを切断
+     * @brief 現在接続中のデバイスを切断（呼び出し元のスレッドで実行）
+     * 実行中の非同期のデバイス操作が終わるまで待つ
      */
     void disconnectDevice();
 
+    /**
+     * @brief デバイス操作用のスレッドでMIDIデバイスを列挙
+     * 結果はdevicesListedで通知する
+     */
+    void listDevicesAsync();
+
+    /**
+     * @brief デバイス操作用のスレッドでMIDIデバイスに接続
+     * 可視化と再生は呼び出し時に停止する。結果はdeviceConnectedで通知する
+     * @param deviceIndex デバイスインデックス
+     */
+    void connectToDeviceAsync(int deviceIndex);
+
+    /**
+     * @brief デバイス操作用のスレッドで接続中のデバイスを切断
+     * 可視化と再生は呼び出し時に停止する。完了はdeviceDisconnectedで通知する
+     */
+    void disconnectDeviceAsync();
+
+    /**
+     * @brief MIDIデバイスが接続されているかどうかを取得
+     */
+    bool isDeviceConnected() const;
+
     /**
      * @brief 可視化の開始
      * @return 開始が成功したかどうか
@@ -51,6 +88,162 @@ public:
      */
     bool isRunning() const;
 
+    /**
+     * @brief MIDI入力のセッション記録を開始
+     * 拡張子が .mid/.midi の場合はStandard MIDI File、それ以外は .lpvs 形式で記録する
+     * @param filePath 出力ファイルパス
+     * @return 開始に成功した場合true
+     */
+    bool startRecording(const QString& filePath);
+
+    /**
+     * @brief セッション記録を停止
+     */
+    void stopRecording();
+
+    /**
+     * @brief セッション記録中かどうかを取得
+     * @return 記録中の場合true
+     */
+    bool isRecording() const;
+
+    /**
+     * @brief 記録済みセッションの再生を開始
+     * ライブ入力のデバイスはデバイス操作用のスレッドで切断され、切断後に
+     * 再生イベントが同じ経路で可視化される。開始の結果はplaybackStartedで通知する。
+     * 拡張子が .mid/.midi の場合はStandard MIDI Fileとして読み込む
+     * @param filePath セッションファイルパス
+     * @return ファイルを開けて再生の開始を受け付けた場合true
+     */
+    bool startPlayback(const QString& filePath);
+
+    /**
+     * @brief セッションの再生を停止
+     */
+    void stopPlayback();
+
+    /**
+     * @brief セッションを再生中かどうかを取得
+     * @return 再生中または再生の開始待ちの場合true
+     */
+    bool isPlaying() const;
+
+    /**
+     * @brief 再生速度を設定
+     * @param speed 倍率 (0.1-100)。SessionPlayer::AS_FAST_AS_POSSIBLEで最速
+     */
+    void setPlaybackSpeed(double speed);
+
+    /**
+     * @brief 再生の一時停止状態を設定
+     * @param paused 一時停止する場合true
+     */
+    void setPlaybackPaused(bool paused);
+
+    /**
+     * @brief 再生位置を移動
+     * @param positionNs セッション開始からの時刻 (ナノ秒)
+     */
+    void seekPlayback(uint64_t positionNs);
+
+    /**
+     * @brief 現在の再生位置を取得
+     * @return セッション開始からの時刻 (ナノ秒)
+     */
+    uint64_t playbackPositionNs() const;
+
+    /**
+     * @brief 再生中のセッションの長さを取得
+     * @return 長さ (ナノ秒)
+     */
+    uint64_t playbackDurationNs() const;
+
+    /**
+     * @brief 入力から描画までのレイテンシ計測器を取得
+     * @return 計測器（可視化エンジンが所有）
+     */
+    LatencyTracker* latencyTracker() const;
+
+    /**
+     * @brief 表示用のカウンターを取得
+     * @return カウンター（可視化エンジンが所有）
+     */
+    Telemetry* telemetry() const;
+
+    /**
+     * @brief 記録の書き込み待ちのイベント数を取得
+     */
+    std::size_t recordingQueueDepth() const;
+
+    /**
+     * @brief 記録のキューの深さの最大値を取得（記録開始からの値）
+     */
+    std::size_t recordingQueueHighWater() const;
+
+    /**
+     * @brief 記録のキューが満杯で破棄したイベント数を取得
+     */
+    uint64_t droppedEventCount() const;
+
+    /**
+     * @brief 可視化中のパッドの状態を取得
+     * @return 状態（GUIスレッドで更新される）
+     */
+    const PadStateModel& padState() const;
+
+    /**
+     * @brief キャプチャしたMIDIイベントを時刻付きで受け取るキューを取得
+     * 取り出し側は1つに限る（既定では無効）
+     */
+    MidiEventTap* eventTap();
+
+    /**
+     * @brief 複数のパッドの色をまとめて設定
+     * 1つのSysExメッセージにしてデバイスに送り（出力が開いている場合）、
+     * 可視化中の状態も更新してpadColorChangedを発行する
+     * @param colors 設定する色
+     * @param count 色の数
+     * @return デバイスに送信した場合true
+     */
+    bool applyPadColors(const LaunchpadProtocol::PadColor* colors, std::size_t count);
+
+    /**
+     * @brief パッドごとの使用統計を取得
+     * @return 統計（GUIスレッドで更新される）
+     */
+    const PadStatistics& padStatistics() const;
+
+    /**
+     * @brief パッドの使用統計をリセット
+     */
+    void resetStatistics();
+
+    /**
+     * @brief パッドの使用統計をCSVファイルに保存
+     * 打鍵のあったパッドのみを1行ずつ出力する
+     * @param filePath 保存先
+     * @return 保存に成功した場合true
+     */
+    bool exportStatistics(const QString& filePath) const;
+
+    /**
+     * @brief 打鍵から推定したテンポを取得
+     * @return BPM。推定できていない場合は0
+     */
+    double tempoBpm() const;
+
+    /**
+     * @brief テンポ推定の信頼度を取得
+     * @return 0.0-1.0
+     */
+    double tempoConfidence() const;
+
+    /**
+     * @brief 外部MIDIクロックの追従状態を取得
+     * @return テンポと拍位相（任意のスレッドから読み出せる）
+     */
+    const MidiClockTracker& clockTracker() const;
+
 public slots:
     /**
      * @brief MIDIノートオンイベントを受信したときに呼ばれる
@@ -65,37 +258,130 @@ public slots:
      */
     void onNoteOff(unsigned char note);
     
+    /**
+     * @brief MIDIコントロールチェンジを受信したときに呼ばれる
+     * 上段・右端のボタンの押下/離上として扱う
+     * @param controller コントロール番号
+     * @param value 値
+     */
+    void onControlChange(unsigned char controller, unsigned char value);
+    
     /**
      * @brief SysExメッセージを受信したときに呼ばれる
      * @param data SysExデータバイト
      */
     void onSysEx(const std::vector<unsigned char>& data);
 
+    /**
+     * @brief シークでパッド状態が復元されたときに呼ばれる
+     * @param state 復元されたパッド状態
+     */
+    void onPadStateRestored(const PadStateModel& state);
+
 signals:
     /**
      * @brief パッドが押されたときに発生するシグナル
-     * @param x X座標 (0-7)
-     * @param y Y座標 (0-7)
+     * @param x X座標 (0-8)
+     * @param y Y座標 (0-8)
      * @param velocity ベロシティ値
      */
     void padPressed(int x, int y, int velocity);
     
     /**
      * @brief パッドが離されたときに発生するシグナル
-     * @param x X座標 (0-7)
-     * @param y Y座標 (0-7)
+     * @param x X座標 (0-8)
+     * @param y Y座標 (0-8)
      */
     void padReleased(int x, int y);
     
     /**
      * @brief パッドの色が変更されたときに発生するシグナル
-     * @param x X座標 (0-7)
-     * @param y Y座標 (0-7)
-     * @param color 色 (RGB値)
+     * @param x X座標 (0-8)
+     * @param y Y座標 (0-8)
+     * @param rgb 色 (0x00RRGGBB)
+     */
+    void padColorChanged(int x, int y, uint32_t rgb);
+
+    /**
+     * @brief 非同期のデバイス列挙が終わったときに発生するシグナル
+     * @param devices デバイス名のリスト
+     */
+    void devicesListed(const QStringList& devices);
+
+    /**
+     * @brief 非同期のデバイス接続が終わったときに発生するシグナル
+     * @param success 接続に成功した場合true
+     */
+    void deviceConnected(bool success);
+
+    /**
+     * @brief 非同期のデバイス切断が終わったときに発生するシグナル
+     */
+    void deviceDisconnected();
+
+    /**
+     * @brief セッションの再生が終了したときに発生するシグナル
+     */
+    void playbackFinished();
+
+    /**
+     * @brief ライブ入力の切断を待っていた再生の開始処理が終わったときに発生するシグナル
+     * @param success 再生を開始できた場合true
+     */
+    void playbackStarted(bool success);
+
+    /**
+     * @brief 使用統計のスライディングウィンドウが進んだときに発生するシグナル
      */
-    void padColorChanged(int x, int y, QColor color);
+    void statisticsUpdated();
+
+    /**
+     * @brief 推定テンポが変化したときに発生するシグナル
+     * @param bpm 推定テンポ (BPM)
+     * @param confidence 信頼度 (0.0-1.0)
+     */
+    void tempoChanged(double bpm, double confidence);
+
+    /**
+     * @brief 外部MIDIクロックの再生状態が変化したときに発生するシグナル
+     * @param running 再生中の場合true
+     */
+    void clockRunningChanged(bool running);
+
+private slots:
+    /**
+     * @brief 統計のスライディングウィンドウを現在時刻まで進める
+     */
+    void advanceStatistics();
+
+    /**
+     * @brief デバイス列挙の完了時に結果を通知
+     */
+    void onDevicesListed();
+
+    /**
+     * @brief デバイス接続の完了時に結果を通知
+     */
+    void onDeviceConnected();
+
+    /**
+     * @brief デバイス切断の完了を通知
+     */
+    void onDeviceDisconnected();
+
+    /**
+     * @brief 再生前のライブ入力の切断が終わったら保留中の再生を開始
+     */
+    void onInputClosedForPlayback();
 
 private:
+    /**
+     * @brief Standard MIDI Fileの拡張子かどうかを判定
+     * @param filePath ファイルパス
+     * @return .mid/.midi の場合true
+     */
+    static bool isMidiFile(const QString& filePath);
+
     /**
      * @brief ノート番号からX,Y座標に変換
      * @param note ノート番号
@@ -105,8 +391,51 @@ private:
      */
     bool noteToCoordinates(unsigned char note, int& x, int& y) const;
 
+    /**
+     * @brief パッドを押下状態にして統計と表示に反映
+     * @param x X座標 (0-8)
+     * @param y Y座標 (0-8)
+     * @param velocity ベロシティ値
+     */
+    void pressPad(int x, int y, unsigned char velocity);
+
+    /**
+     * @brief パッドを離上状態にして統計と表示に反映
+     * @param x X座標 (0-8)
+     * @param y Y座標 (0-8)
+     */
+    void releasePad(int x, int y);
+
+    /**
+     * @brief 推定テンポが変化していればtempoChangedを発行
+     */
+    void publishTempo();
+
+    /**
+     * @brief 再生と開始待ちの再生を取り消す
+     */
+    void cancelPlayback();
+
+    std::unique_ptr<LatencyTracker> m_latencyTracker;  // レイテンシ計測器（MIDIマネージャーより後に破棄）
+    std::unique_ptr<Telemetry> m_telemetry;            // 表示用のカウンター（MIDIマネージャーより後に破棄）
+    std::unique_ptr<TempoEstimator> m_tempoEstimator;  // テンポ推定（MIDIマネージャーより後に破棄）
+    std::unique_ptr<SessionRecorder> m_recorder;  // セッションレコーダー（MIDIマネージャーより後に破棄）
+    std::unique_ptr<MidiEventTap> m_eventTap;     // 時刻付きイベントの受け渡し（MIDIマネージャーより後に破棄）
     std::unique_ptr<MidiManager> m_midiManager;  // MIDIマネージャー
+    std::unique_ptr<SessionPlayer> m_player;     // セッションプレイヤー（MIDIマネージャーより先に破棄）
+    LaunchpadProtocol m_protocol;  // デバイスへの送信メッセージの生成
+    PadStateModel m_padState;  // 可視化中のパッド状態
+    PadStatistics m_statistics;  // パッドの使用統計
+    QTimer m_statisticsTimer;    // 統計ウィンドウを進めるタイマー
+    QFutureWatcher<QStringList> m_listWatcher;  // 非同期のデバイス列挙
+    QFutureWatcher<bool> m_connectWatcher;      // 非同期のデバイス接続
+    QFutureWatcher<void> m_disconnectWatcher;   // 非同期のデバイス切断
+    QFutureWatcher<void> m_playbackCloseWatcher;  // 再生開始前のライブ入力の切断
+    std::unique_ptr<PlaybackSource> m_pendingPlayback;  // ライブ入力の切断を待っている再生ソース
+    QString m_pendingPlaybackPath;  // 開始待ちの再生ファイルパス（ログ用）
     bool m_isRunning;  // 可視化実行中フラグ
+    double m_publishedBpm;         // 最後に通知したテンポ
+    double m_publishedConfidence;  // 最後に通知した信頼度
 };
 
 #endif // LAUNCHPAD_VISUALIZER_H
\ No newline at end of file
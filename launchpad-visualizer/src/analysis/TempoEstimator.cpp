@@ -0,0 +1,147 @@
+#include "TempoEstimator.h"
+#include <cmath>
+
+namespace {
+constexpr double NS_PER_SECOND = 1e9;
+constexpr double MAX_GAIN = 1e12;  // これを超えたらヒストグラムを正規化する
+}
+
+TempoEstimator::TempoEstimator()
+    : m_bpm(0.0f)
+    , m_confidence(0.0f)
+{
+    reset();
+}
+
+void TempoEstimator::reset()
+{
+    for (uint64_t& onset : m_onsets) {
+        onset = 0;
+    }
+    for (double& bin : m_bins) {
+        bin = 0.0;
+    }
+    m_onsetCount = 0;
+    m_onsetHead = 0;
+    m_totalWeight = 0.0;
+    m_gain = 1.0;
+    m_bpm.store(0.0f, std::memory_order_relaxed);
+    m_confidence.store(0.0f, std::memory_order_relaxed);
+}
+
+void TempoEstimator::midiEventCaptured(const MidiEvent& event)
+{
+    // ベロシティ0のNote OnはNote Offなので打鍵として扱わない
+    if ((event.status() & 0xF0) == 0x90 && event.size >= 3 && event.data[2] > 0) {
+        addOnset(event.timestampNs);
+    }
+}
+
+void TempoEstimator::addOnset(uint64_t timestampNs)
+{
+    if (m_onsetCount > 0) {
+        const int last = (m_onsetHead + HISTORY_SIZE - 1) % HISTORY_SIZE;
+        const uint64_t lastOnset = m_onsets[last];
+        if (timestampNs < lastOnset + MERGE_WINDOW_NS) {
+            return;  // 和音・フラムは1つの打鍵とみなす
+        }
+
+        // 経過時間分だけ既存の重みを減衰させる代わりに、新しい重みを大きくする
+        const double elapsedSeconds = (timestampNs - lastOnset) / NS_PER_SECOND;
+        m_gain *= std::exp(elapsedSeconds / DECAY_TIME_SECONDS);
+        if (m_gain > MAX_GAIN) {
+            for (double& bin : m_bins) {
+                bin /= m_gain;
+            }
+            m_totalWeight /= m_gain;
+            m_gain = 1.0;
+        }
+
+        // 直前の打鍵ほど強く重み付けする
+        for (int i = 1; i <= m_onsetCount; ++i) {
+            const int index = (m_onsetHead + HISTORY_SIZE - i) % HISTORY_SIZE;
+            const uint64_t intervalNs = timestampNs - m_onsets[index];
+            if (intervalNs > MAX_INTERVAL_NS) {
+                break;
+            }
+            addInterval(intervalNs, 1.0 / i);
+        }
+        updateEstimate();
+    }
+
+    m_onsets[m_onsetHead] = timestampNs;
+    m_onsetHead = (m_onsetHead + 1) % HISTORY_SIZE;
+    if (m_onsetCount < HISTORY_SIZE) {
+        ++m_onsetCount;
+    }
+}
+
+void TempoEstimator::addInterval(uint64_t intervalNs, double weight)
+{
+    // 間隔を拍として扱い、倍・半分のテンポを推定範囲に折り畳む
+    double bpm = 60.0 * NS_PER_SECOND / static_cast<double>(intervalNs);
+    while (bpm < MIN_BPM) {
+        bpm *= 2.0;
+    }
+    while (bpm >= MAX_BPM) {
+        bpm *= 0.5;
+    }
+
+    // 三角カーネルで隣接ビンに分配し、量子化誤差を抑える
+    const double position = std::log2(bpm / MIN_BPM) * BIN_COUNT - 0.5;
+    const int lower = static_cast<int>(std::floor(position));
+    const double fraction = position - lower;
+    const double scaled = weight * m_gain;
+    m_bins[(lower + BIN_COUNT) % BIN_COUNT] += scaled * (1.0 - fraction);
+    m_bins[(lower + 1) % BIN_COUNT] += scaled * fraction;
+    m_totalWeight += scaled;
+}
+
+void TempoEstimator::updateEstimate()
+{
+    int peak = 0;
+    for (int i = 1; i < BIN_COUNT; ++i) {
+        if (m_bins[i] > m_bins[peak]) {
+            peak = i;
+        }
+    }
+    if (m_bins[peak] <= 0.0 || m_totalWeight <= 0.0) {
+        return;
+    }
+
+    // 放物線補間でビン幅より細かいピーク位置を求める
+    double offset = 0.0;
+    const double left = m_bins[(peak + BIN_COUNT - 1) % BIN_COUNT];
+    const double center = m_bins[peak];
+    const double right = m_bins[(peak + 1) % BIN_COUNT];
+    const double denominator = left - 2.0 * center + right;
+    if (denominator < 0.0) {
+        offset = 0.5 * (left - right) / denominator;
+    }
+
+    double peakWeight = 0.0;
+    for (int i = peak - PEAK_RADIUS; i <= peak + PEAK_RADIUS; ++i) {
+        peakWeight += m_bins[(i + BIN_COUNT) % BIN_COUNT];
+    }
+
+    // 循環する対数軸上の位置をBPMに戻す
+    double position = (peak + 0.5 + offset) / BIN_COUNT;
+    if (position >= 1.0) {
+        position -= 1.0;
+    } else if (position < 0.0) {
+        position += 1.0;
+    }
+    const double bpm = MIN_BPM * std::exp2(position);
+    m_bpm.store(static_cast<float>(bpm), std::memory_order_relaxed);
+    m_confidence.store(static_cast<float>(peakWeight / m_totalWeight), std::memory_order_relaxed);
+}
+
+double TempoEstimator::bpm() const
+{
+    return m_bpm.load(std::memory_order_relaxed);
+}
+
+double TempoEstimator::confidence() const
+{
+    return m_confidence.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,89 @@
+#ifndef TEMPO_ESTIMATOR_H
+#define TEMPO_ESTIMATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include "../midi/MidiInputListener.h"
+
+/**
+ * @brief パッドの打鍵（Note On）の間隔からテンポを推定するクラス
+ *
+ * キャプチャスレッドで動作し、新しい打鍵ごとに直前の数打鍵との間隔（IOI）を
+ * 1オクターブ分のBPM範囲に折り畳んでテンポのヒストグラムに加算する。
+ * 範囲を1オクターブにすることで、倍・半分のテンポが別のピークに分かれない。
+ * ビンは対数軸で等間隔に並べ、範囲の両端を循環的につなげて扱う。
+ * ヒストグラムは時間とともに指数減衰し、最も重みの大きいテンポを推定値とする。
+ * 1イベントあたりの処理時間・メモリはいずれも固定量で、動的確保は行わない。
+ * 推定結果はアトミック変数で公開し、任意のスレッドから読み出せる
+ */
+class TempoEstimator : public MidiInputListener {
+public:
+    static constexpr double MIN_BPM = 88.0;        // 推定範囲の下限（一般的なテンポが端に来ないよう選ぶ）
+    static constexpr double MAX_BPM = 2 * MIN_BPM;  // 推定範囲の上限（含まない）
+
+    TempoEstimator();
+
+    /**
+     * @brief 推定状態を破棄
+     * キャプチャ・再生スレッドが停止している間に呼び出すこと
+     */
+    void reset();
+
+    /**
+     * @brief 打鍵を1つ追加（キャプチャスレッド）
+     * @param timestampNs 打鍵のキャプチャ時刻
+     */
+    void addOnset(uint64_t timestampNs);
+
+    /**
+     * @brief 推定テンポを取得
+     * @return BPM。推定できていない場合は0
+     */
+    double bpm() const;
+
+    /**
+     * @brief 推定の信頼度を取得
+     * @return 0.0-1.0（ピーク付近に集中した重みの割合）
+     */
+    double confidence() const;
+
+    /**
+     * @brief キャプチャスレッドから呼ばれるイベント受信処理
+     */
+    void midiEventCaptured(const MidiEvent& event) override;
+
+private:
+    /**
+     * @brief 間隔から求めたテンポをヒストグラムに加算
+     * @param intervalNs 打鍵間隔
+     * @param weight 重み
+     */
+    void addInterval(uint64_t intervalNs, double weight);
+
+    /**
+     * @brief ヒストグラムのピークから推定値を更新
+     */
+    void updateEstimate();
+
+private:
+    static constexpr int BIN_COUNT = 240;         // 1オクターブあたりのビン数 (約0.3%刻み)
+    static constexpr int HISTORY_SIZE = 8;        // 間隔を取る直前の打鍵数
+    static constexpr uint64_t MERGE_WINDOW_NS = 40000000ULL;    // 同時打鍵とみなす間隔 (40ms)
+    static constexpr uint64_t MAX_INTERVAL_NS = 3000000000ULL;  // 考慮する最大間隔 (3秒)
+    static constexpr double DECAY_TIME_SECONDS = 8.0;           // ヒストグラムの減衰時定数
+    static constexpr int PEAK_RADIUS = 4;                       // 信頼度に含めるピーク周辺のビン数
+
+    // 以下はキャプチャスレッドのみが扱う
+    uint64_t m_onsets[HISTORY_SIZE];  // 直前の打鍵時刻のリングバッファ
+    int m_onsetCount;                 // 有効な打鍵数
+    int m_onsetHead;                  // 次に書き込む位置
+    double m_bins[BIN_COUNT];         // テンポのヒストグラム（m_gain倍された値）
+    double m_totalWeight;             // ヒストグラムの合計（m_gain倍された値）
+    double m_gain;                    // 減衰を遅延適用するための倍率
+
+    // 公開する推定結果
+    std::atomic<float> m_bpm;
+    std::atomic<float> m_confidence;
+};
+
+#endif // TEMPO_ESTIMATOR_H
@@ -0,0 +1,186 @@
+#include "HeadlessDaemon.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <csignal>
+
+std::atomic<bool> HeadlessDaemon::s_stopRequested(false);
+
+HeadlessDaemon::HeadlessDaemon(const Options& options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_metrics(&m_visualizer)
+    , m_publisher(&m_visualizer)
+    , m_oscBridge(&m_visualizer)
+    , m_sharedState(&m_visualizer)
+    , m_eventStream(&m_visualizer)
+    , m_previousNs(0)
+    , m_started(false)
+{
+    m_stopTimer.setInterval(STOP_POLL_INTERVAL_MS);
+    connect(&m_stopTimer, &QTimer::timeout, this, &HeadlessDaemon::checkStopRequest);
+    connect(&m_statusTimer, &QTimer::timeout, this, &HeadlessDaemon::logStatus);
+    connect(&m_statsTimer, &QTimer::timeout, this, &HeadlessDaemon::saveStatistics);
+}
+
+HeadlessDaemon::~HeadlessDaemon()
+{
+    stop();
+}
+
+bool HeadlessDaemon::start()
+{
+    const QStringList devices = m_visualizer.getAvailableMidiDevices();
+    const int deviceIndex = resolveDevice(devices);
+    if (deviceIndex < 0) {
+        qWarning() << "デバイスが見つかりません:" << m_options.device;
+        return false;
+    }
+
+    if (!m_visualizer.connectToDevice(deviceIndex)) {
+        qWarning() << "デバイスに接続できません:" << devices[deviceIndex];
+        return false;
+    }
+    if (!m_visualizer.startVisualization()) {
+        qWarning() << "入力の受信を開始できません";
+        m_visualizer.disconnectDevice();
+        return false;
+    }
+    qInfo() << "接続しました:" << devices[deviceIndex];
+
+    if (!m_options.recordPath.isEmpty()) {
+        if (!m_visualizer.startRecording(m_options.recordPath)) {
+            qWarning() << "記録を開始できません:" << m_options.recordPath;
+            m_visualizer.stopVisualization();
+            m_visualizer.disconnectDevice();
+            return false;
+        }
+        qInfo() << "記録を開始しました:" << m_options.recordPath;
+    }
+
+    if (m_options.metricsPort > 0 && !m_metrics.listen(static_cast<quint16>(m_options.metricsPort))) {
+        qWarning() << "メトリクスを公開せずに続行します";
+    }
+
+    if (!m_options.broadcastTargets.isEmpty()) {
+        for (const QString& target : m_options.broadcastTargets) {
+            m_publisher.addSubscriber(target);
+        }
+        m_publisher.setSimulatedLoss(m_options.simulatedLoss);
+        m_publisher.start();
+    }
+
+    if (m_options.oscPort > 0 && !m_oscBridge.listen(static_cast<quint16>(m_options.oscPort))) {
+        qWarning() << "OSCを受信せずに続行します";
+    }
+    for (const QString& target : m_options.oscTargets) {
+        m_oscBridge.addTarget(target);
+    }
+
+    if (!m_options.sharedStateName.isEmpty() && !m_sharedState.start(m_options.sharedStateName)) {
+        qWarning() << "共有メモリに書き出さずに続行します";
+    }
+
+    if (!m_options.eventSocket.isEmpty()) {
+        if (m_eventStream.listen(m_options.eventSocket)) {
+            m_metrics.setEventStream(&m_eventStream);
+        } else {
+            qWarning() << "イベントを配信せずに続行します";
+        }
+    }
+
+    m_started = true;
+    m_stopTimer.start();
+    if (m_options.statusIntervalSec > 0) {
+        m_previous = m_visualizer.telemetry()->snapshot();
+        m_previousNs = MidiEvent::now();
+        m_statusTimer.start(m_options.statusIntervalSec * 1000);
+    }
+    if (!m_options.statsPath.isEmpty() && m_options.statsIntervalSec > 0) {
+        m_statsTimer.start(m_options.statsIntervalSec * 1000);
+    }
+    return true;
+}
+
+void HeadlessDaemon::stop()
+{
+    if (!m_started) {
+        return;
+    }
+    m_started = false;
+    m_stopTimer.stop();
+    m_statusTimer.stop();
+    m_statsTimer.stop();
+    m_publisher.stop();
+    m_sharedState.stop();
+    m_eventStream.close();
+
+    if (m_visualizer.isRecording()) {
+        m_visualizer.stopRecording();
+        qInfo() << "記録を保存しました:" << m_options.recordPath;
+    }
+    saveStatistics();
+    m_visualizer.stopVisualization();
+    m_visualizer.disconnectDevice();
+}
+
+void HeadlessDaemon::installSignalHandlers()
+{
+    std::signal(SIGINT, &HeadlessDaemon::handleSignal);
+    std::signal(SIGTERM, &HeadlessDaemon::handleSignal);
+}
+
+void HeadlessDaemon::handleSignal(int)
+{
+    // シグナルハンドラ内ではフラグを立てるだけにし、後始末はイベントループで行う
+    s_stopRequested.store(true);
+}
+
+void HeadlessDaemon::checkStopRequest()
+{
+    if (s_stopRequested.load()) {
+        qInfo() << "終了します";
+        stop();
+        QCoreApplication::quit();
+    }
+}
+
+void HeadlessDaemon::logStatus()
+{
+    const uint64_t nowNs = MidiEvent::now();
+    const Telemetry::Snapshot current = m_visualizer.telemetry()->snapshot();
+    const double seconds = nowNs > m_previousNs ? (nowNs - m_previousNs) / 1e9 : 0.0;
+    const double eventRate = seconds > 0.0 ? (current.eventCount - m_previous.eventCount) / seconds : 0.0;
+    m_previous = current;
+    m_previousNs = nowNs;
+
+    qInfo().noquote() << QString("イベント %1 (%2 /秒)  キュー %3 / %4  破棄 %5  テンポ %6 BPM")
+        .arg(static_cast<qulonglong>(current.eventCount))
+        .arg(eventRate, 0, 'f', 1)
+        .arg(static_cast<qulonglong>(current.pendingCount()))
+        .arg(static_cast<qulonglong>(m_visualizer.recordingQueueDepth()))
+        .arg(static_cast<qulonglong>(m_visualizer.droppedEventCount()))
+        .arg(m_visualizer.tempoBpm(), 0, 'f', 1);
+}
+
+void HeadlessDaemon::saveStatistics()
+{
+    if (!m_options.statsPath.isEmpty()) {
+        m_visualizer.exportStatistics(m_options.statsPath);
+    }
+}
+
+int HeadlessDaemon::resolveDevice(const QStringList& devices) const
+{
+    // 数字だけならインデックス、それ以外は名前の一部として扱う
+    bool isIndex = false;
+    const int index = m_options.device.toInt(&isIndex);
+    if (isIndex) {
+        return (index >= 0 && index < devices.size()) ? index : -1;
+    }
+    for (int i = 0; i < devices.size(); ++i) {
+        if (devices[i].contains(m_options.device, Qt::CaseInsensitive)) {
+            return i;
+        }
+    }
+    return -1;
+}
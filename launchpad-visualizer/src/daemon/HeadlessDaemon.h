@@ -0,0 +1,113 @@
+#ifndef HEADLESS_DAEMON_H
+#define HEADLESS_DAEMON_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <atomic>
+#include <cstdint>
+#include "../LaunchpadVisualizer.h"
+#include "../diag/Telemetry.h"
+#include "../net/MetricsServer.h"
+#include "../net/PadStatePublisher.h"
+#include "../net/OscBridge.h"
+#include "../net/SharedStateExporter.h"
+#include "../net/EventStreamServer.h"
+
+/**
+ * @brief 画面のないサーバーで入力を受け続けるヘッドレスのデーモン
+ * QCoreApplication上でLaunchpadVisualizerだけを動かし、Widgetsには依存しない。
+ * デバイスに接続して入力を記録・集計し、状態を一定間隔でログに出す。
+ * SIGINT/SIGTERMを受けると記録と統計を閉じてからイベントループを抜ける
+ */
+class HeadlessDaemon : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief デーモンの設定
+     */
+    struct Options {
+        QString device = "Launchpad X";  // 接続するデバイス（名前の一部またはインデックス）
+        QString recordPath;              // 記録先（空なら記録しない）
+        QString statsPath;               // 使用統計のCSVの保存先（空なら保存しない）
+        int statsIntervalSec = 60;       // 使用統計を保存する間隔 (0は終了時のみ)
+        int statusIntervalSec = 10;      // 状態をログに出す間隔 (0は出さない)
+        int metricsPort = 0;             // メトリクスを公開するポート (0は公開しない)
+        QStringList broadcastTargets;    // パッドの状態の配信先 ("アドレス:ポート")
+        double simulatedLoss = 0.0;      // 配信で意図的に捨てるパケットの割合（試験用）
+        int oscPort = 0;                 // OSCの色の指定を受け付けるポート (0は受け付けない)
+        QStringList oscTargets;          // パッドのイベントのOSCの送信先 ("アドレス:ポート")
+        QString sharedStateName;         // パッドの状態を書き出す共有メモリの名前（空なら書き出さない）
+        QString eventSocket;             // イベントを配信するローカルソケット（空なら配信しない）
+    };
+
+    explicit HeadlessDaemon(const Options& options, QObject *parent = nullptr);
+    ~HeadlessDaemon();
+
+    /**
+     * @brief デバイスに接続して入力の受信を開始
+     * @return 成功した場合true
+     */
+    bool start();
+
+    /**
+     * @brief 記録と統計を閉じてデバイスから切断
+     */
+    void stop();
+
+    /**
+     * @brief SIGINT/SIGTERMで終了するようシグナルハンドラを設定
+     */
+    static void installSignalHandlers();
+
+private slots:
+    /**
+     * @brief 終了要求を確認し、あればイベントループを抜ける
+     */
+    void checkStopRequest();
+
+    /**
+     * @brief 状態をログに出す
+     */
+    void logStatus();
+
+    /**
+     * @brief 使用統計をCSVに保存
+     */
+    void saveStatistics();
+
+private:
+    static constexpr int STOP_POLL_INTERVAL_MS = 200;  // 終了要求を確認する間隔
+
+    /**
+     * @brief 設定からデバイスのインデックスを決める
+     * @param devices 利用可能なデバイス
+     * @return インデックス（見つからない場合は-1）
+     */
+    int resolveDevice(const QStringList& devices) const;
+
+    /**
+     * @brief シグナルハンドラ（終了要求のフラグを立てるだけ）
+     */
+    static void handleSignal(int signal);
+
+    static std::atomic<bool> s_stopRequested;  // シグナルによる終了要求
+
+    Options m_options;                 // デーモンの設定
+    LaunchpadVisualizer m_visualizer;  // エンジン
+    MetricsServer m_metrics;           // メトリクスの公開
+    PadStatePublisher m_publisher;     // パッドの状態の配信
+    OscBridge m_oscBridge;             // OSCのやり取り
+    SharedStateExporter m_sharedState; // 共有メモリへの書き出し
+    EventStreamServer m_eventStream;   // イベントの配信
+    QTimer m_stopTimer;                // 終了要求の確認タイマー
+    QTimer m_statusTimer;              // 状態のログ出力タイマー
+    QTimer m_statsTimer;               // 使用統計の保存タイマー
+    Telemetry::Snapshot m_previous;    // 前回ログに出したときのカウンター
+    uint64_t m_previousNs;             // 前回ログに出した時刻
+    bool m_started;                    // 開始済みかどうか
+};
+
+#endif // HEADLESS_DAEMON_H
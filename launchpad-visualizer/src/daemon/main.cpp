@@ -0,0 +1,125 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QDebug>
+#include "HeadlessDaemon.h"
+#include "../midi/MidiManager.h"
+#include "../diag/TraceRecorder.h"
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+/**
+ * @brief プロセスの最大常駐メモリをログに出す（取得できる環境のみ）
+ */
+static void logPeakMemory()
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef Q_OS_MACOS
+        const long peakKb = usage.ru_maxrss / 1024;  // macOSはバイト単位
+#else
+        const long peakKb = usage.ru_maxrss;
+#endif
+        qInfo() << "最大常駐メモリ:" << peakKb << "KB";
+    }
+#endif
+}
+
+/**
+ * @brief 画面を使わずに入力を記録・集計するデーモン
+ * lpvd [--device 名前|番号] [--record 出力] [--stats CSV] [--stats-interval 秒] [--status-interval 秒] [--trace JSON] [--metrics-port ポート]
+ *      [--broadcast アドレス:ポート]... [--simulate-loss 割合] [--osc-port ポート] [--osc-target アドレス:ポート]...
+ *      [--shm 名前] [--event-socket パス]
+ */
+int main(int argc, char *argv[])
+{
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+    
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("lpvd");
+    QCoreApplication::setOrganizationName("LaunchpadTools");
+    QCoreApplication::setApplicationVersion("0.1.0");
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Launchpad X の入力を画面なしで記録・集計します");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const QCommandLineOption listOption("list-devices", "利用可能なMIDI入力デバイスを表示して終了");
+    const QCommandLineOption deviceOption(QStringList() << "d" << "device",
+                                          "接続するデバイス（名前の一部または番号）", "デバイス", "Launchpad X");
+    const QCommandLineOption recordOption(QStringList() << "r" << "record",
+                                          "入力を記録するファイル (.lpvs/.mid)", "出力");
+    const QCommandLineOption statsOption("stats", "使用統計を保存するCSVファイル", "CSV");
+    const QCommandLineOption statsIntervalOption("stats-interval", "使用統計を保存する間隔（0は終了時のみ）", "秒", "60");
+    const QCommandLineOption statusIntervalOption("status-interval", "状態をログに出す間隔（0は出さない）", "秒", "10");
+    const QCommandLineOption traceOption("trace", "処理区間のトレースを記録し、終了時に保存するファイル", "JSON");
+    const QCommandLineOption metricsOption("metrics-port", "Prometheus形式のメトリクスをlocalhostで公開するポート", "ポート");
+    const QCommandLineOption broadcastOption("broadcast", "パッドの状態をUDPで配信する宛先（複数指定可）", "アドレス:ポート");
+    const QCommandLineOption lossOption("simulate-loss", "配信で意図的に捨てるパケットの割合（試験用、0-1）", "割合", "0");
+    const QCommandLineOption oscPortOption("osc-port", "OSCの色の指定 (/pad/x/y/color) を受け付けるポート", "ポート");
+    const QCommandLineOption shmOption("shm", "パッドの状態を書き出すPOSIX共有メモリの名前（例: /lpv-padstate）", "名前");
+    const QCommandLineOption eventSocketOption("event-socket", "パッドのイベントを配信するローカルソケットの名前またはパス", "パス");
+    const QCommandLineOption oscTargetOption("osc-target", "パッドのイベントをOSCで送る宛先（複数指定可）", "アドレス:ポート");
+    parser.addOption(listOption);
+    parser.addOption(deviceOption);
+    parser.addOption(recordOption);
+    parser.addOption(statsOption);
+    parser.addOption(statsIntervalOption);
+    parser.addOption(statusIntervalOption);
+    parser.addOption(traceOption);
+    parser.addOption(metricsOption);
+    parser.addOption(broadcastOption);
+    parser.addOption(lossOption);
+    parser.addOption(oscPortOption);
+    parser.addOption(oscTargetOption);
+    parser.addOption(shmOption);
+    parser.addOption(eventSocketOption);
+    parser.process(app);
+    
+    if (parser.isSet(listOption)) {
+        MidiManager midiManager;
+        const QStringList devices = midiManager.getAvailableInputDevices();
+        for (int i = 0; i < devices.size(); ++i) {
+            qInfo().noquote() << QString("%1: %2").arg(i).arg(devices[i]);
+        }
+        return 0;
+    }
+    
+    HeadlessDaemon::Options options;
+    options.device = parser.value(deviceOption);
+    options.recordPath = parser.value(recordOption);
+    options.statsPath = parser.value(statsOption);
+    options.statsIntervalSec = qMax(0, parser.value(statsIntervalOption).toInt());
+    options.statusIntervalSec = qMax(0, parser.value(statusIntervalOption).toInt());
+    options.metricsPort = qBound(0, parser.value(metricsOption).toInt(), 65535);
+    options.broadcastTargets = parser.values(broadcastOption);
+    options.simulatedLoss = parser.value(lossOption).toDouble();
+    options.oscPort = qBound(0, parser.value(oscPortOption).toInt(), 65535);
+    options.oscTargets = parser.values(oscTargetOption);
+    options.sharedStateName = parser.value(shmOption);
+    options.eventSocket = parser.value(eventSocketOption);
+    
+    const QString tracePath = parser.value(traceOption);
+    if (!tracePath.isEmpty()) {
+        TraceRecorder::setThreadName("main");
+        TraceRecorder::setEnabled(true);
+    }
+    
+    HeadlessDaemon daemon(options);
+    if (!daemon.start()) {
+        return 1;
+    }
+    HeadlessDaemon::installSignalHandlers();
+    qInfo() << "起動時間:" << startupTimer.elapsed() << "ms";
+    
+    const int result = app.exec();
+    if (!tracePath.isEmpty()) {
+        TraceRecorder::writeChromeTrace(tracePath);
+    }
+    logPeakMemory();
+    return result;
+}
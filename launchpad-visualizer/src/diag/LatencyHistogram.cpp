@@ -0,0 +1,77 @@
+#include "LatencyHistogram.h"
+
+LatencyHistogram::LatencyHistogram()
+    : m_count(0)
+    , m_sumNs(0)
+    , m_maxNs(0)
+{
+    for (std::atomic<uint64_t>& count : m_counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+    Snapshot result;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        result.counts[i] = m_counts[i].load(std::memory_order_relaxed);
+    }
+    result.count = m_count.load(std::memory_order_relaxed);
+    result.sumNs = m_sumNs.load(std::memory_order_relaxed);
+    result.maxNs = m_maxNs.load(std::memory_order_relaxed);
+    return result;
+}
+
+int LatencyHistogram::bucketIndex(uint64_t valueNs)
+{
+    if (valueNs < static_cast<uint64_t>(SUB_BUCKETS)) {
+        return static_cast<int>(valueNs);
+    }
+
+    int magnitude = 63;
+    while ((valueNs >> magnitude) == 0) {
+        --magnitude;
+    }
+    if (magnitude >= MAX_MAGNITUDE) {
+        return BUCKET_COUNT - 1;  // 上限を超えた値は最後のバケットにまとめる
+    }
+
+    // 最上位ビットを含む上位 PRECISION_BITS+1 ビットで区間内の位置を決める
+    const int shift = magnitude - PRECISION_BITS;
+    const int mantissa = static_cast<int>(valueNs >> shift);
+    return (shift + 1) * SUB_BUCKETS + (mantissa - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::bucketValue(int index)
+{
+    if (index < 2 * SUB_BUCKETS) {
+        return static_cast<uint64_t>(index);
+    }
+
+    const int shift = index / SUB_BUCKETS - 1;
+    const uint64_t mantissa = static_cast<uint64_t>(index % SUB_BUCKETS + SUB_BUCKETS);
+    const uint64_t low = mantissa << shift;
+    return low + ((uint64_t(1) << shift) >> 1);
+}
+
+uint64_t LatencyHistogram::Snapshot::percentile(double percentile) const
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count) + 0.5);
+    if (target < 1) {
+        target = 1;
+    }
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= target) {
+            const uint64_t value = bucketValue(i);
+            return value < maxNs ? value : maxNs;
+        }
+    }
+    return maxNs;
+}
@@ -0,0 +1,91 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief HDRヒストグラム形式のレイテンシ分布（ナノ秒）
+ * 2のべき乗ごとの区間を32分割した対数線形のバケットを持ち、相対誤差は約3%。
+ * 書き込みは単一スレッドからのみ行う前提で、ロックやアトミックな
+ * 読み書き変更命令を使わずに記録する。読み出しは任意のスレッドから可能
+ */
+class LatencyHistogram {
+public:
+    static constexpr int PRECISION_BITS = 5;                             // 区間あたりの分割数 (2^5)
+    static constexpr int SUB_BUCKETS = 1 << PRECISION_BITS;
+    static constexpr int MAX_MAGNITUDE = 40;                             // 記録上限 2^40 ns (約18分)
+    static constexpr int BUCKET_COUNT = (MAX_MAGNITUDE - PRECISION_BITS + 1) * SUB_BUCKETS;
+
+    /**
+     * @brief 読み出し用の集計結果
+     */
+    struct Snapshot {
+        std::array<uint64_t, BUCKET_COUNT> counts;  // バケットごとの件数
+        uint64_t count;                              // 総件数
+        uint64_t sumNs;                              // 合計値
+        uint64_t maxNs;                              // 最大値
+
+        /**
+         * @brief パーセンタイル値を取得
+         * @param percentile 0-100
+         * @return 値 (ナノ秒)。記録がない場合は0
+         */
+        uint64_t percentile(double percentile) const;
+
+        /**
+         * @brief 平均値を取得 (ナノ秒)
+         */
+        uint64_t meanNs() const { return count ? sumNs / count : 0; }
+    };
+
+    LatencyHistogram();
+
+    /**
+     * @brief 値を記録（単一の書き込みスレッドから呼ぶこと）
+     * @param valueNs レイテンシ (ナノ秒)
+     */
+    void record(uint64_t valueNs)
+    {
+        const int index = bucketIndex(valueNs);
+        increment(m_counts[index], 1);
+        increment(m_count, 1);
+        increment(m_sumNs, valueNs);
+        if (valueNs > m_maxNs.load(std::memory_order_relaxed)) {
+            m_maxNs.store(valueNs, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 現在の分布を取得
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * @brief 値からバケット番号を求める
+     */
+    static int bucketIndex(uint64_t valueNs);
+
+    /**
+     * @brief バケットの代表値（区間の中央）を求める
+     */
+    static uint64_t bucketValue(int index);
+
+private:
+    /**
+     * @brief 単一書き込みスレッド用の加算（read-modify-write命令を使わない）
+     */
+    static void increment(std::atomic<uint64_t>& counter, uint64_t amount)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_counts;  // バケットごとの件数
+    std::atomic<uint64_t> m_count;                             // 総件数
+    std::atomic<uint64_t> m_sumNs;                             // 合計値
+    std::atomic<uint64_t> m_maxNs;                             // 最大値
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,128 @@
+#include "LatencyTracker.h"
+
+LatencyTracker::LatencyTracker()
+    : m_paintedCount(0)
+{
+    for (int i = 0; i < PadStateModel::PAD_COUNT; ++i) {
+        m_captureNs[i].store(0, std::memory_order_relaxed);
+        m_dispatchNs[i].store(0, std::memory_order_relaxed);
+    }
+    m_pendingCaptureNs.fill(0);
+    m_pendingApplyNs.fill(0);
+    m_paintedPads.fill(0);
+}
+
+void LatencyTracker::eventDispatched(const MidiEvent& event)
+{
+    int x, y;
+    if (!PadStateModel::eventToXY(event, x, y)) {
+        return;
+    }
+
+    const uint64_t nowNs = MidiEvent::now();
+    const uint64_t captureNs = event.timestampNs;
+    m_histograms[Dispatch].record(nowNs > captureNs ? nowNs - captureNs : 0);
+
+    // 時刻を先に書き、キャプチャ時刻の公開で受け渡しを完了する
+    const int index = PadStateModel::index(x, y);
+    m_dispatchNs[index].store(nowNs, std::memory_order_relaxed);
+    m_captureNs[index].store(captureNs, std::memory_order_release);
+}
+
+void LatencyTracker::eventApplied(int x, int y)
+{
+    if (!PadStateModel::isValidCoordinate(x, y)) {
+        return;
+    }
+
+    const int index = PadStateModel::index(x, y);
+    const uint64_t captureNs = m_captureNs[index].exchange(0, std::memory_order_acquire);
+    if (captureNs == 0) {
+        return;  // シーク時の状態復元など、キャプチャを経由しない更新
+    }
+    const uint64_t dispatchNs = m_dispatchNs[index].load(std::memory_order_relaxed);
+
+    const uint64_t nowNs = MidiEvent::now();
+    m_histograms[Apply].record(nowNs > dispatchNs ? nowNs - dispatchNs : 0);
+
+    // 描画前に同じパッドが再度更新された場合は新しいイベントで上書きする
+    m_pendingCaptureNs[index] = captureNs;
+    m_pendingApplyNs[index] = nowNs;
+}
+
+void LatencyTracker::padPainted(int x, int y)
+{
+    if (!PadStateModel::isValidCoordinate(x, y)) {
+        return;
+    }
+
+    const int index = PadStateModel::index(x, y);
+    if (m_pendingApplyNs[index] != 0 && m_paintedCount < PadStateModel::PAD_COUNT) {
+        m_paintedPads[m_paintedCount++] = static_cast<uint8_t>(index);
+    }
+}
+
+void LatencyTracker::paintFinished(uint64_t renderBeginNs)
+{
+    if (m_paintedCount == 0) {
+        return;
+    }
+
+    const uint64_t nowNs = MidiEvent::now();
+    for (int i = 0; i < m_paintedCount; ++i) {
+        const int index = m_paintedPads[i];
+        const uint64_t applyNs = m_pendingApplyNs[index];
+        const uint64_t captureNs = m_pendingCaptureNs[index];
+        if (applyNs == 0) {
+            continue;  // 同じフレームで重複して描画された
+        }
+
+        m_histograms[RenderBegin].record(renderBeginNs > applyNs ? renderBeginNs - applyNs : 0);
+        m_histograms[PaintEnd].record(nowNs > renderBeginNs ? nowNs - renderBeginNs : 0);
+        m_histograms[EndToEnd].record(nowNs > captureNs ? nowNs - captureNs : 0);
+
+        m_pendingApplyNs[index] = 0;
+        m_pendingCaptureNs[index] = 0;
+    }
+    m_paintedCount = 0;
+}
+
+LatencyHistogram::Snapshot LatencyTracker::snapshot(Stage stage) const
+{
+    return m_histograms[stage].snapshot();
+}
+
+const char* LatencyTracker::stageName(Stage stage)
+{
+    switch (stage) {
+    case Dispatch:    return "capture -> dispatch";
+    case Apply:       return "dispatch -> apply";
+    case RenderBegin: return "apply -> render begin";
+    case PaintEnd:    return "render begin -> paint end";
+    case EndToEnd:    return "capture -> paint end";
+    default:          return "";
+    }
+}
+
+QString LatencyTracker::report() const
+{
+    // マイクロ秒単位で表示する
+    auto us = [](uint64_t ns) {
+        return QString::number(static_cast<double>(ns) / 1000.0, 'f', 1).rightJustified(10);
+    };
+
+    QString text = QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+        .arg("stage", -26).arg("count", 10)
+        .arg("mean(us)", 10).arg("p50", 10).arg("p90", 10)
+        .arg("p99", 10).arg("p99.9", 10).arg("max", 10);
+
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        const Stage stage = static_cast<Stage>(i);
+        const LatencyHistogram::Snapshot data = snapshot(stage);
+        text += QString("%1 %2 ").arg(stageName(stage), -26).arg(data.count, 10);
+        text += us(data.meanNs()) + " " + us(data.percentile(50.0)) + " "
+              + us(data.percentile(90.0)) + " " + us(data.percentile(99.0)) + " "
+              + us(data.percentile(99.9)) + " " + us(data.maxNs) + "\n";
+    }
+    return text;
+}
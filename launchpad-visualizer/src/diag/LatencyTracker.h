@@ -0,0 +1,101 @@
+#ifndef LATENCY_TRACKER_H
+#define LATENCY_TRACKER_H
+
+#include <QString>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "LatencyHistogram.h"
+#include "../midi/MidiEvent.h"
+#include "../model/PadStateModel.h"
+
+/**
+ * @brief 入力から描画までのレイテンシを区間ごとに計測するクラス
+ *
+ * キャプチャ時刻をパッドごとのスロットに記録し、以下の区間をそれぞれの
+ * ヒストグラムに集計する。
+ *   Dispatch    : キャプチャ → シグナル発行（GUIスレッドへのキュー投入）
+ *   Apply       : シグナル発行 → 可視化エンジンでの状態反映
+ *   RenderBegin : 状態反映 → 該当パッドを含むpaintEventの開始
+ *   PaintEnd    : paintEventの開始 → 終了
+ *   EndToEnd    : キャプチャ → paintEventの終了
+ *
+ * Dispatchはキャプチャスレッド（または再生スレッド）、それ以外はGUIスレッドが
+ * 書き込む。各ヒストグラムの書き込みスレッドは1つに限られるため、
+ * ホットパスではロックを使わない
+ */
+class LatencyTracker {
+public:
+    /**
+     * @brief 計測区間
+     */
+    enum Stage {
+        Dispatch = 0,
+        Apply,
+        RenderBegin,
+        PaintEnd,
+        EndToEnd,
+        STAGE_COUNT
+    };
+
+    LatencyTracker();
+
+    /**
+     * @brief イベントがシグナルとして発行された時点を記録（キャプチャスレッド）
+     * パッドのイベント（ノート・コントロールチェンジ）以外は無視する
+     * @param event キャプチャ時刻を持つイベント
+     */
+    void eventDispatched(const MidiEvent& event);
+
+    /**
+     * @brief 可視化エンジンがパッドの状態を反映した時点を記録（GUIスレッド）
+     * @param x X座標
+     * @param y Y座標
+     */
+    void eventApplied(int x, int y);
+
+    /**
+     * @brief paintEventでパッドを描画したことを記録（GUIスレッド）
+     * @param x X座標
+     * @param y Y座標
+     */
+    void padPainted(int x, int y);
+
+    /**
+     * @brief paintEventの終了時に呼び出し、描画したパッドの区間を集計（GUIスレッド）
+     * @param renderBeginNs paintEventの開始時刻 (MidiEvent::now())
+     */
+    void paintFinished(uint64_t renderBeginNs);
+
+    /**
+     * @brief 区間の分布を取得
+     * @param stage 計測区間
+     */
+    LatencyHistogram::Snapshot snapshot(Stage stage) const;
+
+    /**
+     * @brief 区間名を取得
+     */
+    static const char* stageName(Stage stage);
+
+    /**
+     * @brief 全区間の統計をテキストで取得
+     * @return 区間ごとの件数・平均・パーセンタイル・最大値の表
+     */
+    QString report() const;
+
+private:
+    // キャプチャスレッドからGUIスレッドへ受け渡す時刻（0は未設定）
+    std::array<std::atomic<uint64_t>, PadStateModel::PAD_COUNT> m_captureNs;
+    std::array<std::atomic<uint64_t>, PadStateModel::PAD_COUNT> m_dispatchNs;
+
+    // GUIスレッドのみが扱う描画待ちの時刻
+    std::array<uint64_t, PadStateModel::PAD_COUNT> m_pendingCaptureNs;
+    std::array<uint64_t, PadStateModel::PAD_COUNT> m_pendingApplyNs;
+    std::array<uint8_t, PadStateModel::PAD_COUNT> m_paintedPads;  // 描画中のフレームで描いたパッド
+    int m_paintedCount;
+
+    std::array<LatencyHistogram, STAGE_COUNT> m_histograms;  // 区間ごとの分布
+};
+
+#endif // LATENCY_TRACKER_H
@@ -0,0 +1,99 @@
+#include "Telemetry.h"
+#include "../model/PadStateModel.h"
+
+namespace {
+constexpr uint32_t LAST_PAD_VALID = 1u << 24;
+}
+
+Telemetry::Telemetry()
+    : m_eventCount(0)
+    , m_queuedCount(0)
+    , m_handledCount(0)
+    , m_frameCount(0)
+    , m_pendingHighWater(0)
+    , m_lastPad(0)
+{
+    for (std::atomic<uint64_t>& count : m_typeCounts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+void Telemetry::eventDispatched(const MidiEvent& event)
+{
+    increment(m_eventCount);
+
+    // MidiManagerがシグナルとして発行するのはノートとコントロールチェンジ
+    const unsigned char type = event.status() & 0xF0;
+    if ((type != 0x90 && type != 0x80 && type != 0xB0) || event.size < 3) {
+        increment(m_typeCounts[Other]);
+        return;
+    }
+    if (type == 0xB0) {
+        increment(m_typeCounts[ControlChange]);
+    } else {
+        increment(m_typeCounts[(type == 0x90 && event.data[2] > 0) ? NoteOn : NoteOff]);
+    }
+    increment(m_queuedCount);
+
+    int x, y;
+    if (PadStateModel::eventToXY(event, x, y)) {
+        // 離上（Note Off、値0）はベロシティ0として記録する
+        const uint32_t velocity = type == 0x80 ? 0 : event.data[2];
+        m_lastPad.store(LAST_PAD_VALID | (static_cast<uint32_t>(x) << 16) | (static_cast<uint32_t>(y) << 8) | velocity,
+                        std::memory_order_relaxed);
+    }
+}
+
+void Telemetry::eventHandled()
+{
+    // 処理する直前の処理待ちの数で最大値を更新する
+    const uint64_t queued = m_queuedCount.load(std::memory_order_relaxed);
+    const uint64_t handled = m_handledCount.load(std::memory_order_relaxed);
+    if (queued > handled && queued - handled > m_pendingHighWater.load(std::memory_order_relaxed)) {
+        m_pendingHighWater.store(queued - handled, std::memory_order_relaxed);
+    }
+    increment(m_handledCount);
+}
+
+void Telemetry::frameRendered(uint64_t paintNs)
+{
+    increment(m_frameCount);
+    m_paintDuration.record(paintNs);
+}
+
+Telemetry::Snapshot Telemetry::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.eventCount = m_eventCount.load(std::memory_order_relaxed);
+    snapshot.queuedCount = m_queuedCount.load(std::memory_order_relaxed);
+    snapshot.handledCount = m_handledCount.load(std::memory_order_relaxed);
+    snapshot.frameCount = m_frameCount.load(std::memory_order_relaxed);
+    snapshot.pendingHighWater = m_pendingHighWater.load(std::memory_order_relaxed);
+    for (int type = 0; type < EVENT_TYPE_COUNT; ++type) {
+        snapshot.typeCounts[type] = m_typeCounts[type].load(std::memory_order_relaxed);
+    }
+
+    const uint32_t lastPad = m_lastPad.load(std::memory_order_relaxed);
+    if (lastPad & LAST_PAD_VALID) {
+        snapshot.lastPadX = (lastPad >> 16) & 0xFF;
+        snapshot.lastPadY = (lastPad >> 8) & 0xFF;
+        snapshot.lastVelocity = lastPad & 0xFF;
+    }
+    return snapshot;
+}
+
+LatencyHistogram::Snapshot Telemetry::paintDuration() const
+{
+    return m_paintDuration.snapshot();
+}
+
+const char* Telemetry::eventTypeName(EventType type)
+{
+    switch (type) {
+    case NoteOn:        return "note_on";
+    case NoteOff:       return "note_off";
+    case ControlChange: return "control_change";
+    case Other:         return "other";
+    default:            return "";
+    }
+}
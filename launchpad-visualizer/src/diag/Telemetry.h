@@ -0,0 +1,102 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "LatencyHistogram.h"
+#include "../midi/MidiEvent.h"
+
+/**
+ * @brief 実行中の状態を表示用に集計するカウンター群
+ * 各カウンターの書き込みスレッドは1つに限られ（入力側はキャプチャまたは再生スレッド、
+ * 描画側はGUIスレッド）、イベントごとの処理は原子変数の更新だけで済ませる。
+ * 表示側はsnapshot()を一定間隔で読み出し、差分からレートを求める
+ */
+class Telemetry {
+public:
+    /**
+     * @brief 受信したイベントの種類
+     */
+    enum EventType {
+        NoteOn = 0,     // ノートオン（ベロシティ0を除く）
+        NoteOff,        // ノートオフ（ベロシティ0のノートオンを含む）
+        ControlChange,  // コントロールチェンジ
+        Other,          // その他のメッセージ
+        EVENT_TYPE_COUNT
+    };
+
+    /**
+     * @brief ある時点のカウンターの値
+     */
+    struct Snapshot {
+        uint64_t eventCount = 0;        // 受信したMIDIイベント数（クロックを除く）
+        uint64_t queuedCount = 0;       // GUIスレッドへシグナルで送ったイベント数
+        uint64_t handledCount = 0;      // GUIスレッドで処理したイベント数
+        uint64_t frameCount = 0;        // 描画したフレーム数
+        uint64_t pendingHighWater = 0;  // GUIスレッドの処理待ちの最大数
+        std::array<uint64_t, EVENT_TYPE_COUNT> typeCounts{};  // 種類ごとの受信数
+        int lastPadX = -1;              // 最後に操作されたパッドのX座標 (-1は未操作)
+        int lastPadY = -1;              // 最後に操作されたパッドのY座標
+        int lastVelocity = 0;           // 最後の操作のベロシティ (0は離上)
+
+        /**
+         * @brief GUIスレッドの処理待ちのイベント数
+         */
+        uint64_t pendingCount() const { return queuedCount > handledCount ? queuedCount - handledCount : 0; }
+    };
+
+    Telemetry();
+
+    /**
+     * @brief イベントを受信してシグナルを発行した時点で呼び出す（キャプチャ・再生スレッド）
+     * @param event 受信したイベント
+     */
+    void eventDispatched(const MidiEvent& event);
+
+    /**
+     * @brief GUIスレッドがシグナルで受け取ったイベントを処理した時点で呼び出す
+     */
+    void eventHandled();
+
+    /**
+     * @brief フレームの描画が終わった時点で呼び出す（GUIスレッド）
+     * @param paintNs paintEventにかかった時間
+     */
+    void frameRendered(uint64_t paintNs);
+
+    /**
+     * @brief 現在の値を取得（任意のスレッドから呼び出せる）
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * @brief paintEventにかかった時間の分布を取得（任意のスレッドから呼び出せる）
+     */
+    LatencyHistogram::Snapshot paintDuration() const;
+
+    /**
+     * @brief イベントの種類の名前を取得
+     */
+    static const char* eventTypeName(EventType type);
+
+private:
+    /**
+     * @brief 書き込みスレッドが1つのカウンターを加算（ロック命令を使わない）
+     */
+    static void increment(std::atomic<uint64_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> m_eventCount;
+    std::atomic<uint64_t> m_queuedCount;
+    std::atomic<uint64_t> m_handledCount;
+    std::atomic<uint64_t> m_frameCount;
+    std::atomic<uint64_t> m_pendingHighWater;  // GUIスレッドが書き込む
+    std::array<std::atomic<uint64_t>, EVENT_TYPE_COUNT> m_typeCounts;
+    LatencyHistogram m_paintDuration;          // paintEventにかかった時間
+    std::atomic<uint32_t> m_lastPad;  // [有効フラグ 1bit][X 8bit][Y 8bit][ベロシティ 8bit]
+};
+
+#endif // TELEMETRY_H
@@ -0,0 +1,165 @@
+#include "TraceRecorder.h"
+#include <QFile>
+#include <QDebug>
+#include <algorithm>
+
+std::atomic<bool> TraceRecorder::s_enabled(false);
+std::mutex TraceRecorder::s_mutex;
+std::vector<std::unique_ptr<TraceRecorder::ThreadBuffer>> TraceRecorder::s_buffers;
+
+namespace {
+
+/**
+ * @brief JSONの文字列として出力できるようエスケープする
+ */
+QByteArray escapeJson(const char* text)
+{
+    QByteArray escaped;
+    for (const char* p = text; *p; ++p) {
+        if (*p == '"' || *p == '\\') {
+            escaped += '\\';
+        }
+        escaped += *p;
+    }
+    return escaped;
+}
+
+} // namespace
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void TraceRecorder::setThreadName(const char* name)
+{
+    threadBuffer().name.store(name, std::memory_order_relaxed);
+}
+
+void TraceRecorder::record(const char* name, uint64_t startNs, uint64_t endNs)
+{
+    ThreadBuffer& buffer = threadBuffer();
+
+    // 書き込みスレッドは1つなので、ロック命令を使わずに番号を進める
+    const uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    Slot& slot = buffer.entries[index & (BUFFER_CAPACITY - 1)];
+
+    // 上書きを始めることを先に公開し、読み出し側が書き換え中の要素を捨てられるようにする
+    buffer.claimed.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startNs.store(startNs, std::memory_order_relaxed);
+    slot.durationNs.store(endNs > startNs ? endNs - startNs : 0, std::memory_order_relaxed);
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::threadBuffer()
+{
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_buffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer));
+        buffer = s_buffers.back().get();
+        buffer->threadId = static_cast<int>(s_buffers.size());
+    }
+    return *buffer;
+}
+
+bool TraceRecorder::writeChromeTrace(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "トレースを保存できません:" << filePath;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    QByteArray json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    int eventCount = 0;
+    uint64_t droppedScopes = 0;
+    std::vector<Event> events;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : s_buffers) {
+        const QByteArray tid = QByteArray::number(buffer->threadId);
+
+        // スレッド名のメタデータ
+        const char* name = buffer->name.load(std::memory_order_relaxed);
+        if (name) {
+            json += first ? "" : ",\n";
+            json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid
+                + ",\"args\":{\"name\":\"" + escapeJson(name) + "\"}}";
+            first = false;
+        }
+
+        // 残っている区間を写し取る。写している間に上書きされ始めた区間は
+        // 書き込みを始めた数から判定して捨てる
+        const uint64_t written = buffer->written.load(std::memory_order_acquire);
+        const uint64_t oldest = written > BUFFER_CAPACITY ? written - BUFFER_CAPACITY : 0;
+        const uint64_t begin = std::max(buffer->readCount, oldest);
+        events.clear();
+        for (uint64_t index = begin; index < written; ++index) {
+            const Slot& slot = buffer->entries[index & (BUFFER_CAPACITY - 1)];
+            Event event;
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.startNs = slot.startNs.load(std::memory_order_relaxed);
+            event.durationNs = slot.durationNs.load(std::memory_order_relaxed);
+            events.push_back(event);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t claimed = buffer->claimed.load(std::memory_order_relaxed);
+        const uint64_t overwritten = claimed > BUFFER_CAPACITY ? claimed - BUFFER_CAPACITY : 0;
+        const uint64_t intact = std::min(std::max(overwritten, begin), written);
+
+        const uint64_t dropped = intact - buffer->readCount;
+        buffer->dropped += dropped;
+        buffer->readCount = written;
+        droppedScopes += dropped;
+
+        // 時刻はマイクロ秒 (小数でナノ秒まで)
+        for (std::size_t i = static_cast<std::size_t>(intact - begin); i < events.size(); ++i) {
+            const Event& event = events[i];
+            json += first ? "" : ",\n";
+            json += "{\"name\":\"" + escapeJson(event.name) + "\",\"cat\":\"lpv\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid
+                + ",\"ts\":" + QByteArray::number(event.startNs / 1e3, 'f', 3)
+                + ",\"dur\":" + QByteArray::number(event.durationNs / 1e3, 'f', 3) + "}";
+            first = false;
+            ++eventCount;
+        }
+
+        // 大きくなったら途中で書き出してメモリを抑える
+        if (json.size() > (1 << 20)) {
+            if (file.write(json) != json.size()) {
+                qWarning() << "トレースを保存できません:" << file.errorString();
+                return false;
+            }
+            json.clear();
+        }
+    }
+    // 上書きで失われた区間があると、各スレッドの最初の区間より前は記録が欠けている
+    json += "\n],\"otherData\":{\"droppedScopes\":" + QByteArray::number(static_cast<qulonglong>(droppedScopes))
+        + ",\"bufferCapacity\":" + QByteArray::number(static_cast<qulonglong>(BUFFER_CAPACITY)) + "}}\n";
+    if (file.write(json) != json.size()) {
+        qWarning() << "トレースを保存できません:" << file.errorString();
+        return false;
+    }
+
+    qInfo() << "トレースを保存しました:" << filePath << eventCount << "区間";
+    if (droppedScopes > 0) {
+        qWarning() << "バッファが一杯になり、古い区間を上書きしました:" << droppedScopes << "区間";
+    }
+    return true;
+}
+
+uint64_t TraceRecorder::droppedCount()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    uint64_t dropped = 0;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : s_buffers) {
+        // まだ読み出していない区間のうち、既に上書きされた分も含める
+        const uint64_t written = buffer->written.load(std::memory_order_acquire);
+        const uint64_t oldest = written > BUFFER_CAPACITY ? written - BUFFER_CAPACITY : 0;
+        dropped += buffer->dropped + (oldest > buffer->readCount ? oldest - buffer->readCount : 0);
+    }
+    return dropped;
+}
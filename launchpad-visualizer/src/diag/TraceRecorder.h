@@ -0,0 +1,156 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <QString>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "../midi/MidiEvent.h"
+
+/**
+ * @brief 処理の区間をスレッドごとに記録し、Chrome Trace Event形式で書き出すクラス
+ *
+ * 区間はTRACE_SCOPEで囲んだスコープの開始・終了時刻として記録する。各スレッドは
+ * 初めて記録するときに自分専用のリングバッファを登録し、以後はロックを使わずに
+ * 書き込む。バッファは直近のBUFFER_CAPACITY区間を残すフライトレコーダーで、
+ * 満杯になると最も古い区間を上書きする（ヒッチの直後に保存すればその前後が残る）。
+ * 書き出し時にすべてのバッファを読み出してJSONにまとめる
+ * （chrome://tracing や Perfetto UI で開ける）。
+ * 記録が無効の間、TRACE_SCOPEは原子変数を1回読むだけになる。
+ * LPV_NO_TRACE を定義してビルドするとTRACE_SCOPEは何も生成しない
+ */
+class TraceRecorder {
+public:
+    static constexpr std::size_t BUFFER_CAPACITY = 16384;  // スレッドあたりに残す区間の数（2のべき乗）
+
+    /**
+     * @brief 記録した1区間
+     */
+    struct Event {
+        const char* name = nullptr;  // 区間の名前（文字列リテラル）
+        uint64_t startNs = 0;        // 開始時刻 (steady_clock基準)
+        uint64_t durationNs = 0;     // 長さ
+    };
+
+    /**
+     * @brief スコープの開始から終了までを1区間として記録する
+     */
+    class Scope {
+    public:
+        explicit Scope(const char* name)
+            : m_name(isEnabled() ? name : nullptr)
+            , m_startNs(m_name ? MidiEvent::now() : 0)
+        {
+        }
+
+        ~Scope()
+        {
+            if (m_name) {
+                record(m_name, m_startNs, MidiEvent::now());
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_name;  // 区間の名前（無効時はnullptr）
+        uint64_t m_startNs;  // 開始時刻
+    };
+
+    /**
+     * @brief 記録の有効・無効を切り替える（任意のスレッドから呼び出せる）
+     */
+    static void setEnabled(bool enabled);
+
+    /**
+     * @brief 記録が有効かどうか
+     */
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 呼び出し元スレッドの名前を設定（トレース上の表示名）
+     * @param name スレッドの名前（文字列リテラル）
+     */
+    static void setThreadName(const char* name);
+
+    /**
+     * @brief 区間を記録（呼び出し元スレッドのバッファに追加）
+     * バッファが満杯の場合は最も古い区間を上書きする
+     * @param name 区間の名前（文字列リテラル）
+     * @param startNs 開始時刻
+     * @param endNs 終了時刻
+     */
+    static void record(const char* name, uint64_t startNs, uint64_t endNs);
+
+    /**
+     * @brief 記録した区間をすべて読み出し、Chrome Trace Event形式のJSONとして保存
+     * 読み出した区間はバッファから取り除かれる。前回の書き出し以降に上書きで
+     * 失われた区間の数は otherData.droppedScopes に書く
+     * @param filePath 保存先
+     * @return 保存に成功した場合true
+     */
+    static bool writeChromeTrace(const QString& filePath);
+
+    /**
+     * @brief 読み出される前に上書きされた区間の数（起動からの累計）
+     */
+    static uint64_t droppedCount();
+
+private:
+    /**
+     * @brief バッファの1要素
+     * 読み出し中に所有スレッドが上書きすることがあるため、各項目を原子変数にする
+     */
+    struct Slot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> startNs{0};
+        std::atomic<uint64_t> durationNs{0};
+    };
+
+    /**
+     * @brief スレッドごとのバッファ
+     * 書き込みは所有スレッド、読み出しは書き出し側だけが行う。
+     * n番目の区間は entries[n % BUFFER_CAPACITY] に入り、n + BUFFER_CAPACITY 番目で上書きされる
+     */
+    struct ThreadBuffer {
+        std::array<Slot, BUFFER_CAPACITY> entries;  // 記録した区間
+        std::atomic<uint64_t> claimed{0};           // 書き込みを始めた区間の数
+        std::atomic<uint64_t> written{0};           // 書き込みを終えた区間の数
+        std::atomic<const char*> name{nullptr};     // スレッドの名前
+        uint64_t readCount = 0;                     // 読み出し済みの区間の数（s_mutexで保護）
+        uint64_t dropped = 0;                       // 読み出す前に上書きされた区間の数（s_mutexで保護）
+        int threadId = 0;                           // トレース上のスレッド番号
+    };
+
+    /**
+     * @brief 呼び出し元スレッドのバッファを取得（初回のみ登録する）
+     */
+    static ThreadBuffer& threadBuffer();
+
+    static std::atomic<bool> s_enabled;                         // 記録が有効かどうか
+    static std::mutex s_mutex;                                  // バッファの登録と書き出しの排他
+    static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers; // 登録済みのバッファ（スレッド終了後も保持）
+};
+
+#ifdef LPV_NO_TRACE
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#else
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+/**
+ * @brief 現在のスコープを名前付きの区間として記録する
+ */
+#define TRACE_SCOPE(name) TraceRecorder::Scope TRACE_CONCAT(traceScope_, __LINE__)(name)
+/**
+ * @brief 記録が有効な場合に呼び出し元スレッドの名前を設定する
+ */
+#define TRACE_THREAD_NAME(name) \
+    do { if (TraceRecorder::isEnabled()) { TraceRecorder::setThreadName(name); } } while (0)
+#endif
+
+#endif // TRACE_RECORDER_H
@@ -0,0 +1,77 @@
+#include "LatencyDialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QPushButton>
+#include <QFileDialog>
+#include <QFile>
+#include <QTextStream>
+#include <QMessageBox>
+#include <QFontDatabase>
+
+LatencyDialog::LatencyDialog(const LatencyTracker* tracker, QWidget *parent)
+    : QDialog(parent)
+    , m_tracker(tracker)
+{
+    setWindowTitle("レイテンシ統計");
+    
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    
+    // 表形式で読めるよう等幅フォントで表示
+    m_reportView = new QPlainTextEdit(this);
+    m_reportView->setReadOnly(true);
+    m_reportView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    layout->addWidget(m_reportView, 1);
+    
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    buttonLayout->addStretch(1);
+    
+    QPushButton* saveButton = new QPushButton("保存...", this);
+    connect(saveButton, &QPushButton::clicked, this, &LatencyDialog::saveReport);
+    buttonLayout->addWidget(saveButton);
+    
+    QPushButton* closeButton = new QPushButton("閉じる", this);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::close);
+    buttonLayout->addWidget(closeButton);
+    
+    layout->addLayout(buttonLayout);
+    
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(500);
+    connect(m_refreshTimer, &QTimer::timeout, this, &LatencyDialog::refresh);
+    
+    resize(760, 240);
+}
+
+void LatencyDialog::showEvent(QShowEvent *event)
+{
+    refresh();
+    m_refreshTimer->start();
+    QDialog::showEvent(event);
+}
+
+void LatencyDialog::hideEvent(QHideEvent *event)
+{
+    m_refreshTimer->stop();
+    QDialog::hideEvent(event);
+}
+
+void LatencyDialog::refresh()
+{
+    m_reportView->setPlainText(m_tracker->report());
+}
+
+void LatencyDialog::saveReport()
+{
+    QString filePath = QFileDialog::getSaveFileName(
+        this, "レイテンシ統計の保存先", "latency.txt", "テキストファイル (*.txt)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+    
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, "エラー", "ファイルを保存できませんでした。");
+        return;
+    }
+    QTextStream(&file) << m_tracker->report();
+}
@@ -0,0 +1,47 @@
+#ifndef LATENCY_DIALOG_H
+#define LATENCY_DIALOG_H
+
+#include <QDialog>
+#include <QPlainTextEdit>
+#include <QTimer>
+#include "../diag/LatencyTracker.h"
+
+/**
+ * @brief 入力から描画までのレイテンシ統計を表示するダイアログ
+ * 表示中は定期的に統計を更新する
+ */
+class LatencyDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit LatencyDialog(const LatencyTracker* tracker, QWidget *parent = nullptr);
+
+protected:
+    /**
+     * @brief 表示時に更新を開始
+     */
+    void showEvent(QShowEvent *event) override;
+
+    /**
+     * @brief 非表示時に更新を停止
+     */
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    /**
+     * @brief 統計の表示を更新
+     */
+    void refresh();
+
+    /**
+     * @brief 統計をテキストファイルに保存
+     */
+    void saveReport();
+
+private:
+    const LatencyTracker* m_tracker;  // 計測データ
+    QPlainTextEdit* m_reportView;     // 統計表示
+    QTimer* m_refreshTimer;           // 表示の更新タイマー
+};
+
+#endif // LATENCY_DIALOG_H
@@ -1,12 +1,25 @@
 #include "LaunchpadGrid.h"
+#include "../diag/LatencyTracker.h"
+#include "../diag/Telemetry.h"
+#include "../diag/TraceRecorder.h"
 #include <QPainter>
 #include <QPaintEvent>
 #include <QResizeEvent>
+#include <QContextMenuEvent>
+#include <QMenu>
 #include <QDebug>
 
-LaunchpadGrid::LaunchpadGrid(QWidget *parent)
+LaunchpadGrid::LaunchpadGrid(PadDisplayModel* model, QWidget *parent)
     : QWidget(parent)
-    , m_padSize(0)
+    , m_model(model)
+    , m_layout(model->gridSize())
+    , m_latencyTracker(nullptr)
+    , m_telemetry(nullptr)
+    , m_statistics(nullptr)
+    , m_heatmapEnabled(false)
+    , m_heatmapWindow(PadStatistics::Window::Total)
+    , m_spriteCacheEnabled(true)
+    , m_renderBackend(RenderBackend::Painter)
 {
     // 背景色を黒に設定
     setBackgroundRole(QPalette::Base);
@@ -20,9 +33,8 @@ LaunchpadGrid::LaunchpadGrid(QWidget *parent)
     // 最小サイズを設定
     setMinimumSize(200, 200);
     
-    // 色とアクティブ状態の初期化
-    m_padColors = QVector<QVector<QColor>>(GRID_SIZE, QVector<QColor>(GRID_SIZE, Qt::black));
-    m_padActiveState = QVector<QVector<bool>>(GRID_SIZE, QVector<bool>(GRID_SIZE, false));
+    // 状態の変化はモデルのフレームごとにまとめて受け取る
+    connect(m_model, &PadDisplayModel::frame, this, &LaunchpadGrid::onFrame);
 }
 
 LaunchpadGrid::~LaunchpadGrid()
@@ -30,121 +42,302 @@ LaunchpadGrid::~LaunchpadGrid()
     // 特に何もしない
 }
 
-void LaunchpadGrid::setPadColor(int x, int y, const QColor& color)
+PadDisplayModel* LaunchpadGrid::model() const
 {
-    if (!isValidCoordinate(x, y)) {
+    return m_model;
+}
+
+void LaunchpadGrid::setLatencyTracker(LatencyTracker* tracker)
+{
+    m_latencyTracker = tracker;
+}
+
+void LaunchpadGrid::setTelemetry(Telemetry* telemetry)
+{
+    m_telemetry = telemetry;
+}
+
+void LaunchpadGrid::setStatistics(const PadStatistics* statistics)
+{
+    m_statistics = statistics;
+    markAllDirty();
+}
+
+void LaunchpadGrid::setHeatmapMode(bool enabled, PadStatistics::Window window)
+{
+    m_heatmapEnabled = enabled;
+    m_heatmapWindow = window;
+    markAllDirty();
+}
+
+bool LaunchpadGrid::isHeatmapMode() const
+{
+    return m_heatmapEnabled;
+}
+
+void LaunchpadGrid::refreshHeatmap()
+{
+    if (m_heatmapEnabled) {
+        markAllDirty();
+    }
+}
+
+void LaunchpadGrid::setSpriteCacheEnabled(bool enabled)
+{
+    m_spriteCacheEnabled = enabled;
+    m_spriteCache.clear();
+    markAllDirty();
+}
+
+bool LaunchpadGrid::isSpriteCacheEnabled() const
+{
+    return m_spriteCacheEnabled;
+}
+
+void LaunchpadGrid::setRenderBackend(RenderBackend backend)
+{
+    if (m_renderBackend == backend) {
         return;
     }
     
-    m_padColors[y][x] = color;
-    update(calculatePadRect(x, y)); // 該当パッドのみ再描画
+    m_renderBackend = backend;
+    
+    // 使わなくなった方の描画資源を解放し、次のフレームで全体を描き直す
+    m_spriteCache.clear();
+    m_rasterizer = PadRasterizer();
+    update();
 }
 
-void LaunchpadGrid::setPadActive(int x, int y, bool active)
+LaunchpadGrid::RenderBackend LaunchpadGrid::renderBackend() const
 {
-    if (!isValidCoordinate(x, y)) {
+    return m_renderBackend;
+}
+
+void LaunchpadGrid::markAllDirty()
+{
+    m_dirtyPads.setFirst(m_layout.padCount());
+    m_model->requestFrame();
+}
+
+void LaunchpadGrid::onFrame(const PadMask& dirtyPads)
+{
+    if (m_heatmapEnabled && dirtyPads.any()) {
+        // 正規化の基準が変わりうるため全体を再描画
+        m_dirtyPads.setFirst(m_layout.padCount());
+    } else {
+        m_dirtyPads |= dirtyPads;
+    }
+    
+    if (!m_dirtyPads.any()) {
         return;
     }
     
-    m_padActiveState[y][x] = active;
-    update(calculatePadRect(x, y)); // 該当パッドのみ再描画
+    // 蓄積したパッドの矩形だけを再描画領域として要求する
+    QRegion region;
+    m_dirtyPads.forEach([&](int index) {
+        region += m_layout.padRect(index);
+    });
+    m_framePads |= m_dirtyPads;
+    m_frameRegion += region;
+    m_dirtyPads.clear();
+    
+    update(region);
 }
 
-void LaunchpadGrid::resetGrid()
+void LaunchpadGrid::paintEvent(QPaintEvent *event)
 {
-    // すべてのパッドの色とアクティブ状態をリセット
-    for (int y = 0; y < GRID_SIZE; ++y) {
-        for (int x = 0; x < GRID_SIZE; ++x) {
-            m_padColors[y][x] = Qt::black;
-            m_padActiveState[y][x] = false;
+    TRACE_SCOPE("grid.paint");
+    const uint64_t renderBeginNs = (m_latencyTracker || m_telemetry) ? MidiEvent::now() : 0;
+    
+    // ヒートマップは最も多く打鍵されたパッドを基準に正規化する
+    const uint32_t maxHits = (m_heatmapEnabled && m_statistics)
+        ? m_statistics->maxHitCount(m_heatmapWindow) : 0;
+    
+    // 拍の先頭でパッドの境界線を明るくする
+    const double pulse = m_model->pulse();
+    const QColor borderColor = LaunchpadGrid::borderColor(pulse);
+    const int gridSize = m_layout.gridSize();
+    
+    if (m_renderBackend == RenderBackend::Raster) {
+        paintRaster(event, maxHits, borderColor);
+    } else if ((event->region() - m_frameRegion).isEmpty()) {
+        QPainter painter(this);
+        painter.setRenderHint(QPainter::Antialiasing);
+        
+        // フレームで要求したパッドのみを描画
+        m_framePads.forEach([&](int index) {
+            paintPad(painter, index % gridSize, index / gridSize, maxHits, borderColor);
+        });
+    } else {
+        QPainter painter(this);
+        painter.setRenderHint(QPainter::Antialiasing);
+        
+        // 露出やリサイズなど、要求外の領域を含む場合は交差するパッドをすべて描画
+        const QRect updateRect = event->rect();
+        for (int index = 0; index < m_layout.padCount(); ++index) {
+            if (m_layout.padRect(index).intersects(updateRect)) {
+                paintPad(painter, index % gridSize, index / gridSize, maxHits, borderColor);
+            }
         }
     }
+    m_framePads.clear();
+    m_frameRegion = QRegion();
     
-    // 全体を再描画
-    update();
+    if (m_latencyTracker) {
+        m_latencyTracker->paintFinished(renderBeginNs);
+    }
+    if (m_telemetry) {
+        m_telemetry->frameRendered(MidiEvent::now() - renderBeginNs);
+    }
 }
 
-void LaunchpadGrid::paintEvent(QPaintEvent *event)
+void LaunchpadGrid::paintPad(QPainter& painter, int x, int y, uint32_t maxHits, const QColor& borderColor)
 {
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
-    
-    // 再描画する矩形を取得
-    QRect updateRect = event->rect();
-    
-    // 描画範囲内のパッドのみ描画
-    for (int y = 0; y < GRID_SIZE; ++y) {
-        for (int x = 0; x < GRID_SIZE; ++x) {
-            QRect padRect = calculatePadRect(x, y);
-            
-            // 更新矩形と交差する場合のみ描画
-            if (padRect.intersects(updateRect)) {
-                // パッドの色を取得
-                QColor padColor = m_padColors[y][x];
-                
-                // パッドの描画
-                if (m_padActiveState[y][x]) {
-                    // アクティブ状態: 中心に小さめの四角を描画
-                    painter.setPen(Qt::NoPen);
-                    painter.setBrush(padColor);
-                    painter.drawRoundedRect(padRect, 5, 5);
-                    
-                    // さらに押された状態を表現するために、中央に明るい色で小さな四角を描画
-                    QColor brighterColor = padColor.lighter(150);
-                    QRect innerRect = padRect;
-                    innerRect.adjust(
-                        padRect.width() * (1.0f - ACTIVE_SCALE) / 2,
-                        padRect.height() * (1.0f - ACTIVE_SCALE) / 2,
-                        -padRect.width() * (1.0f - ACTIVE_SCALE) / 2,
-                        -padRect.height() * (1.0f - ACTIVE_SCALE) / 2
-                    );
-                    painter.setBrush(brighterColor);
-                    painter.drawRoundedRect(innerRect, 5, 5);
-                } else {
-                    // 非アクティブ状態: 通常の四角を描画
-                    painter.setPen(Qt::NoPen);
-                    painter.setBrush(padColor);
-                    painter.drawRoundedRect(padRect, 5, 5);
-                }
-                
-                // パッド境界線
-                painter.setPen(Qt::gray);
-                painter.setBrush(Qt::NoBrush);
-                painter.drawRoundedRect(padRect, 5, 5);
+    const int index = m_model->index(x, y);
+    const QRect& padRect = m_layout.padRect(index);
+    const bool round = m_layout.isRound(index);
+    const QColor padColor = displayColor(x, y, maxHits);
+    
+    // パッドの描画
+    if (m_spriteCacheEnabled) {
+        // 描画済みの画像を転送する（ボタンとロゴはパッドより小さい）
+        const QPixmap& sprite = m_spriteCache.sprite(
+            padColor, m_model->padGlow(x, y), borderColor, round, padRect.width(), devicePixelRatioF());
+        painter.drawPixmap(padRect.topLeft() - QPoint(PadSpriteCache::MARGIN, PadSpriteCache::MARGIN), sprite);
+    } else {
+        PadSpriteCache::renderPad(painter, padRect, padColor, m_model->padGlow(x, y), borderColor, round);
+    }
+    
+    if (m_latencyTracker) {
+        m_latencyTracker->padPainted(x, y);
+    }
+}
+
+void LaunchpadGrid::paintRaster(QPaintEvent* event, uint32_t maxHits, const QColor& borderColor)
+{
+    const QColor background = palette().color(QPalette::Base);
+    const int gridSize = m_layout.gridSize();
+    
+    if (m_rasterizer.resize(size(), devicePixelRatioF())) {
+        // バッファを作り直した場合は全体を描き直す
+        m_rasterizer.fill(background);
+        m_framePads.setFirst(m_layout.padCount());
+    } else if (!(event->region() - m_frameRegion).isEmpty()) {
+        // 要求外の領域はバッファの内容が有効なので、交差するパッドを描き直すだけでよい
+        const QRect updateRect = event->rect();
+        for (int index = 0; index < m_layout.padCount(); ++index) {
+            if (m_layout.padRect(index).intersects(updateRect)) {
+                m_framePads.set(index);
             }
         }
     }
+    
+    m_framePads.forEach([&](int index) {
+        const int x = index % gridSize;
+        const int y = index / gridSize;
+        const QRect& padRect = m_layout.padRect(index);
+        m_rasterizer.clearRect(padRect.adjusted(-PadSpriteCache::MARGIN, -PadSpriteCache::MARGIN,
+                                                PadSpriteCache::MARGIN, PadSpriteCache::MARGIN), background);
+        m_rasterizer.drawPad(padRect, displayColor(x, y, maxHits), m_model->padGlow(x, y), borderColor,
+                             m_layout.isRound(index));
+        
+        if (m_latencyTracker) {
+            m_latencyTracker->padPainted(x, y);
+        }
+    });
+    
+    // 更新領域をバックバッファから1回で転送
+    const QRect updateRect = event->rect();
+    const qreal ratio = m_rasterizer.image().devicePixelRatio();
+    const QRectF sourceRect(updateRect.x() * ratio, updateRect.y() * ratio,
+                            updateRect.width() * ratio, updateRect.height() * ratio);
+    QPainter painter(this);
+    painter.drawImage(QRectF(updateRect), m_rasterizer.image(), sourceRect);
+}
+
+QColor LaunchpadGrid::displayColor(int x, int y, uint32_t maxHits) const
+{
+    if (m_heatmapEnabled && m_statistics) {
+        const uint32_t hits = m_statistics->hitCount(x, y, m_heatmapWindow);
+        return heatmapColor(maxHits ? static_cast<double>(hits) / maxHits : 0.0);
+    }
+    return m_model->padColor(x, y);
 }
 
 void LaunchpadGrid::resizeEvent(QResizeEvent *event)
 {
-    // ウィジェットのサイズが変更されたときにパッドサイズを再計算
-    QSize newSize = event->size();
-    int width = newSize.width();
-    int height = newSize.height();
-    
-    // グリッド全体を正方形に収める
-    int minDim = qMin(width, height);
+    // ウィジェットのサイズが変更されたときにパッドの配置を再計算（描画時は表を引くだけ）
+    m_layout.setSize(event->size());
     
-    // パッドのサイズを計算 (ギャップを考慮)
-    m_padSize = (minDim - PAD_GAP * (GRID_SIZE + 1)) / GRID_SIZE;
+    // サイズの異なるパッド画像は再利用できないため破棄
+    m_spriteCache.clear();
     
     QWidget::resizeEvent(event);
 }
 
-QRect LaunchpadGrid::calculatePadRect(int x, int y) const
+void LaunchpadGrid::contextMenuEvent(QContextMenuEvent *event)
 {
-    if (!isValidCoordinate(x, y)) {
-        return QRect();
+    // ビューごとに表示モードと描画方式を選べるようにする
+    QMenu menu(this);
+    QAction* normalAction = menu.addAction("通常表示");
+    normalAction->setCheckable(true);
+    normalAction->setChecked(!m_heatmapEnabled);
+    
+    const struct {
+        const char* label;
+        PadStatistics::Window window;
+    } heatmaps[] = {
+        { "ヒートマップ（全体）", PadStatistics::Window::Total },
+        { "ヒートマップ（直近10秒）", PadStatistics::Window::Last10s },
+        { "ヒートマップ（直近60秒）", PadStatistics::Window::Last60s },
+    };
+    QAction* heatmapActions[3];
+    for (int i = 0; i < 3; ++i) {
+        heatmapActions[i] = menu.addAction(heatmaps[i].label);
+        heatmapActions[i]->setCheckable(true);
+        heatmapActions[i]->setChecked(m_heatmapEnabled && m_heatmapWindow == heatmaps[i].window);
+        heatmapActions[i]->setEnabled(m_statistics != nullptr);
     }
     
-    int padX = PAD_GAP + x * (m_padSize + PAD_GAP);
-    int padY = PAD_GAP + y * (m_padSize + PAD_GAP);
+    menu.addSeparator();
+    QAction* rasterAction = menu.addAction("QImageへ直接描画");
+    rasterAction->setCheckable(true);
+    rasterAction->setChecked(m_renderBackend == RenderBackend::Raster);
     
-    return QRect(padX, padY, m_padSize, m_padSize);
+    QAction* selected = menu.exec(event->globalPos());
+    if (!selected) {
+        return;
+    }
+    
+    if (selected == normalAction) {
+        setHeatmapMode(false);
+    } else if (selected == rasterAction) {
+        setRenderBackend(rasterAction->isChecked() ? RenderBackend::Raster : RenderBackend::Painter);
+    } else {
+        for (int i = 0; i < 3; ++i) {
+            if (selected == heatmapActions[i]) {
+                setHeatmapMode(true, heatmaps[i].window);
+            }
+        }
+    }
 }
 
-bool LaunchpadGrid::isValidCoordinate(int x, int y) const
+QColor LaunchpadGrid::borderColor(double pulse)
 {
-    return (x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE);
+    // 拍の先頭で明るくなる
+    return QColor(
+        static_cast<int>(160 + 95 * pulse),
+        static_cast<int>(160 + 95 * pulse),
+        static_cast<int>(164 + 91 * pulse));
+}
+
+QColor LaunchpadGrid::heatmapColor(double t)
+{
+    t = qBound(0.0, t, 1.0);
+    
+    // 黒 → 赤 (0-1/3)、赤 → 黄 (1/3-2/3)、黄 → 白 (2/3-1)
+    const int r = static_cast<int>(qMin(1.0, t * 3.0) * 255);
+    const int g = static_cast<int>(qBound(0.0, t * 3.0 - 1.0, 1.0) * 255);
+    const int b = static_cast<int>(qBound(0.0, t * 3.0 - 2.0, 1.0) * 255);
+    return QColor(r, g, b);
 }
\ No newline at end of file
@@ -3,38 +3,120 @@
 
 #include <QWidget>
 #include <QColor>
-#include <QVector>
+#include <QRegion>
+#include "PadSpriteCache.h"
+#include "PadRasterizer.h"
+#include "PadDisplayModel.h"
+#include "PadLayout.h"
+#include "../model/PadStatistics.h"
+#include "../util/PadMask.h"
+
+class LatencyTracker;
+class Telemetry;
+class QPainter;
 
 /**
  * @brief Launchpad X のパッドグリッドを表示するウィジェット
+ * パッドの状態は共有のPadDisplayModelから読み、モデルのフレームごとに
+ * 変化したパッドだけを再描画する。サイズや表示モード・描画方式はビューごとに持つため、
+ * 同じモデルを複数のビュー（別ウィンドウ）で異なる見た目で表示できる
  */
 class LaunchpadGrid : public QWidget {
     Q_OBJECT
 
 public:
-    explicit LaunchpadGrid(QWidget *parent = nullptr);
+    /**
+     * @brief パッドの描画方式
+     */
+    enum class RenderBackend {
+        Painter,  // パッドごとにQPainterで描画（画像キャッシュを併用）
+        Raster    // QImageのバックバッファへ直接書き込み、まとめて転送
+    };
+
+    /**
+     * @brief コンストラクタ
+     * @param model 表示するパッドの状態（所有権は移らない。ビューより長く生存すること）
+     * @param parent 親ウィジェット
+     */
+    explicit LaunchpadGrid(PadDisplayModel* model, QWidget *parent = nullptr);
     ~LaunchpadGrid();
 
     /**
-     * @brief パッドの色を設定
-     * @param x X座標 (0-7)
-     * @param y Y座標 (0-7)
-     * @param color 色
+     * @brief 表示しているパッドの状態を取得
+     */
+    PadDisplayModel* model() const;
+
+    /**
+     * @brief 描画レイテンシの計測器を設定
+     * @param tracker 計測器（所有権は移らない。nullptrで計測しない）
+     */
+    void setLatencyTracker(LatencyTracker* tracker);
+
+    /**
+     * @brief 描画フレーム数を数えるカウンターを設定
+     * @param telemetry カウンター（所有権は移らない。nullptrで集計しない）
+     */
+    void setTelemetry(Telemetry* telemetry);
+
+    /**
+     * @brief ヒートマップ表示に使う統計を設定
+     * @param statistics 統計（所有権は移らない）
      */
-    void setPadColor(int x, int y, const QColor& color);
+    void setStatistics(const PadStatistics* statistics);
 
     /**
-     * @brief パッドのアクティブ状態を設定
-     * @param x X座標 (0-7)
-     * @param y Y座標 (0-7)
-     * @param active アクティブならtrue
+     * @brief ヒートマップ表示の切り替え
+     * 有効な間はパッドの色の代わりに打鍵数を色で表示する
+     * @param enabled 表示する場合true
+     * @param window 集計の範囲
      */
-    void setPadActive(int x, int y, bool active);
+    void setHeatmapMode(bool enabled, PadStatistics::Window window = PadStatistics::Window::Total);
 
     /**
-     * @brief グリッド全体をリセット
+     * @brief ヒートマップ表示が有効かどうかを取得
      */
-    void resetGrid();
+    bool isHeatmapMode() const;
+
+    /**
+     * @brief 描画済みパッド画像のキャッシュを使うかどうかを設定
+     * @param enabled 使う場合true（既定）
+     */
+    void setSpriteCacheEnabled(bool enabled);
+
+    /**
+     * @brief 描画済みパッド画像のキャッシュを使っているかどうか
+     */
+    bool isSpriteCacheEnabled() const;
+
+    /**
+     * @brief パッドの描画方式を設定
+     * @param backend 描画方式（既定はPainter）
+     */
+    void setRenderBackend(RenderBackend backend);
+
+    /**
+     * @brief パッドの描画方式を取得
+     */
+    RenderBackend renderBackend() const;
+
+    /**
+     * @brief パッドの境界線の色を求める
+     * @param pulse 拍のパルスの強さ (0.0-1.0)
+     */
+    static QColor borderColor(double pulse);
+
+public slots:
+    /**
+     * @brief 統計の更新に合わせてヒートマップを再描画
+     */
+    void refreshHeatmap();
+
+private slots:
+    /**
+     * @brief モデルのフレームのタイミングで蓄積したパッドを再描画
+     * @param dirtyPads モデル側で表示が変わったパッド
+     */
+    void onFrame(const PadMask& dirtyPads);
 
 protected:
     /**
@@ -47,31 +129,65 @@ protected:
      */
     void resizeEvent(QResizeEvent *event) override;
 
+    /**
+     * @brief コンテキストメニュー（ビューごとの表示モードと描画方式）
+     */
+    void contextMenuEvent(QContextMenuEvent *event) override;
+
 private:
     /**
-     * @brief 特定のパッドの矩形を計算
-     * @param x X座標 (0-7)
-     * @param y Y座標 (0-7)
-     * @return パッドの矩形
+     * @brief すべてのパッドを再描画の対象に追加し、フレームを要求
      */
-    QRect calculatePadRect(int x, int y) const;
+    void markAllDirty();
 
     /**
-     * @brief 座標が有効かチェック
+     * @brief 1つのパッドを描画
+     * @param painter 描画先
      * @param x X座標
      * @param y Y座標
-     * @return 有効ならtrue
+     * @param maxHits ヒートマップの正規化に使う最大打鍵数
+     * @param borderColor 境界線の色
      */
-    bool isValidCoordinate(int x, int y) const;
+    void paintPad(QPainter& painter, int x, int y, uint32_t maxHits, const QColor& borderColor);
 
-private:
-    static constexpr int GRID_SIZE = 8;      // グリッドサイズ (8x8)
-    static constexpr int PAD_GAP = 5;        // パッド間のギャップ (ピクセル)
-    static constexpr float ACTIVE_SCALE = 0.9f; // アクティブ時のサイズ比率
+    /**
+     * @brief バックバッファにパッドを描き込み、更新領域をまとめて転送
+     * @param event ペイントイベント
+     * @param maxHits ヒートマップの正規化に使う最大打鍵数
+     * @param borderColor 境界線の色
+     */
+    void paintRaster(QPaintEvent* event, uint32_t maxHits, const QColor& borderColor);
+
+    /**
+     * @brief パッドの表示色を求める（ヒートマップ表示中は打鍵数の色）
+     * @param x X座標
+     * @param y Y座標
+     * @param maxHits ヒートマップの正規化に使う最大打鍵数
+     */
+    QColor displayColor(int x, int y, uint32_t maxHits) const;
+
+    /**
+     * @brief 正規化した打鍵数からヒートマップの色を求める
+     * @param t 0.0-1.0
+     * @return 黒→赤→黄→白のグラデーション
+     */
+    static QColor heatmapColor(double t);
 
-    QVector<QVector<QColor>> m_padColors;    // パッドの色
-    QVector<QVector<bool>> m_padActiveState; // パッドのアクティブ状態
-    int m_padSize;                          // パッドのサイズ (ピクセル)
+private:
+    PadDisplayModel* m_model;               // 表示するパッドの状態
+    PadLayout m_layout;                     // パッドの配置
+    LatencyTracker* m_latencyTracker;       // 描画レイテンシの計測器
+    Telemetry* m_telemetry;                 // 描画フレーム数のカウンター
+    const PadStatistics* m_statistics;      // ヒートマップ用の統計
+    bool m_heatmapEnabled;                  // ヒートマップ表示中フラグ
+    PadStatistics::Window m_heatmapWindow;  // ヒートマップの集計範囲
+    PadMask m_dirtyPads;                    // ビュー側の理由で次のフレームに再描画するパッド
+    PadMask m_framePads;                    // 再描画を要求済みのパッド
+    QRegion m_frameRegion;                  // 再描画を要求済みの領域
+    PadSpriteCache m_spriteCache;           // 描画済みパッド画像
+    bool m_spriteCacheEnabled;              // パッド画像キャッシュの使用フラグ
+    RenderBackend m_renderBackend;          // パッドの描画方式
+    PadRasterizer m_rasterizer;             // Raster方式のバックバッファ
 };
 
 #endif // LAUNCHPAD_GRID_H
\ No newline at end of file
@@ -3,17 +3,24 @@
 #include <QHBoxLayout>
 #include <QGroupBox>
 #include <QMessageBox>
+#include <QMenuBar>
+#include <QActionGroup>
+#include <QScreen>
+#include <QFileDialog>
 #include <QDebug>
+#include "../diag/TraceRecorder.h"
 
-MainWindow::MainWindow(LaunchpadVisualizer* visualizer, QWidget *parent)
+MainWindow::MainWindow(LaunchpadVisualizer* visualizer, int gridSize, QWidget *parent)
     : QMainWindow(parent)
     , m_visualizer(visualizer)
+    , m_latencyDialog(nullptr)
+    , m_deviceBusy(false)
 {
     // ウィンドウタイトルの設定
     setWindowTitle("Launchpad X Visualizer");
     
     // UIの初期化
-    initializeUI();
+    initializeUI(gridSize);
     
     // シグナル/スロット接続
     connect(m_visualizer, &LaunchpadVisualizer::padPressed, 
@@ -22,6 +29,18 @@ MainWindow::MainWindow(LaunchpadVisualizer* visualizer, QWidget *parent)
             this, &MainWindow::onPadReleased);
     connect(m_visualizer, &LaunchpadVisualizer::padColorChanged, 
             this, &MainWindow::onPadColorChanged);
+    connect(m_visualizer, &LaunchpadVisualizer::playbackFinished,
+            this, &MainWindow::onPlaybackFinished);
+    connect(m_visualizer, &LaunchpadVisualizer::playbackStarted,
+            this, &MainWindow::onPlaybackStarted);
+    connect(m_visualizer, &LaunchpadVisualizer::tempoChanged,
+            this, &MainWindow::onTempoChanged);
+    connect(m_visualizer, &LaunchpadVisualizer::devicesListed,
+            this, &MainWindow::onDevicesListed);
+    connect(m_visualizer, &LaunchpadVisualizer::deviceConnected,
+            this, &MainWindow::onDeviceConnected);
+    connect(m_visualizer, &LaunchpadVisualizer::deviceDisconnected,
+            this, &MainWindow::onDeviceDisconnected);
     
     // デバイスリストの更新
     updateDeviceList();
@@ -39,8 +58,80 @@ MainWindow::~MainWindow()
     m_visualizer->disconnectDevice();
 }
 
-void MainWindow::initializeUI()
+void MainWindow::initializeUI(int gridSize)
 {
+    // すべてのグリッドビューで共有するパッドの状態
+    m_padDisplay = new PadDisplayModel(gridSize, this);
+    m_padDisplay->setClockTracker(&m_visualizer->clockTracker());
+    connect(m_visualizer, &LaunchpadVisualizer::clockRunningChanged,
+            m_padDisplay, &PadDisplayModel::setClockRunning);
+    
+    // 表示メニュー
+    QMenu* viewMenu = menuBar()->addMenu("表示");
+    QActionGroup* displayModeGroup = new QActionGroup(this);
+    const struct {
+        const char* label;
+        int mode;  // -1は通常表示、それ以外はPadStatistics::Window
+    } displayModes[] = {
+        { "通常表示", -1 },
+        { "ヒートマップ（全体）", static_cast<int>(PadStatistics::Window::Total) },
+        { "ヒートマップ（直近10秒）", static_cast<int>(PadStatistics::Window::Last10s) },
+        { "ヒートマップ（直近60秒）", static_cast<int>(PadStatistics::Window::Last60s) },
+    };
+    for (const auto& displayMode : displayModes) {
+        QAction* action = viewMenu->addAction(displayMode.label);
+        action->setCheckable(true);
+        action->setChecked(displayMode.mode < 0);
+        action->setData(displayMode.mode);
+        displayModeGroup->addAction(action);
+    }
+    connect(displayModeGroup, &QActionGroup::triggered, this, &MainWindow::changeDisplayMode);
+    viewMenu->addSeparator();
+    
+    // 描画フレームレートの上限 (0はディスプレイのリフレッシュレート)
+    QMenu* frameRateMenu = viewMenu->addMenu("フレームレート上限");
+    QActionGroup* frameRateGroup = new QActionGroup(this);
+    for (int fps : { 30, 60, 120, 144, 0 }) {
+        QAction* action = frameRateMenu->addAction(fps > 0 ? QString("%1 fps").arg(fps) : QString("ディスプレイに合わせる"));
+        action->setCheckable(true);
+        action->setChecked(fps == RenderScheduler::DEFAULT_MAX_FRAME_RATE);
+        action->setData(fps);
+        frameRateGroup->addAction(action);
+    }
+    connect(frameRateGroup, &QActionGroup::triggered, this, &MainWindow::changeFrameRate);
+    
+    viewMenu->addSeparator();
+    QAction* afterglowAction = viewMenu->addAction("離したパッドを残光で消す");
+    afterglowAction->setCheckable(true);
+    afterglowAction->setChecked(true);
+    connect(afterglowAction, &QAction::toggled, this, &MainWindow::setAfterglowEnabled);
+    viewMenu->addAction("新しいビューを開く", this, &MainWindow::openGridView);
+    QAction* telemetryAction = viewMenu->addAction("テレメトリを表示");
+    telemetryAction->setCheckable(true);
+    telemetryAction->setChecked(true);
+    viewMenu->addSeparator();
+    viewMenu->addAction("使用統計をリセット", this, &MainWindow::resetStatistics);
+    viewMenu->addAction("使用統計をCSVで保存...", this, &MainWindow::exportStatistics);
+    
+    // 診断メニュー
+    QMenu* diagnosticsMenu = menuBar()->addMenu("診断");
+    diagnosticsMenu->addAction("レイテンシ統計...", this, &MainWindow::showLatencyStats);
+    diagnosticsMenu->addAction("レイテンシ統計をログに出力", this, &MainWindow::dumpLatencyStats);
+    diagnosticsMenu->addSeparator();
+    QAction* spriteCacheAction = diagnosticsMenu->addAction("パッド画像キャッシュを使用");
+    spriteCacheAction->setCheckable(true);
+    spriteCacheAction->setChecked(true);
+    connect(spriteCacheAction, &QAction::toggled, this, &MainWindow::setSpriteCacheEnabled);
+    QAction* rasterAction = diagnosticsMenu->addAction("QImageへ直接描画");
+    rasterAction->setCheckable(true);
+    connect(rasterAction, &QAction::toggled, this, &MainWindow::setRasterBackendEnabled);
+    diagnosticsMenu->addSeparator();
+    QAction* traceAction = diagnosticsMenu->addAction("トレースを記録");
+    traceAction->setCheckable(true);
+    traceAction->setChecked(TraceRecorder::isEnabled());
+    connect(traceAction, &QAction::toggled, this, &MainWindow::setTraceEnabled);
+    diagnosticsMenu->addAction("トレースを保存...", this, &MainWindow::saveTrace);
+    
     // 中央ウィジェット
     QWidget* centralWidget = new QWidget(this);
     setCentralWidget(centralWidget);
@@ -58,9 +149,9 @@ void MainWindow::initializeUI()
     controlLayout->addWidget(m_deviceComboBox, 1);
     
     // 更新ボタン
-    QPushButton* refreshButton = new QPushButton("更新", this);
-    connect(refreshButton, &QPushButton::clicked, this, &MainWindow::updateDeviceList);
-    controlLayout->addWidget(refreshButton);
+    m_refreshButton = new QPushButton("更新", this);
+    connect(m_refreshButton, &QPushButton::clicked, this, &MainWindow::updateDeviceList);
+    controlLayout->addWidget(m_refreshButton);
     
     // 接続/切断ボタン
     m_connectButton = new QPushButton("接続", this);
@@ -76,15 +167,89 @@ void MainWindow::initializeUI()
     connect(m_startStopButton, &QPushButton::clicked, this, &MainWindow::toggleVisualization);
     controlLayout->addWidget(m_startStopButton);
     
+    // 記録ボタン
+    m_recordButton = new QPushButton("記録", this);
+    connect(m_recordButton, &QPushButton::clicked, this, &MainWindow::toggleRecording);
+    controlLayout->addWidget(m_recordButton);
+    
     mainLayout->addWidget(controlGroup);
     
+    // 再生グループ
+    QGroupBox* playbackGroup = new QGroupBox("セッション再生", this);
+    QHBoxLayout* playbackLayout = new QHBoxLayout(playbackGroup);
+    
+    m_playButton = new QPushButton("再生", this);
+    connect(m_playButton, &QPushButton::clicked, this, &MainWindow::togglePlayback);
+    playbackLayout->addWidget(m_playButton);
+    
+    // 再生速度 (0.1倍-100倍)
+    m_speedSpinBox = new QDoubleSpinBox(this);
+    m_speedSpinBox->setRange(SessionPlayer::MIN_SPEED, SessionPlayer::MAX_SPEED);
+    m_speedSpinBox->setSingleStep(0.1);
+    m_speedSpinBox->setDecimals(1);
+    m_speedSpinBox->setValue(1.0);
+    m_speedSpinBox->setSuffix(" x");
+    connect(m_speedSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &MainWindow::applyPlaybackSpeed);
+    playbackLayout->addWidget(new QLabel("速度:", this));
+    playbackLayout->addWidget(m_speedSpinBox);
+    
+    m_fastestCheckBox = new QCheckBox("最速", this);
+    connect(m_fastestCheckBox, &QCheckBox::toggled, this, &MainWindow::applyPlaybackSpeed);
+    playbackLayout->addWidget(m_fastestCheckBox);
+    
+    // シークバー
+    m_seekSlider = new QSlider(Qt::Horizontal, this);
+    m_seekSlider->setEnabled(false);
+    connect(m_seekSlider, &QSlider::sliderReleased, this, &MainWindow::seekPlayback);
+    playbackLayout->addWidget(m_seekSlider, 1);
+    
+    m_positionLabel = new QLabel("0:00 / 0:00", this);
+    playbackLayout->addWidget(m_positionLabel);
+    
+    // 再生位置の表示は低頻度で更新する
+    m_positionTimer = new QTimer(this);
+    m_positionTimer->setInterval(250);
+    connect(m_positionTimer, &QTimer::timeout, this, &MainWindow::updatePlaybackPosition);
+    
+    mainLayout->addWidget(playbackGroup);
+    
     // ステータスラベル
     m_statusLabel = new QLabel("準備完了", this);
     m_statusLabel->setAlignment(Qt::AlignCenter);
     mainLayout->addWidget(m_statusLabel);
     
+    // 推定テンポ
+    m_tempoLabel = new QLabel("テンポ: -", this);
+    m_tempoLabel->setAlignment(Qt::AlignCenter);
+    
+    // 外部MIDIクロック
+    m_clockLabel = new QLabel("MIDIクロック: -", this);
+    m_clockLabel->setAlignment(Qt::AlignCenter);
+    
+    QHBoxLayout* tempoLayout = new QHBoxLayout();
+    tempoLayout->addWidget(m_tempoLabel);
+    tempoLayout->addWidget(m_clockLabel);
+    mainLayout->addLayout(tempoLayout);
+    
+    // 入力・描画の状態（イベントごとではなく一定間隔で更新）
+    m_telemetryPanel = new TelemetryPanel(m_visualizer, this);
+    connect(telemetryAction, &QAction::toggled, m_telemetryPanel, &QWidget::setVisible);
+    mainLayout->addWidget(m_telemetryPanel);
+    
+    // クロックはティックごとに通知されないため、表示は定期的に読み出す
+    m_clockTimer = new QTimer(this);
+    m_clockTimer->setInterval(500);
+    connect(m_clockTimer, &QTimer::timeout, this, &MainWindow::updateClockDisplay);
+    m_clockTimer->start();
+    
     // Launchpadグリッド
-    m_launchpadGrid = new LaunchpadGrid(this);
+    m_launchpadGrid = new LaunchpadGrid(m_padDisplay, this);
+    m_launchpadGrid->setLatencyTracker(m_visualizer->latencyTracker());
+    m_launchpadGrid->setTelemetry(m_visualizer->telemetry());
+    m_launchpadGrid->setStatistics(&m_visualizer->padStatistics());
+    connect(m_visualizer, &LaunchpadVisualizer::statisticsUpdated,
+            m_launchpadGrid, &LaunchpadGrid::refreshHeatmap);
     mainLayout->addWidget(m_launchpadGrid, 1);
     
     // レイアウトのスペースを調整
@@ -94,9 +259,17 @@ void MainWindow::initializeUI()
 
 void MainWindow::updateDeviceList()
 {
+    // 列挙はデバイス操作用のスレッドで行い、結果はonDevicesListedで受け取る
+    m_deviceBusy = true;
+    m_statusLabel->setText("MIDIデバイスを検索しています...");
+    m_visualizer->listDevicesAsync();
+    updateUIState();
+}
+
+void MainWindow::onDevicesListed(const QStringList& devices)
+{
+    m_deviceBusy = false;
     m_deviceComboBox->clear();
-    
-    QStringList devices = m_visualizer->getAvailableMidiDevices();
     m_deviceComboBox->addItems(devices);
     
     if (devices.isEmpty()) {
@@ -116,17 +289,36 @@ void MainWindow::connectToDevice()
         return;
     }
     
-    if (m_visualizer->connectToDevice(deviceIndex)) {
+    // 接続中も描画を止めないよう、結果はonDeviceConnectedで受け取る
+    m_deviceBusy = true;
+    m_statusLabel->setText("デバイスに接続しています: " + m_deviceComboBox->currentText());
+    m_visualizer->connectToDeviceAsync(deviceIndex);
+    updateUIState();
+}
+
+void MainWindow::onDeviceConnected(bool success)
+{
+    m_deviceBusy = false;
+    if (success) {
         m_statusLabel->setText("デバイスに接続しました: " + m_deviceComboBox->currentText());
-        updateUIState();
     } else {
+        m_statusLabel->setText("MIDIデバイスへの接続に失敗しました");
         QMessageBox::warning(this, "接続エラー", "MIDIデバイスへの接続に失敗しました。");
     }
+    updateUIState();
 }
 
 void MainWindow::disconnectDevice()
 {
-    m_visualizer->disconnectDevice();
+    m_deviceBusy = true;
+    m_statusLabel->setText("デバイスから切断しています...");
+    m_visualizer->disconnectDeviceAsync();
+    updateUIState();
+}
+
+void MainWindow::onDeviceDisconnected()
+{
+    m_deviceBusy = false;
     m_statusLabel->setText("デバイスから切断しました");
     updateUIState();
 }
@@ -148,43 +340,282 @@ void MainWindow::toggleVisualization()
     updateUIState();
 }
 
-void MainWindow::onPadPressed(int x, int y, int velocity)
+void MainWindow::toggleRecording()
+{
+    if (m_visualizer->isRecording()) {
+        m_visualizer->stopRecording();
+        m_statusLabel->setText("記録を停止しました");
+    } else {
+        QString filePath = QFileDialog::getSaveFileName(
+            this, "セッションの記録先", QString(),
+            "Launchpadセッション (*.lpvs);;Standard MIDI File (*.mid)");
+        if (filePath.isEmpty()) {
+            return;
+        }
+        
+        if (m_visualizer->startRecording(filePath)) {
+            m_statusLabel->setText("記録中: " + filePath);
+        } else {
+            QMessageBox::warning(this, "エラー", "記録ファイルを作成できませんでした。");
+            return;
+        }
+    }
+    
+    updateUIState();
+}
+
+void MainWindow::togglePlayback()
+{
+    if (m_visualizer->isPlaying()) {
+        m_visualizer->stopPlayback();
+        m_statusLabel->setText("再生を停止しました");
+    } else {
+        QString filePath = QFileDialog::getOpenFileName(
+            this, "再生するセッション", QString(),
+            "Launchpadセッション (*.lpvs);;Standard MIDI File (*.mid *.midi)");
+        if (filePath.isEmpty()) {
+            return;
+        }
+        
+        m_padDisplay->reset();
+        applyPlaybackSpeed();
+        if (m_visualizer->startPlayback(filePath)) {
+            // 再生の開始はライブ入力の切断後にonPlaybackStartedで受け取る
+            m_statusLabel->setText("再生中: " + filePath);
+        } else {
+            QMessageBox::warning(this, "エラー", "セッションファイルを再生できませんでした。");
+            return;
+        }
+    }
+    
+    updateUIState();
+}
+
+void MainWindow::applyPlaybackSpeed()
+{
+    m_speedSpinBox->setEnabled(!m_fastestCheckBox->isChecked());
+    m_visualizer->setPlaybackSpeed(m_fastestCheckBox->isChecked()
+        ? SessionPlayer::AS_FAST_AS_POSSIBLE : m_speedSpinBox->value());
+}
+
+void MainWindow::seekPlayback()
+{
+    m_visualizer->seekPlayback(static_cast<uint64_t>(m_seekSlider->value()) * 1000000);
+}
+
+void MainWindow::updatePlaybackPosition()
+{
+    const uint64_t positionMs = m_visualizer->playbackPositionNs() / 1000000;
+    const uint64_t durationMs = m_visualizer->playbackDurationNs() / 1000000;
+    
+    if (!m_seekSlider->isSliderDown()) {
+        m_seekSlider->setValue(static_cast<int>(positionMs));
+    }
+    
+    auto formatTime = [](uint64_t ms) {
+        const uint64_t seconds = ms / 1000;
+        return QString("%1:%2").arg(seconds / 60).arg(seconds % 60, 2, 10, QChar('0'));
+    };
+    m_positionLabel->setText(formatTime(positionMs) + " / " + formatTime(durationMs));
+}
+
+void MainWindow::onPlaybackFinished()
+{
+    m_visualizer->stopPlayback();
+    updatePlaybackPosition();
+    m_statusLabel->setText("再生が終了しました");
+    updateUIState();
+}
+
+void MainWindow::onPlaybackStarted(bool success)
+{
+    if (success) {
+        m_seekSlider->setRange(0, static_cast<int>(m_visualizer->playbackDurationNs() / 1000000));
+        m_positionTimer->start();
+    } else {
+        m_statusLabel->setText("再生を開始できませんでした");
+        QMessageBox::warning(this, "エラー", "セッションファイルを再生できませんでした。");
+    }
+    
+    updateUIState();
+}
+
+void MainWindow::showLatencyStats()
+{
+    if (!m_latencyDialog) {
+        m_latencyDialog = new LatencyDialog(m_visualizer->latencyTracker(), this);
+    }
+    
+    m_latencyDialog->show();
+    m_latencyDialog->raise();
+    m_latencyDialog->activateWindow();
+}
+
+void MainWindow::dumpLatencyStats()
+{
+    qInfo().noquote() << "レイテンシ統計 (マイクロ秒):\n" + m_visualizer->latencyTracker()->report();
+}
+
+void MainWindow::changeDisplayMode(QAction* action)
+{
+    const int mode = action->data().toInt();
+    if (mode < 0) {
+        m_launchpadGrid->setHeatmapMode(false);
+    } else {
+        m_launchpadGrid->setHeatmapMode(true, static_cast<PadStatistics::Window>(mode));
+    }
+}
+
+void MainWindow::changeFrameRate(QAction* action)
+{
+    int fps = action->data().toInt();
+    if (fps <= 0) {
+        // ウィンドウが表示されているディスプレイのリフレッシュレートを使う
+        QScreen* currentScreen = screen();
+        fps = currentScreen ? qRound(currentScreen->refreshRate()) : RenderScheduler::DEFAULT_MAX_FRAME_RATE;
+    }
+    m_padDisplay->setMaxFrameRate(fps);
+    qInfo() << "描画フレームレートの上限:" << fps << "fps";
+}
+
+void MainWindow::resetStatistics()
+{
+    m_visualizer->resetStatistics();
+    m_statusLabel->setText("使用統計をリセットしました");
+}
+
+void MainWindow::exportStatistics()
+{
+    QString filePath = QFileDialog::getSaveFileName(
+        this, "使用統計の保存先", "pad_statistics.csv", "CSVファイル (*.csv)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+    
+    if (!m_visualizer->exportStatistics(filePath)) {
+        QMessageBox::warning(this, "エラー", "ファイルを保存できませんでした。");
+        return;
+    }
+    
+    m_statusLabel->setText("使用統計を保存しました: " + filePath);
+}
+
+void MainWindow::onTempoChanged(double bpm, double confidence)
 {
-    // パッドが押されたときの処理
-    m_launchpadGrid->setPadActive(x, y, true);
+    m_tempoLabel->setText(QString("テンポ: %1 BPM (信頼度 %2%)")
+        .arg(bpm, 0, 'f', 1).arg(qRound(confidence * 100)));
+}
+
+void MainWindow::updateClockDisplay()
+{
+    const MidiClockTracker& clock = m_visualizer->clockTracker();
+    if (!clock.isLocked()) {
+        m_clockLabel->setText("MIDIクロック: -");
+        return;
+    }
     
-    // ステータス更新（デバッグ用）
-    m_statusLabel->setText(QString("パッド押下: (%1, %2) ベロシティ: %3").arg(x).arg(y).arg(velocity));
+    m_clockLabel->setText(QString("MIDIクロック: %1 BPM%2")
+        .arg(clock.bpm(), 0, 'f', 1)
+        .arg(clock.isRunning() ? "" : " (停止中)"));
+}
+
+void MainWindow::setSpriteCacheEnabled(bool enabled)
+{
+    m_launchpadGrid->setSpriteCacheEnabled(enabled);
+}
+
+void MainWindow::setAfterglowEnabled(bool enabled)
+{
+    m_padDisplay->setEnvelope(0, 0, 1.0f, enabled ? PadDisplayModel::DEFAULT_RELEASE_MS : 0);
+}
+
+void MainWindow::openGridView()
+{
+    // 別ウィンドウのビュー。状態とフレームは共有し、サイズや表示モードはビューごとに持つ
+    // （メインウィンドウの子にして、メインウィンドウと一緒に閉じる）
+    LaunchpadGrid* view = new LaunchpadGrid(m_padDisplay, this);
+    view->setWindowFlags(Qt::Window);
+    view->setAttribute(Qt::WA_DeleteOnClose);
+    view->setWindowTitle("Launchpad X Visualizer - ビュー");
+    view->setStatistics(&m_visualizer->padStatistics());
+    connect(m_visualizer, &LaunchpadVisualizer::statisticsUpdated,
+            view, &LaunchpadGrid::refreshHeatmap);
+    view->resize(600, 600);
+    view->show();
+}
+
+void MainWindow::setRasterBackendEnabled(bool enabled)
+{
+    m_launchpadGrid->setRenderBackend(enabled
+        ? LaunchpadGrid::RenderBackend::Raster : LaunchpadGrid::RenderBackend::Painter);
+}
+
+void MainWindow::setTraceEnabled(bool enabled)
+{
+    TraceRecorder::setThreadName("GUI");
+    TraceRecorder::setEnabled(enabled);
+    m_statusLabel->setText(enabled ? "トレースの記録を開始しました" : "トレースの記録を停止しました");
+}
+
+void MainWindow::saveTrace()
+{
+    QString filePath = QFileDialog::getSaveFileName(
+        this, "トレースの保存先", "trace.json", "Chrome Trace (*.json)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+    
+    if (!TraceRecorder::writeChromeTrace(filePath)) {
+        QMessageBox::warning(this, "エラー", "ファイルを保存できませんでした。");
+        return;
+    }
+    
+    m_statusLabel->setText("トレースを保存しました: " + filePath);
+}
+
+void MainWindow::onPadPressed(int x, int y)
+{
+    // パッドが押されたときの処理（最後のパッドの表示はテレメトリパネルが定期的に読み出す）
+    m_padDisplay->setPadActive(x, y, true);
 }
 
 void MainWindow::onPadReleased(int x, int y)
 {
     // パッドが離されたときの処理
-    m_launchpadGrid->setPadActive(x, y, false);
-    
-    // ステータス更新（デバッグ用）
-    m_statusLabel->setText(QString("パッド離上: (%1, %2)").arg(x).arg(y));
+    m_padDisplay->setPadActive(x, y, false);
 }
 
-void MainWindow::onPadColorChanged(int x, int y, QColor color)
+void MainWindow::onPadColorChanged(int x, int y, uint32_t rgb)
 {
     // パッドの色が変更されたときの処理
-    m_launchpadGrid->setPadColor(x, y, color);
+    m_padDisplay->setPadColor(x, y, QColor::fromRgb(rgb));
 }
 
 void MainWindow::updateUIState()
 {
     bool isConnected = m_visualizer && m_visualizer->isRunning();
-    bool isDeviceConnected = m_visualizer && m_visualizer->isRunning();
+    bool isDeviceConnected = m_visualizer && m_visualizer->isDeviceConnected();
     
-    // デバイスリスト
-    m_deviceComboBox->setEnabled(!isDeviceConnected);
+    // デバイスリスト（デバイス操作の完了待ちの間は操作できない）
+    m_deviceComboBox->setEnabled(!isDeviceConnected && !m_deviceBusy);
+    m_refreshButton->setEnabled(!m_deviceBusy);
     
     // 接続/切断ボタン
-    m_connectButton->setEnabled(!isDeviceConnected && m_deviceComboBox->count() > 0);
-    m_disconnectButton->setEnabled(isDeviceConnected);
+    m_connectButton->setEnabled(!isDeviceConnected && !m_deviceBusy && m_deviceComboBox->count() > 0);
+    m_disconnectButton->setEnabled(isDeviceConnected && !m_deviceBusy);
     
     // 開始/停止ボタン
-    m_startStopButton->setEnabled(isDeviceConnected);
+    m_startStopButton->setEnabled(isDeviceConnected && !m_deviceBusy);
     m_startStopButton->setText(isConnected ? "停止" : "開始");
+    
+    // 記録ボタン
+    m_recordButton->setText(m_visualizer && m_visualizer->isRecording() ? "記録停止" : "記録");
+    
+    // 再生ボタン
+    const bool isPlaying = m_visualizer && m_visualizer->isPlaying();
+    m_playButton->setText(isPlaying ? "再生停止" : "再生");
+    m_seekSlider->setEnabled(isPlaying);
+    if (!isPlaying) {
+        m_positionTimer->stop();
+    }
 }
\ No newline at end of file
@@ -5,8 +5,15 @@
 #include <QComboBox>
 #include <QPushButton>
 #include <QLabel>
+#include <QDoubleSpinBox>
+#include <QCheckBox>
+#include <QSlider>
+#include <QTimer>
 #include "../LaunchpadVisualizer.h"
 #include "LaunchpadGrid.h"
+#include "PadDisplayModel.h"
+#include "LatencyDialog.h"
+#include "TelemetryPanel.h"
 
 /**
  * @brief アプリケーションのメインウィンドウクラス
@@ -15,34 +22,166 @@ class MainWindow : public QMainWindow {
     Q_OBJECT
 
 public:
-    explicit MainWindow(LaunchpadVisualizer* visualizer, QWidget *parent = nullptr);
+    /**
+     * @param visualizer アプリケーション本体
+     * @param gridSize 表示する表面の1辺のパッド数（複数台を並べた表示は16-64）
+     * @param parent 親ウィジェット
+     */
+    explicit MainWindow(LaunchpadVisualizer* visualizer, int gridSize = PadDisplayModel::DEFAULT_GRID_SIZE,
+                        QWidget *parent = nullptr);
     ~MainWindow();
 
 private slots:
     /**
-     * @brief デバイス選択コンボボックスの内容を更新
+     * @brief デバイス選択コンボボックスの内容を更新（完了はonDevicesListedで受け取る）
      */
     void updateDeviceList();
 
     /**
-     * @brief MIDIデバイスに接続
+     * @brief MIDIデバイスに接続（完了はonDeviceConnectedで受け取る）
      */
     void connectToDevice();
 
     /**
-     * @brief MIDIデバイスとの接続を切断
+     * @brief MIDIデバイスとの接続を切断（完了はonDeviceDisconnectedで受け取る）
      */
     void disconnectDevice();
 
+    /**
+     * @brief デバイスの列挙結果をコンボボックスに反映
+     * @param devices デバイス名のリスト
+     */
+    void onDevicesListed(const QStringList& devices);
+
+    /**
+     * @brief デバイス接続の結果を反映
+     * @param success 接続に成功した場合true
+     */
+    void onDeviceConnected(bool success);
+
+    /**
+     * @brief デバイス切断の完了を反映
+     */
+    void onDeviceDisconnected();
+
     /**
      * @brief 可視化の開始/停止を切り替え
      */
     void toggleVisualization();
 
+    /**
+     * @brief セッション記録の開始/停止を切り替え
+     */
+    void toggleRecording();
+
+    /**
+     * @brief セッション再生の開始/停止を切り替え
+     */
+    void togglePlayback();
+
+    /**
+     * @brief 再生速度の設定を反映
+     */
+    void applyPlaybackSpeed();
+
+    /**
+     * @brief セッション再生終了時のハンドラー
+     */
+    void onPlaybackFinished();
+
+    /**
+     * @brief セッション再生の開始処理が終わったときのハンドラー
+     * @param success 再生を開始できた場合true
+     */
+    void onPlaybackStarted(bool success);
+
+    /**
+     * @brief シークバーの位置で再生位置を移動
+     */
+    void seekPlayback();
+
+    /**
+     * @brief シークバーを現在の再生位置に合わせる
+     */
+    void updatePlaybackPosition();
+
+    /**
+     * @brief レイテンシ統計ダイアログを表示
+     */
+    void showLatencyStats();
+
+    /**
+     * @brief レイテンシ統計をログに出力
+     */
+    void dumpLatencyStats();
+
+    /**
+     * @brief パッド画像キャッシュの使用を切り替え（描画時間の比較用）
+     */
+    void setSpriteCacheEnabled(bool enabled);
+
+    /**
+     * @brief パッドの描画方式（QPainter/QImageへ直接書き込み）を切り替え
+     */
+    void setRasterBackendEnabled(bool enabled);
+
+    /**
+     * @brief 処理区間のトレースの記録を切り替え
+     */
+    void setTraceEnabled(bool enabled);
+
+    /**
+     * @brief 記録したトレースをChrome Trace Event形式で保存
+     */
+    void saveTrace();
+
+    /**
+     * @brief グリッドの表示モード（通常/ヒートマップ）を切り替え
+     * @param action 選択されたメニュー項目
+     */
+    void changeDisplayMode(QAction* action);
+
+    /**
+     * @brief 離したパッドの残光表示を切り替え
+     */
+    void setAfterglowEnabled(bool enabled);
+
+    /**
+     * @brief 同じパッドの状態を表示する別ウィンドウのビューを開く
+     * 右クリックメニューでビューごとに表示モードと描画方式を選べる
+     */
+    void openGridView();
+
+    /**
+     * @brief パッドの使用統計をリセット
+     */
+    void resetStatistics();
+
+    /**
+     * @brief パッドの使用統計をCSVファイルに保存
+     */
+    void exportStatistics();
+
+    /**
+     * @brief グリッド再描画のフレームレート上限を変更
+     * @param action 選択されたメニュー項目
+     */
+    void changeFrameRate(QAction* action);
+
+    /**
+     * @brief 推定テンポの表示を更新
+     */
+    void onTempoChanged(double bpm, double confidence);
+
+    /**
+     * @brief 外部MIDIクロックのテンポ表示を更新
+     */
+    void updateClockDisplay();
+
     /**
      * @brief パッド押下イベントのハンドラー
      */
-    void onPadPressed(int x, int y, int velocity);
+    void onPadPressed(int x, int y);
 
     /**
      * @brief パッド離上イベントのハンドラー
@@ -52,13 +191,14 @@ private slots:
     /**
      * @brief パッド色変更イベントのハンドラー
      */
-    void onPadColorChanged(int x, int y, QColor color);
+    void onPadColorChanged(int x, int y, uint32_t rgb);
 
 private:
     /**
      * @brief UIコンポーネントの初期化
+     * @param gridSize 表示する表面の1辺のパッド数
      */
-    void initializeUI();
+    void initializeUI(int gridSize);
 
     /**
      * @brief UI状態の更新
@@ -70,11 +210,26 @@ private:
 
     // UIコンポーネント
     QComboBox* m_deviceComboBox;     // デバイス選択コンボボックス
+    QPushButton* m_refreshButton;    // デバイスリストの更新ボタン
     QPushButton* m_connectButton;    // 接続ボタン
     QPushButton* m_disconnectButton; // 切断ボタン
     QPushButton* m_startStopButton;  // 開始/停止ボタン
+    QPushButton* m_recordButton;     // 記録ボタン
+    QPushButton* m_playButton;       // 再生ボタン
+    QDoubleSpinBox* m_speedSpinBox;  // 再生速度
+    QCheckBox* m_fastestCheckBox;    // 最速再生
+    QSlider* m_seekSlider;           // 再生位置 (ミリ秒)
+    QLabel* m_positionLabel;         // 再生位置表示
+    QTimer* m_positionTimer;         // 再生位置の更新タイマー
     QLabel* m_statusLabel;           // ステータス表示
+    QLabel* m_tempoLabel;            // 推定テンポ表示
+    QLabel* m_clockLabel;            // 外部MIDIクロックのテンポ表示
+    QTimer* m_clockTimer;            // クロック表示の更新タイマー
+    TelemetryPanel* m_telemetryPanel; // 入力・描画の状態表示
+    PadDisplayModel* m_padDisplay;   // 全ビューで共有するパッドの状態
     LaunchpadGrid* m_launchpadGrid;  // Launchpad可視化グリッド
+    LatencyDialog* m_latencyDialog;  // レイテンシ統計ダイアログ（初回表示時に作成）
+    bool m_deviceBusy;               // デバイス操作の完了待ち
 };
 
 #endif // MAIN_WINDOW_H
\ No newline at end of file
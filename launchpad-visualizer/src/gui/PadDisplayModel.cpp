@@ -0,0 +1,156 @@
+#include "PadDisplayModel.h"
+#include "../midi/MidiEvent.h"
+#include "../diag/TraceRecorder.h"
+
+PadDisplayModel::PadDisplayModel(int gridSize, QObject *parent)
+    : QObject(parent)
+    , m_gridSize(qBound(1, gridSize, MAX_GRID_SIZE))
+    , m_padColors(m_gridSize * m_gridSize, QColor(Qt::black))
+    , m_envelope(m_gridSize * m_gridSize)
+    , m_clockTracker(nullptr)
+    , m_clockRunning(false)
+    , m_pulseVisible(false)
+    , m_pulse(0.0)
+{
+    m_envelope.setTimes(0, 0, 1.0f, DEFAULT_RELEASE_MS);
+
+    connect(&m_scheduler, &RenderScheduler::frame, this, &PadDisplayModel::onFrame);
+}
+
+void PadDisplayModel::setPadColor(int x, int y, const QColor& color)
+{
+    if (!isValidCoordinate(x, y)) {
+        return;
+    }
+
+    m_padColors[index(x, y)] = color;
+    markDirty(x, y);
+}
+
+void PadDisplayModel::setPadActive(int x, int y, bool active)
+{
+    if (!isValidCoordinate(x, y)) {
+        return;
+    }
+
+    // 明るさはフレームごとにエンベロープを進めて反映する
+    if (active) {
+        m_envelope.noteOn(index(x, y), MidiEvent::now());
+    } else {
+        m_envelope.noteOff(index(x, y), MidiEvent::now());
+    }
+
+    // ヒートマップ表示中のビューは押下の有無で全体を描き直すため、押下したパッドは必ず通知する
+    markDirty(x, y);
+}
+
+void PadDisplayModel::reset()
+{
+    m_padColors.fill(QColor(Qt::black));
+    m_envelope.reset();
+
+    m_dirtyPads.setFirst(padCount());
+    m_scheduler.requestFrame();
+}
+
+QColor PadDisplayModel::padColor(int x, int y) const
+{
+    return isValidCoordinate(x, y) ? m_padColors[index(x, y)] : QColor(Qt::black);
+}
+
+int PadDisplayModel::padGlow(int x, int y) const
+{
+    return isValidCoordinate(x, y) ? m_envelope.level(index(x, y)) * 255 / PadEnvelope::LEVELS : 0;
+}
+
+void PadDisplayModel::setEnvelope(int attackMs, int decayMs, float sustain, int releaseMs)
+{
+    m_envelope.setTimes(attackMs, decayMs, sustain, releaseMs);
+    m_scheduler.requestFrame();
+}
+
+void PadDisplayModel::setClockTracker(const MidiClockTracker* tracker)
+{
+    m_clockTracker = tracker;
+    m_scheduler.requestFrame();
+}
+
+void PadDisplayModel::setClockRunning(bool running)
+{
+    m_clockRunning = running;
+    m_scheduler.requestFrame();
+}
+
+double PadDisplayModel::pulse() const
+{
+    return m_pulse;
+}
+
+void PadDisplayModel::setMaxFrameRate(int fps)
+{
+    m_scheduler.setMaxFrameRate(fps);
+}
+
+int PadDisplayModel::maxFrameRate() const
+{
+    return m_scheduler.maxFrameRate();
+}
+
+void PadDisplayModel::requestFrame()
+{
+    m_scheduler.requestFrame();
+}
+
+bool PadDisplayModel::isValidCoordinate(int x, int y) const
+{
+    return (x >= 0 && x < m_gridSize && y >= 0 && y < m_gridSize);
+}
+
+void PadDisplayModel::markDirty(int x, int y)
+{
+    m_dirtyPads.set(index(x, y));
+    m_scheduler.requestFrame();
+}
+
+void PadDisplayModel::onFrame()
+{
+    TRACE_SCOPE("display.frame");
+
+    // 変化中のパッドがある間は毎フレーム明るさを進め、段階が変わったパッドだけを通知する
+    if (m_envelope.isAnimating()) {
+        m_envelope.advance(MidiEvent::now(), m_dirtyPads);
+        if (m_envelope.isAnimating()) {
+            m_scheduler.requestFrame();
+        }
+    }
+
+    // クロック再生中は毎フレーム境界線のパルスを更新し、停止後に一度だけ消去する
+    // （ビューの画像キャッシュが増えすぎないよう段階を量子化する）
+    const bool pulseActive = m_clockTracker && m_clockRunning;
+    if (pulseActive || m_pulseVisible) {
+        m_pulseVisible = pulseActive;
+        const double pulse = qRound(pulseIntensity() * PULSE_LEVELS) / static_cast<double>(PULSE_LEVELS);
+        if (pulse != m_pulse) {
+            m_pulse = pulse;
+            m_dirtyPads.setFirst(padCount());
+        }
+        if (pulseActive) {
+            m_scheduler.requestFrame();
+        }
+    }
+
+    // ビュー側の要求だけでフレームが来た場合も通知する（各ビューが自分の要求を処理する）
+    const PadMask dirtyPads = m_dirtyPads;
+    m_dirtyPads.clear();
+    emit frame(dirtyPads);
+}
+
+double PadDisplayModel::pulseIntensity() const
+{
+    if (!m_clockTracker || !m_clockRunning || !m_clockTracker->isLocked()) {
+        return 0.0;
+    }
+
+    const double decay = 1.0 - m_clockTracker->beatPhase(MidiEvent::now());
+    return decay * decay * decay;
+}
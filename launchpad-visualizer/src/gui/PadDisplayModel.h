@@ -0,0 +1,169 @@
+#ifndef PAD_DISPLAY_MODEL_H
+#define PAD_DISPLAY_MODEL_H
+
+#include <QObject>
+#include <QColor>
+#include <QVector>
+#include "RenderScheduler.h"
+#include "../model/PadEnvelope.h"
+#include "../model/PadStateModel.h"
+#include "../midi/MidiClockTracker.h"
+#include "../util/PadMask.h"
+
+/**
+ * @brief 複数のLaunchpadGridが共有する表示用のパッド状態
+ * パッドの色・押下状態・残光・拍のパルスを1か所で管理し、
+ * 1つのRenderSchedulerのフレームごとに変化したパッドをまとめて通知する。
+ * ビューの数が増えても状態の更新はフレームごとに1回で、
+ * 各ビューは通知されたパッドの描画だけを行う。
+ * 表面のサイズは構築時に決め（既定はLaunchpad Xの9x9、最大64x64）、
+ * デバイスのパッドは左下の9x9に対応する
+ */
+class PadDisplayModel : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_GRID_SIZE = PadStateModel::GRID_SIZE;  // 既定の表面のサイズ (9x9)
+    static constexpr int MAX_GRID_SIZE = PadMask::MAX_GRID_SIZE;       // 表面のサイズの上限
+    static constexpr int DEFAULT_RELEASE_MS = 300;  // 既定の残光の長さ (ミリ秒)
+    static constexpr int PULSE_LEVELS = 16;         // パルスの量子化段階数
+
+    /**
+     * @param gridSize 表面の1辺のパッド数 (1-MAX_GRID_SIZE)
+     * @param parent 親オブジェクト
+     */
+    explicit PadDisplayModel(int gridSize = DEFAULT_GRID_SIZE, QObject *parent = nullptr);
+
+    /**
+     * @brief 表面の1辺のパッド数を取得
+     */
+    int gridSize() const { return m_gridSize; }
+
+    /**
+     * @brief 表面のパッド数を取得
+     */
+    int padCount() const { return m_gridSize * m_gridSize; }
+
+    /**
+     * @brief パッドの色を設定
+     * @param x X座標 (0 - gridSize-1)
+     * @param y Y座標 (0 - gridSize-1)
+     * @param color 色
+     */
+    void setPadColor(int x, int y, const QColor& color);
+
+    /**
+     * @brief パッドのアクティブ状態を設定
+     * @param x X座標 (0 - gridSize-1)
+     * @param y Y座標 (0 - gridSize-1)
+     * @param active アクティブならtrue
+     */
+    void setPadActive(int x, int y, bool active);
+
+    /**
+     * @brief すべてのパッドをリセット
+     */
+    void reset();
+
+    /**
+     * @brief パッドの色を取得
+     */
+    QColor padColor(int x, int y) const;
+
+    /**
+     * @brief パッドの現在の明るさ
+     * @return 0-255
+     */
+    int padGlow(int x, int y) const;
+
+    /**
+     * @brief 押下/離上時の明るさの変化（エンベロープ）を設定
+     * @param attackMs 押下から最大の明るさまでの時間
+     * @param decayMs 最大からサステインまでの時間
+     * @param sustain 押下中に保つ明るさ (0.0-1.0)
+     * @param releaseMs 離上から消えるまでの時間（0で即座に消える）
+     */
+    void setEnvelope(int attackMs, int decayMs, float sustain, int releaseMs);
+
+    /**
+     * @brief 拍に合わせたパルス表示に使うクロック追従を設定
+     * @param tracker クロック追従（所有権は移らない。nullptrでパルス表示しない）
+     */
+    void setClockTracker(const MidiClockTracker* tracker);
+
+    /**
+     * @brief 現在のフレームのパルスの強さ
+     * @return 0.0-1.0（PULSE_LEVELS段階に量子化済み）
+     */
+    double pulse() const;
+
+    /**
+     * @brief 再描画のフレームレート上限を設定
+     * @param fps 1秒あたりの最大フレーム数
+     */
+    void setMaxFrameRate(int fps);
+
+    /**
+     * @brief 再描画のフレームレート上限を取得
+     */
+    int maxFrameRate() const;
+
+    /**
+     * @brief 次のフレームを要求（ビュー側の再描画要求用）
+     */
+    void requestFrame();
+
+    /**
+     * @brief 座標が有効かチェック
+     */
+    bool isValidCoordinate(int x, int y) const;
+
+    /**
+     * @brief 座標からパッドのインデックスを求める
+     */
+    int index(int x, int y) const { return y * m_gridSize + x; }
+
+public slots:
+    /**
+     * @brief 外部MIDIクロックの再生状態が変化したときに呼ばれる
+     * 再生中はフレームごとにパルス表示を更新する
+     * @param running 再生中の場合true
+     */
+    void setClockRunning(bool running);
+
+signals:
+    /**
+     * @brief フレームのタイミングで発生するシグナル
+     * @param dirtyPads このフレームで表示が変わったパッド
+     */
+    void frame(const PadMask& dirtyPads);
+
+private slots:
+    /**
+     * @brief フレームのタイミングで残光とパルスを進め、ビューに通知
+     */
+    void onFrame();
+
+private:
+    /**
+     * @brief パッドを変化したパッドに追加し、フレームを要求
+     */
+    void markDirty(int x, int y);
+
+    /**
+     * @brief 現在の拍位相からパルスの強さを求める
+     */
+    double pulseIntensity() const;
+
+    int m_gridSize;                         // 表面の1辺のパッド数
+    QVector<QColor> m_padColors;            // パッドの色
+    PadEnvelope m_envelope;                 // パッドの明るさの変化
+    const MidiClockTracker* m_clockTracker; // パルス表示用のクロック追従
+    bool m_clockRunning;                    // 外部クロックの再生中フラグ
+    bool m_pulseVisible;                    // 直前のフレームでパルスを表示したか
+    double m_pulse;                         // 現在のフレームのパルスの強さ
+    RenderScheduler m_scheduler;            // 全ビューで共有するフレーム制御
+    PadMask m_dirtyPads;                    // 次のフレームで通知するパッド
+};
+
+#endif // PAD_DISPLAY_MODEL_H
@@ -0,0 +1,58 @@
+#include "PadLayout.h"
+#include "../util/PadMask.h"
+#include <QtGlobal>
+
+PadLayout::PadLayout(int gridSize)
+    : m_gridSize(qBound(1, gridSize, PadMask::MAX_GRID_SIZE))
+    , m_padSize(0)
+    , m_rects(m_gridSize * m_gridSize)
+    , m_round(m_gridSize * m_gridSize, false)
+{
+    // Launchpadの表面では上段と右端がボタン（右上のロゴは角丸の四角）
+    if (m_gridSize == PadStateModel::GRID_SIZE) {
+        for (int y = 0; y < m_gridSize; ++y) {
+            for (int x = 0; x < m_gridSize; ++x) {
+                const bool edge = (x == m_gridSize - 1) || (y == m_gridSize - 1);
+                const bool logo = (x == m_gridSize - 1) && (y == m_gridSize - 1);
+                m_round[y * m_gridSize + x] = edge && !logo;
+            }
+        }
+    }
+}
+
+void PadLayout::setSize(const QSize& size)
+{
+    // 表面全体を正方形に収める
+    const int minDim = qMin(size.width(), size.height());
+
+    // パッドのサイズを計算 (ギャップを考慮)
+    // セルの多い表面ではギャップを狭め、パッドの面積を確保する
+    const int gap = qBound(1, minDim / (m_gridSize * GAP_DIVISOR), PAD_GAP);
+    m_padSize = qMax(0, (minDim - gap * (m_gridSize + 1)) / m_gridSize);
+
+    const int buttonInset = qRound(m_padSize * (1.0f - BUTTON_SCALE) / 2);
+    const int logoInset = qRound(m_padSize * (1.0f - LOGO_SCALE) / 2);
+    const bool launchpad = m_gridSize == PadStateModel::GRID_SIZE;
+    for (int y = 0; y < m_gridSize; ++y) {
+        for (int x = 0; x < m_gridSize; ++x) {
+            // y=0の段を一番下に描く
+            const int row = m_gridSize - 1 - y;
+            QRect rect(gap + x * (m_padSize + gap),
+                       gap + row * (m_padSize + gap),
+                       m_padSize, m_padSize);
+
+            const int index = y * m_gridSize + x;
+            if (m_round[index]) {
+                rect.adjust(buttonInset, buttonInset, -buttonInset, -buttonInset);
+            } else if (launchpad && x == m_gridSize - 1 && y == m_gridSize - 1) {
+                rect.adjust(logoInset, logoInset, -logoInset, -logoInset);
+            }
+            m_rects[index] = rect;
+        }
+    }
+}
+
+int PadLayout::padSize() const
+{
+    return m_padSize;
+}
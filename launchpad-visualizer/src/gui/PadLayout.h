@@ -0,0 +1,83 @@
+#ifndef PAD_LAYOUT_H
+#define PAD_LAYOUT_H
+
+#include <QRect>
+#include <QSize>
+#include <QVector>
+#include "../model/PadStateModel.h"
+
+/**
+ * @brief パッドの表面の配置
+ * 既定は Launchpad X の表面 (9x9) で、8x8のパッドの上に上段のボタン列、
+ * 右に右端のボタン列、右上にロゴを置く。それ以外のサイズ（複数台を並べた
+ * 16x16-64x64 の表示など）はすべて角丸の四角のパッドを並べる。
+ * 座標はPadStateModelと同じで、y=0が最下段 (ノート11-18)、y=8が上段のボタン列。
+ * 描画領域のサイズが変わったときに全パッドの矩形と形状を平坦な表にまとめて計算し、
+ * 描画時は表を引くだけにする。画面上のLaunchpadGridとオフラインの描画で同じ配置を使う
+ */
+class PadLayout {
+public:
+    static constexpr int PAD_GAP = 5;  // パッド間のギャップの上限 (ピクセル)
+
+    /**
+     * @param gridSize 1辺のセル数（既定はLaunchpad Xの表面）
+     */
+    explicit PadLayout(int gridSize = PadStateModel::GRID_SIZE);
+
+    /**
+     * @brief 1辺のセル数を取得
+     */
+    int gridSize() const { return m_gridSize; }
+
+    /**
+     * @brief セル数を取得
+     */
+    int padCount() const { return m_gridSize * m_gridSize; }
+
+    /**
+     * @brief 描画領域のサイズを設定し、配置の表を再計算
+     * 表面全体は領域に収まる正方形になる
+     * @param size 描画領域のサイズ
+     */
+    void setSize(const QSize& size);
+
+    /**
+     * @brief パッドのサイズを取得
+     */
+    int padSize() const;
+
+    /**
+     * @brief パッドの矩形を取得
+     * @param x X座標 (0 - gridSize-1)
+     * @param y Y座標 (0 - gridSize-1)
+     * @return パッドの矩形（範囲外の場合は空の矩形）
+     */
+    QRect padRect(int x, int y) const
+    {
+        return (x >= 0 && x < m_gridSize && y >= 0 && y < m_gridSize) ? m_rects[y * m_gridSize + x] : QRect();
+    }
+
+    /**
+     * @brief インデックスからパッドの矩形を取得
+     * @param index パッドインデックス (y * gridSize + x)
+     */
+    const QRect& padRect(int index) const { return m_rects[index]; }
+
+    /**
+     * @brief 丸いボタンかどうか（上段・右端のボタン列）
+     * @param index パッドインデックス
+     */
+    bool isRound(int index) const { return m_round[index]; }
+
+private:
+    static constexpr float BUTTON_SCALE = 0.8f;  // セルに対する丸ボタンの直径の比率
+    static constexpr float LOGO_SCALE = 0.5f;    // セルに対するロゴのサイズの比率
+    static constexpr int GAP_DIVISOR = 6;        // ギャップをセル幅の1/6以下に抑える
+
+    int m_gridSize;              // 1辺のセル数
+    int m_padSize;               // パッドのサイズ (ピクセル)
+    QVector<QRect> m_rects;      // パッドの矩形
+    QVector<bool> m_round;       // 丸いボタンかどうか
+};
+
+#endif // PAD_LAYOUT_H
@@ -0,0 +1,266 @@
+#include "PadRasterizer.h"
+#include "PadSpriteCache.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LPV_HAVE_SSE2 1
+#endif
+
+PadRasterizer::PadRasterizer()
+    : m_devicePixelRatio(1.0)
+    , m_radius(0)
+    , m_penWidth(1.0)
+{
+}
+
+bool PadRasterizer::resize(const QSize& size, qreal devicePixelRatio)
+{
+    const QSize deviceSize(qCeil(size.width() * devicePixelRatio), qCeil(size.height() * devicePixelRatio));
+    if (!m_image.isNull() && m_image.size() == deviceSize && m_devicePixelRatio == devicePixelRatio) {
+        return false;
+    }
+
+    m_image = QImage(deviceSize, QImage::Format_ARGB32_Premultiplied);
+    m_image.setDevicePixelRatio(devicePixelRatio);
+    if (m_devicePixelRatio != devicePixelRatio) {
+        m_cornerMasks.clear();
+    }
+    m_devicePixelRatio = devicePixelRatio;
+    // renderPadは論理座標で描くため、半径と1ピクセルのペンはデバイスピクセル比倍になる
+    m_radius = PadSpriteCache::CORNER_RADIUS * devicePixelRatio;
+    m_penWidth = devicePixelRatio;
+    return true;
+}
+
+const QImage& PadRasterizer::image() const
+{
+    return m_image;
+}
+
+void PadRasterizer::fill(const QColor& color)
+{
+    m_image.fill(color.rgba());
+}
+
+void PadRasterizer::clearRect(const QRect& rect, const QColor& color)
+{
+    const QRect deviceRect = toDevice(rect) & m_image.rect();
+    const uint32_t pixel = color.rgba();
+    for (int y = deviceRect.top(); y <= deviceRect.bottom(); ++y) {
+        uint32_t* row = reinterpret_cast<uint32_t*>(m_image.scanLine(y));
+        fillRow(row + deviceRect.left(), deviceRect.width(), pixel);
+    }
+}
+
+void PadRasterizer::drawPad(const QRect& padRect, const QColor& color, int glow, const QColor& borderColor, bool round)
+{
+    if (m_image.isNull()) {
+        return;
+    }
+
+    // renderPadと同じ順序（本体 → 内側の明るい四角 → 境界線）で描く
+    const QRect deviceRect = toDevice(padRect);
+    const qreal radius = cornerRadius(deviceRect, round);
+    fillRoundedRect(deviceRect, color.rgba(), radius);
+    if (glow > 0) {
+        const QRect innerRect = toDevice(PadSpriteCache::activeInnerRect(padRect));
+        fillRoundedRect(innerRect, PadSpriteCache::glowColor(color, glow).rgba(), cornerRadius(innerRect, round));
+    }
+    strokeRoundedRect(deviceRect, borderColor.rgba(), radius);
+}
+
+void PadRasterizer::fillRow(uint32_t* dst, int count, uint32_t pixel)
+{
+#ifdef LPV_HAVE_SSE2
+    // 4ピクセル（16バイト）単位でまとめて書き込む
+    const __m128i value = _mm_set1_epi32(static_cast<int>(pixel));
+    for (; count >= 4; count -= 4, dst += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), value);
+    }
+#endif
+    std::fill_n(dst, count, pixel);
+}
+
+const PadRasterizer::CornerMask& PadRasterizer::cornerMask(qreal radius)
+{
+    for (const CornerMask& mask : m_cornerMasks) {
+        if (mask.radius == radius) {
+            return mask;
+        }
+    }
+
+    // 角の各ピクセルをSUBSAMPLES x SUBSAMPLES点で標本化し、角丸矩形の輪郭（中心(r, r)の円弧と
+    // その先の直線）からの距離を求める。内部は距離r以内、境界線は輪郭から線幅の半分以内の領域とする
+    CornerMask mask;
+    mask.radius = radius;
+    mask.size = qCeil(radius);
+    mask.outset = qCeil(m_penWidth / 2);
+    const int size = mask.size;
+    const int outset = mask.outset;
+    const int span = outset + size;
+    mask.fill.resize(size * size);
+    mask.ring.resize(span * span);
+
+    const double halfWidth = m_penWidth / 2;
+    const int samples = SUBSAMPLES * SUBSAMPLES;
+    for (int cy = -outset; cy < size; ++cy) {
+        for (int cx = -outset; cx < size; ++cx) {
+            int inside = 0;
+            int stroke = 0;
+            for (int sy = 0; sy < SUBSAMPLES; ++sy) {
+                for (int sx = 0; sx < SUBSAMPLES; ++sx) {
+                    // 円の中心より内側（直線部分）は辺までの距離になる
+                    const double px = qMin(cx + (sx + 0.5) / SUBSAMPLES - radius, 0.0);
+                    const double py = qMin(cy + (sy + 0.5) / SUBSAMPLES - radius, 0.0);
+                    const double distance = std::sqrt(px * px + py * py);
+                    if (distance <= radius) {
+                        ++inside;
+                    }
+                    if (std::abs(distance - radius) <= halfWidth) {
+                        ++stroke;
+                    }
+                }
+            }
+            if (cx >= 0 && cy >= 0) {
+                mask.fill[cy * size + cx] = static_cast<uint8_t>((inside * 255 + samples / 2) / samples);
+            }
+            mask.ring[(cy + outset) * span + cx + outset] = static_cast<uint8_t>((stroke * 255 + samples / 2) / samples);
+        }
+    }
+
+    // 直線部分は各ピクセルと線の幅 [-halfWidth, halfWidth] の重なり
+    for (int offset = -outset; offset < outset; ++offset) {
+        const double overlap = qMin(offset + 1.0, halfWidth) - qMax(static_cast<double>(offset), -halfWidth);
+        mask.edge.append(static_cast<uint8_t>(qRound(qMax(overlap, 0.0) * 255)));
+    }
+
+    m_cornerMasks.append(mask);
+    return m_cornerMasks.last();
+}
+
+QRect PadRasterizer::toDevice(const QRect& rect) const
+{
+    if (m_devicePixelRatio == 1.0) {
+        return rect;
+    }
+    const int left = qRound(rect.x() * m_devicePixelRatio);
+    const int top = qRound(rect.y() * m_devicePixelRatio);
+    const int right = qRound((rect.x() + rect.width()) * m_devicePixelRatio);
+    const int bottom = qRound((rect.y() + rect.height()) * m_devicePixelRatio);
+    return QRect(left, top, right - left, bottom - top);
+}
+
+qreal PadRasterizer::cornerRadius(const QRect& rect, bool round) const
+{
+    // 角丸はパッドの半分を超えない（丸いボタンはちょうど半分）
+    const qreal half = qMin(rect.width(), rect.height()) / 2.0;
+    return round ? half : qMin(m_radius, half);
+}
+
+void PadRasterizer::fillRoundedRect(const QRect& rect, uint32_t pixel, qreal radius)
+{
+    if (rect.isEmpty() || !m_image.rect().contains(rect)) {
+        return;
+    }
+
+    const CornerMask& mask = cornerMask(radius);
+    const int size = mask.size;
+    const int left = rect.left();
+    const int right = rect.right();
+
+    for (int row = 0; row < rect.height(); ++row) {
+        uint32_t* line = reinterpret_cast<uint32_t*>(m_image.scanLine(rect.top() + row));
+
+        // 上下の角の行は両端をマスクでブレンドし、間を塗りつぶす
+        int cy = -1;
+        if (row < size) {
+            cy = row;
+        } else if (row >= rect.height() - size) {
+            cy = rect.height() - 1 - row;
+        }
+
+        if (cy < 0) {
+            fillRow(line + left, rect.width(), pixel);
+            continue;
+        }
+
+        const uint8_t* coverage = mask.fill.constData() + cy * size;
+        for (int cx = 0; cx < size; ++cx) {
+            blendPixel(line[left + cx], pixel, coverage[cx]);
+            // 幅が奇数の丸いボタンでは中央の列を2回ブレンドしない
+            if (right - cx > left + cx) {
+                blendPixel(line[right - cx], pixel, coverage[cx]);
+            }
+        }
+        fillRow(line + left + size, qMax(rect.width() - 2 * size, 0), pixel);
+    }
+}
+
+void PadRasterizer::strokeRoundedRect(const QRect& rect, uint32_t pixel, qreal radius)
+{
+    const CornerMask& mask = cornerMask(radius);
+    const int size = mask.size;
+    const int outset = mask.outset;
+    const int span = outset + size;
+    if (rect.isEmpty() || !m_image.rect().contains(rect.adjusted(-outset, -outset, outset, outset))) {
+        return;
+    }
+
+    const int left = rect.left();
+    const int right = rect.right();
+
+    for (int row = -outset; row < rect.height() + outset; ++row) {
+        uint32_t* line = reinterpret_cast<uint32_t*>(m_image.scanLine(rect.top() + row));
+
+        int cy = -outset - 1;
+        if (row < size) {
+            cy = row;
+        } else if (row >= rect.height() - size) {
+            cy = rect.height() - 1 - row;
+        }
+
+        if (cy < -outset) {
+            // 直線部分は左右の辺をまたぐ数ピクセルのみ
+            for (int offset = -outset; offset < outset; ++offset) {
+                blendPixel(line[left + offset], pixel, mask.edge[offset + outset]);
+                blendPixel(line[right - offset], pixel, mask.edge[offset + outset]);
+            }
+            continue;
+        }
+
+        const uint8_t* coverage = mask.ring.constData() + (cy + outset) * span + outset;
+        for (int cx = -outset; cx < size; ++cx) {
+            blendPixel(line[left + cx], pixel, coverage[cx]);
+            if (right - cx > left + cx) {
+                blendPixel(line[right - cx], pixel, coverage[cx]);
+            }
+        }
+        if (cy < outset) {
+            // 上端と下端の直線部分
+            const int edgeCoverage = mask.edge[cy + outset];
+            for (int x = left + size; x <= right - size; ++x) {
+                blendPixel(line[x], pixel, edgeCoverage);
+            }
+        }
+    }
+}
+
+void PadRasterizer::blendPixel(uint32_t& dst, uint32_t pixel, int coverage)
+{
+    if (coverage >= 255) {
+        dst = pixel;
+        return;
+    }
+    if (coverage <= 0) {
+        return;
+    }
+
+    // 不透明な色との線形補間（0x00FF00FFのマスクで2チャンネルずつ計算）
+    const uint32_t inv = 255 - coverage;
+    const uint32_t rb = ((pixel & 0x00FF00FF) * coverage + (dst & 0x00FF00FF) * inv + 0x00800080) >> 8;
+    const uint32_t ag = (((pixel >> 8) & 0x00FF00FF) * coverage + ((dst >> 8) & 0x00FF00FF) * inv + 0x00800080) >> 8;
+    dst = (rb & 0x00FF00FF) | ((ag & 0x00FF00FF) << 8);
+}
@@ -0,0 +1,129 @@
+#ifndef PAD_RASTERIZER_H
+#define PAD_RASTERIZER_H
+
+#include <QImage>
+#include <QRect>
+#include <QColor>
+#include <QVector>
+#include <cstdint>
+
+/**
+ * @brief パッドをQImageのバックバッファへ直接書き込むソフトウェアラスタライザ
+ * QPainterを介さず、内部の塗りつぶしは行単位のSIMD書き込み、角丸は
+ * 事前計算したカバレッジマスクとのブレンドで描画する。
+ * 描画結果はPadSpriteCache::renderPad（QPainter）と見た目が揃うようにしている
+ */
+class PadRasterizer {
+public:
+    PadRasterizer();
+
+    /**
+     * @brief バックバッファのサイズを合わせる
+     * @param size 論理サイズ
+     * @param devicePixelRatio デバイスピクセル比
+     * @return バッファを作り直した（内容が失われた）場合true
+     */
+    bool resize(const QSize& size, qreal devicePixelRatio);
+
+    /**
+     * @brief バックバッファを取得
+     */
+    const QImage& image() const;
+
+    /**
+     * @brief バックバッファ全体を塗りつぶす
+     * @param color 塗りつぶす色
+     */
+    void fill(const QColor& color);
+
+    /**
+     * @brief 論理座標の矩形を塗りつぶす（パッドを描き直す前の消去用）
+     * @param rect 論理座標の矩形
+     * @param color 塗りつぶす色
+     */
+    void clearRect(const QRect& rect, const QColor& color);
+
+    /**
+     * @brief パッドを描画
+     * @param padRect 論理座標のパッドの矩形
+     * @param color パッドの色
+     * @param glow アクティブ時の明るさ (0-255、0は非アクティブ)
+     * @param borderColor 境界線の色
+     * @param round 丸いボタンとして描く場合true（falseは角丸の四角）
+     */
+    void drawPad(const QRect& padRect, const QColor& color, int glow, const QColor& borderColor, bool round);
+
+    /**
+     * @brief 1行分のピクセルを同じ色で埋める
+     * @param dst 書き込み先
+     * @param count ピクセル数
+     * @param pixel ARGB32のピクセル値
+     */
+    static void fillRow(uint32_t* dst, int count, uint32_t pixel);
+
+private:
+    /**
+     * @brief 半径ごとの左上の角のカバレッジマスク
+     * 境界線はrenderPadのペンと同じく輪郭の上に中心を置くため、矩形の外側へ outset だけはみ出す
+     */
+    struct CornerMask {
+        qreal radius = 0;       // 物理ピクセル単位の半径
+        int size = 0;           // 角として扱うピクセル数 (半径の切り上げ)
+        int outset = 0;         // 境界線が矩形の外へはみ出すピクセル数
+        QVector<uint8_t> fill;  // 角丸矩形の内部のカバレッジ (size x size)
+        QVector<uint8_t> ring;  // 境界線のカバレッジ ((outset + size)^2、先頭は(-outset, -outset))
+        QVector<uint8_t> edge;  // 直線部分の境界線の断面 (輪郭の外側outsetから内側outsetまで)
+    };
+
+    /**
+     * @brief 半径に対応するマスクを取得（初回のみ計算）
+     * @param radius 物理ピクセル単位の半径
+     */
+    const CornerMask& cornerMask(qreal radius);
+
+    /**
+     * @brief 論理座標の矩形を物理ピクセルの矩形に変換
+     */
+    QRect toDevice(const QRect& rect) const;
+
+    /**
+     * @brief 矩形の角の半径を求める
+     * @param rect 物理ピクセルの矩形
+     * @param round trueなら矩形に内接する円になる半径
+     */
+    qreal cornerRadius(const QRect& rect, bool round) const;
+
+    /**
+     * @brief 角丸矩形を塗りつぶす
+     * @param rect 物理ピクセルの矩形
+     * @param pixel 塗りつぶす色
+     * @param radius 角の半径
+     */
+    void fillRoundedRect(const QRect& rect, uint32_t pixel, qreal radius);
+
+    /**
+     * @brief 角丸矩形の境界線を輪郭を中心に描く（矩形の外側にもはみ出す）
+     * @param rect 物理ピクセルの矩形
+     * @param pixel 線の色
+     * @param radius 角の半径
+     */
+    void strokeRoundedRect(const QRect& rect, uint32_t pixel, qreal radius);
+
+    /**
+     * @brief 1ピクセルをカバレッジに応じてブレンド
+     * @param dst 書き込み先
+     * @param pixel 不透明な色
+     * @param coverage 0-255
+     */
+    static void blendPixel(uint32_t& dst, uint32_t pixel, int coverage);
+
+    static constexpr int SUBSAMPLES = 4;  // カバレッジ計算の1軸あたりのサンプル数
+
+    QImage m_image;                    // バックバッファ（物理ピクセル）
+    qreal m_devicePixelRatio;          // デバイスピクセル比
+    QVector<CornerMask> m_cornerMasks; // 計算済みのマスク（デバイスピクセル比が変わると作り直す）
+    qreal m_radius;                    // 現在の物理ピクセル単位の半径
+    qreal m_penWidth;                  // 現在の物理ピクセル単位の境界線の幅
+};
+
+#endif // PAD_RASTERIZER_H
@@ -0,0 +1,129 @@
+#include "PadSpriteCache.h"
+#include <QPainter>
+#include <QtMath>
+
+namespace {
+constexpr float ACTIVE_SCALE = 0.9f;  // アクティブ時の内側の四角のサイズ比率
+}
+
+PadSpriteCache::PadSpriteCache(int capacity)
+    : m_capacity(capacity > 0 ? capacity : DEFAULT_CAPACITY)
+{
+}
+
+const QPixmap& PadSpriteCache::sprite(const QColor& color, int glow, const QColor& borderColor, bool round,
+                                      int padSize, qreal devicePixelRatio)
+{
+    const Key key = makeKey(color, glow, borderColor, round, padSize, devicePixelRatio);
+    
+    auto found = m_index.find(key);
+    if (found != m_index.end()) {
+        // 最近使った要素として先頭に移動
+        m_entries.splice(m_entries.begin(), m_entries, found.value());
+        return m_entries.front().pixmap;
+    }
+    
+    // 高DPI環境でも粗くならないよう物理ピクセル単位で描画する
+    const int logicalSize = padSize + MARGIN * 2;
+    const int physicalSize = qCeil(logicalSize * devicePixelRatio);
+    QPixmap pixmap(physicalSize, physicalSize);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+    {
+        QPainter painter(&pixmap);
+        painter.setRenderHint(QPainter::Antialiasing);
+        renderPad(painter, QRect(MARGIN, MARGIN, padSize, padSize), color, glow, borderColor, round);
+    }
+    
+    // 容量を超えたら最も古い要素を破棄
+    if (static_cast<int>(m_entries.size()) >= m_capacity) {
+        m_index.remove(m_entries.back().key);
+        m_entries.pop_back();
+    }
+    
+    m_entries.push_front(Entry{ key, pixmap });
+    m_index.insert(key, m_entries.begin());
+    return m_entries.front().pixmap;
+}
+
+void PadSpriteCache::clear()
+{
+    m_entries.clear();
+    m_index.clear();
+}
+
+int PadSpriteCache::size() const
+{
+    return static_cast<int>(m_entries.size());
+}
+
+void PadSpriteCache::renderPad(QPainter& painter, const QRect& padRect, const QColor& color,
+                               int glow, const QColor& borderColor, bool round)
+{
+    // パッド本体
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(color);
+    if (round) {
+        painter.drawEllipse(padRect);
+    } else {
+        painter.drawRoundedRect(padRect, CORNER_RADIUS, CORNER_RADIUS);
+    }
+    
+    if (glow > 0) {
+        // 押された状態を表現するために、中央に明るい色で小さな四角を描画
+        painter.setBrush(glowColor(color, glow));
+        if (round) {
+            painter.drawEllipse(activeInnerRect(padRect));
+        } else {
+            painter.drawRoundedRect(activeInnerRect(padRect), CORNER_RADIUS, CORNER_RADIUS);
+        }
+    }
+    
+    // パッド境界線
+    painter.setPen(borderColor);
+    painter.setBrush(Qt::NoBrush);
+    if (round) {
+        painter.drawEllipse(padRect);
+    } else {
+        painter.drawRoundedRect(padRect, CORNER_RADIUS, CORNER_RADIUS);
+    }
+}
+
+QColor PadSpriteCache::glowColor(const QColor& color, int glow)
+{
+    const QColor lighter = color.lighter(150);
+    if (glow >= 255) {
+        return lighter;
+    }
+    
+    glow = qMax(glow, 0);
+    return QColor(
+        (color.red() * (255 - glow) + lighter.red() * glow) / 255,
+        (color.green() * (255 - glow) + lighter.green() * glow) / 255,
+        (color.blue() * (255 - glow) + lighter.blue() * glow) / 255);
+}
+
+QRect PadSpriteCache::activeInnerRect(const QRect& padRect)
+{
+    QRect innerRect = padRect;
+    innerRect.adjust(
+        padRect.width() * (1.0f - ACTIVE_SCALE) / 2,
+        padRect.height() * (1.0f - ACTIVE_SCALE) / 2,
+        -padRect.width() * (1.0f - ACTIVE_SCALE) / 2,
+        -padRect.height() * (1.0f - ACTIVE_SCALE) / 2
+    );
+    return innerRect;
+}
+
+PadSpriteCache::Key PadSpriteCache::makeKey(const QColor& color, int glow, const QColor& borderColor, bool round,
+                                            int padSize, qreal devicePixelRatio)
+{
+    // 1語目: [色 32bit][境界線の色 32bit]
+    // 2語目: [形状 1bit][明るさ 8bit][サイズ 16bit][ピクセル比x100 16bit]
+    const quint64 colors = (static_cast<quint64>(color.rgba()) << 32) | borderColor.rgba();
+    const quint64 ratio = static_cast<quint64>(qRound(devicePixelRatio * 100)) & 0xFFFF;
+    const quint64 layout = (static_cast<quint64>(round ? 1 : 0) << 40)
+                         | ((static_cast<quint64>(glow) & 0xFF) << 32)
+                         | ((static_cast<quint64>(padSize) & 0xFFFF) << 16) | ratio;
+    return Key(colors, layout);
+}
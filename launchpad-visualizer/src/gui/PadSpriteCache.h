@@ -0,0 +1,93 @@
+#ifndef PAD_SPRITE_CACHE_H
+#define PAD_SPRITE_CACHE_H
+
+#include <QColor>
+#include <QHash>
+#include <QPixmap>
+#include <QPair>
+#include <list>
+
+/**
+ * @brief 描画済みのパッド画像を保持するLRUキャッシュ
+ * パッドの角丸矩形はアンチエイリアス付きの描画が重いため、
+ * (色, アクティブ時の明るさ, 境界線の色, 形状, パッドサイズ, デバイスピクセル比) ごとに
+ * 一度だけ描画し、以降は画像の転送で済ませる
+ */
+class PadSpriteCache {
+public:
+    static constexpr int DEFAULT_CAPACITY = 256;  // 既定の最大保持数
+    static constexpr int MARGIN = 1;              // 境界線のはみ出し分の余白 (ピクセル)
+    static constexpr int CORNER_RADIUS = 5;       // パッドの角丸の半径 (論理ピクセル)
+
+    explicit PadSpriteCache(int capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief パッド画像を取得（なければ描画して追加）
+     * 画像はパッドの矩形より MARGIN だけ四方に大きい
+     * @param color パッドの色
+     * @param glow アクティブ時の明るさ (0-255、0は非アクティブ)
+     * @param borderColor 境界線の色
+     * @param round 丸いボタンとして描く場合true
+     * @param padSize パッドのサイズ (論理ピクセル)
+     * @param devicePixelRatio デバイスピクセル比
+     * @return パッド画像
+     */
+    const QPixmap& sprite(const QColor& color, int glow, const QColor& borderColor, bool round,
+                          int padSize, qreal devicePixelRatio);
+
+    /**
+     * @brief すべての画像を破棄
+     */
+    void clear();
+
+    /**
+     * @brief 保持している画像の数
+     */
+    int size() const;
+
+    /**
+     * @brief パッドを描画（キャッシュを使わない場合と共通の描画処理）
+     * @param painter 描画先
+     * @param padRect パッドの矩形
+     * @param color パッドの色
+     * @param glow アクティブ時の明るさ (0-255、0は非アクティブ)
+     * @param borderColor 境界線の色
+     * @param round 丸いボタンとして描く場合true（falseは角丸の四角）
+     */
+    static void renderPad(QPainter& painter, const QRect& padRect, const QColor& color,
+                          int glow, const QColor& borderColor, bool round);
+
+    /**
+     * @brief アクティブ時に内側の四角を描く色を求める
+     * @param color パッドの色
+     * @param glow 明るさ (0-255、255で最も明るい)
+     * @return パッドの色と明るい色を明るさで補間した色
+     */
+    static QColor glowColor(const QColor& color, int glow);
+
+    /**
+     * @brief アクティブ時に明るく描く内側の矩形を求める
+     * @param padRect パッドの矩形
+     */
+    static QRect activeInnerRect(const QRect& padRect);
+
+private:
+    /**
+     * @brief キャッシュのキーを作成
+     */
+    typedef QPair<quint64, quint64> Key;
+
+    static Key makeKey(const QColor& color, int glow, const QColor& borderColor, bool round,
+                       int padSize, qreal devicePixelRatio);
+
+    struct Entry {
+        Key key;
+        QPixmap pixmap;
+    };
+
+    int m_capacity;                                            // 最大保持数
+    std::list<Entry> m_entries;                                // 最近使った順 (先頭が最新)
+    QHash<Key, std::list<Entry>::iterator> m_index;            // キーから要素への索引
+};
+
+#endif // PAD_SPRITE_CACHE_H
@@ -0,0 +1,52 @@
+#include "RemoteViewer.h"
+#include "LaunchpadGrid.h"
+#include <QColor>
+
+RemoteViewer::RemoteViewer(QObject *parent)
+    : QObject(parent)
+    , m_grid(std::make_unique<LaunchpadGrid>(&m_model))
+{
+    for (bool& active : m_active) {
+        active = false;
+    }
+    
+    m_grid->resize(600, 600);
+    connect(&m_subscriber, &PadStateSubscriber::padChanged, this, &RemoteViewer::onPadChanged);
+    connect(&m_statusTimer, &QTimer::timeout, this, &RemoteViewer::updateStatus);
+}
+
+RemoteViewer::~RemoteViewer()
+{
+}
+
+bool RemoteViewer::start(quint16 port)
+{
+    if (!m_subscriber.listen(port)) {
+        return false;
+    }
+    
+    updateStatus();
+    m_statusTimer.start(STATUS_INTERVAL_MS);
+    m_grid->show();
+    return true;
+}
+
+void RemoteViewer::onPadChanged(int x, int y, uint32_t rgb, bool active)
+{
+    m_model.setPadColor(x, y, QColor::fromRgb(rgb));
+    
+    // 色だけが変わった場合に残光をやり直さないよう、押下状態は変化したときだけ伝える
+    bool& shown = m_active[PadStateModel::index(x, y)];
+    if (shown != active) {
+        shown = active;
+        m_model.setPadActive(x, y, active);
+    }
+}
+
+void RemoteViewer::updateStatus()
+{
+    m_grid->setWindowTitle(QString("Launchpad X Visualizer - リモートビュー (受信 %1 / 欠落 %2%3)")
+        .arg(static_cast<qulonglong>(m_subscriber.packetsReceived()))
+        .arg(static_cast<qulonglong>(m_subscriber.packetsLost()))
+        .arg(m_subscriber.isSynchronized() ? "" : " / 同期待ち"));
+}
@@ -0,0 +1,53 @@
+#ifndef REMOTE_VIEWER_H
+#define REMOTE_VIEWER_H
+
+#include <QObject>
+#include <QTimer>
+#include <cstdint>
+#include <memory>
+#include "PadDisplayModel.h"
+#include "../net/PadStateSubscriber.h"
+
+class LaunchpadGrid;
+
+/**
+ * @brief ネットワークで配信されたパッドの状態を表示するビューア
+ * MIDIデバイスを持たないマシンで、PadStatePublisherの配信をグリッドに映す。
+ * ウィンドウのタイトルに受信数・取りこぼし数・同期状態を表示する
+ */
+class RemoteViewer : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int STATUS_INTERVAL_MS = 1000;  // タイトルの更新間隔
+
+    explicit RemoteViewer(QObject *parent = nullptr);
+    ~RemoteViewer();
+
+    /**
+     * @brief 受信を開始してウィンドウを表示
+     * @param port 受信するポート
+     * @return 成功した場合true
+     */
+    bool start(quint16 port);
+
+private slots:
+    /**
+     * @brief 受信したパッドの変化を表示に反映
+     */
+    void onPadChanged(int x, int y, uint32_t rgb, bool active);
+
+    /**
+     * @brief ウィンドウのタイトルを更新
+     */
+    void updateStatus();
+
+private:
+    PadDisplayModel m_model;                 // 表示状態
+    std::unique_ptr<LaunchpadGrid> m_grid;   // 表示ウィンドウ
+    PadStateSubscriber m_subscriber;         // 受信
+    QTimer m_statusTimer;                    // タイトルの更新タイマー
+    bool m_active[PadStateModel::PAD_COUNT];    // 表示中の押下状態
+};
+
+#endif // REMOTE_VIEWER_H
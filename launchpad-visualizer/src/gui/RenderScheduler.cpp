@@ -0,0 +1,44 @@
+#include "RenderScheduler.h"
+
+RenderScheduler::RenderScheduler(QObject *parent)
+    : QObject(parent)
+    , m_lastFrameNs(-1)
+    , m_maxFrameRate(DEFAULT_MAX_FRAME_RATE)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &RenderScheduler::onTimeout);
+    m_clock.start();
+}
+
+void RenderScheduler::setMaxFrameRate(int fps)
+{
+    m_maxFrameRate = qBound(1, fps, 1000);
+}
+
+int RenderScheduler::maxFrameRate() const
+{
+    return m_maxFrameRate;
+}
+
+void RenderScheduler::requestFrame()
+{
+    if (m_timer.isActive()) {
+        return;  // 次のフレームにまとめる
+    }
+    
+    // 前回のフレームから最小間隔が経過するまで待つ
+    const qint64 frameIntervalNs = 1000000000LL / m_maxFrameRate;
+    qint64 delayNs = 0;
+    if (m_lastFrameNs >= 0) {
+        delayNs = m_lastFrameNs + frameIntervalNs - m_clock.nsecsElapsed();
+    }
+    
+    m_timer.start(delayNs > 0 ? static_cast<int>((delayNs + 999999) / 1000000) : 0);
+}
+
+void RenderScheduler::onTimeout()
+{
+    m_lastFrameNs = m_clock.nsecsElapsed();
+    emit frame();
+}
@@ -0,0 +1,56 @@
+#ifndef RENDER_SCHEDULER_H
+#define RENDER_SCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+/**
+ * @brief 再描画の要求をまとめ、フレームレートの上限を守ってフレームを発行するクラス
+ * 何度要求されても次のフレームで1回だけframeシグナルを発行する。
+ * 要求がない間はタイマーを止め、CPUを消費しない
+ */
+class RenderScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_MAX_FRAME_RATE = 60;  // 既定のフレームレート上限
+
+    explicit RenderScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief フレームレートの上限を設定
+     * @param fps 1秒あたりの最大フレーム数 (1-1000)
+     */
+    void setMaxFrameRate(int fps);
+
+    /**
+     * @brief フレームレートの上限を取得
+     */
+    int maxFrameRate() const;
+
+    /**
+     * @brief 次のフレームを要求（既に要求済みなら何もしない）
+     */
+    void requestFrame();
+
+signals:
+    /**
+     * @brief フレームの描画タイミングで発生するシグナル
+     */
+    void frame();
+
+private slots:
+    /**
+     * @brief フレームタイマーの満了
+     */
+    void onTimeout();
+
+private:
+    QTimer m_timer;          // 次のフレームまでの単発タイマー
+    QElapsedTimer m_clock;   // 前回のフレーム時刻の計測
+    qint64 m_lastFrameNs;    // 前回のフレーム時刻 (-1は未発行)
+    int m_maxFrameRate;      // フレームレートの上限
+};
+
+#endif // RENDER_SCHEDULER_H
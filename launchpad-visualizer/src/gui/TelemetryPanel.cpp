@@ -0,0 +1,83 @@
+#include "TelemetryPanel.h"
+#include "../LaunchpadVisualizer.h"
+#include <QGridLayout>
+
+TelemetryPanel::TelemetryPanel(const LaunchpadVisualizer* visualizer, QWidget *parent)
+    : QGroupBox("テレメトリ", parent)
+    , m_visualizer(visualizer)
+    , m_previousNs(0)
+{
+    QGridLayout* layout = new QGridLayout(this);
+    m_eventRateLabel = addField("イベント:", 0, 0);
+    m_lastPadLabel = addField("最後のパッド:", 0, 2);
+    m_queueLabel = addField("キュー (GUI / 記録):", 0, 4);
+    m_droppedLabel = addField("破棄:", 1, 0);
+    m_frameRateLabel = addField("描画:", 1, 2);
+    m_latencyLabel = addField("レイテンシ (p50 / p99):", 1, 4);
+    layout->setColumnStretch(1, 1);
+    layout->setColumnStretch(3, 1);
+    layout->setColumnStretch(5, 1);
+    
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(REFRESH_INTERVAL_MS);
+    connect(m_refreshTimer, &QTimer::timeout, this, &TelemetryPanel::refresh);
+}
+
+void TelemetryPanel::showEvent(QShowEvent *event)
+{
+    refresh();
+    m_refreshTimer->start();
+    QGroupBox::showEvent(event);
+}
+
+void TelemetryPanel::hideEvent(QHideEvent *event)
+{
+    m_refreshTimer->stop();
+    m_previousNs = 0;
+    QGroupBox::hideEvent(event);
+}
+
+void TelemetryPanel::refresh()
+{
+    const uint64_t nowNs = MidiEvent::now();
+    const Telemetry::Snapshot current = m_visualizer->telemetry()->snapshot();
+    
+    // レートは前回の読み出しからの差分で求める（初回は表示しない）
+    if (m_previousNs != 0 && nowNs > m_previousNs) {
+        const double seconds = (nowNs - m_previousNs) / 1e9;
+        m_eventRateLabel->setText(QString("%1 /秒")
+            .arg((current.eventCount - m_previous.eventCount) / seconds, 0, 'f', 0));
+        m_frameRateLabel->setText(QString("%1 fps")
+            .arg((current.frameCount - m_previous.frameCount) / seconds, 0, 'f', 1));
+    }
+    m_previous = current;
+    m_previousNs = nowNs;
+    
+    if (current.lastPadX >= 0) {
+        m_lastPadLabel->setText(current.lastVelocity > 0
+            ? QString("(%1, %2) ベロシティ %3").arg(current.lastPadX).arg(current.lastPadY).arg(current.lastVelocity)
+            : QString("(%1, %2) 離上").arg(current.lastPadX).arg(current.lastPadY));
+    }
+    m_queueLabel->setText(QString("%1 / %2")
+        .arg(current.pendingCount())
+        .arg(static_cast<qulonglong>(m_visualizer->recordingQueueDepth())));
+    m_droppedLabel->setText(QString::number(m_visualizer->droppedEventCount()));
+    
+    const LatencyHistogram::Snapshot latency =
+        m_visualizer->latencyTracker()->snapshot(LatencyTracker::EndToEnd);
+    if (latency.count > 0) {
+        m_latencyLabel->setText(QString("%1 / %2 ms")
+            .arg(latency.percentile(50) / 1e6, 0, 'f', 2)
+            .arg(latency.percentile(99) / 1e6, 0, 'f', 2));
+    }
+}
+
+QLabel* TelemetryPanel::addField(const QString& name, int row, int column)
+{
+    QGridLayout* grid = static_cast<QGridLayout*>(layout());
+    grid->addWidget(new QLabel(name, this), row, column);
+    
+    QLabel* value = new QLabel("-", this);
+    grid->addWidget(value, row, column + 1);
+    return value;
+}
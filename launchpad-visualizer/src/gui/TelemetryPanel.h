@@ -0,0 +1,66 @@
+#ifndef TELEMETRY_PANEL_H
+#define TELEMETRY_PANEL_H
+
+#include <QGroupBox>
+#include <QLabel>
+#include <QTimer>
+#include <cstdint>
+#include "../diag/Telemetry.h"
+
+class LaunchpadVisualizer;
+
+/**
+ * @brief 入力・描画の状態を一定間隔で表示するパネル
+ * イベントごとには何もせず、REFRESH_INTERVAL_MSごとにカウンターを読み出して
+ * 前回との差分からイベント数/秒と描画フレームレートを求める。
+ * 表示中のみ更新する
+ */
+class TelemetryPanel : public QGroupBox {
+    Q_OBJECT
+
+public:
+    static constexpr int REFRESH_INTERVAL_MS = 100;  // 表示の更新間隔 (10Hz)
+
+    explicit TelemetryPanel(const LaunchpadVisualizer* visualizer, QWidget *parent = nullptr);
+
+protected:
+    /**
+     * @brief 表示時に更新を開始
+     */
+    void showEvent(QShowEvent *event) override;
+
+    /**
+     * @brief 非表示時に更新を停止
+     */
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    /**
+     * @brief カウンターを読み出して表示を更新
+     */
+    void refresh();
+
+private:
+    /**
+     * @brief 項目名と値のラベルを追加
+     * @param name 項目名
+     * @param row 行
+     * @param column 列（項目名と値で2列を使う）
+     * @return 値のラベル
+     */
+    QLabel* addField(const QString& name, int row, int column);
+
+    const LaunchpadVisualizer* m_visualizer;  // 読み出し元
+    QTimer* m_refreshTimer;                   // 表示の更新タイマー
+    Telemetry::Snapshot m_previous;           // 前回のカウンター
+    uint64_t m_previousNs;                    // 前回の読み出し時刻 (0は未読み出し)
+
+    QLabel* m_eventRateLabel;   // イベント数/秒
+    QLabel* m_lastPadLabel;     // 最後に操作されたパッド
+    QLabel* m_queueLabel;       // GUIスレッド・記録のキューの深さ
+    QLabel* m_droppedLabel;     // 破棄したイベント数
+    QLabel* m_frameRateLabel;   // 描画フレームレート
+    QLabel* m_latencyLabel;     // 入力から描画までのレイテンシ
+};
+
+#endif // TELEMETRY_PANEL_H
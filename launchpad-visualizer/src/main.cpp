@@ -1,8 +1,149 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QDebug>
+#include <cstdio>
+#include <cstring>
 #include "gui/MainWindow.h"
 #include "LaunchpadVisualizer.h"
+#include "record/SessionIndexer.h"
+#include "record/SessionPlayer.h"
+#include "render/OfflineRenderer.h"
+#include "diag/TraceRecorder.h"
+#include "net/MetricsServer.h"
+#include "net/PadStatePublisher.h"
+#include "net/OscBridge.h"
+#include "net/SharedStateExporter.h"
+#include "net/EventStreamServer.h"
+#include "gui/RemoteViewer.h"
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+/**
+ * @brief 記録を映像フレームとして出力する
+ * --render <入力> [--output <出力|->] [--fps N] [--size WxH] [--format y4m|rgb24] [--threads N] [--grid N]
+ * @return 終了コード
+ */
+static int renderSession(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("記録したセッションを固定フレームレートの映像として出力します");
+    parser.addHelpOption();
+    const QCommandLineOption renderOption("render", "描画する記録ファイル (.lpvs/.mid)", "入力");
+    const QCommandLineOption outputOption(QStringList() << "o" << "output", "出力先（-は標準出力）", "出力", "-");
+    const QCommandLineOption fpsOption("fps", "フレームレート", "fps", "60");
+    const QCommandLineOption sizeOption("size", "フレームのサイズ", "幅x高さ", "1080x1080");
+    const QCommandLineOption formatOption("format", "出力形式 (y4m, rgb24)", "形式", "y4m");
+    const QCommandLineOption threadsOption("threads", "描画スレッド数（0はCPUコア数）", "数", "0");
+    const QCommandLineOption gridOption("grid", "表面の1辺のパッド数（複数台を並べた表示は16-64）", "数",
+                                        QString::number(PadDisplayModel::DEFAULT_GRID_SIZE));
+    parser.addOption(renderOption);
+    parser.addOption(outputOption);
+    parser.addOption(fpsOption);
+    parser.addOption(sizeOption);
+    parser.addOption(formatOption);
+    parser.addOption(threadsOption);
+    parser.addOption(gridOption);
+    parser.process(arguments);
+    
+    OfflineRenderer::Options options;
+    options.fps = parser.value(fpsOption).toInt();
+    options.threads = parser.value(threadsOption).toInt();
+    options.gridSize = parser.value(gridOption).toInt();
+    
+    const QStringList size = parser.value(sizeOption).split('x');
+    if (size.size() != 2 || size[0].toInt() <= 0 || size[1].toInt() <= 0) {
+        qWarning() << "フレームのサイズは 幅x高さ で指定してください:" << parser.value(sizeOption);
+        return 1;
+    }
+    options.size = QSize(size[0].toInt(), size[1].toInt());
+    
+    const QString format = parser.value(formatOption);
+    if (format == "rgb24") {
+        options.format = OfflineRenderer::Format::Rgb24;
+    } else if (format != "y4m") {
+        qWarning() << "未対応の出力形式です:" << format;
+        return 1;
+    }
+    if (options.fps <= 0) {
+        qWarning() << "フレームレートが不正です:" << parser.value(fpsOption);
+        return 1;
+    }
+    if (options.gridSize <= 0 || options.gridSize > PadDisplayModel::MAX_GRID_SIZE) {
+        qWarning() << "表面のサイズが不正です:" << parser.value(gridOption);
+        return 1;
+    }
+    
+    std::unique_ptr<PlaybackSource> source = SessionPlayer::openSource(parser.value(renderOption));
+    if (!source) {
+        qWarning() << "記録ファイルを開けません:" << parser.value(renderOption);
+        return 1;
+    }
+    
+    QFile output;
+    const QString outputPath = parser.value(outputOption);
+    if (outputPath == "-") {
+#ifdef Q_OS_WIN
+        // 改行の変換でフレームが壊れないようバイナリモードにする
+        _setmode(_fileno(stdout), _O_BINARY);
+        const bool opened = output.open(_fileno(stdout), QIODevice::WriteOnly);
+#else
+        const bool opened = output.open(fileno(stdout), QIODevice::WriteOnly);
+#endif
+        if (!opened) {
+            qWarning() << "標準出力を開けません";
+            return 1;
+        }
+    } else {
+        output.setFileName(outputPath);
+        if (!output.open(QIODevice::WriteOnly)) {
+            qWarning() << "出力ファイルを開けません:" << outputPath;
+            return 1;
+        }
+    }
+    
+    OfflineRenderer renderer(options);
+    const bool succeeded = renderer.render(*source, output);
+    output.close();
+    
+    // 標準出力は映像データなので、進捗はログ（標準エラー）に出す
+    qInfo() << "描画したフレーム数:" << renderer.framesWritten();
+    return succeeded ? 0 : 1;
+}
 
 int main(int argc, char *argv[]) {
+    // 既存の記録にキーフレームとインデックスを付与する: --reindex <入力> [出力]
+    if (argc >= 3 && std::strcmp(argv[1], "--reindex") == 0) {
+        QCoreApplication app(argc, argv);
+        const QString input = QString::fromLocal8Bit(argv[2]);
+        const QString output = argc >= 4 ? QString::fromLocal8Bit(argv[3]) : input;
+        return SessionIndexer::rebuild(input, output) ? 0 : 1;
+    }
+    
+    // 記録を映像フレームとして出力する: --render <入力> [オプション]
+    if (argc >= 3 && std::strcmp(argv[1], "--render") == 0) {
+        QCoreApplication app(argc, argv);
+        return renderSession(app.arguments());
+    }
+    
+    // 配信されたパッドの状態を表示する: --view <ポート>
+    if (argc >= 3 && std::strcmp(argv[1], "--view") == 0) {
+        QApplication app(argc, argv);
+        const int port = QString::fromLocal8Bit(argv[2]).toInt();
+        if (port <= 0 || port > 65535) {
+            qWarning() << "ポート番号が不正です:" << argv[2];
+            return 1;
+        }
+        RemoteViewer viewer;
+        if (!viewer.start(static_cast<quint16>(port))) {
+            return 1;
+        }
+        return app.exec();
+    }
+    
     QApplication app(argc, argv);
     
     // アプリケーション情報の設定
@@ -10,13 +151,82 @@ int main(int argc, char *argv[]) {
     QCoreApplication::setOrganizationName("LaunchpadTools");
     QCoreApplication::setApplicationVersion("0.1.0");
     
+    // ウィンドウやデバイスを用意する前に引数を解析する（--help と --version はここで表示して終了する）
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Launchpad X の入力をリアルタイムに表示します\n"
+                                     "記録の変換・描画・配信の表示は先頭の引数で切り替えます:\n"
+                                     "  --reindex <入力> [出力]\n"
+                                     "  --render <入力> [オプション]（--render --help で一覧）\n"
+                                     "  --view <ポート>");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.process(app);
+    
+    // 環境変数 LPV_TRACE に保存先があれば起動時からトレースを記録し、終了時に保存する
+    const QString tracePath = qEnvironmentVariable("LPV_TRACE");
+    if (!tracePath.isEmpty()) {
+        TraceRecorder::setThreadName("GUI");
+        TraceRecorder::setEnabled(true);
+    }
+    
     // メインアプリケーションクラスの初期化
     LaunchpadVisualizer visualizer;
     
+    // 環境変数 LPV_METRICS_PORT があればPrometheus形式のメトリクスをlocalhostで公開する
+    MetricsServer metricsServer(&visualizer);
+    const int metricsPort = qEnvironmentVariable("LPV_METRICS_PORT").toInt();
+    if (metricsPort > 0 && metricsPort <= 65535) {
+        metricsServer.listen(static_cast<quint16>(metricsPort));
+    }
+    
+    // 環境変数 LPV_BROADCAST があればパッドの状態をUDPで配信する（"アドレス:ポート" をカンマ区切り）
+    PadStatePublisher publisher(&visualizer);
+    const QString broadcastTargets = qEnvironmentVariable("LPV_BROADCAST");
+    if (!broadcastTargets.isEmpty()) {
+        for (const QString& target : broadcastTargets.split(',')) {
+            publisher.addSubscriber(target.trimmed());
+        }
+        publisher.start();
+    }
+    
+    // 環境変数 LPV_OSC_PORT でOSCの色の指定を受け付け、LPV_OSC_TARGET にパッドのイベントを送る
+    OscBridge oscBridge(&visualizer);
+    const int oscPort = qEnvironmentVariable("LPV_OSC_PORT").toInt();
+    if (oscPort > 0 && oscPort <= 65535) {
+        oscBridge.listen(static_cast<quint16>(oscPort));
+    }
+    const QString oscTargets = qEnvironmentVariable("LPV_OSC_TARGET");
+    if (!oscTargets.isEmpty()) {
+        for (const QString& target : oscTargets.split(',')) {
+            oscBridge.addTarget(target.trimmed());
+        }
+    }
+    
+    // 環境変数 LPV_SHM があればパッドの状態をその名前の共有メモリに書き出す
+    SharedStateExporter sharedState(&visualizer);
+    const QString sharedStateName = qEnvironmentVariable("LPV_SHM");
+    if (!sharedStateName.isEmpty()) {
+        sharedState.start(sharedStateName);
+    }
+    
+    // 環境変数 LPV_EVENT_SOCKET があればパッドのイベントをローカルソケットで配信する
+    EventStreamServer eventStream(&visualizer);
+    const QString eventSocket = qEnvironmentVariable("LPV_EVENT_SOCKET");
+    if (!eventSocket.isEmpty() && eventStream.listen(eventSocket)) {
+        metricsServer.setEventStream(&eventStream);
+    }
+    
+    // 環境変数 LPV_GRID_SIZE で表示する表面の1辺のパッド数を変える（複数台を並べた表示用）
+    const int gridSize = qEnvironmentVariable("LPV_GRID_SIZE").toInt();
+    
     // メインウィンドウの作成と表示
-    MainWindow mainWindow(&visualizer);
+    MainWindow mainWindow(&visualizer, gridSize > 0 ? gridSize : PadDisplayModel::DEFAULT_GRID_SIZE);
     mainWindow.show();
     
     // イベントループ開始
-    return app.exec();
+    const int result = app.exec();
+    if (!tracePath.isEmpty()) {
+        TraceRecorder::writeChromeTrace(tracePath);
+    }
+    return result;
 }
\ No newline at end of file
@@ -1,5 +1,4 @@
 #include "LaunchpadProtocol.h"
-#include <QDebug>
 
 LaunchpadProtocol::LaunchpadProtocol()
 {
@@ -7,54 +6,54 @@ LaunchpadProtocol::LaunchpadProtocol()
     // 注: これは仮のマッピングです。実際のLaunchpad Xの色マップは公式プログラマーリファレンスに基づいて実装する必要があります
     
     // 0: オフ
-    m_velocityColorMap[0] = QColor(0, 0, 0);
+    m_velocityColorMap[0] = packRgb(0, 0, 0);
     
     // 1-15: 低輝度の赤シェード
     for (int i = 1; i <= 15; i++) {
         int intensity = (i * 16) - 1;
-        m_velocityColorMap[i] = QColor(intensity, 0, 0);
+        m_velocityColorMap[i] = packRgb(intensity, 0, 0);
     }
     
     // 16-31: 低輝度の黄シェード
     for (int i = 16; i <= 31; i++) {
         int intensity = ((i - 16) * 16) - 1;
-        m_velocityColorMap[i] = QColor(intensity, intensity, 0);
+        m_velocityColorMap[i] = packRgb(intensity, intensity, 0);
     }
     
     // 32-47: 低輝度の緑シェード
     for (int i = 32; i <= 47; i++) {
         int intensity = ((i - 32) * 16) - 1;
-        m_velocityColorMap[i] = QColor(0, intensity, 0);
+        m_velocityColorMap[i] = packRgb(0, intensity, 0);
     }
     
     // 48-63: 低輝度の水色シェード
     for (int i = 48; i <= 63; i++) {
         int intensity = ((i - 48) * 16) - 1;
-        m_velocityColorMap[i] = QColor(0, intensity, intensity);
+        m_velocityColorMap[i] = packRgb(0, intensity, intensity);
     }
     
     // 64-79: 低輝度の青シェード
     for (int i = 64; i <= 79; i++) {
         int intensity = ((i - 64) * 16) - 1;
-        m_velocityColorMap[i] = QColor(0, 0, intensity);
+        m_velocityColorMap[i] = packRgb(0, 0, intensity);
     }
     
     // 80-95: 低輝度の紫シェード
     for (int i = 80; i <= 95; i++) {
         int intensity = ((i - 80) * 16) - 1;
-        m_velocityColorMap[i] = QColor(intensity, 0, intensity);
+        m_velocityColorMap[i] = packRgb(intensity, 0, intensity);
     }
     
     // 96-111: 高輝度の赤シェード
     for (int i = 96; i <= 111; i++) {
         int intensity = ((i - 96) * 16) + 127;
-        m_velocityColorMap[i] = QColor(intensity, 0, 0);
+        m_velocityColorMap[i] = packRgb(intensity, 0, 0);
     }
     
     // 112-127: 高輝度の白シェード
     for (int i = 112; i <= 127; i++) {
         int intensity = ((i - 112) * 16) + 127;
-        m_velocityColorMap[i] = QColor(intensity, intensity, intensity);
+        m_velocityColorMap[i] = packRgb(intensity, intensity, intensity);
     }
 }
 
@@ -63,7 +62,7 @@ LaunchpadProtocol::~LaunchpadProtocol()
     // 特に何もしない
 }
 
-QColor LaunchpadProtocol::velocityToColor(unsigned char velocity) const
+uint32_t LaunchpadProtocol::velocityToColor(unsigned char velocity) const
 {
     // ベロシティから色へのマッピングを検索
     auto it = m_velocityColorMap.find(velocity);
@@ -72,22 +71,22 @@ QColor LaunchpadProtocol::velocityToColor(unsigned char velocity) const
     }
     
     // マップにない場合は既定の色を返す
-    return QColor(0, 0, 0);
+    return 0;
 }
 
-unsigned char LaunchpadProtocol::colorToVelocity(const QColor& color) const
+unsigned char LaunchpadProtocol::colorToVelocity(uint32_t rgb) const
 {
     // 色から最も近いベロシティ値を検索
     unsigned char bestMatch = 0;
     int minDistance = 255 * 255 * 3; // 最大可能距離（R、G、B各成分の距離の二乗の和）
     
     for (const auto& entry : m_velocityColorMap) {
-        QColor mapColor = entry.second;
+        const uint32_t mapColor = entry.second;
         
         // RGB空間での距離を計算
-        int dr = mapColor.red() - color.red();
-        int dg = mapColor.green() - color.green();
-        int db = mapColor.blue() - color.blue();
+        int dr = static_cast<int>((mapColor >> 16) & 0xFF) - static_cast<int>((rgb >> 16) & 0xFF);
+        int dg = static_cast<int>((mapColor >> 8) & 0xFF) - static_cast<int>((rgb >> 8) & 0xFF);
+        int db = static_cast<int>(mapColor & 0xFF) - static_cast<int>(rgb & 0xFF);
         int distance = dr*dr + dg*dg + db*db;
         
         if (distance < minDistance) {
@@ -100,7 +99,7 @@ unsigned char LaunchpadProtocol::colorToVelocity(const QColor& color) const
 }
 
 bool LaunchpadProtocol::parseSysExColorMessage(const std::vector<unsigned char>& sysExData, 
-                                              int& x, int& y, QColor& color) const
+                                              int& x, int& y, uint32_t& rgb) const
 {
     // Launchpad X SysExカラーメッセージのフォーマット解析
     // 注: この実装は仮のもので、実際のLaunchpad XのSysEx仕様に基づいて実装する必要があります
@@ -137,7 +136,7 @@ bool LaunchpadProtocol::parseSysExColorMessage(const std::vector<unsigned char>&
     g = (g * 255) / 127;
     b = (b * 255) / 127;
     
-    color = QColor(r, g, b);
+    rgb = packRgb(r, g, b);
     
     return true;
 }
@@ -147,33 +146,65 @@ std::vector<unsigned char> LaunchpadProtocol::createRgbColorMessage(int x, int y
                                                                   unsigned char g, 
                                                                   unsigned char b) const
 {
-    // Launchpad X のRGB色設定SysExメッセージを生成
-    // 注: 実際のLaunchpad XのSysEx仕様に基づいて実装する必要があります
+    // F0 00 20 29 02 0C 03 [03] [LED index] [R] [G] [B] F7
+    std::vector<unsigned char> message;
+    appendLightingHeader(message);
+    if (!appendRgbSpec(message, x, y, r, g, b)) {
+        return std::vector<unsigned char>();
+    }
+    message.push_back(0xF7);   // SysEx終了
     
+    return message;
+}
+
+std::vector<unsigned char> LaunchpadProtocol::createRgbColorMessage(const PadColor* colors, std::size_t count) const
+{
+    // 1つのメッセージに複数のRGB指定を並べられる
     std::vector<unsigned char> message;
+    message.reserve(8 + count * 5);
+    appendLightingHeader(message);
     
-    // F0 00 20 29 02 0A [LED index] [R] [G] [B] F7
-    // 上記は仮のフォーマットで、実際のLaunchpad XのSysEx仕様に置き換える必要があります
+    bool any = false;
+    for (std::size_t i = 0; i < count; ++i) {
+        const uint32_t rgb = colors[i].rgb;
+        any |= appendRgbSpec(message, colors[i].x, colors[i].y,
+                             static_cast<unsigned char>(((rgb >> 16) & 0xFF) >> 1),
+                             static_cast<unsigned char>(((rgb >> 8) & 0xFF) >> 1),
+                             static_cast<unsigned char>((rgb & 0xFF) >> 1));
+    }
+    if (!any) {
+        return std::vector<unsigned char>();
+    }
+    message.push_back(0xF7);   // SysEx終了
     
+    return message;
+}
+
+void LaunchpadProtocol::appendLightingHeader(std::vector<unsigned char>& message)
+{
     message.push_back(0xF0);   // SysExスタート
-    message.push_back(0x00);   // Novation ID (仮)
+    message.push_back(0x00);   // Novation ID
     message.push_back(0x20);
     message.push_back(0x29);
-    message.push_back(0x02);   // Launchpad X ID (仮)
-    message.push_back(0x0A);   // RGB色設定コマンド (仮)
-    
-    // LED位置 (x, yから計算)
-    unsigned char ledIndex = (y << 4) | x;
-    message.push_back(ledIndex);
+    message.push_back(0x02);   // Launchpad X
+    message.push_back(0x0C);
+    message.push_back(0x03);   // LED点灯コマンド
+}
+
+bool LaunchpadProtocol::appendRgbSpec(std::vector<unsigned char>& message, int x, int y,
+                                      unsigned char r, unsigned char g, unsigned char b)
+{
+    if (x < 0 || x >= SURFACE_SIZE || y < 0 || y >= SURFACE_SIZE) {
+        return false;
+    }
     
-    // RGB値 (0-127に制限)
+    // LED位置はプログラマーモードのノート番号 (10の位が行、1の位が列)
+    message.push_back(LIGHTING_RGB);
+    message.push_back(static_cast<unsigned char>((y + 1) * 10 + (x + 1)));
     message.push_back(r & 0x7F);
     message.push_back(g & 0x7F);
     message.push_back(b & 0x7F);
-    
-    message.push_back(0xF7);   // SysEx終了
-    
-    return message;
+    return true;
 }
 
 bool LaunchpadProtocol::noteToXY(unsigned char note, int& x, int& y) const
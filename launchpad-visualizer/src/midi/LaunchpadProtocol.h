@@ -1,58 +1,80 @@
 #ifndef LAUNCHPAD_PROTOCOL_H
 #define LAUNCHPAD_PROTOCOL_H
 
-#include <QColor>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <map>
 
 /**
  * @brief Launchpad X の通信プロトコルを扱うクラス
- * Novation Launchpad X のMIDI通信プロトコルに関する処理を担当
+ * Novation Launchpad X のMIDI通信プロトコルに関する処理を担当。
+ * Qtに依存せず、色は 0x00RRGGBB の整数で扱う
  */
 class LaunchpadProtocol {
 public:
+    /**
+     * @brief 1つのパッドに設定する色
+     */
+    struct PadColor {
+        int x;         // X座標 (0-8)
+        int y;         // Y座標 (0-8)
+        uint32_t rgb;  // 色 (0x00RRGGBB)
+    };
+
     LaunchpadProtocol();
     ~LaunchpadProtocol();
 
     /**
      * @brief パッドのベロシティ値からRGB色を取得
      * @param velocity ベロシティ値 (0-127)
-     * @return 対応するRGB色
+     * @return 対応するRGB色 (0x00RRGGBB)
      */
-    QColor velocityToColor(unsigned char velocity) const;
+    uint32_t velocityToColor(unsigned char velocity) const;
 
     /**
      * @brief RGB色からベロシティ値に近似変換
-     * @param color RGB色
+     * @param rgb RGB色 (0x00RRGGBB)
      * @return 最も近いLaunchpadの色に対応するベロシティ値
      */
-    unsigned char colorToVelocity(const QColor& color) const;
+    unsigned char colorToVelocity(uint32_t rgb) const;
 
     /**
      * @brief SysExメッセージから色情報を解析
      * @param sysExData SysExメッセージデータ
      * @param x 出力X座標
      * @param y 出力Y座標
-     * @param color 出力色
+     * @param rgb 出力色 (0x00RRGGBB)
      * @return 解析成功の場合true
      */
     bool parseSysExColorMessage(const std::vector<unsigned char>& sysExData, 
-                                int& x, int& y, QColor& color) const;
+                                int& x, int& y, uint32_t& rgb) const;
 
     /**
      * @brief RGB値で指定されたパッドの色を設定するためのSysExメッセージを生成
-     * @param x X座標 (0-7)
-     * @param y Y座標 (0-7)
+     * プログラマーモードのLED点灯メッセージ (F0 00 20 29 02 0C 03 ... F7) を使う
+     * @param x X座標 (0-8、上段・右端のボタンを含む)
+     * @param y Y座標 (0-8)
      * @param r 赤成分 (0-127)
      * @param g 緑成分 (0-127)
      * @param b 青成分 (0-127)
-     * @return SysExメッセージ
+     * @return SysExメッセージ（座標が範囲外の場合は空）
      */
     std::vector<unsigned char> createRgbColorMessage(int x, int y, 
                                                     unsigned char r,
                                                     unsigned char g, 
                                                     unsigned char b) const;
 
+    /**
+     * @brief 複数のパッドの色を1つのSysExメッセージにまとめて生成
+     * 範囲外の座標は読み飛ばす
+     * @param colors 設定する色（各成分0-255を0-127に変換する）
+     * @param count 色の数
+     * @return SysExメッセージ（有効なパッドがない場合は空）
+     */
+    std::vector<unsigned char> createRgbColorMessage(const PadColor* colors, std::size_t count) const;
+
     /**
      * @brief ノート番号からXY座標への変換
      * @param note ノート番号
@@ -74,9 +96,33 @@ private:
     // Launchpad X の定数
     static constexpr int GRID_SIZE = 8;      // グリッドサイズ (8x8)
     static constexpr int MAX_BRIGHTNESS = 63; // 最大輝度
+    static constexpr int SURFACE_SIZE = 9;   // ボタンとロゴを含む表面のサイズ (9x9)
+    static constexpr unsigned char LIGHTING_RGB = 3;  // LED点灯メッセージのRGB指定
+
+    /**
+     * @brief LED点灯メッセージのヘッダー (F0 00 20 29 02 0C 03) を書き込む
+     */
+    static void appendLightingHeader(std::vector<unsigned char>& message);
+
+    /**
+     * @brief LED点灯メッセージにパッド1つ分のRGB指定を追加
+     * @return 座標が有効で追加した場合true
+     */
+    static bool appendRgbSpec(std::vector<unsigned char>& message, int x, int y,
+                              unsigned char r, unsigned char g, unsigned char b);
     
+    /**
+     * @brief 成分から 0x00RRGGBB の色を作る（各成分は0-255に丸める）
+     */
+    static uint32_t packRgb(int r, int g, int b)
+    {
+        return (static_cast<uint32_t>(std::clamp(r, 0, 255)) << 16)
+             | (static_cast<uint32_t>(std::clamp(g, 0, 255)) << 8)
+             | static_cast<uint32_t>(std::clamp(b, 0, 255));
+    }
+
     // 色マッピング用の内部テーブル
-    std::map<unsigned char, QColor> m_velocityColorMap; // ベロシティ→色マップ
+    std::map<unsigned char, uint32_t> m_velocityColorMap; // ベロシティ→色マップ
 };
 
 #endif // LAUNCHPAD_PROTOCOL_H
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "MidiClockTracker.h"
+#include <cmath>
+
+MidiClockTracker::MidiClockTracker()
+    : m_sequence(0)
+    , m_publishedTickNs(0)
+    , m_publishedPeriodNs(0.0)
+    , m_publishedTickCount(0)
+    , m_running(false)
+    , m_locked(false)
+{
+    reset();
+}
+
+void MidiClockTracker::reset()
+{
+    m_lastTickNs = 0;
+    m_estimatedTickNs = 0.0;
+    m_periodNs = 0.0;
+    m_tickCount = 0;
+    m_ticksSinceLock = 0;
+    m_running.store(false, std::memory_order_relaxed);
+    m_locked.store(false, std::memory_order_relaxed);
+    publish();
+}
+
+void MidiClockTracker::processMessage(unsigned char status, uint64_t timestampNs)
+{
+    switch (status) {
+    case 0xF8:  // タイミングクロック
+        processTick(timestampNs);
+        break;
+    case 0xFA:  // スタート: 次のティックが1拍目の先頭
+        m_tickCount = 0;
+        m_running.store(true, std::memory_order_relaxed);
+        publish();
+        break;
+    case 0xFB:  // コンティニュー: 位置を保持したまま再開
+        m_running.store(true, std::memory_order_relaxed);
+        break;
+    case 0xFC:  // ストップ
+        m_running.store(false, std::memory_order_relaxed);
+        break;
+    default:
+        break;
+    }
+}
+
+void MidiClockTracker::processTick(uint64_t timestampNs)
+{
+    const double tickNs = static_cast<double>(timestampNs);
+
+    if (m_lastTickNs == 0) {
+        // 最初のティック: 位相のみ合わせる
+        m_estimatedTickNs = tickNs;
+    } else {
+        const double intervalNs = static_cast<double>(timestampNs - m_lastTickNs);
+
+        if (m_periodNs <= 0.0) {
+            // 2番目のティック: 実測間隔を初期周期とする
+            if (intervalNs >= MIN_PERIOD_NS && intervalNs <= MAX_PERIOD_NS) {
+                m_periodNs = intervalNs;
+                m_ticksSinceLock = 1;
+            }
+            m_estimatedTickNs = tickNs;
+        } else {
+            const double predictedNs = m_estimatedTickNs + m_periodNs;
+            const double errorNs = tickNs - predictedNs;
+
+            if (std::fabs(errorNs) > m_periodNs) {
+                // クロックの中断やテンポの急変: 実測値から再同期する
+                m_periodNs = (intervalNs >= MIN_PERIOD_NS && intervalNs <= MAX_PERIOD_NS) ? intervalNs : 0.0;
+                m_estimatedTickNs = tickNs;
+                m_ticksSinceLock = m_periodNs > 0.0 ? 1 : 0;
+            } else {
+                // α-βフィルタで位相と周期を補正し、ティックごとのジッターを平滑化する
+                m_estimatedTickNs = predictedNs + PHASE_GAIN * errorNs;
+                m_periodNs += PERIOD_GAIN * errorNs;
+                if (m_periodNs < MIN_PERIOD_NS) {
+                    m_periodNs = MIN_PERIOD_NS;
+                } else if (m_periodNs > MAX_PERIOD_NS) {
+                    m_periodNs = MAX_PERIOD_NS;
+                }
+                if (m_ticksSinceLock < LOCK_TICKS) {
+                    ++m_ticksSinceLock;
+                }
+            }
+        }
+    }
+
+    m_lastTickNs = timestampNs;
+    ++m_tickCount;
+    m_locked.store(m_ticksSinceLock >= LOCK_TICKS, std::memory_order_relaxed);
+    publish();
+}
+
+void MidiClockTracker::publish()
+{
+    const uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_publishedTickNs.store(static_cast<uint64_t>(m_estimatedTickNs), std::memory_order_relaxed);
+    m_publishedPeriodNs.store(m_periodNs, std::memory_order_relaxed);
+    m_publishedTickCount.store(m_tickCount, std::memory_order_relaxed);
+
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool MidiClockTracker::isRunning() const
+{
+    return m_running.load(std::memory_order_relaxed);
+}
+
+bool MidiClockTracker::isLocked() const
+{
+    return m_locked.load(std::memory_order_relaxed);
+}
+
+double MidiClockTracker::bpm() const
+{
+    if (!isLocked()) {
+        return 0.0;
+    }
+
+    const double periodNs = m_publishedPeriodNs.load(std::memory_order_relaxed);
+    return periodNs > 0.0 ? 60e9 / (periodNs * PULSES_PER_QUARTER) : 0.0;
+}
+
+double MidiClockTracker::beatPhase(uint64_t nowNs) const
+{
+    if (!isLocked()) {
+        return 0.0;
+    }
+
+    uint64_t tickNs;
+    double periodNs;
+    uint64_t tickCount;
+    uint32_t before, after;
+    do {
+        before = m_sequence.load(std::memory_order_acquire);
+        tickNs = m_publishedTickNs.load(std::memory_order_relaxed);
+        periodNs = m_publishedPeriodNs.load(std::memory_order_relaxed);
+        tickCount = m_publishedTickCount.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = m_sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+
+    if (periodNs <= 0.0 || tickCount == 0) {
+        return 0.0;
+    }
+
+    // 最後のティックからの経過を1ティック未満に制限して補間する
+    double fraction = nowNs > tickNs ? static_cast<double>(nowNs - tickNs) / periodNs : 0.0;
+    if (fraction > 0.999) {
+        fraction = 0.999;
+    }
+
+    // スタート後の最初のティックが拍の先頭 (ティック番号0)
+    const double tickInBeat = static_cast<double>((tickCount - 1) % PULSES_PER_QUARTER) + fraction;
+    return tickInBeat / PULSES_PER_QUARTER;
+}
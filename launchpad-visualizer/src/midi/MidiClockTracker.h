@@ -0,0 +1,102 @@
+#ifndef MIDI_CLOCK_TRACKER_H
+#define MIDI_CLOCK_TRACKER_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief MIDIクロック (0xF8) からテンポと拍の位相を追従するクラス
+ *
+ * キャプチャスレッドでクロック・スタート・ストップ・コンティニューを処理し、
+ * 2次のPLL（位相と周期を補正するα-βフィルタ）でジッターを除いたクロック周期を推定する。
+ * 1ティックごとの処理は数回の演算のみで、シグナルは発行しない。
+ * 推定結果はシーケンスロックで公開し、描画側は任意の時刻の拍位相を計算できる
+ */
+class MidiClockTracker {
+public:
+    static constexpr int PULSES_PER_QUARTER = 24;  // MIDIクロックの分解能
+
+    MidiClockTracker();
+
+    /**
+     * @brief 追従状態を破棄
+     * キャプチャ・再生スレッドが停止している間に呼び出すこと
+     */
+    void reset();
+
+    /**
+     * @brief クロック関連のリアルタイムメッセージかどうかを判定
+     * @param status ステータスバイト
+     * @return 0xF8/0xFA/0xFB/0xFC の場合true
+     */
+    static bool isClockMessage(unsigned char status)
+    {
+        return status == 0xF8 || status == 0xFA || status == 0xFB || status == 0xFC;
+    }
+
+    /**
+     * @brief リアルタイムメッセージを処理（キャプチャスレッド）
+     * @param status ステータスバイト (0xF8/0xFA/0xFB/0xFC)
+     * @param timestampNs キャプチャ時刻
+     */
+    void processMessage(unsigned char status, uint64_t timestampNs);
+
+    /**
+     * @brief 送信側のシーケンサーが再生中かどうか
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief PLLがクロックに追従しているかどうか
+     */
+    bool isLocked() const;
+
+    /**
+     * @brief 推定テンポを取得
+     * @return BPM。追従していない場合は0
+     */
+    double bpm() const;
+
+    /**
+     * @brief 指定時刻の拍の位相を取得
+     * 最後のティックから1ティック分までは推定周期で補間する
+     * @param nowNs 時刻 (MidiEvent::now())
+     * @return 0.0以上1.0未満。追従していない場合は0
+     */
+    double beatPhase(uint64_t nowNs) const;
+
+private:
+    /**
+     * @brief クロック (0xF8) を1ティック処理
+     */
+    void processTick(uint64_t timestampNs);
+
+    /**
+     * @brief 現在の推定値を公開
+     */
+    void publish();
+
+private:
+    static constexpr double PHASE_GAIN = 0.1;      // 位相誤差の補正係数 (α)
+    static constexpr double PERIOD_GAIN = 0.005;   // 周期誤差の補正係数 (β)
+    static constexpr int LOCK_TICKS = PULSES_PER_QUARTER;  // 追従完了とみなすティック数
+    static constexpr double MIN_PERIOD_NS = 60e9 / (400.0 * PULSES_PER_QUARTER);  // 400 BPM
+    static constexpr double MAX_PERIOD_NS = 60e9 / (20.0 * PULSES_PER_QUARTER);   // 20 BPM
+
+    // 以下はキャプチャスレッドのみが扱う
+    uint64_t m_lastTickNs;    // 直前のティックのキャプチャ時刻 (0は未受信)
+    double m_estimatedTickNs; // PLLが推定した直前のティック時刻
+    double m_periodNs;        // PLLが推定したティック周期 (0は未推定)
+    uint64_t m_tickCount;     // スタートからのティック数
+    int m_ticksSinceLock;     // 再同期してからのティック数
+
+    // 公開する推定結果（m_sequenceが奇数の間は書き込み中）
+    std::atomic<uint32_t> m_sequence;
+    std::atomic<uint64_t> m_publishedTickNs;
+    std::atomic<double> m_publishedPeriodNs;
+    std::atomic<uint64_t> m_publishedTickCount;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_locked;
+};
+
+#endif // MIDI_CLOCK_TRACKER_H
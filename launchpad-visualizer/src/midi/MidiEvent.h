@@ -0,0 +1,62 @@
+#ifndef MIDI_EVENT_H
+#define MIDI_EVENT_H
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief キャプチャ時刻付きのMIDIメッセージ
+ * SysEx以外の短いメッセージ（最大3バイト）を固定長で保持する。
+ * スレッド間のリングバッファに載せるため、動的確保を伴わないPOD型とする
+ */
+struct MidiEvent {
+    uint64_t timestampNs;   // キャプチャ時刻 (steady_clock基準、ナノ秒)
+    unsigned char data[3];  // ステータスバイト + データバイト
+    unsigned char size;     // 有効バイト数 (1-3)
+
+    /**
+     * @brief ステータスバイトを取得
+     */
+    unsigned char status() const { return data[0]; }
+
+    /**
+     * @brief 現在の単調増加時刻を取得
+     * @return steady_clock基準のナノ秒
+     */
+    static uint64_t now()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+/**
+ * @brief ステータスバイトからメッセージ長を取得
+ * @param status ステータスバイト
+ * @return バイト数。SysExなど可変長のメッセージ、またはデータバイトの場合は0
+ */
+inline int midiMessageLength(unsigned char status)
+{
+    if (status < 0x80) {
+        return 0;  // データバイト
+    }
+    if (status < 0xF0) {
+        // チャンネルメッセージ: プログラムチェンジとチャンネルプレッシャーのみ2バイト
+        unsigned char type = status & 0xF0;
+        return (type == 0xC0 || type == 0xD0) ? 2 : 3;
+    }
+    switch (status) {
+    case 0xF0:  // SysEx開始
+    case 0xF7:  // SysEx終了
+        return 0;
+    case 0xF1:  // MTCクォーターフレーム
+    case 0xF3:  // ソングセレクト
+        return 2;
+    case 0xF2:  // ソングポジション
+        return 3;
+    default:    // チューンリクエスト、リアルタイムメッセージ
+        return 1;
+    }
+}
+
+#endif // MIDI_EVENT_H
@@ -0,0 +1,39 @@
+#include "MidiEventTap.h"
+
+MidiEventTap::MidiEventTap()
+    : m_enabled(false)
+    , m_droppedCount(0)
+{
+}
+
+void MidiEventTap::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool MidiEventTap::isEnabled() const
+{
+    return m_enabled.load(std::memory_order_relaxed);
+}
+
+bool MidiEventTap::tryPop(MidiEvent& event)
+{
+    return m_queue.tryPop(event);
+}
+
+uint64_t MidiEventTap::droppedCount() const
+{
+    return m_droppedCount.load(std::memory_order_relaxed);
+}
+
+void MidiEventTap::midiEventCaptured(const MidiEvent& event)
+{
+    if (!m_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // 取り出しが追いつかなくてもキャプチャスレッドは待たない
+    if (!m_queue.tryPush(event)) {
+        m_droppedCount.store(m_droppedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
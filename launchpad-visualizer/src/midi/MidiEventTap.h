@@ -0,0 +1,53 @@
+#ifndef MIDI_EVENT_TAP_H
+#define MIDI_EVENT_TAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "MidiInputListener.h"
+#include "../util/SpscRingBuffer.h"
+
+/**
+ * @brief キャプチャしたMIDIイベントを時刻付きのまま別のスレッドに渡すキュー
+ * 有効な間だけキャプチャスレッドでリングバッファに追加し、満杯なら破棄して数える。
+ * 取り出し側は1つのスレッドに限る
+ */
+class MidiEventTap : public MidiInputListener {
+public:
+    static constexpr std::size_t QUEUE_CAPACITY = 8192;  // キューの容量（2のべき乗）
+
+    MidiEventTap();
+
+    /**
+     * @brief キューへの追加を有効・無効にする
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief キューへの追加が有効かどうか
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief イベントを1つ取り出す（取り出し側のスレッドから）
+     * @return 空の場合false
+     */
+    bool tryPop(MidiEvent& event);
+
+    /**
+     * @brief キューが満杯で破棄したイベント数
+     */
+    uint64_t droppedCount() const;
+
+    /**
+     * @brief キャプチャスレッドから呼ばれる（キューへの追加のみ）
+     */
+    void midiEventCaptured(const MidiEvent& event) override;
+
+private:
+    SpscRingBuffer<MidiEvent, QUEUE_CAPACITY> m_queue;  // キャプチャスレッドからのキュー
+    std::atomic<bool> m_enabled;                        // キューへの追加が有効か
+    std::atomic<uint64_t> m_droppedCount;               // 破棄したイベント数
+};
+
+#endif // MIDI_EVENT_TAP_H
@@ -0,0 +1,22 @@
+#ifndef MIDI_INPUT_LISTENER_H
+#define MIDI_INPUT_LISTENER_H
+
+#include "MidiEvent.h"
+
+/**
+ * @brief MidiManagerのキャプチャスレッドでMIDIイベントを受け取るインターフェース
+ * RtMidiのコールバックスレッドから直接呼ばれるため、実装はロックや
+ * 動的確保を行わず、即座に戻ること
+ */
+class MidiInputListener {
+public:
+    virtual ~MidiInputListener() = default;
+
+    /**
+     * @brief MIDIイベントをキャプチャしたときに呼ばれる
+     * @param event キャプチャ時刻付きのイベント
+     */
+    virtual void midiEventCaptured(const MidiEvent& event) = 0;
+};
+
+#endif // MIDI_INPUT_LISTENER_H
@@ -1,13 +1,25 @@
 #include "MidiManager.h"
+#include "../diag/LatencyTracker.h"
+#include "../diag/Telemetry.h"
+#include "../diag/TraceRecorder.h"
 #include <QDebug>
+#include <QtConcurrent>
+#include <algorithm>
 
 MidiManager::MidiManager(QObject *parent)
     : QObject(parent)
     , m_isInitialized(false)
+    , m_latencyTracker(nullptr)
+    , m_telemetry(nullptr)
+    , m_portOpen(false)
 {
+    // RtMidiの呼び出しは1つのスレッドで順番に行う
+    m_devicePool.setMaxThreadCount(1);
+    
     try {
         // RtMidiインスタンス作成
         m_midiIn = std::make_unique<RtMidiIn>();
+        m_midiOut = std::make_unique<RtMidiOut>();
         m_isInitialized = true;
     } catch (RtMidiError &error) {
         qCritical() << "RtMidi初期化エラー:" << QString::fromStdString(error.getMessage());
@@ -17,6 +29,7 @@ MidiManager::MidiManager(QObject *parent)
 
 MidiManager::~MidiManager()
 {
+    waitForDeviceOperations();
     closeInputDevice();
 }
 
@@ -62,6 +75,7 @@ bool MidiManager::openInputDevice(int deviceIndex)
         }
         
         m_midiIn->openPort(deviceIndex);
+        m_portOpen.store(true);
         
         // コールバック関数を設定
         m_midiIn->setCallback(&MidiManager::midiCallback, this);
@@ -69,8 +83,11 @@ bool MidiManager::openInputDevice(int deviceIndex)
         // すべてのタイプのMIDIメッセージを受信
         m_midiIn->ignoreTypes(false, false, false);
         
-        QString deviceName = QString::fromStdString(m_midiIn->getPortName(deviceIndex));
-        qInfo() << "MIDI入力デバイスを開きました:" << deviceName;
+        const std::string portName = m_midiIn->getPortName(deviceIndex);
+        qInfo() << "MIDI入力デバイスを開きました:" << QString::fromStdString(portName);
+        
+        // LEDを点灯させるため、同じデバイスの出力も開いておく
+        openOutputFor(portName);
         return true;
     } catch (RtMidiError &error) {
         qWarning() << "MIDIデバイス接続エラー:" << QString::fromStdString(error.getMessage());
@@ -83,6 +100,10 @@ void MidiManager::closeInputDevice()
     if (m_isInitialized && m_midiIn->isPortOpen()) {
         try {
             m_midiIn->closePort();
+            m_portOpen.store(false);
+            closeOutput();
+            m_clockTracker.reset();
+            emit clockRunningChanged(false);
             qInfo() << "MIDI入力デバイスを閉じました";
         } catch (RtMidiError &error) {
             qWarning() << "MIDIデバイス切断エラー:" << QString::fromStdString(error.getMessage());
@@ -90,21 +111,164 @@ void MidiManager::closeInputDevice()
     }
 }
 
+QFuture<QStringList> MidiManager::getAvailableInputDevicesAsync()
+{
+    return QtConcurrent::run(&m_devicePool, this, &MidiManager::getAvailableInputDevices);
+}
+
+QFuture<bool> MidiManager::openInputDeviceAsync(int deviceIndex)
+{
+    return QtConcurrent::run(&m_devicePool, this, &MidiManager::openInputDevice, deviceIndex);
+}
+
+QFuture<void> MidiManager::closeInputDeviceAsync()
+{
+    return QtConcurrent::run(&m_devicePool, this, &MidiManager::closeInputDevice);
+}
+
+void MidiManager::waitForDeviceOperations()
+{
+    m_devicePool.waitForDone();
+}
+
 bool MidiManager::isInputDeviceOpen() const
 {
-    return m_isInitialized && m_midiIn->isPortOpen();
+    // 操作中のRtMidiに触れないよう、開閉時に更新したフラグを読む
+    return m_portOpen.load();
+}
+
+bool MidiManager::isOutputDeviceOpen() const
+{
+    std::lock_guard<std::mutex> lock(m_outputMutex);
+    return m_isInitialized && m_midiOut->isPortOpen();
+}
+
+bool MidiManager::sendMessage(const std::vector<unsigned char>& message)
+{
+    std::lock_guard<std::mutex> lock(m_outputMutex);
+    if (!m_isInitialized || !m_midiOut->isPortOpen() || message.empty()) {
+        return false;
+    }
+    
+    try {
+        m_midiOut->sendMessage(&message);
+        return true;
+    } catch (RtMidiError &error) {
+        qWarning() << "MIDI送信エラー:" << QString::fromStdString(error.getMessage());
+        return false;
+    }
+}
+
+void MidiManager::openOutputFor(const std::string& inputName)
+{
+    std::lock_guard<std::mutex> lock(m_outputMutex);
+    try {
+        if (m_midiOut->isPortOpen()) {
+            m_midiOut->closePort();
+        }
+        
+        // 同じ名前を優先し、なければ名前の一方が他方を含むポートを使う
+        const unsigned int portCount = m_midiOut->getPortCount();
+        int match = -1;
+        for (unsigned int i = 0; i < portCount && match < 0; ++i) {
+            if (m_midiOut->getPortName(i) == inputName) {
+                match = static_cast<int>(i);
+            }
+        }
+        for (unsigned int i = 0; i < portCount && match < 0; ++i) {
+            const std::string name = m_midiOut->getPortName(i);
+            if (name.find(inputName) != std::string::npos || inputName.find(name) != std::string::npos) {
+                match = static_cast<int>(i);
+            }
+        }
+        if (match < 0) {
+            qInfo() << "対応するMIDI出力ポートがないため、LEDの点灯は行いません";
+            return;
+        }
+        
+        m_midiOut->openPort(static_cast<unsigned int>(match));
+        qInfo() << "MIDI出力デバイスを開きました:" << QString::fromStdString(m_midiOut->getPortName(match));
+    } catch (RtMidiError &error) {
+        qWarning() << "MIDI出力の接続エラー:" << QString::fromStdString(error.getMessage());
+    }
+}
+
+void MidiManager::closeOutput()
+{
+    std::lock_guard<std::mutex> lock(m_outputMutex);
+    if (m_midiOut->isPortOpen()) {
+        m_midiOut->closePort();
+    }
+}
+
+void MidiManager::addInputListener(MidiInputListener* listener)
+{
+    if (listener && std::find(m_listeners.begin(), m_listeners.end(), listener) == m_listeners.end()) {
+        m_listeners.push_back(listener);
+    }
+}
+
+void MidiManager::removeInputListener(MidiInputListener* listener)
+{
+    m_listeners.erase(std::remove(m_listeners.begin(), m_listeners.end(), listener), m_listeners.end());
+}
+
+void MidiManager::setLatencyTracker(LatencyTracker* tracker)
+{
+    m_latencyTracker = tracker;
+}
+
+void MidiManager::setTelemetry(Telemetry* telemetry)
+{
+    m_telemetry = telemetry;
+}
+
+const MidiClockTracker& MidiManager::clockTracker() const
+{
+    return m_clockTracker;
+}
+
+void MidiManager::injectEvent(const MidiEvent& event)
+{
+    TRACE_SCOPE("midi.dispatch");
+    
+    // 24ppqnで届くクロックは追従処理だけに使い、記録やシグナル発行の対象にしない
+    if (MidiClockTracker::isClockMessage(event.status())) {
+        m_clockTracker.processMessage(event.status(), event.timestampNs);
+        if (event.status() != 0xF8) {
+            emit clockRunningChanged(m_clockTracker.isRunning());
+        }
+        return;
+    }
+    
+    for (MidiInputListener* listener : m_listeners) {
+        listener->midiEventCaptured(event);
+    }
+    
+    dispatchEvent(event);
+    
+    if (m_latencyTracker) {
+        m_latencyTracker->eventDispatched(event);
+    }
+    if (m_telemetry) {
+        m_telemetry->eventDispatched(event);
+    }
 }
 
 void MidiManager::midiCallback(double /*timeStamp*/, std::vector<unsigned char>* message, void* userData)
 {
+    // キャプチャ時刻はRtMidiの差分タイムスタンプではなく単調増加時刻で記録する
+    const uint64_t timestampNs = MidiEvent::now();
+    TRACE_THREAD_NAME("MIDI入力");
+
     // static関数からインスタンスメソッドを呼び出す
     if (userData && message) {
         MidiManager* midiManager = static_cast<MidiManager*>(userData);
-        midiManager->processMidiMessage(*message);
+        midiManager->processMidiMessage(*message, timestampNs);
     }
 }
 
-void MidiManager::processMidiMessage(const std::vector<unsigned char>& message)
+void MidiManager::processMidiMessage(const std::vector<unsigned char>& message, uint64_t timestampNs)
 {
     if (message.empty()) {
         return;
@@ -119,13 +283,26 @@ void MidiManager::processMidiMessage(const std::vector<unsigned char>& message)
         return;
     }
     
+    // 固定長のイベントに変換
+    MidiEvent event;
+    event.timestampNs = timestampNs;
+    event.size = static_cast<unsigned char>(std::min<std::size_t>(message.size(), sizeof(event.data)));
+    event.data[0] = status;
+    event.data[1] = event.size > 1 ? message[1] : 0;
+    event.data[2] = event.size > 2 ? message[2] : 0;
+    
+    injectEvent(event);
+}
+
+void MidiManager::dispatchEvent(const MidiEvent& event)
+{
     // チャンネルメッセージの種類を取得 (ステータスバイトの上位4ビット)
-    unsigned char messageType = status & 0xF0;
+    unsigned char messageType = event.status() & 0xF0;
     
     // Note Onメッセージ (ステータス 0x9n)
-    if (messageType == 0x90 && message.size() >= 3) {
-        unsigned char note = message[1];
-        unsigned char velocity = message[2];
+    if (messageType == 0x90 && event.size >= 3) {
+        unsigned char note = event.data[1];
+        unsigned char velocity = event.data[2];
         
         // ベロシティ0のNote Onはチャンネル・モードでのNote Offとして扱う
         if (velocity > 0) {
@@ -135,8 +312,12 @@ void MidiManager::processMidiMessage(const std::vector<unsigned char>& message)
         }
     }
     // Note Offメッセージ (ステータス 0x8n)
-    else if (messageType == 0x80 && message.size() >= 3) {
-        unsigned char note = message[1];
+    else if (messageType == 0x80 && event.size >= 3) {
+        unsigned char note = event.data[1];
         emit noteOffReceived(note);
     }
-}
\ No newline at end of file
+    // Control Changeメッセージ (ステータス 0xBn)
+    else if (messageType == 0xB0 && event.size >= 3) {
+        emit controlChangeReceived(event.data[1], event.data[2]);
+    }
+}
@@ -3,9 +3,19 @@
 
 #include <QObject>
 #include <QStringList>
+#include <QFuture>
+#include <QThreadPool>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <RtMidi.h>
+#include "MidiEvent.h"
+#include "MidiInputListener.h"
+#include "MidiClockTracker.h"
+
+class LatencyTracker;
+class Telemetry;
 
 /**
  * @brief MIDIデバイスとの通信を管理するクラス
@@ -19,12 +29,15 @@ public:
 
     /**
      * @brief 利用可能なMIDI入力デバイスのリストを取得
+     * ALSA/JACKでは数百ミリ秒かかることがあるため、GUIスレッドからは非同期版を使う。
+     * 非同期の操作と同時に呼び出さないこと
      * @return デバイス名のリスト
      */
     QStringList getAvailableInputDevices() const;
 
     /**
      * @brief MIDI入力デバイスを開く
+     * 非同期の操作と同時に呼び出さないこと
      * @param deviceIndex デバイスインデックス
      * @return 接続成功の場合true
      */
@@ -32,15 +45,98 @@ public:
 
     /**
      * @brief MIDI入力デバイスを閉じる
+     * 非同期の操作と同時に呼び出さないこと
      */
     void closeInputDevice();
 
+    /**
+     * @brief デバイス操作用のスレッドでMIDI入力デバイスを列挙
+     * デバイス操作は1つのスレッドで順番に実行されるため、互いに重ならない
+     * @return デバイス名のリスト
+     */
+    QFuture<QStringList> getAvailableInputDevicesAsync();
+
+    /**
+     * @brief デバイス操作用のスレッドでMIDI入力デバイスを開く
+     * @param deviceIndex デバイスインデックス
+     * @return 接続成功の場合true
+     */
+    QFuture<bool> openInputDeviceAsync(int deviceIndex);
+
+    /**
+     * @brief デバイス操作用のスレッドでMIDI入力デバイスを閉じる
+     */
+    QFuture<void> closeInputDeviceAsync();
+
+    /**
+     * @brief 実行中・実行待ちのデバイス操作がすべて終わるまで待つ
+     * 同期版の操作を呼び出す前に使う
+     */
+    void waitForDeviceOperations();
+
     /**
      * @brief MIDI入力デバイスが開いているかチェック
+     * デバイス操作中でも任意のスレッドから呼び出せる
      * @return 開いている場合true
      */
     bool isInputDeviceOpen() const;
 
+    /**
+     * @brief 入力デバイスと同じデバイスのMIDI出力が開いているかチェック
+     * 入力デバイスを開くときに同じ名前の出力ポートがあれば一緒に開く
+     */
+    bool isOutputDeviceOpen() const;
+
+    /**
+     * @brief デバイスにMIDIメッセージを送信（任意のスレッドから呼び出せる）
+     * @param message 送信するメッセージ（SysExも可）
+     * @return 送信した場合true（出力が開いていない場合false）
+     */
+    bool sendMessage(const std::vector<unsigned char>& message);
+
+    /**
+     * @brief キャプチャスレッドでイベントを受け取るリスナーを登録
+     * デバイスを開く前に登録すること
+     * @param listener リスナー（所有権は移らない）
+     */
+    void addInputListener(MidiInputListener* listener);
+
+    /**
+     * @brief 登録済みのリスナーを解除
+     * デバイスを閉じた状態で呼び出すこと
+     * @param listener リスナー
+     */
+    void removeInputListener(MidiInputListener* listener);
+
+    /**
+     * @brief レイテンシ計測器を設定
+     * デバイスを閉じた状態で呼び出すこと
+     * @param tracker 計測器（所有権は移らない。nullptrで計測しない）
+     */
+    void setLatencyTracker(LatencyTracker* tracker);
+
+    /**
+     * @brief 表示用のカウンターを設定
+     * デバイスを閉じた状態で呼び出すこと
+     * @param telemetry カウンター（所有権は移らない。nullptrで集計しない）
+     */
+    void setTelemetry(Telemetry* telemetry);
+
+    /**
+     * @brief MIDIクロックの追従状態を取得
+     * @return テンポと拍位相（任意のスレッドから読み出せる）
+     */
+    const MidiClockTracker& clockTracker() const;
+
+    /**
+     * @brief 外部からイベントを入力（記録の再生など）
+     * デバイスから受信した場合と同じくリスナーへの通知とシグナル発行を行う。
+     * クロック関連のリアルタイムメッセージはクロック追従のみに渡し、リスナーには通知しない。
+     * キャプチャスレッドと同時に呼び出さないこと
+     * @param event 入力するイベント
+     */
+    void injectEvent(const MidiEvent& event);
+
 signals:
     /**
      * @brief MIDI Note Onメッセージを受信したときのシグナル
@@ -55,12 +151,26 @@ signals:
      */
     void noteOffReceived(unsigned char note);
 
+    /**
+     * @brief MIDI Control Changeメッセージを受信したときのシグナル
+     * @param controller コントロール番号
+     * @param value 値
+     */
+    void controlChangeReceived(unsigned char controller, unsigned char value);
+
     /**
      * @brief MIDI SysExメッセージを受信したときのシグナル
      * @param data SysExデータ
      */
     void sysExReceived(const std::vector<unsigned char>& data);
 
+    /**
+     * @brief 外部MIDIクロックの再生状態が変化したときのシグナル
+     * スタート・ストップ・コンティニューでのみ発生し、ティックごとには発生しない
+     * @param running 再生中の場合true
+     */
+    void clockRunningChanged(bool running);
+
 private:
     /**
      * @brief RtMidiからのコールバック関数（静的）
@@ -69,12 +179,38 @@ private:
 
     /**
      * @brief MIDI入力データ処理メソッド
+     * @param message 受信メッセージ
+     * @param timestampNs キャプチャ時刻
+     */
+    void processMidiMessage(const std::vector<unsigned char>& message, uint64_t timestampNs);
+
+    /**
+     * @brief 短いMIDIメッセージをシグナルとして発行
+     */
+    void dispatchEvent(const MidiEvent& event);
+
+    /**
+     * @brief 入力ポートと同じデバイスの出力ポートを開く（見つからなければ何もしない）
+     * @param inputName 入力ポートの名前
+     */
+    void openOutputFor(const std::string& inputName);
+
+    /**
+     * @brief 出力ポートを閉じる
      */
-    void processMidiMessage(const std::vector<unsigned char>& message);
+    void closeOutput();
 
 private:
     std::unique_ptr<RtMidiIn> m_midiIn;  // MIDI入力デバイス
+    std::unique_ptr<RtMidiOut> m_midiOut; // MIDI出力デバイス（LEDの点灯用）
+    mutable std::mutex m_outputMutex;    // 出力の開閉と送信の排他
     bool m_isInitialized;  // 初期化フラグ
+    std::vector<MidiInputListener*> m_listeners;  // キャプチャスレッドのリスナー
+    LatencyTracker* m_latencyTracker;  // レイテンシ計測器
+    Telemetry* m_telemetry;            // 表示用のカウンター
+    QThreadPool m_devicePool;          // デバイス操作用のスレッド（1つ）
+    std::atomic<bool> m_portOpen;      // 入力ポートを開いているか
+    MidiClockTracker m_clockTracker;   // MIDIクロックの追従
 };
 
 #endif // MIDI_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "PadEnvelope.h"
+#include <algorithm>
+#include <cmath>
+
+PadEnvelope::PadEnvelope(int padCount)
+    : m_padCount(std::min(std::max(padCount, 1), CAPACITY))
+    , m_value(m_padCount)
+    , m_target(m_padCount)
+    , m_rate(m_padCount)
+    , m_stage(m_padCount)
+    , m_output(m_padCount)
+    , m_attackRate(0.0f)
+    , m_decayRate(0.0f)
+    , m_sustain(1.0f)
+    , m_releaseRate(0.0f)
+    , m_animating(0)
+    , m_lastNs(0)
+{
+    reset();
+    setTimes(0, 0, 1.0f, 0);
+}
+
+int PadEnvelope::padCount() const
+{
+    return m_padCount;
+}
+
+void PadEnvelope::setTimes(int attackMs, int decayMs, float sustain, int releaseMs)
+{
+    m_attackRate = rateFromMs(attackMs);
+    m_decayRate = rateFromMs(decayMs);
+    m_sustain = std::min(std::max(sustain, 0.0f), 1.0f);
+    m_releaseRate = rateFromMs(releaseMs);
+
+    // 変化中のパッドには新しい速度を反映する
+    for (int i = 0; i < m_padCount; ++i) {
+        if (m_stage[i] != Idle) {
+            enterStage(i, static_cast<Stage>(m_stage[i]));
+        }
+    }
+}
+
+void PadEnvelope::noteOn(int index, uint64_t nowNs)
+{
+    if (index < 0 || index >= m_padCount) {
+        return;
+    }
+
+    // 止まっていたエンベロープは押下時刻から進める
+    if (m_animating == 0) {
+        m_lastNs = nowNs;
+    }
+    if (m_stage[index] == Idle || m_stage[index] == Sustain) {
+        ++m_animating;
+    }
+    enterStage(index, Attack);
+}
+
+void PadEnvelope::noteOff(int index, uint64_t nowNs)
+{
+    if (index < 0 || index >= m_padCount || m_stage[index] == Idle || m_stage[index] == Release) {
+        return;
+    }
+
+    if (m_animating == 0) {
+        m_lastNs = nowNs;
+    }
+    if (m_stage[index] == Sustain) {
+        ++m_animating;
+    }
+    enterStage(index, Release);
+}
+
+void PadEnvelope::reset()
+{
+    std::fill(m_value.begin(), m_value.end(), 0.0f);
+    std::fill(m_target.begin(), m_target.end(), 0.0f);
+    std::fill(m_rate.begin(), m_rate.end(), 0.0f);
+    std::fill(m_stage.begin(), m_stage.end(), static_cast<uint8_t>(Idle));
+    std::fill(m_output.begin(), m_output.end(), static_cast<uint8_t>(0));
+    m_animating = 0;
+    m_lastNs = 0;
+}
+
+bool PadEnvelope::isAnimating() const
+{
+    return m_animating > 0;
+}
+
+void PadEnvelope::advance(uint64_t nowNs, PadMask& changed)
+{
+    if (m_animating == 0) {
+        return;
+    }
+
+    const float dt = nowNs > m_lastNs
+        ? std::min(static_cast<float>(nowNs - m_lastNs) * 1e-9f, MAX_STEP_SECONDS) : 0.0f;
+    m_lastNs = nowNs;
+
+    // 全パッドを目標値へ一定速度で近づける（停止中のパッドは速度0なので値は変わらない）
+    // 自動ベクトル化が効くよう、ループ内では生のポインタで扱う
+    float* value = m_value.data();
+    const float* target = m_target.data();
+    const float* rate = m_rate.data();
+    for (int i = 0; i < m_padCount; ++i) {
+        const float step = rate[i] * dt;
+        const float diff = target[i] - value[i];
+        const float moved = value[i] + std::min(std::max(diff, -step), step);
+        // 丸め誤差で目標に届かないことがないよう、届く場合は目標値をそのまま使う
+        value[i] = std::abs(diff) <= step ? target[i] : moved;
+    }
+
+    // 出力の段階が変わったパッドを記録し、目標に達したパッドの段階を進める
+    for (int i = 0; i < m_padCount; ++i) {
+        const uint8_t output = static_cast<uint8_t>(m_value[i] * LEVELS + 0.5f);
+        if (output != m_output[i]) {
+            m_output[i] = output;
+            changed.set(i);
+        }
+
+        if (m_value[i] != m_target[i]) {
+            continue;
+        }
+        switch (m_stage[i]) {
+        case Attack:
+            enterStage(i, Decay);
+            if (m_value[i] == m_target[i]) {
+                enterStage(i, Sustain);
+                --m_animating;
+            }
+            break;
+        case Decay:
+            enterStage(i, Sustain);
+            --m_animating;
+            break;
+        case Release:
+            enterStage(i, Idle);
+            --m_animating;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+int PadEnvelope::level(int index) const
+{
+    if (index < 0 || index >= m_padCount) {
+        return 0;
+    }
+    return m_output[index];
+}
+
+void PadEnvelope::enterStage(int index, Stage stage)
+{
+    m_stage[index] = stage;
+    switch (stage) {
+    case Attack:
+        m_target[index] = 1.0f;
+        m_rate[index] = m_attackRate;
+        break;
+    case Decay:
+        m_target[index] = m_sustain;
+        m_rate[index] = m_decayRate;
+        break;
+    case Release:
+        m_target[index] = 0.0f;
+        m_rate[index] = m_releaseRate;
+        break;
+    case Sustain:
+    case Idle:
+        m_target[index] = m_value[index];
+        m_rate[index] = 0.0f;
+        break;
+    }
+}
+
+float PadEnvelope::rateFromMs(int ms)
+{
+    // 0ミリ秒は1ステップで必ず目標に達する速度にする
+    if (ms <= 0) {
+        return 1.0f / 1e-9f;
+    }
+    return 1000.0f / ms;
+}
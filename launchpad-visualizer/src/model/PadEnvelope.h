@@ -0,0 +1,117 @@
+#ifndef PAD_ENVELOPE_H
+#define PAD_ENVELOPE_H
+
+#include <cstdint>
+#include <vector>
+#include "PadStateModel.h"
+#include "../util/PadMask.h"
+
+/**
+ * @brief パッドごとの明るさのエンベロープ（アタック/ディケイ/サステイン/リリース）
+ * 押下で明るくなり、離上後は徐々に消える残光表示に使う。
+ * 値は連続した配列に格納し、フレームごとに全パッドを1回の分岐のないループで
+ * 目標値へ近づけるため、コンパイラの自動ベクトル化が効く。
+ * 出力はLEVELS段階に量子化し、段階が変わったパッドだけを再描画の対象にする。
+ * 変化中のパッドがなければadvance()は何もしない。
+ * 配列は構築時のパッド数だけ確保する（最大CAPACITY）
+ */
+class PadEnvelope {
+public:
+    static constexpr int CAPACITY = PadMask::CAPACITY;  // 扱える最大パッド数
+    static constexpr int LEVELS = 16;                   // 出力の量子化段階数
+
+    /**
+     * @param padCount パッド数 (1-CAPACITY、既定は9x9の表面)
+     */
+    explicit PadEnvelope(int padCount = PadStateModel::PAD_COUNT);
+
+    /**
+     * @brief パッド数を取得
+     */
+    int padCount() const;
+
+    /**
+     * @brief エンベロープの時間を設定
+     * 0ミリ秒の段階は次のフレームで即座に目標に達する
+     * @param attackMs 0から最大まで上がる時間
+     * @param decayMs 最大からサステインまで下がる時間
+     * @param sustain 押下中に保つ明るさ (0.0-1.0)
+     * @param releaseMs 最大から0まで下がる時間
+     */
+    void setTimes(int attackMs, int decayMs, float sustain, int releaseMs);
+
+    /**
+     * @brief パッドの押下（アタックを開始）
+     * @param index パッドのインデックス
+     * @param nowNs 現在時刻 (ナノ秒)
+     */
+    void noteOn(int index, uint64_t nowNs);
+
+    /**
+     * @brief パッドの離上（リリースを開始）
+     * @param index パッドのインデックス
+     * @param nowNs 現在時刻 (ナノ秒)
+     */
+    void noteOff(int index, uint64_t nowNs);
+
+    /**
+     * @brief すべてのパッドを消灯した状態に戻す
+     */
+    void reset();
+
+    /**
+     * @brief 変化中のパッドがあるかどうか
+     */
+    bool isAnimating() const;
+
+    /**
+     * @brief 時刻を進めて全パッドの明るさを更新
+     * @param nowNs 現在時刻 (ナノ秒)
+     * @param changed 出力の段階が変わったパッドを追加する
+     */
+    void advance(uint64_t nowNs, PadMask& changed);
+
+    /**
+     * @brief 量子化した明るさを取得
+     * @param index パッドのインデックス
+     * @return 0-LEVELS
+     */
+    int level(int index) const;
+
+private:
+    enum Stage : uint8_t {
+        Idle,
+        Attack,
+        Decay,
+        Sustain,
+        Release
+    };
+
+    /**
+     * @brief 段階を切り替え、目標値と速度を設定
+     */
+    void enterStage(int index, Stage stage);
+
+    /**
+     * @brief 変化にかかる時間から1秒あたりの変化量を求める
+     */
+    static float rateFromMs(int ms);
+
+    static constexpr float MAX_STEP_SECONDS = 0.1f;  // 1フレームで進める最大時間
+
+    int m_padCount;                 // パッド数
+    std::vector<float> m_value;     // 現在の明るさ (0.0-1.0)
+    std::vector<float> m_target;    // 目標の明るさ
+    std::vector<float> m_rate;      // 1秒あたりの変化量
+    std::vector<uint8_t> m_stage;   // 現在の段階
+    std::vector<uint8_t> m_output;  // 量子化した明るさ
+
+    float m_attackRate;   // アタックの変化量
+    float m_decayRate;    // ディケイの変化量
+    float m_sustain;      // サステインの明るさ
+    float m_releaseRate;  // リリースの変化量
+    int m_animating;      // アタック/ディケイ/リリース中のパッド数
+    uint64_t m_lastNs;    // 最後に進めた時刻
+};
+
+#endif // PAD_ENVELOPE_H
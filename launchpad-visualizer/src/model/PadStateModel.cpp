@@ -0,0 +1,168 @@
+#include "PadStateModel.h"
+#include <cmath>
+#include <cstring>
+
+PadStateModel::PadStateModel()
+{
+    reset();
+}
+
+void PadStateModel::reset()
+{
+    std::memset(m_rgb, 0, sizeof(m_rgb));
+    std::memset(m_velocity, 0, sizeof(m_velocity));
+    std::memset(m_active, 0, sizeof(m_active));
+}
+
+void PadStateModel::press(int x, int y, uint8_t velocity)
+{
+    if (!isValidCoordinate(x, y)) {
+        return;
+    }
+
+    const int i = index(x, y);
+    m_active[i] = 1;
+    m_velocity[i] = velocity & 0x7F;
+    m_rgb[i] = velocityToRgb(velocity);
+}
+
+void PadStateModel::release(int x, int y)
+{
+    if (!isValidCoordinate(x, y)) {
+        return;
+    }
+
+    m_active[index(x, y)] = 0;
+}
+
+void PadStateModel::setColor(int x, int y, uint32_t rgb)
+{
+    if (!isValidCoordinate(x, y)) {
+        return;
+    }
+
+    m_rgb[index(x, y)] = rgb & 0xFFFFFF;
+}
+
+bool PadStateModel::applyEvent(const MidiEvent& event)
+{
+    int x, y;
+    if (!eventToXY(event, x, y)) {
+        return false;
+    }
+
+    // ベロシティ0のNote On、値0のコントロールチェンジは離上として扱う
+    const unsigned char type = event.status() & 0xF0;
+    if (type != 0x80 && event.data[2] > 0) {
+        press(x, y, event.data[2]);
+    } else {
+        release(x, y);
+    }
+    return true;
+}
+
+void PadStateModel::serialize(unsigned char* out) const
+{
+    for (int i = 0; i < PAD_COUNT; ++i) {
+        serializePad(i, out);
+        out += PAD_RECORD_SIZE;
+    }
+}
+
+void PadStateModel::deserialize(const unsigned char* in)
+{
+    for (int i = 0; i < PAD_COUNT; ++i) {
+        deserializePad(i, in);
+        in += PAD_RECORD_SIZE;
+    }
+}
+
+void PadStateModel::serializePad(int index, unsigned char* out) const
+{
+    out[0] = static_cast<unsigned char>(m_rgb[index] >> 16);
+    out[1] = static_cast<unsigned char>(m_rgb[index] >> 8);
+    out[2] = static_cast<unsigned char>(m_rgb[index]);
+    out[3] = static_cast<unsigned char>((m_active[index] ? 0x80 : 0) | (m_velocity[index] & 0x7F));
+}
+
+void PadStateModel::deserializePad(int index, const unsigned char* in)
+{
+    m_rgb[index] = (static_cast<uint32_t>(in[0]) << 16) | (static_cast<uint32_t>(in[1]) << 8) | in[2];
+    m_active[index] = (in[3] & 0x80) ? 1 : 0;
+    m_velocity[index] = in[3] & 0x7F;
+}
+
+bool PadStateModel::noteToXY(unsigned char note, int& x, int& y)
+{
+    // 11 12 ... 19
+    // 21 22 ... 29
+    // ...
+    // 91 92 ... 99
+    if (note < 11 || note > 99) {
+        return false;
+    }
+
+    const int row = (note / 10) - 1;
+    const int col = (note % 10) - 1;
+    if (!isValidCoordinate(col, row)) {
+        return false;  // 1の位が0の番号
+    }
+
+    x = col;
+    y = row;
+    return true;
+}
+
+bool PadStateModel::controlToXY(unsigned char controller, int& x, int& y)
+{
+    int col, row;
+    if (!noteToXY(controller, col, row)) {
+        return false;
+    }
+
+    // 8x8のパッドはノートだけを送る
+    if (col != GRID_SIZE - 1 && row != GRID_SIZE - 1) {
+        return false;
+    }
+
+    x = col;
+    y = row;
+    return true;
+}
+
+bool PadStateModel::eventToXY(const MidiEvent& event, int& x, int& y)
+{
+    if (event.size < 3) {
+        return false;
+    }
+
+    const unsigned char type = event.status() & 0xF0;
+    if (type == 0x90 || type == 0x80) {
+        return noteToXY(event.data[1], x, y);
+    }
+    if (type == 0xB0) {
+        return controlToXY(event.data[1], x, y);
+    }
+    return false;
+}
+
+uint32_t PadStateModel::velocityToRgb(uint8_t velocity)
+{
+    // 色相 = ベロシティ * 2 (度)、彩度・明度は最大
+    const double h = ((velocity * 2) % 360) / 60.0;
+    const int sector = static_cast<int>(h);
+    const double f = h - sector;
+    const uint32_t rising = static_cast<uint32_t>(std::lround(f * 255.0));
+    const uint32_t falling = 255 - rising;
+
+    uint32_t r = 0, g = 0, b = 0;
+    switch (sector) {
+    case 0: r = 255;     g = rising;  b = 0;       break;
+    case 1: r = falling; g = 255;     b = 0;       break;
+    case 2: r = 0;       g = 255;     b = rising;  break;
+    case 3: r = 0;       g = falling; b = 255;     break;
+    case 4: r = rising;  g = 0;       b = 255;     break;
+    default: r = 255;    g = 0;       b = falling; break;
+    }
+    return (r << 16) | (g << 8) | b;
+}
@@ -0,0 +1,147 @@
+#ifndef PAD_STATE_MODEL_H
+#define PAD_STATE_MODEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "../midi/MidiEvent.h"
+
+/**
+ * @brief Launchpad X の表面全体 (9x9) のパッド状態を保持するモデル
+ * Qtに依存しない値型で、各パッドの状態はパッドインデックス順の
+ * 連続した配列に格納する。インデックスは y * GRID_SIZE + x
+ */
+class PadStateModel {
+public:
+    static constexpr int GRID_SIZE = 9;                          // 表面のサイズ (9x9)
+    static constexpr int PAD_COUNT = GRID_SIZE * GRID_SIZE;      // パッド数
+    static constexpr std::size_t PAD_RECORD_SIZE = 4;            // パッド1つ分のシリアライズ後のサイズ (バイト)
+    static constexpr std::size_t SNAPSHOT_SIZE = PAD_COUNT * PAD_RECORD_SIZE;  // シリアライズ後のサイズ (バイト)
+
+    PadStateModel();
+
+    /**
+     * @brief すべてのパッドを消灯・非アクティブにする
+     */
+    void reset();
+
+    /**
+     * @brief パッドを押下状態にし、ベロシティから色を設定
+     * @param x X座標 (0-8)
+     * @param y Y座標 (0-8)
+     * @param velocity ベロシティ値 (1-127)
+     */
+    void press(int x, int y, uint8_t velocity);
+
+    /**
+     * @brief パッドを離上状態にする（色は保持）
+     * @param x X座標 (0-8)
+     * @param y Y座標 (0-8)
+     */
+    void release(int x, int y);
+
+    /**
+     * @brief パッドの色を設定
+     * @param x X座標 (0-8)
+     * @param y Y座標 (0-8)
+     * @param rgb 色 (0x00RRGGBB)
+     */
+    void setColor(int x, int y, uint32_t rgb);
+
+    /**
+     * @brief MIDIイベントを適用
+     * Note On/Offはパッド、コントロールチェンジは上段・右端のボタンとして扱う
+     * @param event 適用するイベント
+     * @return パッドの状態が変化した場合true
+     */
+    bool applyEvent(const MidiEvent& event);
+
+    /**
+     * @brief パッドの色を取得
+     * @return 色 (0x00RRGGBB)
+     */
+    uint32_t color(int x, int y) const { return m_rgb[index(x, y)]; }
+
+    /**
+     * @brief パッドが押下中かどうかを取得
+     */
+    bool isActive(int x, int y) const { return m_active[index(x, y)] != 0; }
+
+    /**
+     * @brief 最後に押されたときのベロシティを取得
+     */
+    uint8_t velocity(int x, int y) const { return m_velocity[index(x, y)]; }
+
+    /**
+     * @brief 状態をバイト列にシリアライズ
+     * パッドごとに [R][G][B][アクティブフラグ(0x80) | ベロシティ] の4バイト
+     * @param out 出力先 (SNAPSHOT_SIZEバイト)
+     */
+    void serialize(unsigned char* out) const;
+
+    /**
+     * @brief シリアライズされたバイト列から状態を復元
+     * @param in 入力 (SNAPSHOT_SIZEバイト)
+     */
+    void deserialize(const unsigned char* in);
+
+    /**
+     * @brief パッド1つの状態をシリアライズ（形式はserializeと同じ）
+     * @param index パッドインデックス
+     * @param out 出力先 (PAD_RECORD_SIZEバイト)
+     */
+    void serializePad(int index, unsigned char* out) const;
+
+    /**
+     * @brief シリアライズされたパッド1つの状態を復元
+     * @param index パッドインデックス
+     * @param in 入力 (PAD_RECORD_SIZEバイト)
+     */
+    void deserializePad(int index, const unsigned char* in);
+
+    /**
+     * @brief 座標が有効かチェック
+     */
+    static bool isValidCoordinate(int x, int y)
+    {
+        return x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE;
+    }
+
+    /**
+     * @brief 座標からパッドインデックスに変換
+     */
+    static int index(int x, int y) { return y * GRID_SIZE + x; }
+
+    /**
+     * @brief ノート番号から座標に変換 (10の位が行、1の位が列)
+     * @return 変換成功の場合true
+     */
+    static bool noteToXY(unsigned char note, int& x, int& y);
+
+    /**
+     * @brief コントロールチェンジ番号から座標に変換
+     * プログラマーモードでCCを送る上段 (91-98) と右端 (19-89) のボタンだけを受け付ける
+     * @return 変換成功の場合true
+     */
+    static bool controlToXY(unsigned char controller, int& x, int& y);
+
+    /**
+     * @brief パッドを操作するMIDIイベントから座標に変換
+     * @param event Note On/Off またはコントロールチェンジ
+     * @return パッドのイベントの場合true
+     */
+    static bool eventToXY(const MidiEvent& event, int& x, int& y);
+
+    /**
+     * @brief ベロシティから表示色を算出
+     * 色相をベロシティに比例させた最大彩度・最大明度の色
+     * @return 色 (0x00RRGGBB)
+     */
+    static uint32_t velocityToRgb(uint8_t velocity);
+
+private:
+    uint32_t m_rgb[PAD_COUNT];      // パッドの色
+    uint8_t m_velocity[PAD_COUNT];  // 最後のベロシティ
+    uint8_t m_active[PAD_COUNT];    // 押下中なら1
+};
+
+#endif // PAD_STATE_MODEL_H
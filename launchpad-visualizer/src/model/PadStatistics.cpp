@@ -0,0 +1,232 @@
+#include "PadStatistics.h"
+#include <cstring>
+
+namespace {
+constexpr uint64_t NS_PER_SECOND = 1000000000ULL;
+}
+
+PadStatistics::PadStatistics()
+{
+    reset();
+}
+
+void PadStatistics::reset()
+{
+    std::memset(m_hits, 0, sizeof(m_hits));
+    std::memset(m_velocitySum, 0, sizeof(m_velocitySum));
+    std::memset(m_maxVelocity, 0, sizeof(m_maxVelocity));
+    std::memset(m_pressStartNs, 0, sizeof(m_pressStartNs));
+    std::memset(m_holdSumNs, 0, sizeof(m_holdSumNs));
+    std::memset(m_holdCount, 0, sizeof(m_holdCount));
+    std::memset(m_maxHoldNs, 0, sizeof(m_maxHoldNs));
+    clearWindows();
+
+    m_firstHitNs = 0;
+    m_lastNs = 0;
+    m_currentSecond = 0;
+}
+
+void PadStatistics::clearWindows()
+{
+    std::memset(m_bucketHits, 0, sizeof(m_bucketHits));
+    std::memset(m_bucketVelocitySum, 0, sizeof(m_bucketVelocitySum));
+    std::memset(m_shortHits, 0, sizeof(m_shortHits));
+    std::memset(m_shortVelocitySum, 0, sizeof(m_shortVelocitySum));
+    std::memset(m_longHits, 0, sizeof(m_longHits));
+    std::memset(m_longVelocitySum, 0, sizeof(m_longVelocitySum));
+}
+
+void PadStatistics::notePressed(int x, int y, uint8_t velocity, uint64_t nowNs)
+{
+    if (!PadStateModel::isValidCoordinate(x, y)) {
+        return;
+    }
+
+    advance(nowNs);
+    if (m_firstHitNs == 0) {
+        m_firstHitNs = nowNs;
+    }
+
+    const int i = PadStateModel::index(x, y);
+    m_hits[i]++;
+    m_velocitySum[i] += velocity;
+    if (velocity > m_maxVelocity[i]) {
+        m_maxVelocity[i] = velocity;
+    }
+    m_pressStartNs[i] = nowNs;
+
+    const int slot = static_cast<int>(m_currentSecond % LONG_WINDOW_SECONDS);
+    if (m_bucketHits[slot][i] < UINT16_MAX) {
+        m_bucketHits[slot][i]++;
+        m_bucketVelocitySum[slot][i] += velocity;
+        m_shortHits[i]++;
+        m_shortVelocitySum[i] += velocity;
+        m_longHits[i]++;
+        m_longVelocitySum[i] += velocity;
+    }
+}
+
+void PadStatistics::noteReleased(int x, int y, uint64_t nowNs)
+{
+    if (!PadStateModel::isValidCoordinate(x, y)) {
+        return;
+    }
+
+    advance(nowNs);
+
+    const int i = PadStateModel::index(x, y);
+    if (m_pressStartNs[i] == 0) {
+        return;  // 集計開始前から押されていた
+    }
+
+    const uint64_t holdNs = nowNs > m_pressStartNs[i] ? nowNs - m_pressStartNs[i] : 0;
+    m_pressStartNs[i] = 0;
+    m_holdSumNs[i] += holdNs;
+    m_holdCount[i]++;
+    if (holdNs > m_maxHoldNs[i]) {
+        m_maxHoldNs[i] = holdNs;
+    }
+}
+
+void PadStatistics::advance(uint64_t nowNs)
+{
+    if (nowNs < m_lastNs) {
+        return;
+    }
+    m_lastNs = nowNs;
+
+    const uint64_t second = nowNs / NS_PER_SECOND;
+    if (m_currentSecond == 0) {
+        m_currentSecond = second;  // 最初の呼び出し
+        return;
+    }
+    advanceToSecond(second);
+}
+
+void PadStatistics::advanceToSecond(uint64_t second)
+{
+    if (second <= m_currentSecond) {
+        return;
+    }
+
+    // ウィンドウ全体より長く空いた場合はまとめて破棄する
+    if (second - m_currentSecond >= LONG_WINDOW_SECONDS) {
+        clearWindows();
+        m_currentSecond = second;
+        return;
+    }
+
+    while (m_currentSecond < second) {
+        ++m_currentSecond;
+
+        // 短いウィンドウから外れたバケットを差し引く
+        const int expiredShort = static_cast<int>((m_currentSecond - SHORT_WINDOW_SECONDS) % LONG_WINDOW_SECONDS);
+        for (int i = 0; i < PAD_COUNT; ++i) {
+            m_shortHits[i] -= m_bucketHits[expiredShort][i];
+            m_shortVelocitySum[i] -= m_bucketVelocitySum[expiredShort][i];
+        }
+
+        // 長いウィンドウから外れたバケットは新しい秒のバケットとして再利用する
+        const int slot = static_cast<int>(m_currentSecond % LONG_WINDOW_SECONDS);
+        for (int i = 0; i < PAD_COUNT; ++i) {
+            m_longHits[i] -= m_bucketHits[slot][i];
+            m_longVelocitySum[i] -= m_bucketVelocitySum[slot][i];
+            m_bucketHits[slot][i] = 0;
+            m_bucketVelocitySum[slot][i] = 0;
+        }
+    }
+}
+
+uint32_t PadStatistics::hitCount(int x, int y, Window window) const
+{
+    if (!PadStateModel::isValidCoordinate(x, y)) {
+        return 0;
+    }
+
+    const int i = PadStateModel::index(x, y);
+    switch (window) {
+    case Window::Last10s: return m_shortHits[i];
+    case Window::Last60s: return m_longHits[i];
+    default:              return m_hits[i];
+    }
+}
+
+double PadStatistics::meanVelocity(int x, int y, Window window) const
+{
+    if (!PadStateModel::isValidCoordinate(x, y)) {
+        return 0.0;
+    }
+
+    const int i = PadStateModel::index(x, y);
+    uint64_t hits = m_hits[i];
+    uint64_t sum = m_velocitySum[i];
+    if (window == Window::Last10s) {
+        hits = m_shortHits[i];
+        sum = m_shortVelocitySum[i];
+    } else if (window == Window::Last60s) {
+        hits = m_longHits[i];
+        sum = m_longVelocitySum[i];
+    }
+    return hits ? static_cast<double>(sum) / static_cast<double>(hits) : 0.0;
+}
+
+uint8_t PadStatistics::maxVelocity(int x, int y) const
+{
+    return PadStateModel::isValidCoordinate(x, y) ? m_maxVelocity[PadStateModel::index(x, y)] : 0;
+}
+
+uint64_t PadStatistics::meanHoldNs(int x, int y) const
+{
+    if (!PadStateModel::isValidCoordinate(x, y)) {
+        return 0;
+    }
+
+    const int i = PadStateModel::index(x, y);
+    return m_holdCount[i] ? m_holdSumNs[i] / m_holdCount[i] : 0;
+}
+
+uint64_t PadStatistics::maxHoldNs(int x, int y) const
+{
+    return PadStateModel::isValidCoordinate(x, y) ? m_maxHoldNs[PadStateModel::index(x, y)] : 0;
+}
+
+double PadStatistics::hitsPerMinute(int x, int y, Window window) const
+{
+    const double hits = static_cast<double>(hitCount(x, y, window));
+    switch (window) {
+    case Window::Last10s:
+        return hits * 60.0 / SHORT_WINDOW_SECONDS;
+    case Window::Last60s:
+        return hits * 60.0 / LONG_WINDOW_SECONDS;
+    default:
+        break;
+    }
+
+    if (m_firstHitNs == 0 || m_lastNs <= m_firstHitNs) {
+        return 0.0;
+    }
+    // 1分未満の間は1分として扱い、打ち始めの値が過大にならないようにする
+    double minutes = static_cast<double>(m_lastNs - m_firstHitNs) / (60.0 * NS_PER_SECOND);
+    if (minutes < 1.0) {
+        minutes = 1.0;
+    }
+    return hits / minutes;
+}
+
+uint32_t PadStatistics::maxHitCount(Window window) const
+{
+    const uint32_t* hits = m_hits;
+    if (window == Window::Last10s) {
+        hits = m_shortHits;
+    } else if (window == Window::Last60s) {
+        hits = m_longHits;
+    }
+
+    uint32_t maxHits = 0;
+    for (int i = 0; i < PAD_COUNT; ++i) {
+        if (hits[i] > maxHits) {
+            maxHits = hits[i];
+        }
+    }
+    return maxHits;
+}
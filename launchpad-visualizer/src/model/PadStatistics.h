@@ -0,0 +1,137 @@
+#ifndef PAD_STATISTICS_H
+#define PAD_STATISTICS_H
+
+#include <cstdint>
+#include "PadStateModel.h"
+
+/**
+ * @brief パッドごとの使用統計をイベントの到着に合わせて逐次集計するクラス
+ *
+ * 打鍵数・平均/最大ベロシティ・押下時間・毎分打鍵数を、パッドインデックス順の
+ * 連続した配列で保持する。各イベントの処理はO(1)。
+ * 直近10秒・直近60秒のスライディングウィンドウは1秒単位のバケットで管理し、
+ * 秒の境界をまたいだときに古いバケットの分をウィンドウの合計から差し引く
+ */
+class PadStatistics {
+public:
+    /**
+     * @brief 集計の範囲
+     */
+    enum class Window {
+        Total,    // 集計開始から
+        Last10s,  // 直近10秒
+        Last60s   // 直近60秒
+    };
+
+    static constexpr int SHORT_WINDOW_SECONDS = 10;  // 短いウィンドウの長さ
+    static constexpr int LONG_WINDOW_SECONDS = 60;   // 長いウィンドウの長さ (バケット数)
+
+    PadStatistics();
+
+    /**
+     * @brief すべての統計を破棄
+     */
+    void reset();
+
+    /**
+     * @brief パッドの押下を記録
+     * @param x X座標 (0-8)
+     * @param y Y座標 (0-8)
+     * @param velocity ベロシティ値 (1-127)
+     * @param nowNs 現在時刻 (MidiEvent::now())
+     */
+    void notePressed(int x, int y, uint8_t velocity, uint64_t nowNs);
+
+    /**
+     * @brief パッドの離上を記録（押下時間を集計）
+     * @param x X座標 (0-8)
+     * @param y Y座標 (0-8)
+     * @param nowNs 現在時刻 (MidiEvent::now())
+     */
+    void noteReleased(int x, int y, uint64_t nowNs);
+
+    /**
+     * @brief スライディングウィンドウを現在時刻まで進める
+     * イベントがない間もウィンドウを減衰させるため定期的に呼び出す
+     * @param nowNs 現在時刻 (MidiEvent::now())
+     */
+    void advance(uint64_t nowNs);
+
+    /**
+     * @brief 打鍵数を取得
+     */
+    uint32_t hitCount(int x, int y, Window window = Window::Total) const;
+
+    /**
+     * @brief 平均ベロシティを取得
+     * @return 平均値。打鍵がない場合は0
+     */
+    double meanVelocity(int x, int y, Window window = Window::Total) const;
+
+    /**
+     * @brief 最大ベロシティを取得（集計開始から）
+     */
+    uint8_t maxVelocity(int x, int y) const;
+
+    /**
+     * @brief 平均押下時間を取得（集計開始から）
+     * @return ナノ秒。離上が記録されていない場合は0
+     */
+    uint64_t meanHoldNs(int x, int y) const;
+
+    /**
+     * @brief 最長押下時間を取得（集計開始から）
+     * @return ナノ秒
+     */
+    uint64_t maxHoldNs(int x, int y) const;
+
+    /**
+     * @brief 毎分打鍵数を取得
+     * Totalの場合は最初の打鍵から最後に進めた時刻までの平均
+     */
+    double hitsPerMinute(int x, int y, Window window = Window::Total) const;
+
+    /**
+     * @brief 全パッドの中で最大の打鍵数を取得（ヒートマップの正規化用）
+     */
+    uint32_t maxHitCount(Window window = Window::Total) const;
+
+private:
+    /**
+     * @brief 指定した秒までバケットを進める
+     */
+    void advanceToSecond(uint64_t second);
+
+    /**
+     * @brief スライディングウィンドウをすべて空にする
+     */
+    void clearWindows();
+
+private:
+    static constexpr int PAD_COUNT = PadStateModel::PAD_COUNT;
+
+    // 集計開始からの値
+    uint32_t m_hits[PAD_COUNT];
+    uint64_t m_velocitySum[PAD_COUNT];
+    uint8_t m_maxVelocity[PAD_COUNT];
+    uint64_t m_pressStartNs[PAD_COUNT];  // 押下中の押下時刻 (0は離上中)
+    uint64_t m_holdSumNs[PAD_COUNT];
+    uint32_t m_holdCount[PAD_COUNT];
+    uint64_t m_maxHoldNs[PAD_COUNT];
+
+    // 1秒単位のバケット (秒 % LONG_WINDOW_SECONDS 番目)
+    uint16_t m_bucketHits[LONG_WINDOW_SECONDS][PAD_COUNT];
+    uint32_t m_bucketVelocitySum[LONG_WINDOW_SECONDS][PAD_COUNT];
+
+    // ウィンドウごとの合計
+    uint32_t m_shortHits[PAD_COUNT];
+    uint32_t m_shortVelocitySum[PAD_COUNT];
+    uint32_t m_longHits[PAD_COUNT];
+    uint32_t m_longVelocitySum[PAD_COUNT];
+
+    uint64_t m_firstHitNs;     // 最初の打鍵時刻 (0は未打鍵)
+    uint64_t m_lastNs;         // 最後に進めた時刻
+    uint64_t m_currentSecond;  // 現在のバケットの秒
+};
+
+#endif // PAD_STATISTICS_H
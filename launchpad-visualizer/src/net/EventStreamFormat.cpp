@@ -0,0 +1,75 @@
+#include "EventStreamFormat.h"
+
+namespace EventStreamFormat {
+
+bool Subscription::matches(const Event& event) const
+{
+    if (event.type == GAP) {
+        return true;
+    }
+    if (event.type < PRESS || event.type > PRESSURE || !(typeMask & (1u << (event.type - 1)))) {
+        return false;
+    }
+    if (event.x == NO_PAD) {
+        return true;
+    }
+    return event.x >= x0 && event.x <= x1 && event.y >= y0 && event.y <= y1;
+}
+
+void encode(const Event& event, unsigned char* out)
+{
+    out[0] = event.type;
+    out[1] = event.x;
+    out[2] = event.y;
+    out[3] = event.value;
+    for (int i = 0; i < 4; ++i) {
+        out[4 + i] = static_cast<unsigned char>(event.data >> (8 * i));
+    }
+    for (int i = 0; i < 8; ++i) {
+        out[8 + i] = static_cast<unsigned char>(event.timestampNs >> (8 * i));
+    }
+}
+
+void decode(const unsigned char* data, Event& event)
+{
+    event.type = data[0];
+    event.x = data[1];
+    event.y = data[2];
+    event.value = data[3];
+    event.data = 0;
+    for (int i = 0; i < 4; ++i) {
+        event.data |= static_cast<uint32_t>(data[4 + i]) << (8 * i);
+    }
+    event.timestampNs = 0;
+    for (int i = 0; i < 8; ++i) {
+        event.timestampNs |= static_cast<uint64_t>(data[8 + i]) << (8 * i);
+    }
+}
+
+void encodeSubscription(const Subscription& subscription, unsigned char* out)
+{
+    out[0] = static_cast<unsigned char>(SUBSCRIBE_TAG);
+    out[1] = VERSION;
+    out[2] = subscription.typeMask;
+    out[3] = subscription.flags;
+    out[4] = subscription.x0;
+    out[5] = subscription.y0;
+    out[6] = subscription.x1;
+    out[7] = subscription.y1;
+}
+
+bool decodeSubscription(const unsigned char* data, Subscription& subscription)
+{
+    if (data[0] != static_cast<unsigned char>(SUBSCRIBE_TAG) || data[1] != VERSION) {
+        return false;
+    }
+    subscription.typeMask = data[2] & TYPE_MASK_ALL;
+    subscription.flags = data[3];
+    subscription.x0 = data[4];
+    subscription.y0 = data[5];
+    subscription.x1 = data[6];
+    subscription.y1 = data[7];
+    return subscription.x0 <= subscription.x1 && subscription.y0 <= subscription.y1;
+}
+
+} // namespace EventStreamFormat
@@ -0,0 +1,106 @@
+#ifndef EVENT_STREAM_FORMAT_H
+#define EVENT_STREAM_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief ローカルソケットで配信するイベントストリームのフォーマット定義
+ *
+ * 購読要求 (クライアント → サーバー、SUBSCRIBE_SIZEバイト。送り直すとフィルターを変更できる)
+ *   [0]     'S'
+ *   [1]     バージョン
+ *   [2]     受け取るイベントの種類 (bit0: 押下, bit1: 離上, bit2: 色, bit3: プレッシャー)
+ *   [3]     フラグ (bit0: キューが溢れたら切断する。0ならイベントを捨ててGAPで知らせる)
+ *   [4-7]   受け取るパッドの範囲 x0, y0, x1, y1 (両端を含む、0-8)
+ *
+ * イベント (サーバー → クライアント、RECORD_SIZEバイトの固定長、発生順)
+ *   [0]     種類 (EventType)
+ *   [1-2]   パッドの座標 x, y (パッドに対応しないものはNO_PAD)
+ *   [3]     値 (押下はベロシティ、プレッシャーは圧力、それ以外は0)
+ *   [4-7]   データ (色は0x00RRGGBB、GAPは捨てたイベント数。リトルエンディアン)
+ *   [8-15]  時刻 (キャプチャ時刻、steady_clock基準のナノ秒。リトルエンディアン)
+ */
+namespace EventStreamFormat {
+
+constexpr char SUBSCRIBE_TAG = 'S';
+constexpr uint8_t VERSION = 1;
+constexpr std::size_t SUBSCRIBE_SIZE = 8;
+constexpr std::size_t RECORD_SIZE = 16;
+constexpr uint8_t NO_PAD = 0xFF;
+constexpr uint8_t FLAG_DISCONNECT_ON_OVERFLOW = 0x01;
+
+/**
+ * @brief イベントの種類
+ */
+enum EventType : uint8_t {
+    PRESS = 1,     // パッドの押下
+    RELEASE = 2,   // パッドの離上
+    COLOR = 3,     // パッドの色の変化
+    PRESSURE = 4,  // プレッシャー（ポリフォニック、またはチャンネル全体でNO_PAD）
+    GAP = 0x7F     // キューが溢れてイベントを捨てた（フィルターに関係なく届く）
+};
+
+constexpr uint8_t TYPE_MASK_ALL = 0x0F;
+
+/**
+ * @brief 1つのイベント
+ */
+struct Event {
+    uint64_t timestampNs;  // 時刻
+    uint32_t data;         // 色または捨てたイベント数
+    uint8_t type;          // EventType
+    uint8_t x;             // X座標 (0-8 またはNO_PAD)
+    uint8_t y;             // Y座標 (0-8 またはNO_PAD)
+    uint8_t value;         // ベロシティまたは圧力
+};
+
+/**
+ * @brief 購読の条件
+ */
+struct Subscription {
+    uint8_t typeMask = TYPE_MASK_ALL;  // 受け取る種類
+    uint8_t flags = 0;                 // FLAG_*
+    uint8_t x0 = 0;                    // 範囲の左下
+    uint8_t y0 = 0;
+    uint8_t x1 = 8;                    // 範囲の右上
+    uint8_t y1 = 8;
+
+    /**
+     * @brief イベントが条件に合うか
+     */
+    bool matches(const Event& event) const;
+};
+
+/**
+ * @brief イベントを書き込む
+ * @param event イベント
+ * @param out 出力先 (RECORD_SIZEバイト)
+ */
+void encode(const Event& event, unsigned char* out);
+
+/**
+ * @brief イベントを読む
+ * @param data RECORD_SIZEバイトのデータ
+ * @param event 出力先
+ */
+void decode(const unsigned char* data, Event& event);
+
+/**
+ * @brief 購読要求を書き込む
+ * @param subscription 購読の条件
+ * @param out 出力先 (SUBSCRIBE_SIZEバイト)
+ */
+void encodeSubscription(const Subscription& subscription, unsigned char* out);
+
+/**
+ * @brief 購読要求を読む
+ * @param data SUBSCRIBE_SIZEバイトのデータ
+ * @param subscription 出力先
+ * @return 正しい要求の場合true
+ */
+bool decodeSubscription(const unsigned char* data, Subscription& subscription);
+
+} // namespace EventStreamFormat
+
+#endif // EVENT_STREAM_FORMAT_H
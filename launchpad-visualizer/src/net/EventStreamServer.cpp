@@ -0,0 +1,363 @@
+#include "EventStreamServer.h"
+#include "../LaunchpadVisualizer.h"
+#include "../midi/MidiEventTap.h"
+#include <QLocalSocket>
+#include <QDebug>
+#include <algorithm>
+
+using EventStreamFormat::Event;
+
+EventStreamServer::EventStreamServer(LaunchpadVisualizer* visualizer, QObject *parent)
+    : QObject(parent)
+    , m_visualizer(visualizer)
+    , m_tap(visualizer->eventTap())
+    , m_nextClientId(1)
+    , m_slowDisconnectCount(0)
+{
+    m_drainTimer.setTimerType(Qt::PreciseTimer);
+    m_drainTimer.setInterval(DRAIN_INTERVAL_MS);
+    connect(&m_drainTimer, &QTimer::timeout, this, &EventStreamServer::drain);
+    connect(&m_server, &QLocalServer::newConnection, this, &EventStreamServer::onNewConnection);
+    connect(m_visualizer, &LaunchpadVisualizer::padColorChanged, this, &EventStreamServer::onPadColorChanged);
+}
+
+EventStreamServer::~EventStreamServer()
+{
+    close();
+}
+
+bool EventStreamServer::listen(const QString& name)
+{
+    QLocalServer::removeServer(name);
+    m_server.setSocketOptions(QLocalServer::UserAccessOption);
+    if (!m_server.listen(name)) {
+        qWarning() << "イベント配信の待ち受けを開始できません:" << m_server.errorString();
+        return false;
+    }
+    qInfo() << "パッドのイベントを配信しています:" << m_server.fullServerName();
+    return true;
+}
+
+void EventStreamServer::close()
+{
+    for (const std::unique_ptr<Client>& client : m_clients) {
+        if (client->socket) {
+            closeClient(*client, "サーバーの停止");
+        }
+    }
+    removeClosedClients();
+    m_drainTimer.stop();
+    m_server.close();
+}
+
+std::vector<EventStreamServer::ClientStats> EventStreamServer::clientStats() const
+{
+    const uint64_t nowNs = MidiEvent::now();
+    std::vector<ClientStats> stats;
+    stats.reserve(m_clients.size());
+    for (const std::unique_ptr<Client>& client : m_clients) {
+        if (client->socket) {
+            stats.push_back(statsFor(*client, nowNs));
+        }
+    }
+    return stats;
+}
+
+uint64_t EventStreamServer::slowDisconnectCount() const
+{
+    return m_slowDisconnectCount;
+}
+
+uint64_t EventStreamServer::ingestDroppedCount() const
+{
+    return m_tap->droppedCount();
+}
+
+void EventStreamServer::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server.nextPendingConnection()) {
+        // キューはここで確保し、配信中は確保しない
+        std::unique_ptr<Client> client(new Client());
+        client->id = m_nextClientId++;
+        client->socket = socket;
+        client->subscribed = false;
+        client->queue.reset(new EventQueue());
+        client->pendingGap = 0;
+        client->sentCount = 0;
+        client->droppedCount = 0;
+        client->maxLagNs = 0;
+        m_clients.push_back(std::move(client));
+
+        connect(socket, &QLocalSocket::readyRead, this, &EventStreamServer::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, &EventStreamServer::onDisconnected);
+        connect(socket, &QLocalSocket::bytesWritten, this, &EventStreamServer::onBytesWritten);
+    }
+    if (!m_drainTimer.isActive()) {
+        m_drainTimer.start();
+    }
+}
+
+void EventStreamServer::onReadyRead()
+{
+    Client* client = findClient(qobject_cast<QLocalSocket*>(sender()));
+    if (!client) {
+        return;
+    }
+
+    // 購読要求は固定長。送り直された場合は最後の要求を使う
+    while (client->socket && client->socket->bytesAvailable() >= static_cast<qint64>(EventStreamFormat::SUBSCRIBE_SIZE)) {
+        unsigned char request[EventStreamFormat::SUBSCRIBE_SIZE];
+        client->socket->read(reinterpret_cast<char*>(request), sizeof(request));
+        EventStreamFormat::Subscription subscription;
+        if (!EventStreamFormat::decodeSubscription(request, subscription)) {
+            closeClient(*client, "不正な購読要求");
+            break;
+        }
+        client->subscription = subscription;
+        if (!client->subscribed) {
+            client->subscribed = true;
+            qInfo() << "イベント配信のクライアント" << client->id << "が購読を開始しました";
+        }
+    }
+    updateTapEnabled();
+}
+
+void EventStreamServer::onDisconnected()
+{
+    Client* client = findClient(qobject_cast<QLocalSocket*>(sender()));
+    if (client) {
+        closeClient(*client, "クライアントが切断");
+    }
+}
+
+void EventStreamServer::onBytesWritten()
+{
+    Client* client = findClient(qobject_cast<QLocalSocket*>(sender()));
+    if (client) {
+        flushClient(*client);
+    }
+}
+
+void EventStreamServer::onPadColorChanged(int x, int y, uint32_t rgb)
+{
+    if (!m_tap->isEnabled()) {
+        return;
+    }
+
+    // 色の変化のきっかけになった押下をすでにキューから配信しておく
+    drainTap();
+
+    Event event;
+    event.timestampNs = MidiEvent::now();
+    event.data = rgb;
+    event.type = EventStreamFormat::COLOR;
+    event.x = static_cast<uint8_t>(x);
+    event.y = static_cast<uint8_t>(y);
+    event.value = 0;
+    dispatch(event);
+}
+
+void EventStreamServer::drain()
+{
+    drainTap();
+
+    const uint64_t nowNs = MidiEvent::now();
+    for (const std::unique_ptr<Client>& client : m_clients) {
+        if (!client->socket) {
+            continue;
+        }
+        flushClient(*client);
+
+        // 送信が追いつかないクライアントは、入力を待たせずに切り離す
+        const ClientStats stats = statsFor(*client, nowNs);
+        client->maxLagNs = std::max(client->maxLagNs, stats.lagNs);
+        if (stats.lagNs > static_cast<uint64_t>(MAX_LAG_MS) * 1000000ULL) {
+            ++m_slowDisconnectCount;
+            closeClient(*client, "遅延が上限を超えたため切断");
+        }
+    }
+    removeClosedClients();
+
+    if (m_clients.empty()) {
+        m_drainTimer.stop();
+    }
+}
+
+void EventStreamServer::drainTap()
+{
+    MidiEvent midi;
+    while (m_tap->tryPop(midi)) {
+        Event event;
+        if (toStreamEvent(midi, event)) {
+            dispatch(event);
+        }
+    }
+}
+
+void EventStreamServer::dispatch(const Event& event)
+{
+    for (const std::unique_ptr<Client>& client : m_clients) {
+        if (client->socket && client->subscribed && client->subscription.matches(event)) {
+            enqueue(*client, event);
+        }
+    }
+}
+
+void EventStreamServer::enqueue(Client& client, const Event& event)
+{
+    // 捨てたイベントがあれば、その位置にGAPを入れてから続ける
+    if (client.pendingGap > 0) {
+        Event gap;
+        gap.timestampNs = event.timestampNs;
+        gap.data = client.pendingGap;
+        gap.type = EventStreamFormat::GAP;
+        gap.x = EventStreamFormat::NO_PAD;
+        gap.y = EventStreamFormat::NO_PAD;
+        gap.value = 0;
+        if (client.queue->tryPush(gap)) {
+            client.pendingGap = 0;
+        }
+    }
+
+    if (client.pendingGap == 0 && client.queue->tryPush(event)) {
+        return;
+    }
+
+    ++client.droppedCount;
+    if (client.subscription.flags & EventStreamFormat::FLAG_DISCONNECT_ON_OVERFLOW) {
+        ++m_slowDisconnectCount;
+        closeClient(client, "キューが溢れたため切断");
+        return;
+    }
+    ++client.pendingGap;
+}
+
+void EventStreamServer::flushClient(Client& client)
+{
+    unsigned char buffer[WRITE_BATCH * EventStreamFormat::RECORD_SIZE];
+    while (client.socket && client.socket->bytesToWrite() < MAX_SOCKET_BACKLOG) {
+        int count = 0;
+        Event event;
+        while (count < WRITE_BATCH && client.queue->tryPop(event)) {
+            EventStreamFormat::encode(event, buffer + count * EventStreamFormat::RECORD_SIZE);
+            ++count;
+        }
+        if (count == 0) {
+            break;
+        }
+        client.socket->write(reinterpret_cast<const char*>(buffer),
+                             static_cast<qint64>(count) * EventStreamFormat::RECORD_SIZE);
+        client.sentCount += static_cast<uint64_t>(count);
+    }
+}
+
+void EventStreamServer::closeClient(Client& client, const char* reason)
+{
+    if (!client.socket) {
+        return;
+    }
+
+    const ClientStats stats = statsFor(client, MidiEvent::now());
+    qInfo().noquote() << QString("イベント配信のクライアント%1: %2 (送信 %3、破棄 %4、最大遅延 %5 ms)")
+        .arg(client.id)
+        .arg(QString::fromUtf8(reason))
+        .arg(stats.sentCount)
+        .arg(stats.droppedCount)
+        .arg(stats.maxLagNs / 1e6, 0, 'f', 1);
+
+    // 切断のシグナルで再びここに来ないよう、先に接続を外す
+    QLocalSocket* socket = client.socket;
+    client.socket = nullptr;
+    socket->disconnect(this);
+    socket->abort();
+    socket->deleteLater();
+    updateTapEnabled();
+}
+
+void EventStreamServer::removeClosedClients()
+{
+    m_clients.erase(std::remove_if(m_clients.begin(), m_clients.end(),
+                                   [](const std::unique_ptr<Client>& client) { return !client->socket; }),
+                    m_clients.end());
+}
+
+void EventStreamServer::updateTapEnabled()
+{
+    bool subscribed = false;
+    for (const std::unique_ptr<Client>& client : m_clients) {
+        subscribed = subscribed || (client->socket && client->subscribed);
+    }
+    if (subscribed == m_tap->isEnabled()) {
+        return;
+    }
+
+    // 購読者がいない間に残ったイベントは配信しない
+    if (subscribed) {
+        MidiEvent stale;
+        while (m_tap->tryPop(stale)) {
+        }
+    }
+    m_tap->setEnabled(subscribed);
+}
+
+EventStreamServer::Client* EventStreamServer::findClient(QLocalSocket* socket)
+{
+    if (!socket) {
+        return nullptr;
+    }
+    for (const std::unique_ptr<Client>& client : m_clients) {
+        if (client->socket == socket) {
+            return client.get();
+        }
+    }
+    return nullptr;
+}
+
+EventStreamServer::ClientStats EventStreamServer::statsFor(const Client& client, uint64_t nowNs) const
+{
+    ClientStats stats;
+    stats.id = client.id;
+    stats.queueDepth = client.queue->size();
+    stats.socketBacklog = client.socket ? client.socket->bytesToWrite() : 0;
+    const Event* oldest = client.queue->front();
+    stats.lagNs = oldest && nowNs > oldest->timestampNs ? nowNs - oldest->timestampNs : 0;
+    stats.maxLagNs = std::max(client.maxLagNs, stats.lagNs);
+    stats.sentCount = client.sentCount;
+    stats.droppedCount = client.droppedCount;
+    return stats;
+}
+
+bool EventStreamServer::toStreamEvent(const MidiEvent& midi, Event& event)
+{
+    event.timestampNs = midi.timestampNs;
+    event.data = 0;
+    event.x = EventStreamFormat::NO_PAD;
+    event.y = EventStreamFormat::NO_PAD;
+    event.value = 0;
+
+    const unsigned char type = midi.status() & 0xF0;
+    int x, y;
+    if (type == 0xA0 && midi.size >= 3) {
+        // ポリフォニックプレッシャー
+        if (!PadStateModel::noteToXY(midi.data[1], x, y)) {
+            return false;
+        }
+        event.type = EventStreamFormat::PRESSURE;
+        event.value = midi.data[2];
+    } else if (type == 0xD0 && midi.size >= 2) {
+        // チャンネルプレッシャー（パッドに対応しない）
+        event.type = EventStreamFormat::PRESSURE;
+        event.value = midi.data[1];
+        return true;
+    } else if (PadStateModel::eventToXY(midi, x, y)) {
+        // ベロシティ0のNote On、値0のコントロールチェンジは離上として扱う
+        const bool press = type != 0x80 && midi.data[2] > 0;
+        event.type = press ? EventStreamFormat::PRESS : EventStreamFormat::RELEASE;
+        event.value = press ? midi.data[2] : 0;
+    } else {
+        return false;
+    }
+    event.x = static_cast<uint8_t>(x);
+    event.y = static_cast<uint8_t>(y);
+    return true;
+}
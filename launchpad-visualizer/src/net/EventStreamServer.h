@@ -0,0 +1,177 @@
+#ifndef EVENT_STREAM_SERVER_H
+#define EVENT_STREAM_SERVER_H
+
+#include <QObject>
+#include <QLocalServer>
+#include <QString>
+#include <QTimer>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "EventStreamFormat.h"
+#include "../util/SpscRingBuffer.h"
+
+class LaunchpadVisualizer;
+class MidiEventTap;
+struct MidiEvent;
+class QLocalSocket;
+
+/**
+ * @brief パッドのイベントを発生順に配信するローカルソケット (Unixドメインソケット) のサーバー
+ * キャプチャしたイベント（押下・離上・プレッシャー）は時刻付きのままMidiEventTapから受け取り、
+ * 色の変化と合わせてクライアントごとのリングバッファに入れる。ソケットへの書き込みは
+ * 送信バッファが空いている分だけ行い、読み出しが遅いクライアントのために入力側が待つことはない。
+ * キューが溢れたクライアントはイベントを捨ててGAPで知らせるか（要求による）切断し、
+ * 遅延がMAX_LAG_MSを超えたクライアントは切断する
+ */
+class EventStreamServer : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr std::size_t CLIENT_QUEUE_CAPACITY = 4096;  // クライアントごとのキューの容量
+    static constexpr int DRAIN_INTERVAL_MS = 2;                 // キューを送る間隔
+    static constexpr int MAX_LAG_MS = 2000;                     // これ以上遅れたクライアントは切断する
+    static constexpr qint64 MAX_SOCKET_BACKLOG = 64 * 1024;     // ソケットに積む未送信バイト数の上限
+    static constexpr int WRITE_BATCH = 256;                     // 1回の書き込みにまとめるイベント数
+
+    /**
+     * @brief クライアントごとの計測値
+     */
+    struct ClientStats {
+        int id;                  // クライアント番号（接続順）
+        std::size_t queueDepth;  // キューに残っているイベント数
+        qint64 socketBacklog;    // ソケットの未送信バイト数
+        uint64_t lagNs;          // キューの先頭のイベントの遅れ
+        uint64_t maxLagNs;       // 接続してからの最大の遅れ
+        uint64_t sentCount;      // 送ったイベント数
+        uint64_t droppedCount;   // キューが溢れて捨てたイベント数
+    };
+
+    explicit EventStreamServer(LaunchpadVisualizer* visualizer, QObject *parent = nullptr);
+    ~EventStreamServer();
+
+    /**
+     * @brief 待ち受けを開始
+     * 前回の異常終了で残ったソケットファイルは削除してから作り直す
+     * @param name ソケットの名前またはパス
+     * @return 成功した場合true
+     */
+    bool listen(const QString& name);
+
+    /**
+     * @brief 待ち受けを停止し、すべてのクライアントを切断
+     */
+    void close();
+
+    /**
+     * @brief 接続中のクライアントの計測値を取得
+     */
+    std::vector<ClientStats> clientStats() const;
+
+    /**
+     * @brief 遅れやキューの溢れで切断したクライアント数
+     */
+    uint64_t slowDisconnectCount() const;
+
+    /**
+     * @brief キャプチャスレッドからのキューが溢れて捨てたイベント数
+     */
+    uint64_t ingestDroppedCount() const;
+
+private slots:
+    void onNewConnection();
+
+    /**
+     * @brief 購読要求を読む
+     */
+    void onReadyRead();
+
+    void onDisconnected();
+
+    /**
+     * @brief ソケットに空きができたらキューの続きを送る
+     */
+    void onBytesWritten();
+
+    /**
+     * @brief 色の変化を配信（先にそれまでのキャプチャしたイベントを配信して順序を保つ）
+     */
+    void onPadColorChanged(int x, int y, uint32_t rgb);
+
+    /**
+     * @brief キャプチャしたイベントを配信し、各クライアントのキューを送る
+     */
+    void drain();
+
+private:
+    using EventQueue = SpscRingBuffer<EventStreamFormat::Event, CLIENT_QUEUE_CAPACITY>;
+
+    /**
+     * @brief 接続中のクライアント
+     */
+    struct Client {
+        int id;                                       // クライアント番号
+        QLocalSocket* socket;                         // ソケット（nullptrは切断済み）
+        bool subscribed;                              // 購読要求を受け取ったか
+        EventStreamFormat::Subscription subscription; // 購読の条件
+        std::unique_ptr<EventQueue> queue;            // 送信待ちのイベント
+        uint32_t pendingGap;                          // 次にGAPで知らせる、捨てたイベント数
+        uint64_t sentCount;                           // 送ったイベント数
+        uint64_t droppedCount;                        // 捨てたイベント数
+        uint64_t maxLagNs;                            // 最大の遅れ
+    };
+
+    /**
+     * @brief キャプチャスレッドからのキューを読み、配信する
+     */
+    void drainTap();
+
+    /**
+     * @brief 条件に合うクライアントのキューにイベントを追加
+     */
+    void dispatch(const EventStreamFormat::Event& event);
+
+    /**
+     * @brief クライアントのキューにイベントを追加（溢れた場合は要求に従って捨てるか切断）
+     */
+    void enqueue(Client& client, const EventStreamFormat::Event& event);
+
+    /**
+     * @brief ソケットの空きの分だけキューを送る
+     */
+    void flushClient(Client& client);
+
+    /**
+     * @brief クライアントを切断し、計測値をログに出す（一覧からの削除はremoveClosedClientsで行う）
+     */
+    void closeClient(Client& client, const char* reason);
+
+    /**
+     * @brief 切断済みのクライアントを一覧から削除
+     */
+    void removeClosedClients();
+
+    /**
+     * @brief キャプチャスレッドからのキューを使うかどうかを購読の有無に合わせる
+     */
+    void updateTapEnabled();
+
+    Client* findClient(QLocalSocket* socket);
+    ClientStats statsFor(const Client& client, uint64_t nowNs) const;
+
+    /**
+     * @brief MIDIイベントを配信するイベントに変換
+     * @return 配信する種類のイベントの場合true
+     */
+    static bool toStreamEvent(const MidiEvent& midi, EventStreamFormat::Event& event);
+
+    LaunchpadVisualizer* m_visualizer;              // 色の変化の発生元
+    MidiEventTap* m_tap;                            // キャプチャしたイベントの受け取り口
+    QLocalServer m_server;                          // 待ち受けソケット
+    QTimer m_drainTimer;                            // 配信タイマー
+    std::vector<std::unique_ptr<Client>> m_clients; // 接続中のクライアント
+    int m_nextClientId;                             // 次のクライアント番号
+    uint64_t m_slowDisconnectCount;                 // 遅れで切断したクライアント数
+};
+
+#endif // EVENT_STREAM_SERVER_H
@@ -0,0 +1,237 @@
+#include "MetricsServer.h"
+#include "../LaunchpadVisualizer.h"
+#include "../diag/LatencyTracker.h"
+#include "EventStreamServer.h"
+#include <QTcpSocket>
+#include <QDebug>
+
+namespace {
+
+// LatencyTrackerの区間に対応するラベル
+const char* const STAGE_LABELS[LatencyTracker::STAGE_COUNT] = {
+    "dispatch", "apply", "render_begin", "paint_end", "end_to_end"
+};
+
+// summaryとして出力するパーセンタイル
+const double QUANTILES[] = { 50.0, 90.0, 99.0, 99.9 };
+
+QByteArray seconds(uint64_t valueNs)
+{
+    return QByteArray::number(valueNs / 1e9, 'g', 9);
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(const LaunchpadVisualizer* visualizer, QObject *parent)
+    : QObject(parent)
+    , m_visualizer(visualizer)
+    , m_eventStream(nullptr)
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+}
+
+bool MetricsServer::listen(quint16 port)
+{
+    if (!m_server.listen(QHostAddress::LocalHost, port)) {
+        qWarning() << "メトリクスの待ち受けを開始できません:" << m_server.errorString();
+        return false;
+    }
+    qInfo() << "メトリクスを公開しています: http://127.0.0.1:" << m_server.serverPort() << "/metrics";
+    return true;
+}
+
+quint16 MetricsServer::serverPort() const
+{
+    return m_server.serverPort();
+}
+
+void MetricsServer::setEventStream(const EventStreamServer* server)
+{
+    m_eventStream = server;
+}
+
+void MetricsServer::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server.nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, &MetricsServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &MetricsServer::onDisconnected);
+    }
+}
+
+void MetricsServer::onDisconnected()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (socket) {
+        m_requests.remove(socket);
+        socket->deleteLater();
+    }
+}
+
+void MetricsServer::onReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+
+    // ヘッダーが揃うまで待つ（本文は使わない）
+    QByteArray& request = m_requests[socket];
+    request += socket->readAll();
+    const int headerEnd = request.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        if (request.size() > MAX_REQUEST_SIZE) {
+            m_requests.remove(socket);
+            socket->abort();
+        }
+        return;
+    }
+
+    const QByteArray requestLine = request.left(request.indexOf("\r\n"));
+    m_requests.remove(socket);
+
+    QByteArray status;
+    QByteArray body;
+    if (!requestLine.startsWith("GET ")) {
+        status = "405 Method Not Allowed";
+    } else if (requestLine.startsWith("GET /metrics ") || requestLine.startsWith("GET /metrics?")) {
+        status = "200 OK";
+        body = metrics();
+    } else {
+        status = "404 Not Found";
+    }
+
+    QByteArray response = "HTTP/1.1 " + status + "\r\n";
+    response += "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+QByteArray MetricsServer::metrics() const
+{
+    const Telemetry* telemetry = m_visualizer->telemetry();
+    const Telemetry::Snapshot current = telemetry->snapshot();
+
+    QByteArray out;
+    out.reserve(4096);
+
+    appendHeader(out, "lpv_midi_events_total", "counter", "MIDI events received by type (clock excluded).");
+    for (int type = 0; type < Telemetry::EVENT_TYPE_COUNT; ++type) {
+        out += "lpv_midi_events_total{type=\"";
+        out += Telemetry::eventTypeName(static_cast<Telemetry::EventType>(type));
+        out += "\"} " + QByteArray::number(static_cast<qulonglong>(current.typeCounts[type])) + "\n";
+    }
+
+    appendHeader(out, "lpv_gui_events_handled_total", "counter", "Events handled on the GUI thread.");
+    out += "lpv_gui_events_handled_total " + QByteArray::number(static_cast<qulonglong>(current.handledCount)) + "\n";
+    appendHeader(out, "lpv_gui_queue_depth", "gauge", "Events queued to the GUI thread and not yet handled.");
+    out += "lpv_gui_queue_depth " + QByteArray::number(static_cast<qulonglong>(current.pendingCount())) + "\n";
+    appendHeader(out, "lpv_gui_queue_high_water", "gauge", "Maximum GUI thread queue depth since start.");
+    out += "lpv_gui_queue_high_water " + QByteArray::number(static_cast<qulonglong>(current.pendingHighWater)) + "\n";
+
+    appendHeader(out, "lpv_recording_queue_depth", "gauge", "Events waiting to be written by the recorder.");
+    out += "lpv_recording_queue_depth "
+        + QByteArray::number(static_cast<qulonglong>(m_visualizer->recordingQueueDepth())) + "\n";
+    appendHeader(out, "lpv_recording_queue_high_water", "gauge", "Maximum recorder queue depth since recording started.");
+    out += "lpv_recording_queue_high_water "
+        + QByteArray::number(static_cast<qulonglong>(m_visualizer->recordingQueueHighWater())) + "\n";
+    appendHeader(out, "lpv_recording_dropped_events_total", "counter", "Events dropped because the recorder queue was full.");
+    out += "lpv_recording_dropped_events_total "
+        + QByteArray::number(static_cast<qulonglong>(m_visualizer->droppedEventCount())) + "\n";
+
+    appendHeader(out, "lpv_frames_rendered_total", "counter", "Frames painted by the main grid.");
+    out += "lpv_frames_rendered_total " + QByteArray::number(static_cast<qulonglong>(current.frameCount)) + "\n";
+
+    appendHeader(out, "lpv_paint_duration_seconds", "summary", "Time spent in the main grid paintEvent.");
+    appendSummary(out, "lpv_paint_duration_seconds", QByteArray(), telemetry->paintDuration());
+
+    appendHeader(out, "lpv_latency_seconds", "summary", "Pipeline latency by stage.");
+    const LatencyTracker* tracker = m_visualizer->latencyTracker();
+    for (int stage = 0; stage < LatencyTracker::STAGE_COUNT; ++stage) {
+        appendSummary(out, "lpv_latency_seconds", QByteArray("stage=\"") + STAGE_LABELS[stage] + "\"",
+                      tracker->snapshot(static_cast<LatencyTracker::Stage>(stage)));
+    }
+
+    appendHeader(out, "lpv_tempo_bpm", "gauge", "Tempo estimated from pad hits.");
+    out += "lpv_tempo_bpm " + QByteArray::number(m_visualizer->tempoBpm(), 'f', 2) + "\n";
+    appendHeader(out, "lpv_device_connected", "gauge", "Whether a MIDI input device is open.");
+    out += QByteArray("lpv_device_connected ") + (m_visualizer->isDeviceConnected() ? "1" : "0") + "\n";
+
+    if (m_eventStream) {
+        const std::vector<EventStreamServer::ClientStats> clients = m_eventStream->clientStats();
+        appendHeader(out, "lpv_event_stream_clients", "gauge", "Connected event stream clients.");
+        out += "lpv_event_stream_clients " + QByteArray::number(static_cast<qulonglong>(clients.size())) + "\n";
+        appendHeader(out, "lpv_event_stream_slow_disconnects_total", "counter",
+                     "Event stream clients disconnected for lag or queue overflow.");
+        out += "lpv_event_stream_slow_disconnects_total "
+            + QByteArray::number(static_cast<qulonglong>(m_eventStream->slowDisconnectCount())) + "\n";
+        appendHeader(out, "lpv_event_stream_ingest_dropped_total", "counter",
+                     "Captured events dropped before reaching the event stream.");
+        out += "lpv_event_stream_ingest_dropped_total "
+            + QByteArray::number(static_cast<qulonglong>(m_eventStream->ingestDroppedCount())) + "\n";
+
+        appendHeader(out, "lpv_event_stream_client_lag_seconds", "gauge", "Age of the oldest event queued for a client.");
+        for (const EventStreamServer::ClientStats& client : clients) {
+            out += "lpv_event_stream_client_lag_seconds{client=\"" + QByteArray::number(client.id) + "\"} "
+                + seconds(client.lagNs) + "\n";
+        }
+        appendHeader(out, "lpv_event_stream_client_max_lag_seconds", "gauge", "Maximum client lag since it connected.");
+        for (const EventStreamServer::ClientStats& client : clients) {
+            out += "lpv_event_stream_client_max_lag_seconds{client=\"" + QByteArray::number(client.id) + "\"} "
+                + seconds(client.maxLagNs) + "\n";
+        }
+        appendHeader(out, "lpv_event_stream_client_queue_depth", "gauge", "Events queued for a client.");
+        for (const EventStreamServer::ClientStats& client : clients) {
+            out += "lpv_event_stream_client_queue_depth{client=\"" + QByteArray::number(client.id) + "\"} "
+                + QByteArray::number(static_cast<qulonglong>(client.queueDepth)) + "\n";
+        }
+        appendHeader(out, "lpv_event_stream_client_socket_backlog_bytes", "gauge", "Bytes written but not yet sent to a client.");
+        for (const EventStreamServer::ClientStats& client : clients) {
+            out += "lpv_event_stream_client_socket_backlog_bytes{client=\"" + QByteArray::number(client.id) + "\"} "
+                + QByteArray::number(static_cast<qulonglong>(client.socketBacklog)) + "\n";
+        }
+        appendHeader(out, "lpv_event_stream_client_sent_total", "counter", "Events sent to a client.");
+        for (const EventStreamServer::ClientStats& client : clients) {
+            out += "lpv_event_stream_client_sent_total{client=\"" + QByteArray::number(client.id) + "\"} "
+                + QByteArray::number(static_cast<qulonglong>(client.sentCount)) + "\n";
+        }
+        appendHeader(out, "lpv_event_stream_client_dropped_total", "counter", "Events dropped for a client whose queue was full.");
+        for (const EventStreamServer::ClientStats& client : clients) {
+            out += "lpv_event_stream_client_dropped_total{client=\"" + QByteArray::number(client.id) + "\"} "
+                + QByteArray::number(static_cast<qulonglong>(client.droppedCount)) + "\n";
+        }
+    }
+    return out;
+}
+
+void MetricsServer::appendHeader(QByteArray& out, const char* name, const char* type, const char* help)
+{
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+void MetricsServer::appendSummary(QByteArray& out, const char* name, const QByteArray& labels,
+                                  const LatencyHistogram::Snapshot& histogram)
+{
+    const QByteArray prefix = labels.isEmpty() ? QByteArray("{") : "{" + labels + ",";
+    for (double quantile : QUANTILES) {
+        out += name;
+        out += prefix + "quantile=\"" + QByteArray::number(quantile / 100.0, 'g', 4) + "\"} ";
+        out += seconds(histogram.count ? histogram.percentile(quantile) : 0) + "\n";
+    }
+
+    const QByteArray suffix = labels.isEmpty() ? QByteArray() : "{" + labels + "}";
+    out += name;
+    out += "_sum" + suffix + " " + seconds(histogram.sumNs) + "\n";
+    out += name;
+    out += "_count" + suffix + " " + QByteArray::number(static_cast<qulonglong>(histogram.count)) + "\n";
+}
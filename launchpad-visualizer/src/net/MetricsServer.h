@@ -0,0 +1,94 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QTcpServer>
+#include <cstdint>
+#include "../diag/LatencyHistogram.h"
+#include "../diag/Telemetry.h"
+
+class LaunchpadVisualizer;
+class EventStreamServer;
+class QTcpSocket;
+
+/**
+ * @brief 計測値をPrometheusのテキスト形式で公開するHTTPサーバー
+ * localhostだけで待ち受け、GET /metrics に対してカウンター・ゲージ・
+ * レイテンシの要約を返す。値はすべて書き込みスレッドが原子変数に置いたものを
+ * 読み出すだけなので、スクレイプがキャプチャや描画の処理を止めることはない
+ */
+class MetricsServer : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int MAX_REQUEST_SIZE = 8192;  // 受け付けるリクエストヘッダーの最大長
+
+    explicit MetricsServer(const LaunchpadVisualizer* visualizer, QObject *parent = nullptr);
+
+    /**
+     * @brief localhostの指定ポートで待ち受けを開始
+     * @param port ポート番号（0は空いているポート）
+     * @return 成功した場合true
+     */
+    bool listen(quint16 port);
+
+    /**
+     * @brief 待ち受けているポート番号を取得
+     */
+    quint16 serverPort() const;
+
+    /**
+     * @brief イベント配信のクライアントごとの遅れも公開する
+     * @param server イベント配信サーバー（nullptrで公開しない）
+     */
+    void setEventStream(const EventStreamServer* server);
+
+    /**
+     * @brief 現在の計測値をPrometheusのテキスト形式で取得
+     * 読み出しは状態を持たないので、何度呼び出しても結果はスクレイプの間隔に依存しない。
+     * フレームレートなどの率はカウンターからPrometheus側で求める
+     * (例: rate(lpv_frames_rendered_total[1m]))
+     */
+    QByteArray metrics() const;
+
+private slots:
+    /**
+     * @brief 新しい接続を受け付ける
+     */
+    void onNewConnection();
+
+    /**
+     * @brief リクエストを読み、ヘッダーが揃ったら応答して切断する
+     */
+    void onReadyRead();
+
+    /**
+     * @brief 切断された接続を破棄
+     */
+    void onDisconnected();
+
+private:
+    /**
+     * @brief レイテンシの分布を秒単位のsummaryとして追加
+     * @param out 出力先
+     * @param name メトリクス名
+     * @param labels 追加のラベル（"key=\"value\"" の形式、空も可）
+     * @param histogram 分布
+     */
+    static void appendSummary(QByteArray& out, const char* name, const QByteArray& labels,
+                              const LatencyHistogram::Snapshot& histogram);
+
+    /**
+     * @brief メトリクスの説明と型の行を追加
+     */
+    static void appendHeader(QByteArray& out, const char* name, const char* type, const char* help);
+
+    const LaunchpadVisualizer* m_visualizer;  // 読み出し元
+    const EventStreamServer* m_eventStream;   // イベント配信（nullptrは公開しない）
+    QTcpServer m_server;                      // 待ち受けソケット
+    QHash<QTcpSocket*, QByteArray> m_requests; // 接続ごとの受信途中のリクエスト
+};
+
+#endif // METRICS_SERVER_H
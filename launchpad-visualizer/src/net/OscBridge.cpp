@@ -0,0 +1,219 @@
+#include "OscBridge.h"
+#include "../LaunchpadVisualizer.h"
+#include <QDebug>
+#include <cstdio>
+#include <cstring>
+
+OscBridge::OscBridge(LaunchpadVisualizer* visualizer, QObject *parent)
+    : QObject(parent)
+    , m_visualizer(visualizer)
+    , m_writer(m_outPacket, sizeof(m_outPacket))
+    , m_pendingCount(0)
+    , m_applyingInput(false)
+    , m_messagesSent(0)
+    , m_messagesReceived(0)
+    , m_batchesApplied(0)
+{
+    m_writer.beginBundle();
+
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setTimerType(Qt::PreciseTimer);
+    m_flushTimer.setInterval(FLUSH_INTERVAL_MS);
+    connect(&m_flushTimer, &QTimer::timeout, this, &OscBridge::flush);
+    connect(&m_socket, &QUdpSocket::readyRead, this, &OscBridge::onReadyRead);
+
+    connect(m_visualizer, &LaunchpadVisualizer::padPressed, this, &OscBridge::onPadPressed);
+    connect(m_visualizer, &LaunchpadVisualizer::padReleased, this, &OscBridge::onPadReleased);
+    connect(m_visualizer, &LaunchpadVisualizer::padColorChanged, this, &OscBridge::onPadColorChanged);
+}
+
+bool OscBridge::listen(quint16 port)
+{
+    if (!m_socket.bind(QHostAddress::Any, port)) {
+        qWarning() << "OSCを受信できません:" << m_socket.errorString();
+        return false;
+    }
+    qInfo() << "OSCを受信しています: ポート" << port;
+    return true;
+}
+
+quint16 OscBridge::localPort() const
+{
+    return m_socket.localPort();
+}
+
+void OscBridge::addTarget(const QHostAddress& address, quint16 port)
+{
+    m_targets.push_back({address, port});
+    qInfo() << "パッドのイベントをOSCで送信します:" << address.toString() << port;
+}
+
+bool OscBridge::addTarget(const QString& hostAndPort)
+{
+    const int separator = hostAndPort.lastIndexOf(':');
+    bool ok = false;
+    const int port = separator > 0 ? hostAndPort.mid(separator + 1).toInt(&ok) : 0;
+    const QHostAddress address(hostAndPort.left(separator));
+    if (!ok || port <= 0 || port > 65535 || address.isNull()) {
+        qWarning() << "OSCの送信先は アドレス:ポート で指定してください:" << hostAndPort;
+        return false;
+    }
+    addTarget(address, static_cast<quint16>(port));
+    return true;
+}
+
+uint64_t OscBridge::messagesSent() const
+{
+    return m_messagesSent;
+}
+
+uint64_t OscBridge::messagesReceived() const
+{
+    return m_messagesReceived;
+}
+
+uint64_t OscBridge::batchesApplied() const
+{
+    return m_batchesApplied;
+}
+
+void OscBridge::onPadPressed(int x, int y, int velocity)
+{
+    const int32_t values[] = {velocity};
+    appendPadMessage(x, y, "press", "i", values);
+}
+
+void OscBridge::onPadReleased(int x, int y)
+{
+    appendPadMessage(x, y, "release", "", nullptr);
+}
+
+void OscBridge::onPadColorChanged(int x, int y, uint32_t rgb)
+{
+    // 受信した色を同じ経路で送り返さない
+    if (m_applyingInput) {
+        return;
+    }
+    const int32_t values[] = {
+        static_cast<int32_t>((rgb >> 16) & 0xFF),
+        static_cast<int32_t>((rgb >> 8) & 0xFF),
+        static_cast<int32_t>(rgb & 0xFF)
+    };
+    appendPadMessage(x, y, "color", "iii", values);
+}
+
+void OscBridge::appendPadMessage(int x, int y, const char* action, const char* typeTags, const int32_t* values)
+{
+    if (m_targets.empty()) {
+        return;
+    }
+
+    char address[32];
+    std::snprintf(address, sizeof(address), "/pad/%d/%d/%s", x, y, action);
+
+    // バンドルが一杯なら先に送り、空のバンドルに書き直す
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        m_writer.beginMessage(address, typeTags);
+        for (int i = 0; typeTags[i]; ++i) {
+            m_writer.addInt(values[i]);
+        }
+        if (m_writer.endMessage()) {
+            break;
+        }
+        flush();
+    }
+
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void OscBridge::flush()
+{
+    m_flushTimer.stop();
+    if (m_writer.messageCount() == 0) {
+        return;
+    }
+
+    for (const Target& target : m_targets) {
+        m_socket.writeDatagram(reinterpret_cast<const char*>(m_outPacket), static_cast<qint64>(m_writer.size()),
+                               target.address, target.port);
+    }
+    m_messagesSent += static_cast<uint64_t>(m_writer.messageCount());
+
+    m_writer.reset();
+    m_writer.beginBundle();
+}
+
+void OscBridge::onReadyRead()
+{
+    // 届いているデータグラムの色の指定をまとめて1つのSysExで反映する
+    while (m_socket.hasPendingDatagrams()) {
+        const qint64 size = m_socket.readDatagram(reinterpret_cast<char*>(m_inPacket), sizeof(m_inPacket));
+        if (size <= 0) {
+            continue;
+        }
+        OscReader::parse(m_inPacket, static_cast<std::size_t>(size),
+                         [this](const OscMessage& message) { handleMessage(message); });
+    }
+    applyPendingColors();
+}
+
+void OscBridge::handleMessage(const OscMessage& message)
+{
+    int x, y;
+    const char* action;
+    if (!parsePadAddress(message.address, x, y, action) || std::strcmp(action, "color") != 0) {
+        return;
+    }
+
+    // 整数は0-255、浮動小数点数は0.0-1.0として扱う
+    uint32_t rgb = 0;
+    for (int i = 0; i < 3; ++i) {
+        float value;
+        if (!message.number(i, value)) {
+            return;
+        }
+        if (message.typeTags[i] == 'f') {
+            value *= 255.0f;
+        }
+        const uint32_t component = static_cast<uint32_t>(qBound(0.0f, value, 255.0f) + 0.5f);
+        rgb = (rgb << 8) | component;
+    }
+
+    if (m_pendingCount == PadStateModel::PAD_COUNT) {
+        applyPendingColors();
+    }
+    m_pendingColors[m_pendingCount++] = {x, y, rgb};
+}
+
+void OscBridge::applyPendingColors()
+{
+    if (m_pendingCount == 0) {
+        return;
+    }
+    m_applyingInput = true;
+    m_visualizer->applyPadColors(m_pendingColors, m_pendingCount);
+    m_applyingInput = false;
+    m_messagesReceived += m_pendingCount;
+    ++m_batchesApplied;
+    m_pendingCount = 0;
+}
+
+bool OscBridge::parsePadAddress(const char* address, int& x, int& y, const char*& action)
+{
+    static const char PREFIX[] = "/pad/";
+    if (std::strncmp(address, PREFIX, sizeof(PREFIX) - 1) != 0) {
+        return false;
+    }
+    const char* p = address + sizeof(PREFIX) - 1;
+
+    // 座標は1桁 (0-8)
+    if (p[0] < '0' || p[0] > '9' || p[1] != '/' || p[2] < '0' || p[2] > '9' || p[3] != '/') {
+        return false;
+    }
+    x = p[0] - '0';
+    y = p[2] - '0';
+    action = p + 4;
+    return PadStateModel::isValidCoordinate(x, y);
+}
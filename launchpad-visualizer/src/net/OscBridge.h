@@ -0,0 +1,143 @@
+#ifndef OSC_BRIDGE_H
+#define OSC_BRIDGE_H
+
+#include <QObject>
+#include <QHostAddress>
+#include <QTimer>
+#include <QUdpSocket>
+#include <cstdint>
+#include <vector>
+#include "OscCodec.h"
+#include "../midi/LaunchpadProtocol.h"
+#include "../model/PadStateModel.h"
+
+class LaunchpadVisualizer;
+
+/**
+ * @brief パッドのイベントとデバイスの色をOSCでやり取りするクラス
+ * 送信: 押下・離上・色の変化を /pad/x/y/press (i: ベロシティ)、/pad/x/y/release、
+ * /pad/x/y/color (iii: 0-255) として、FLUSH_INTERVAL_MSの間の変化を1つのバンドルにまとめて送る。
+ * 受信: /pad/x/y/color (iii: 0-255 または fff: 0.0-1.0) を1つのデータグラム分まとめて
+ * デバイスの色に反映する。パケットの組み立てと解析は確保済みのバッファ上で行う
+ */
+class OscBridge : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int FLUSH_INTERVAL_MS = 16;       // 変化をまとめる時間（1フレーム）
+    static constexpr int MAX_PACKET_SIZE = 1472;       // 送信するバンドルの最大サイズ（分割されないUDPの大きさ）
+    static constexpr int MAX_RECEIVE_SIZE = 8192;      // 受信するパケットの最大サイズ
+
+    explicit OscBridge(LaunchpadVisualizer* visualizer, QObject *parent = nullptr);
+
+    /**
+     * @brief 色の指定の受信を開始
+     * @param port 待ち受けるポート
+     * @return 成功した場合true
+     */
+    bool listen(quint16 port);
+
+    /**
+     * @brief 待ち受けているポート番号を取得
+     */
+    quint16 localPort() const;
+
+    /**
+     * @brief イベントの送信先を追加
+     * @param address 宛先のアドレス
+     * @param port 宛先のポート
+     */
+    void addTarget(const QHostAddress& address, quint16 port);
+
+    /**
+     * @brief "ホスト:ポート" の形式で送信先を追加
+     * @return 形式が正しい場合true
+     */
+    bool addTarget(const QString& hostAndPort);
+
+    /**
+     * @brief 送信したメッセージ数
+     */
+    uint64_t messagesSent() const;
+
+    /**
+     * @brief 受信して反映した色の指定の数
+     */
+    uint64_t messagesReceived() const;
+
+    /**
+     * @brief 受信した色の指定をデバイスに反映した回数（まとめて反映した単位）
+     */
+    uint64_t batchesApplied() const;
+
+private slots:
+    void onPadPressed(int x, int y, int velocity);
+    void onPadReleased(int x, int y);
+    void onPadColorChanged(int x, int y, uint32_t rgb);
+
+    /**
+     * @brief まとめたメッセージを全送信先に送る
+     */
+    void flush();
+
+    /**
+     * @brief 受信した色の指定をデバイスに反映
+     */
+    void onReadyRead();
+
+private:
+    /**
+     * @brief 送信するバンドルにパッドのメッセージを追加
+     * バンドルに入りきらない場合は先に送ってから追加する
+     * @param x X座標
+     * @param y Y座標
+     * @param action アドレスの末尾 ("press" など)
+     * @param typeTags 引数の型（すべて'i'）
+     * @param values 引数の値
+     */
+    void appendPadMessage(int x, int y, const char* action, const char* typeTags, const int32_t* values);
+
+    /**
+     * @brief 受信したメッセージを1つ処理
+     */
+    void handleMessage(const OscMessage& message);
+
+    /**
+     * @brief 集めた色の指定を反映
+     */
+    void applyPendingColors();
+
+    /**
+     * @brief "/pad/x/y/action" の形式のアドレスを解析
+     * @param address アドレス
+     * @param x 出力X座標
+     * @param y 出力Y座標
+     * @param action 出力（アドレスの末尾を指す）
+     * @return 形式が正しく座標が範囲内の場合true
+     */
+    static bool parsePadAddress(const char* address, int& x, int& y, const char*& action);
+
+    /**
+     * @brief 送信先
+     */
+    struct Target {
+        QHostAddress address;
+        quint16 port;
+    };
+
+    LaunchpadVisualizer* m_visualizer;  // イベントの発生元・色の反映先
+    QUdpSocket m_socket;                // 送受信用ソケット
+    QTimer m_flushTimer;                // バンドルを送るタイマー
+    std::vector<Target> m_targets;      // 送信先
+    unsigned char m_outPacket[MAX_PACKET_SIZE];  // 組み立て中のバンドル
+    OscWriter m_writer;                          // m_outPacketへの書き込み
+    unsigned char m_inPacket[MAX_RECEIVE_SIZE];  // 受信したパケット
+    LaunchpadProtocol::PadColor m_pendingColors[PadStateModel::PAD_COUNT];  // 反映待ちの色
+    std::size_t m_pendingCount;  // 反映待ちの色の数
+    bool m_applyingInput;        // 受信した色を反映中（送り返さない）
+    uint64_t m_messagesSent;     // 送信したメッセージ数
+    uint64_t m_messagesReceived; // 受信して反映した色の指定の数
+    uint64_t m_batchesApplied;   // 色の指定を反映した回数
+};
+
+#endif // OSC_BRIDGE_H
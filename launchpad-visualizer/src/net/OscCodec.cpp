@@ -0,0 +1,232 @@
+#include "OscCodec.h"
+
+namespace {
+
+/**
+ * @brief 4バイト境界に切り上げる
+ */
+std::size_t padded(std::size_t size)
+{
+    return (size + 3) & ~static_cast<std::size_t>(3);
+}
+
+/**
+ * @brief 終端を含む文字列の長さを4バイト境界で求める
+ * @return 文字列がデータ内で終わっていない場合は0
+ */
+std::size_t paddedStringSize(const unsigned char* data, std::size_t size)
+{
+    const void* end = std::memchr(data, '\0', size);
+    if (!end) {
+        return 0;
+    }
+    const std::size_t length = static_cast<const unsigned char*>(end) - data;
+    const std::size_t total = padded(length + 1);
+    return total <= size ? total : 0;
+}
+
+} // namespace
+
+OscWriter::OscWriter(unsigned char* buffer, std::size_t capacity)
+    : m_buffer(buffer)
+    , m_capacity(capacity)
+{
+    reset();
+}
+
+void OscWriter::reset()
+{
+    m_size = 0;
+    m_messageStart = 0;
+    m_inBundle = false;
+    m_failed = false;
+    m_messageCount = 0;
+}
+
+bool OscWriter::beginBundle(uint64_t timeTag)
+{
+    if (m_size != 0) {
+        return false;
+    }
+    if (!write("#bundle", 8) || !writeUint32(static_cast<uint32_t>(timeTag >> 32))
+        || !writeUint32(static_cast<uint32_t>(timeTag))) {
+        reset();
+        return false;
+    }
+    m_inBundle = true;
+    return true;
+}
+
+bool OscWriter::beginMessage(const char* address, const char* typeTags)
+{
+    m_messageStart = m_size;
+    m_failed = false;
+
+    // バンドル内の要素は先頭にサイズを持つ（endMessageで書き込む）
+    if (m_inBundle) {
+        m_failed = !writeUint32(0);
+    }
+    m_failed = m_failed || !writeString(address);
+
+    // 型タグは ',' に続けて並べる
+    if (!m_failed) {
+        const std::size_t length = std::strlen(typeTags);
+        const std::size_t total = padded(length + 2);
+        if (m_size + total > m_capacity) {
+            m_failed = true;
+        } else {
+            m_buffer[m_size] = ',';
+            std::memcpy(m_buffer + m_size + 1, typeTags, length);
+            std::memset(m_buffer + m_size + 1 + length, 0, total - length - 1);
+            m_size += total;
+        }
+    }
+    return !m_failed;
+}
+
+bool OscWriter::addInt(int32_t value)
+{
+    m_failed = m_failed || !writeUint32(static_cast<uint32_t>(value));
+    return !m_failed;
+}
+
+bool OscWriter::addFloat(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    m_failed = m_failed || !writeUint32(bits);
+    return !m_failed;
+}
+
+bool OscWriter::endMessage()
+{
+    if (m_failed) {
+        m_size = m_messageStart;
+        m_failed = false;
+        return false;
+    }
+    if (m_inBundle) {
+        const uint32_t elementSize = static_cast<uint32_t>(m_size - m_messageStart - 4);
+        unsigned char* out = m_buffer + m_messageStart;
+        out[0] = static_cast<unsigned char>(elementSize >> 24);
+        out[1] = static_cast<unsigned char>(elementSize >> 16);
+        out[2] = static_cast<unsigned char>(elementSize >> 8);
+        out[3] = static_cast<unsigned char>(elementSize);
+    }
+    ++m_messageCount;
+    return true;
+}
+
+bool OscWriter::write(const void* data, std::size_t size)
+{
+    if (m_size + size > m_capacity) {
+        return false;
+    }
+    std::memcpy(m_buffer + m_size, data, size);
+    m_size += size;
+    return true;
+}
+
+bool OscWriter::writeString(const char* text)
+{
+    const std::size_t length = std::strlen(text);
+    const std::size_t total = padded(length + 1);
+    if (m_size + total > m_capacity) {
+        return false;
+    }
+    std::memcpy(m_buffer + m_size, text, length);
+    std::memset(m_buffer + m_size + length, 0, total - length);
+    m_size += total;
+    return true;
+}
+
+bool OscWriter::writeUint32(uint32_t value)
+{
+    const unsigned char bytes[4] = {
+        static_cast<unsigned char>(value >> 24), static_cast<unsigned char>(value >> 16),
+        static_cast<unsigned char>(value >> 8), static_cast<unsigned char>(value)
+    };
+    return write(bytes, sizeof(bytes));
+}
+
+bool OscMessage::number(int index, float& value) const
+{
+    if (index < 0 || index >= argumentCount) {
+        return false;
+    }
+    if (typeTags[index] == 'i') {
+        value = static_cast<float>(arguments[index].i);
+        return true;
+    }
+    if (typeTags[index] == 'f') {
+        value = arguments[index].f;
+        return true;
+    }
+    return false;
+}
+
+bool OscReader::parseMessage(const unsigned char* data, std::size_t size, OscMessage& message)
+{
+    if (data[0] != '/') {
+        return false;
+    }
+    const std::size_t addressSize = paddedStringSize(data, size);
+    if (addressSize == 0) {
+        return false;
+    }
+    message.address = reinterpret_cast<const char*>(data);
+
+    // 型タグがないメッセージは引数なしとして扱う
+    std::size_t offset = addressSize;
+    if (offset == size) {
+        message.typeTags = "";
+        message.argumentCount = 0;
+        return true;
+    }
+    const std::size_t tagsSize = paddedStringSize(data + offset, size - offset);
+    if (tagsSize == 0 || data[offset] != ',') {
+        return false;
+    }
+    message.typeTags = reinterpret_cast<const char*>(data + offset + 1);
+    offset += tagsSize;
+
+    message.argumentCount = 0;
+    for (const char* tag = message.typeTags; *tag; ++tag) {
+        if (message.argumentCount == OscMessage::MAX_ARGUMENTS) {
+            return false;
+        }
+        OscMessage::Argument& argument = message.arguments[message.argumentCount++];
+        switch (*tag) {
+        case 'i':
+        case 'f': {
+            if (offset + 4 > size) {
+                return false;
+            }
+            const uint32_t bits = OscReader::readUint32(data + offset);
+            if (*tag == 'i') {
+                argument.i = static_cast<int32_t>(bits);
+            } else {
+                std::memcpy(&argument.f, &bits, sizeof(bits));
+            }
+            offset += 4;
+            break;
+        }
+        case 's': {
+            const std::size_t stringSize = paddedStringSize(data + offset, size - offset);
+            if (stringSize == 0) {
+                return false;
+            }
+            argument.s = reinterpret_cast<const char*>(data + offset);
+            offset += stringSize;
+            break;
+        }
+        case 'T':
+        case 'F':
+            argument.i = *tag == 'T' ? 1 : 0;
+            break;
+        default:
+            return false;
+        }
+    }
+    return offset == size;
+}
@@ -0,0 +1,176 @@
+#ifndef OSC_CODEC_H
+#define OSC_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief OSC 1.0 のパケットを呼び出し元のバッファに直接書き込むクラス
+ * 動的なメモリ確保を行わない。バンドルを開始すると、以後のメッセージは
+ * すべてそのバンドルの要素になる。書き込めなかったメッセージは取り消す
+ */
+class OscWriter {
+public:
+    static constexpr uint64_t IMMEDIATELY = 1;  // 即時実行のタイムタグ
+
+    /**
+     * @param buffer 書き込み先
+     * @param capacity 書き込み先のサイズ
+     */
+    OscWriter(unsigned char* buffer, std::size_t capacity);
+
+    /**
+     * @brief 書き込んだ内容を破棄して先頭に戻る
+     */
+    void reset();
+
+    /**
+     * @brief バンドルを開始（空の状態でのみ呼び出せる）
+     * @param timeTag タイムタグ (NTP形式)
+     * @return 成功した場合true
+     */
+    bool beginBundle(uint64_t timeTag = IMMEDIATELY);
+
+    /**
+     * @brief メッセージを開始
+     * @param address アドレス ("/pad/0/0/press" など)
+     * @param typeTags 引数の型 (先頭の','を除く。"iii" など)
+     * @return 書き込めた場合true
+     */
+    bool beginMessage(const char* address, const char* typeTags);
+
+    /**
+     * @brief 32ビット整数の引数を追加
+     */
+    bool addInt(int32_t value);
+
+    /**
+     * @brief 32ビット浮動小数点数の引数を追加
+     */
+    bool addFloat(float value);
+
+    /**
+     * @brief メッセージを終える
+     * @return 途中で書き込めなかった場合はメッセージを取り消してfalse
+     */
+    bool endMessage();
+
+    /**
+     * @brief 書き込んだバイト数
+     */
+    std::size_t size() const { return m_size; }
+
+    /**
+     * @brief 書き込んだメッセージの数
+     */
+    int messageCount() const { return m_messageCount; }
+
+private:
+    bool write(const void* data, std::size_t size);
+    bool writeString(const char* text);
+    bool writeUint32(uint32_t value);
+
+    unsigned char* m_buffer;     // 書き込み先
+    std::size_t m_capacity;      // 書き込み先のサイズ
+    std::size_t m_size;          // 書き込んだバイト数
+    std::size_t m_messageStart;  // 書き込み中のメッセージの先頭（バンドル内では要素サイズの位置）
+    bool m_inBundle;             // バンドルを開始したかどうか
+    bool m_failed;               // 書き込み中のメッセージが入りきらなかったかどうか
+    int m_messageCount;          // 書き込んだメッセージの数
+};
+
+/**
+ * @brief 受信したOSCメッセージ
+ * アドレスと文字列の引数は受信バッファを直接指す（コピーしない）
+ */
+struct OscMessage {
+    static constexpr int MAX_ARGUMENTS = 8;  // 扱う引数の最大数
+
+    /**
+     * @brief 引数の値
+     */
+    union Argument {
+        int32_t i;
+        float f;
+        const char* s;
+    };
+
+    const char* address = nullptr;   // アドレス
+    const char* typeTags = nullptr;  // 引数の型 (先頭の','を除く)
+    int argumentCount = 0;           // 引数の数
+    Argument arguments[MAX_ARGUMENTS];
+
+    /**
+     * @brief 数値の引数を浮動小数点数として取得（'i'と'f'に対応）
+     * @param index 引数の位置
+     * @param value 出力値
+     * @return 数値の引数の場合true
+     */
+    bool number(int index, float& value) const;
+};
+
+/**
+ * @brief OSC 1.0 のパケットを読むクラス
+ * バンドルは入れ子も含めて展開し、含まれるメッセージを順にハンドラに渡す。
+ * 対応する引数の型は i, f, s, T, F で、それ以外を含むメッセージは読み飛ばす
+ */
+class OscReader {
+public:
+    static constexpr int MAX_BUNDLE_DEPTH = 4;  // バンドルの入れ子の上限
+
+    /**
+     * @brief パケットを読み、メッセージごとにハンドラを呼び出す
+     * @param data パケット
+     * @param size パケットのサイズ
+     * @param handler void(const OscMessage&) を呼び出せる関数
+     * @return パケットの形式が正しい場合true
+     */
+    template <typename Handler>
+    static bool parse(const unsigned char* data, std::size_t size, Handler&& handler, int depth = 0)
+    {
+        if (size < 8 || (size & 3) != 0) {
+            return false;
+        }
+        if (std::memcmp(data, "#bundle", 8) != 0) {
+            OscMessage message;
+            if (parseMessage(data, size, message)) {
+                handler(static_cast<const OscMessage&>(message));
+            }
+            return true;
+        }
+
+        // "#bundle" タイムタグ (8バイト) に続けて、サイズ付きの要素が並ぶ
+        if (depth >= MAX_BUNDLE_DEPTH || size < 16) {
+            return false;
+        }
+        std::size_t offset = 16;
+        while (offset + 4 <= size) {
+            const std::size_t elementSize = readUint32(data + offset);
+            offset += 4;
+            if (elementSize > size - offset || !parse(data + offset, elementSize, handler, depth + 1)) {
+                return false;
+            }
+            offset += elementSize;
+        }
+        return offset == size;
+    }
+
+    /**
+     * @brief ビッグエンディアンの32ビット値を読む
+     */
+    static uint32_t readUint32(const unsigned char* data)
+    {
+        return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16)
+             | (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+    }
+
+private:
+    /**
+     * @brief 1つのメッセージを読む
+     * @return 対応する形式の場合true
+     */
+    static bool parseMessage(const unsigned char* data, std::size_t size, OscMessage& message);
+};
+
+#endif // OSC_CODEC_H
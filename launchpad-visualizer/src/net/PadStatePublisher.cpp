@@ -0,0 +1,109 @@
+#include "PadStatePublisher.h"
+#include "../LaunchpadVisualizer.h"
+#include <QDebug>
+#include <cstring>
+
+PadStatePublisher::PadStatePublisher(const LaunchpadVisualizer* visualizer, QObject *parent)
+    : QObject(parent)
+    , m_visualizer(visualizer)
+    , m_session(std::random_device{}())
+    , m_sequence(0)
+    , m_lastKeyframeNs(0)
+    , m_packetsSent(0)
+    , m_simulatedLoss(0.0)
+    , m_random(std::random_device{}())
+{
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    m_frameTimer.setInterval(1000 / DEFAULT_FRAME_RATE);
+    connect(&m_frameTimer, &QTimer::timeout, this, &PadStatePublisher::publishFrame);
+}
+
+void PadStatePublisher::addSubscriber(const QHostAddress& address, quint16 port)
+{
+    m_subscribers.push_back({address, port});
+    qInfo() << "パッドの状態を配信します:" << address.toString() << port;
+}
+
+bool PadStatePublisher::addSubscriber(const QString& hostAndPort)
+{
+    const int separator = hostAndPort.lastIndexOf(':');
+    bool ok = false;
+    const int port = separator > 0 ? hostAndPort.mid(separator + 1).toInt(&ok) : 0;
+    const QHostAddress address(hostAndPort.left(separator));
+    if (!ok || port <= 0 || port > 65535 || address.isNull()) {
+        qWarning() << "配信先は アドレス:ポート で指定してください:" << hostAndPort;
+        return false;
+    }
+    addSubscriber(address, static_cast<quint16>(port));
+    return true;
+}
+
+void PadStatePublisher::setFrameRate(int fps)
+{
+    m_frameTimer.setInterval(1000 / qBound(1, fps, 1000));
+}
+
+void PadStatePublisher::setSimulatedLoss(double ratio)
+{
+    m_simulatedLoss = qBound(0.0, ratio, 1.0);
+}
+
+void PadStatePublisher::start()
+{
+    m_lastKeyframeNs = 0;
+    m_frameTimer.start();
+}
+
+void PadStatePublisher::stop()
+{
+    m_frameTimer.stop();
+}
+
+uint64_t PadStatePublisher::packetsSent() const
+{
+    return m_packetsSent;
+}
+
+void PadStatePublisher::publishFrame()
+{
+    if (m_subscribers.empty()) {
+        return;
+    }
+
+    // 前回送った状態と比べて変化したパッドを集める
+    const PadStateModel& state = m_visualizer->padState();
+    PadMask changed;
+    for (int index = 0; index < PadStateModel::PAD_COUNT; ++index) {
+        unsigned char current[PadStateModel::PAD_RECORD_SIZE];
+        unsigned char sent[PadStateModel::PAD_RECORD_SIZE];
+        state.serializePad(index, current);
+        m_sent.serializePad(index, sent);
+        if (std::memcmp(current, sent, sizeof(current)) != 0) {
+            changed.set(index);
+        }
+    }
+
+    const uint64_t nowNs = MidiEvent::now();
+    const bool keyframe = m_lastKeyframeNs == 0
+        || nowNs - m_lastKeyframeNs >= static_cast<uint64_t>(KEYFRAME_INTERVAL_MS) * 1000000ULL;
+    if (!keyframe && !changed.any()) {
+        return;
+    }
+
+    // 1フレームにつき1回だけ組み立て、同じパケットを全宛先に送る
+    const std::size_t size = StreamFormat::encode(state, changed, keyframe, m_session, m_sequence++, m_packet);
+    m_sent = state;
+    if (keyframe) {
+        m_lastKeyframeNs = nowNs;
+    }
+
+    std::uniform_real_distribution<double> loss(0.0, 1.0);
+    for (const Subscriber& subscriber : m_subscribers) {
+        if (m_simulatedLoss > 0.0 && loss(m_random) < m_simulatedLoss) {
+            continue;
+        }
+        m_socket.writeDatagram(reinterpret_cast<const char*>(m_packet), static_cast<qint64>(size),
+                               subscriber.address, subscriber.port);
+    }
+    ++m_packetsSent;
+}
@@ -0,0 +1,100 @@
+#ifndef PAD_STATE_PUBLISHER_H
+#define PAD_STATE_PUBLISHER_H
+
+#include <QObject>
+#include <QHostAddress>
+#include <QTimer>
+#include <QUdpSocket>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "StreamFormat.h"
+#include "../model/PadStateModel.h"
+
+class LaunchpadVisualizer;
+
+/**
+ * @brief パッドの状態をUDPで配信するクラス
+ * 一定間隔で現在の状態を前回送った状態と比べ、変化したパッドだけを1つのパケットに
+ * まとめる。パケットはフレームごとに1回だけ組み立て、同じバイト列を全宛先に送る。
+ * 途中から受信を始めた宛先のため、KEYFRAME_INTERVAL_MSごとに全パッドを送る
+ */
+class PadStatePublisher : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_FRAME_RATE = 60;       // 配信の頻度 (フレーム/秒)
+    static constexpr int KEYFRAME_INTERVAL_MS = 1000;   // キーフレームの間隔
+
+    explicit PadStatePublisher(const LaunchpadVisualizer* visualizer, QObject *parent = nullptr);
+
+    /**
+     * @brief 配信先を追加
+     * @param address 宛先のアドレス（ブロードキャストアドレスも可）
+     * @param port 宛先のポート
+     */
+    void addSubscriber(const QHostAddress& address, quint16 port);
+
+    /**
+     * @brief "ホスト:ポート" の形式で配信先を追加
+     * @return 形式が正しい場合true
+     */
+    bool addSubscriber(const QString& hostAndPort);
+
+    /**
+     * @brief 配信の頻度を設定
+     * @param fps フレーム/秒
+     */
+    void setFrameRate(int fps);
+
+    /**
+     * @brief パケットを意図的に捨てる割合を設定（取りこぼしの試験用）
+     * @param ratio 0.0-1.0
+     */
+    void setSimulatedLoss(double ratio);
+
+    /**
+     * @brief 配信を開始（最初のパケットはキーフレーム）
+     */
+    void start();
+
+    /**
+     * @brief 配信を停止
+     */
+    void stop();
+
+    /**
+     * @brief 送信したパケット数
+     */
+    uint64_t packetsSent() const;
+
+private slots:
+    /**
+     * @brief 変化したパッドを配信
+     */
+    void publishFrame();
+
+private:
+    /**
+     * @brief 配信先
+     */
+    struct Subscriber {
+        QHostAddress address;
+        quint16 port;
+    };
+
+    const LaunchpadVisualizer* m_visualizer;  // 読み出し元
+    QUdpSocket m_socket;                      // 送信用ソケット
+    QTimer m_frameTimer;                      // 配信タイマー
+    std::vector<Subscriber> m_subscribers;    // 配信先
+    PadStateModel m_sent;                     // 最後に送った状態
+    uint32_t m_session;                       // セッションID（受信側が再起動を見分ける）
+    uint32_t m_sequence;                      // 次のパケットのシーケンス番号
+    uint64_t m_lastKeyframeNs;                // 最後にキーフレームを送った時刻 (0は未送信)
+    uint64_t m_packetsSent;                   // 送信したパケット数
+    double m_simulatedLoss;                   // 意図的に捨てる割合
+    std::mt19937 m_random;                    // 捨てるパケットの選択用
+    unsigned char m_packet[StreamFormat::MAX_PACKET_SIZE];  // 組み立て中のパケット
+};
+
+#endif // PAD_STATE_PUBLISHER_H
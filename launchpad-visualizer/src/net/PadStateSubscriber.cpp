@@ -0,0 +1,117 @@
+#include "PadStateSubscriber.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+PadStateSubscriber::PadStateSubscriber(QObject *parent)
+    : QObject(parent)
+    , m_session(0)
+    , m_retiredSessions()
+    , m_retiredCount(0)
+    , m_expectedSequence(0)
+    , m_receivedAny(false)
+    , m_synchronized(false)
+    , m_packetsReceived(0)
+    , m_packetsLost(0)
+{
+    connect(&m_socket, &QUdpSocket::readyRead, this, &PadStateSubscriber::onReadyRead);
+}
+
+bool PadStateSubscriber::listen(quint16 port)
+{
+    if (!m_socket.bind(QHostAddress::Any, port, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint)) {
+        qWarning() << "パッドの状態を受信できません:" << m_socket.errorString();
+        return false;
+    }
+    qInfo() << "パッドの状態を受信しています: ポート" << port;
+    return true;
+}
+
+const PadStateModel& PadStateSubscriber::state() const
+{
+    return m_state;
+}
+
+bool PadStateSubscriber::isSynchronized() const
+{
+    return m_synchronized;
+}
+
+uint64_t PadStateSubscriber::packetsReceived() const
+{
+    return m_packetsReceived;
+}
+
+uint64_t PadStateSubscriber::packetsLost() const
+{
+    return m_packetsLost;
+}
+
+void PadStateSubscriber::onReadyRead()
+{
+    while (m_socket.hasPendingDatagrams()) {
+        const qint64 size = m_socket.readDatagram(reinterpret_cast<char*>(m_packet), sizeof(m_packet));
+        if (size > 0) {
+            processPacket(m_packet, static_cast<std::size_t>(size));
+        }
+    }
+}
+
+bool PadStateSubscriber::processPacket(const unsigned char* data, std::size_t size)
+{
+    // 写しに反映し、シーケンス番号を確かめてから採用する
+    PadStateModel decoded = m_state;
+    PadMask changed;
+    bool keyframe = false;
+    uint32_t session = 0;
+    uint32_t sequence = 0;
+    if (!StreamFormat::decode(data, size, decoded, changed, keyframe, session, sequence)) {
+        return false;
+    }
+
+    if (m_receivedAny && session != m_session) {
+        // 配信側が再起動した: 全パッドの絶対値を持つキーフレームが届くまで切り替えない。
+        // 切り替えた後に前のセッションのパケットが遅れて届いても採用しない
+        const uint32_t* retiredBegin = m_retiredSessions;
+        const uint32_t* retiredEnd = retiredBegin + m_retiredCount;
+        if (!keyframe || std::find(retiredBegin, retiredEnd, session) != retiredEnd) {
+            return false;
+        }
+        std::copy_backward(m_retiredSessions, m_retiredSessions + RETIRED_SESSION_COUNT - 1,
+                           m_retiredSessions + RETIRED_SESSION_COUNT);
+        m_retiredSessions[0] = m_session;
+        m_retiredCount = std::min(m_retiredCount + 1, RETIRED_SESSION_COUNT);
+    } else if (m_receivedAny) {
+        // 符号付きの差で前後を判定する（番号の一巡にも対応）
+        const int32_t gap = static_cast<int32_t>(sequence - m_expectedSequence);
+        if (gap < 0) {
+            return false;  // 遅れて届いた古いパケットはキーフレームでも捨てる
+        }
+        if (gap > 0) {
+            m_packetsLost += static_cast<uint64_t>(gap);
+            m_synchronized = false;
+        }
+    }
+    m_receivedAny = true;
+    m_session = session;
+    m_expectedSequence = sequence + 1;
+    ++m_packetsReceived;
+    if (keyframe) {
+        m_synchronized = true;
+    }
+
+    // キーフレームは全パッドを含むため、実際に変わったパッドだけを通知する
+    changed.forEach([&](int index) {
+        unsigned char before[PadStateModel::PAD_RECORD_SIZE];
+        unsigned char after[PadStateModel::PAD_RECORD_SIZE];
+        m_state.serializePad(index, before);
+        decoded.serializePad(index, after);
+        if (std::memcmp(before, after, sizeof(before)) != 0) {
+            const int x = index % PadStateModel::GRID_SIZE;
+            const int y = index / PadStateModel::GRID_SIZE;
+            emit padChanged(x, y, decoded.color(x, y), decoded.isActive(x, y));
+        }
+    });
+    m_state = decoded;
+    return true;
+}
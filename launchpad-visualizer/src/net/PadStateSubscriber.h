@@ -0,0 +1,93 @@
+#ifndef PAD_STATE_SUBSCRIBER_H
+#define PAD_STATE_SUBSCRIBER_H
+
+#include <QObject>
+#include <QUdpSocket>
+#include <cstdint>
+#include "StreamFormat.h"
+#include "../model/PadStateModel.h"
+
+/**
+ * @brief PadStatePublisherが配信するパッドの状態を受信するクラス
+ * 受信したパケットを状態に反映し、変化したパッドをシグナルで通知する。
+ * シーケンス番号の飛びで取りこぼしを検出し、次のキーフレームまでは
+ * 同期が外れているものとして扱う（差分はそのまま適用する）。
+ * 期待より古いパケットは遅れて届いたものとして、キーフレームも含めて捨てる。
+ * 配信側が再起動するとセッションIDが変わるので、新しいセッションのキーフレームが
+ * 届いた時点でそのセッションに切り替えてシーケンス番号を合わせ直す
+ * （切り替える前のセッションのパケットは、遅れて届いても以後は採用しない）
+ */
+class PadStateSubscriber : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int RETIRED_SESSION_COUNT = 4;  // 採用しない過去のセッションIDの数
+
+    explicit PadStateSubscriber(QObject *parent = nullptr);
+
+    /**
+     * @brief 指定ポートで受信を開始
+     * @param port 受信するポート
+     * @return 成功した場合true
+     */
+    bool listen(quint16 port);
+
+    /**
+     * @brief 受信した1つのパケットを状態に反映
+     * @param data パケット
+     * @param size パケットのサイズ
+     * @return 採用した場合true（不正なパケット、古いパケット、切り替え前の別セッションのパケットはfalse）
+     */
+    bool processPacket(const unsigned char* data, std::size_t size);
+
+    /**
+     * @brief 受信した状態を取得
+     */
+    const PadStateModel& state() const;
+
+    /**
+     * @brief キーフレームを受信済みで、以後取りこぼしがないかどうか
+     */
+    bool isSynchronized() const;
+
+    /**
+     * @brief 受信したパケット数
+     */
+    uint64_t packetsReceived() const;
+
+    /**
+     * @brief シーケンス番号の飛びから数えた取りこぼしのパケット数
+     */
+    uint64_t packetsLost() const;
+
+signals:
+    /**
+     * @brief パッドの状態が変化したときに発行
+     * @param x X座標
+     * @param y Y座標
+     * @param rgb パッドの色 (0x00RRGGBB)
+     * @param active 押下中かどうか
+     */
+    void padChanged(int x, int y, uint32_t rgb, bool active);
+
+private slots:
+    /**
+     * @brief 届いたパケットをすべて読み出して反映
+     */
+    void onReadyRead();
+
+private:
+    QUdpSocket m_socket;          // 受信用ソケット
+    PadStateModel m_state;        // 受信した状態
+    uint32_t m_session;           // 受信中のセッションID
+    uint32_t m_retiredSessions[RETIRED_SESSION_COUNT];  // 切り替える前のセッションID（新しい順）
+    int m_retiredCount;           // 記録した過去のセッションIDの数
+    uint32_t m_expectedSequence;  // 次に届くはずのシーケンス番号
+    bool m_receivedAny;           // パケットを受信したかどうか
+    bool m_synchronized;          // 同期しているかどうか
+    uint64_t m_packetsReceived;   // 受信したパケット数
+    uint64_t m_packetsLost;       // 取りこぼしたパケット数
+    unsigned char m_packet[StreamFormat::MAX_PACKET_SIZE];  // 受信バッファ
+};
+
+#endif // PAD_STATE_SUBSCRIBER_H
@@ -0,0 +1,152 @@
+#include "SharedStateExporter.h"
+#include "../LaunchpadVisualizer.h"
+#include <QDebug>
+#include <cerrno>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+SharedStateExporter::SharedStateExporter(const LaunchpadVisualizer* visualizer, QObject *parent)
+    : QObject(parent)
+    , m_visualizer(visualizer)
+    , m_segment(nullptr)
+    , m_updateCount(0)
+{
+    std::memset(m_pads, 0, sizeof(m_pads));
+
+    // シグナルの引数のうち座標だけを使い、値は常にモデルから読む
+    connect(m_visualizer, &LaunchpadVisualizer::padPressed, this, &SharedStateExporter::onPadPressed);
+    connect(m_visualizer, &LaunchpadVisualizer::padReleased, this, &SharedStateExporter::onPadReleased);
+    connect(m_visualizer, &LaunchpadVisualizer::padColorChanged, this, &SharedStateExporter::onPadColorChanged);
+}
+
+SharedStateExporter::~SharedStateExporter()
+{
+    stop();
+}
+
+bool SharedStateExporter::start(const QString& name)
+{
+#ifdef Q_OS_UNIX
+    stop();
+
+    const QByteArray path = name.toLocal8Bit();
+    const int fd = shm_open(path.constData(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        qWarning() << "共有メモリを作成できません:" << name << std::strerror(errno);
+        return false;
+    }
+    if (ftruncate(fd, sizeof(lpv_shm_segment)) != 0) {
+        qWarning() << "共有メモリのサイズを設定できません:" << name << std::strerror(errno);
+        close(fd);
+        shm_unlink(path.constData());
+        return false;
+    }
+    void* mapped = mmap(nullptr, sizeof(lpv_shm_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        qWarning() << "共有メモリをマップできません:" << name << std::strerror(errno);
+        shm_unlink(path.constData());
+        return false;
+    }
+    m_segment = static_cast<lpv_shm_segment*>(mapped);
+    m_name = name;
+
+    // 前回の書き込み側が更新中に終了していた場合は、sequenceを偶数に戻してから更新を始める
+    __atomic_store_n(&m_segment->magic, 0u, __ATOMIC_RELAXED);
+    const uint32_t sequence = __atomic_load_n(&m_segment->sequence, __ATOMIC_RELAXED);
+    if (sequence & 1u) {
+        __atomic_store_n(&m_segment->sequence, sequence + 1u, __ATOMIC_RELAXED);
+    }
+    m_segment->version = LPV_SHM_VERSION;
+    m_segment->size = sizeof(lpv_shm_segment);
+    m_segment->writer_pid = static_cast<uint32_t>(getpid());
+
+    // 全パッドを現在の状態で初期化してから、読み出し側に公開する
+    lpv_shm_write_begin(m_segment);
+    for (int y = 0; y < LPV_SHM_GRID_SIZE; ++y) {
+        for (int x = 0; x < LPV_SHM_GRID_SIZE; ++x) {
+            const int index = PadStateModel::index(x, y);
+            m_pads[index] = padValue(x, y);
+            lpv_shm_write_pad(m_segment, index, m_pads[index]);
+        }
+    }
+    lpv_shm_write_end(m_segment, lpv_shm_checksum(m_pads), MidiEvent::now());
+    __atomic_store_n(&m_segment->magic, LPV_SHM_MAGIC, __ATOMIC_RELEASE);
+    ++m_updateCount;
+
+    qInfo() << "パッドの状態を共有メモリに書き出しています:" << name;
+    return true;
+#else
+    qWarning() << "共有メモリへの書き出しはこの環境では使えません:" << name;
+    return false;
+#endif
+}
+
+void SharedStateExporter::stop()
+{
+#ifdef Q_OS_UNIX
+    if (!m_segment) {
+        return;
+    }
+
+    // 読み出し中のプロセスがマップを残していても、無効と分かるようにする
+    __atomic_store_n(&m_segment->magic, 0u, __ATOMIC_RELEASE);
+    munmap(m_segment, sizeof(lpv_shm_segment));
+    shm_unlink(m_name.toLocal8Bit().constData());
+    m_segment = nullptr;
+#endif
+}
+
+bool SharedStateExporter::isActive() const
+{
+    return m_segment != nullptr;
+}
+
+uint64_t SharedStateExporter::updateCount() const
+{
+    return m_updateCount;
+}
+
+void SharedStateExporter::onPadPressed(int x, int y)
+{
+    writePad(x, y);
+}
+
+void SharedStateExporter::onPadReleased(int x, int y)
+{
+    writePad(x, y);
+}
+
+void SharedStateExporter::onPadColorChanged(int x, int y)
+{
+    writePad(x, y);
+}
+
+void SharedStateExporter::writePad(int x, int y)
+{
+    if (!m_segment || !PadStateModel::isValidCoordinate(x, y)) {
+        return;
+    }
+    const int index = PadStateModel::index(x, y);
+    const uint32_t value = padValue(x, y);
+    if (value == m_pads[index]) {
+        return;
+    }
+
+    m_pads[index] = value;
+    lpv_shm_write_begin(m_segment);
+    lpv_shm_write_pad(m_segment, index, value);
+    lpv_shm_write_end(m_segment, lpv_shm_checksum(m_pads), MidiEvent::now());
+    ++m_updateCount;
+}
+
+uint32_t SharedStateExporter::padValue(int x, int y) const
+{
+    const PadStateModel& state = m_visualizer->padState();
+    return LPV_SHM_PAD_VALUE(state.isActive(x, y), state.velocity(x, y), state.color(x, y));
+}
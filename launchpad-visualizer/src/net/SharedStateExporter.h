@@ -0,0 +1,70 @@
+#ifndef SHARED_STATE_EXPORTER_H
+#define SHARED_STATE_EXPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <cstdint>
+#include "lpv_shm.h"
+
+class LaunchpadVisualizer;
+
+/**
+ * @brief パッドの状態をPOSIX共有メモリに書き出すクラス
+ * 同じマシンの他のプロセスがソケットを使わずに現在の状態を読めるようにする。
+ * 配置と読み出し方は include/lpv_shm.h に定義し、パッドが変化するたびに
+ * 変化したパッドだけを seqlock で囲んで書き込む。POSIX以外の環境では何もしない
+ */
+class SharedStateExporter : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SharedStateExporter(const LaunchpadVisualizer* visualizer, QObject *parent = nullptr);
+    ~SharedStateExporter();
+
+    /**
+     * @brief 共有メモリを作成して書き出しを開始
+     * 同じ名前の古いセグメントが残っていれば引き継いで初期化し直す
+     * @param name 共有メモリの名前 ('/'で始まる)
+     * @return 成功した場合true
+     */
+    bool start(const QString& name = QString(LPV_SHM_DEFAULT_NAME));
+
+    /**
+     * @brief 書き出しを停止し、共有メモリを削除
+     */
+    void stop();
+
+    /**
+     * @brief 書き出し中かどうか
+     */
+    bool isActive() const;
+
+    /**
+     * @brief 書き込んだ更新の回数
+     */
+    uint64_t updateCount() const;
+
+private slots:
+    void onPadPressed(int x, int y);
+    void onPadReleased(int x, int y);
+    void onPadColorChanged(int x, int y);
+
+private:
+    /**
+     * @brief 1つのパッドの現在の状態を書き込む
+     */
+    void writePad(int x, int y);
+
+    /**
+     * @brief 現在の状態からパッドの値を作る
+     */
+    uint32_t padValue(int x, int y) const;
+
+    const LaunchpadVisualizer* m_visualizer;  // 読み出し元
+    lpv_shm_segment* m_segment;               // マップした共有メモリ (nullptrは停止中)
+    QString m_name;                           // 共有メモリの名前
+    uint32_t m_pads[LPV_SHM_PAD_COUNT];       // 書き込んだパッドの値（チェックサムの計算用）
+    uint64_t m_updateCount;                   // 書き込んだ更新の回数
+};
+
+#endif // SHARED_STATE_EXPORTER_H
@@ -0,0 +1,69 @@
+#include "StreamFormat.h"
+#include <cstring>
+
+namespace StreamFormat {
+
+std::size_t encode(const PadStateModel& state, const PadMask& changed, bool keyframe,
+                   uint32_t session, uint32_t sequence, unsigned char* out)
+{
+    std::memcpy(out, MAGIC, sizeof(MAGIC));
+    out[4] = VERSION;
+    out[5] = keyframe ? FLAG_KEYFRAME : 0;
+    for (int i = 0; i < 4; ++i) {
+        out[6 + i] = static_cast<unsigned char>(sequence >> (8 * i));
+        out[10 + i] = static_cast<unsigned char>(session >> (8 * i));
+    }
+
+    unsigned char* mask = out + HEADER_SIZE;
+    unsigned char* record = mask + MASK_SIZE;
+    std::memset(mask, 0, MASK_SIZE);
+    for (int index = 0; index < PadStateModel::PAD_COUNT; ++index) {
+        if (!keyframe && !changed.test(index)) {
+            continue;
+        }
+        mask[index >> 3] |= static_cast<unsigned char>(1 << (index & 7));
+        state.serializePad(index, record);
+        record += PadStateModel::PAD_RECORD_SIZE;
+    }
+    return static_cast<std::size_t>(record - out);
+}
+
+bool decode(const unsigned char* data, std::size_t size, PadStateModel& state, PadMask& changed,
+            bool& keyframe, uint32_t& session, uint32_t& sequence)
+{
+    if (size < HEADER_SIZE + MASK_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || data[4] != VERSION) {
+        return false;
+    }
+
+    // 先にマスクとサイズが合っているかを確かめてから反映する
+    const unsigned char* mask = data + HEADER_SIZE;
+    PadMask pads;
+    std::size_t padCount = 0;
+    for (int index = 0; index < PadStateModel::PAD_COUNT; ++index) {
+        if (mask[index >> 3] & (1 << (index & 7))) {
+            pads.set(index);
+            ++padCount;
+        }
+    }
+    if (size != HEADER_SIZE + MASK_SIZE + padCount * PadStateModel::PAD_RECORD_SIZE) {
+        return false;
+    }
+
+    const unsigned char* record = mask + MASK_SIZE;
+    pads.forEach([&](int index) {
+        state.deserializePad(index, record);
+        record += PadStateModel::PAD_RECORD_SIZE;
+    });
+
+    changed = pads;
+    keyframe = (data[5] & FLAG_KEYFRAME) != 0;
+    sequence = 0;
+    session = 0;
+    for (int i = 0; i < 4; ++i) {
+        sequence |= static_cast<uint32_t>(data[6 + i]) << (8 * i);
+        session |= static_cast<uint32_t>(data[10 + i]) << (8 * i);
+    }
+    return true;
+}
+
+} // namespace StreamFormat
@@ -0,0 +1,65 @@
+#ifndef STREAM_FORMAT_H
+#define STREAM_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "../model/PadStateModel.h"
+#include "../util/PadMask.h"
+
+/**
+ * @brief パッドの状態をネットワークで配信するパケット (UDP) のフォーマット定義
+ *
+ * パケット構成:
+ *   ヘッダー (14バイト)
+ *     [0-3]   マジック "LPVN"
+ *     [4]     バージョン
+ *     [5]     フラグ (bit0: キーフレーム)
+ *     [6-9]   シーケンス番号 (リトルエンディアン、パケットごとに1ずつ増える)
+ *     [10-13] セッションID (リトルエンディアン、配信側の起動ごとに乱数で決める)
+ *   変化したパッドのビットマスク (MASK_SIZEバイト、パッドインデックスの昇順にLSBから)
+ *   変化したパッドの状態 (ビットの立ったパッドの順に PadStateModel::PAD_RECORD_SIZE バイトずつ)
+ *
+ * キーフレームは全パッドのビットを立てたパケット。差分のパケットも変化したパッドの
+ * 絶対値を持つため、パケットを取りこぼしても受信側はそれ以降の差分をそのまま適用でき、
+ * 取りこぼした分は次のキーフレームで揃う。
+ * シーケンス番号は同じセッションの中でだけ比較する（配信側が再起動すると番号が戻る）
+ */
+namespace StreamFormat {
+
+constexpr char MAGIC[4] = {'L', 'P', 'V', 'N'};
+constexpr uint8_t VERSION = 2;
+constexpr uint8_t FLAG_KEYFRAME = 0x01;
+constexpr std::size_t HEADER_SIZE = 14;
+constexpr std::size_t MASK_SIZE = (PadStateModel::PAD_COUNT + 7) / 8;
+constexpr std::size_t MAX_PACKET_SIZE = HEADER_SIZE + MASK_SIZE + PadStateModel::SNAPSHOT_SIZE;
+
+/**
+ * @brief パケットを組み立てる
+ * @param state 現在の状態
+ * @param changed 送るパッド（キーフレームの場合は無視して全パッドを送る）
+ * @param keyframe キーフレームかどうか
+ * @param session セッションID
+ * @param sequence シーケンス番号
+ * @param out 出力先 (MAX_PACKET_SIZEバイト以上)
+ * @return パケットのサイズ
+ */
+std::size_t encode(const PadStateModel& state, const PadMask& changed, bool keyframe,
+                   uint32_t session, uint32_t sequence, unsigned char* out);
+
+/**
+ * @brief パケットを読み、変化したパッドを状態に反映する
+ * @param data パケット
+ * @param size パケットのサイズ
+ * @param state 反映先
+ * @param changed 反映したパッド（出力）
+ * @param keyframe キーフレームかどうか（出力）
+ * @param session セッションID（出力）
+ * @param sequence シーケンス番号（出力）
+ * @return 正しいパケットの場合true（falseの場合stateは変更しない）
+ */
+bool decode(const unsigned char* data, std::size_t size, PadStateModel& state, PadMask& changed,
+            bool& keyframe, uint32_t& session, uint32_t& sequence);
+
+} // namespace StreamFormat
+
+#endif // STREAM_FORMAT_H
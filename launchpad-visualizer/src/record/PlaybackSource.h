@@ -0,0 +1,44 @@
+#ifndef PLAYBACK_SOURCE_H
+#define PLAYBACK_SOURCE_H
+
+#include <cstdint>
+#include "../midi/MidiEvent.h"
+#include "../model/PadStateModel.h"
+
+/**
+ * @brief 再生用のMIDIイベント供給元のインターフェース
+ * SessionPlayerはこのインターフェースを通じてイベントを順に読み出す
+ */
+class PlaybackSource {
+public:
+    virtual ~PlaybackSource() = default;
+
+    /**
+     * @brief 次のイベントを読み出す
+     * @param event 出力イベント。timestampNsにはセッション開始からの経過時間を設定する
+     * @return イベントがない（終端または不正なデータ）場合false
+     */
+    virtual bool readNext(MidiEvent& event) = 0;
+
+    /**
+     * @brief 読み出し位置を先頭に戻す
+     */
+    virtual void rewind() = 0;
+
+    /**
+     * @brief 指定位置へシークし、その時点のパッド状態を復元する
+     * シーク後のreadNextは、時刻がtargetNs以上の最初のイベントを返す
+     * @param targetNs セッション開始からの時刻 (ナノ秒)
+     * @param state 出力パッド状態
+     * @return 成功した場合true
+     */
+    virtual bool seek(uint64_t targetNs, PadStateModel& state) = 0;
+
+    /**
+     * @brief セッションの長さを取得
+     * @return 長さ (ナノ秒)
+     */
+    virtual uint64_t durationNs() const = 0;
+};
+
+#endif // PLAYBACK_SOURCE_H
@@ -0,0 +1,30 @@
+#ifndef RECORDING_WRITER_H
+#define RECORDING_WRITER_H
+
+#include <cstdint>
+#include "../midi/MidiEvent.h"
+
+/**
+ * @brief SessionRecorderが使用する記録先フォーマットのインターフェース
+ * 書き込みスレッドからのみ呼ばれる
+ */
+class RecordingWriter {
+public:
+    virtual ~RecordingWriter() = default;
+
+    /**
+     * @brief イベントを1件書き込む
+     * @param event 書き込むイベント
+     * @param timeUs 記録開始からの時刻 (マイクロ秒、単調増加)
+     * @return 記録対象のイベントだった場合true
+     */
+    virtual bool writeEvent(const MidiEvent& event, uint64_t timeUs) = 0;
+
+    /**
+     * @brief 未書き込みのデータを書き出してファイルを閉じる
+     * @return すべての書き込みに成功した場合true
+     */
+    virtual bool close() = 0;
+};
+
+#endif // RECORDING_WRITER_H
@@ -0,0 +1,155 @@
+#ifndef SESSION_FORMAT_H
+#define SESSION_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief セッション記録ファイル (.lpvs) のフォーマット定義
+ *
+ * ファイル構成:
+ *   ヘッダー (16バイト)
+ *     [0-3]   マジック "LPVS"
+ *     [4-5]   バージョン (リトルエンディアン)
+ *     [6-7]   予約 (0)
+ *     [8-15]  記録開始時刻 (UNIXエポックからのミリ秒、リトルエンディアン)
+ *   レコード列
+ *     [varint] 直前のレコードからの経過時間 (マイクロ秒、LEB128)
+ *     [1バイト] ステータスバイト (ランニングステータスの場合は省略)
+ *     [0-2バイト] データバイト
+ *   インデックス (バージョン2以降、正常に閉じられたファイルのみ)
+ *     [16バイト x N] キーフレームの時刻 (マイクロ秒) とファイル先頭からのオフセット
+ *   トレーラー (24バイト)
+ *     [0-7]   インデックスの開始オフセット (= レコード列の終端)
+ *     [8-15]  セッションの長さ (マイクロ秒)
+ *     [16-19] インデックスのエントリ数
+ *     [20-23] マジック "LPVI"
+ *
+ * ランニングステータスはチャンネルメッセージにのみ適用し、システムメッセージは
+ * 常にステータスバイトを書き込む（ランニングステータスも更新しない）
+ *
+ * キーフレームはステータスバイト KEYFRAME_STATUS (MIDIで未定義の0xFD) に続けて
+ * PadStateModel のスナップショットを持つレコード。キーフレームの直後は
+ * ランニングステータスが無効になるため、次のチャンネルメッセージは必ず
+ * ステータスバイトを持つ。トレーラーのないファイル（バージョン1や記録中の
+ * 異常終了）はファイル終端までをレコード列として扱う。
+ * キーフレームとトレーラーは KEYFRAME_VERSION 以降のファイルでのみ解釈する
+ * （バージョン1の0xFDは通常の1バイトのシステムメッセージ）
+ */
+namespace SessionFormat {
+
+constexpr char MAGIC[4] = {'L', 'P', 'V', 'S'};
+constexpr uint16_t VERSION = 2;
+constexpr uint16_t KEYFRAME_VERSION = 2;          // キーフレームとインデックスを導入したバージョン
+constexpr std::size_t HEADER_SIZE = 16;
+
+constexpr unsigned char KEYFRAME_STATUS = 0xFD;   // キーフレームレコードのステータス
+constexpr std::size_t INDEX_ENTRY_SIZE = 16;      // インデックス1エントリのサイズ
+constexpr char TRAILER_MAGIC[4] = {'L', 'P', 'V', 'I'};
+constexpr std::size_t TRAILER_SIZE = 24;
+
+/**
+ * @brief varintの最大バイト数 (64ビット値)
+ */
+constexpr std::size_t MAX_VARINT_SIZE = 10;
+
+/**
+ * @brief 符号なし整数をLEB128形式で書き込む
+ * @param value 書き込む値
+ * @param out 出力先 (MAX_VARINT_SIZEバイト以上の空きが必要)
+ * @return 書き込んだバイト数
+ */
+inline std::size_t writeVarint(uint64_t value, unsigned char* out)
+{
+    std::size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = static_cast<unsigned char>(value);
+    return n;
+}
+
+/**
+ * @brief LEB128形式の符号なし整数を読み込む
+ * @param data 読み込み位置（成功時は読み込んだ分だけ進める）
+ * @param end データ終端
+ * @param value 出力値
+ * @return 成功した場合true、データ不足または不正な場合false
+ */
+inline bool readVarint(const unsigned char*& data, const unsigned char* end, uint64_t& value)
+{
+    uint64_t result = 0;
+    int shift = 0;
+    for (const unsigned char* p = data; p < end && shift < 64; ++p, shift += 7) {
+        result |= static_cast<uint64_t>(*p & 0x7F) << shift;
+        if ((*p & 0x80) == 0) {
+            data = p + 1;
+            value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 16ビット値をリトルエンディアンで書き込む
+ */
+inline void writeU16(uint16_t value, unsigned char* out)
+{
+    out[0] = static_cast<unsigned char>(value);
+    out[1] = static_cast<unsigned char>(value >> 8);
+}
+
+/**
+ * @brief 64ビット値をリトルエンディアンで書き込む
+ */
+inline void writeU64(uint64_t value, unsigned char* out)
+{
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<unsigned char>(value >> (i * 8));
+    }
+}
+
+/**
+ * @brief 32ビット値をリトルエンディアンで書き込む
+ */
+inline void writeU32(uint32_t value, unsigned char* out)
+{
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<unsigned char>(value >> (i * 8));
+    }
+}
+
+/**
+ * @brief リトルエンディアンの16ビット値を読み込む
+ */
+inline uint16_t readU16(const unsigned char* in)
+{
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+/**
+ * @brief リトルエンディアンの32ビット値を読み込む
+ */
+inline uint32_t readU32(const unsigned char* in)
+{
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8)
+        | (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+/**
+ * @brief リトルエンディアンの64ビット値を読み込む
+ */
+inline uint64_t readU64(const unsigned char* in)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (i * 8);
+    }
+    return value;
+}
+
+} // namespace SessionFormat
+
+#endif // SESSION_FORMAT_H
@@ -0,0 +1,49 @@
+#include "SessionIndexer.h"
+#include "SessionReader.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+
+bool SessionIndexer::rebuild(const QString& inputPath, const QString& outputPath,
+                             uint64_t keyframeIntervalUs, uint32_t keyframeEvents)
+{
+    // 入力はマップしたまま読むため、同じパスへの出力は一時ファイル経由で置き換える
+    const bool inPlace = QFileInfo(inputPath).canonicalFilePath() == QFileInfo(outputPath).canonicalFilePath();
+    const QString writePath = inPlace ? outputPath + ".tmp" : outputPath;
+
+    SessionReader reader;
+    if (!reader.open(inputPath)) {
+        return false;
+    }
+
+    SessionWriter writer;
+    writer.setKeyframeInterval(keyframeIntervalUs, keyframeEvents);
+    if (!writer.open(writePath, reader.startEpochMs())) {
+        return false;
+    }
+
+    MidiEvent event;
+    uint64_t count = 0;
+    while (reader.readNext(event)) {
+        if (writer.writeEvent(event, event.timestampNs / 1000)) {
+            ++count;
+        }
+    }
+
+    reader.close();
+    if (!writer.close()) {
+        QFile::remove(writePath);
+        return false;
+    }
+
+    if (inPlace) {
+        QFile::remove(outputPath);
+        if (!QFile::rename(writePath, outputPath)) {
+            qWarning() << "インデックス付きファイルで置き換えられません:" << outputPath;
+            return false;
+        }
+    }
+
+    qInfo() << "インデックスを作成しました:" << outputPath << "イベント数:" << count;
+    return true;
+}
@@ -0,0 +1,28 @@
+#ifndef SESSION_INDEXER_H
+#define SESSION_INDEXER_H
+
+#include <QString>
+#include <cstdint>
+#include "SessionWriter.h"
+
+/**
+ * @brief 既存のセッションファイルにキーフレームとインデックスを付与するクラス
+ * 入力を先頭から1回だけ読み、SessionWriterで書き直すストリーミング処理のため、
+ * 長時間の記録でもメモリ使用量はインデックスの大きさ程度に収まる
+ */
+class SessionIndexer {
+public:
+    /**
+     * @brief キーフレームとインデックスを付けたセッションファイルを作成
+     * @param inputPath 入力ファイル（バージョン1のファイルも可）
+     * @param outputPath 出力ファイル（入力と同じパスなら置き換える）
+     * @param keyframeIntervalUs キーフレーム間の最大時間 (マイクロ秒)
+     * @param keyframeEvents キーフレーム間の最大イベント数
+     * @return 成功した場合true
+     */
+    static bool rebuild(const QString& inputPath, const QString& outputPath,
+                        uint64_t keyframeIntervalUs = SessionWriter::DEFAULT_KEYFRAME_INTERVAL_US,
+                        uint32_t keyframeEvents = SessionWriter::DEFAULT_KEYFRAME_EVENTS);
+};
+
+#endif // SESSION_INDEXER_H
@@ -0,0 +1,231 @@
+#include "SessionPlayer.h"
+#include "SessionReader.h"
+#include "SmfReader.h"
+#include "../midi/MidiManager.h"
+#include "../diag/TraceRecorder.h"
+#include <QFileInfo>
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+
+SessionPlayer::SessionPlayer(MidiManager* target, QObject *parent)
+    : QObject(parent)
+    , m_target(target)
+    , m_running(false)
+    , m_paused(false)
+    , m_speed(1.0)
+    , m_positionNs(0)
+    , m_seekRequestNs(NO_SEEK)
+    , m_durationNs(0)
+{
+    qRegisterMetaType<PadStateModel>();
+}
+
+SessionPlayer::~SessionPlayer()
+{
+    stop();
+}
+
+std::unique_ptr<PlaybackSource> SessionPlayer::openSource(const QString& filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == "mid" || suffix == "midi") {
+        auto smfReader = std::make_unique<SmfReader>();
+        if (!smfReader->open(filePath)) {
+            return nullptr;
+        }
+        return smfReader;
+    }
+
+    auto sessionReader = std::make_unique<SessionReader>();
+    if (!sessionReader->open(filePath)) {
+        return nullptr;
+    }
+    return sessionReader;
+}
+
+bool SessionPlayer::start(std::unique_ptr<PlaybackSource> source)
+{
+    stop();
+
+    if (!source || !m_target) {
+        return false;
+    }
+
+    m_source = std::move(source);
+    m_source->rewind();
+    m_positionNs.store(0, std::memory_order_relaxed);
+    m_seekRequestNs.store(NO_SEEK, std::memory_order_relaxed);
+    m_durationNs.store(m_source->durationNs(), std::memory_order_relaxed);
+    m_paused.store(false, std::memory_order_relaxed);
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&SessionPlayer::playbackLoop, this);
+    return true;
+}
+
+void SessionPlayer::stop()
+{
+    m_running.store(false, std::memory_order_release);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_source.reset();
+}
+
+void SessionPlayer::setPaused(bool paused)
+{
+    m_paused.store(paused, std::memory_order_release);
+}
+
+void SessionPlayer::setSpeed(double speed)
+{
+    if (speed != AS_FAST_AS_POSSIBLE) {
+        speed = std::clamp(speed, MIN_SPEED, MAX_SPEED);
+    }
+    m_speed.store(speed, std::memory_order_release);
+}
+
+double SessionPlayer::speed() const
+{
+    return m_speed.load(std::memory_order_acquire);
+}
+
+bool SessionPlayer::isPlaying() const
+{
+    return m_running.load(std::memory_order_acquire);
+}
+
+uint64_t SessionPlayer::positionNs() const
+{
+    return m_positionNs.load(std::memory_order_relaxed);
+}
+
+void SessionPlayer::seek(uint64_t positionNs)
+{
+    m_seekRequestNs.store(positionNs, std::memory_order_release);
+}
+
+uint64_t SessionPlayer::durationNs() const
+{
+    return m_durationNs.load(std::memory_order_relaxed);
+}
+
+void SessionPlayer::playbackLoop()
+{
+    TRACE_THREAD_NAME("再生");
+
+    // 再生位置と実時刻の対応点。速度変更や一時停止からの復帰で取り直す
+    uint64_t anchorWallNs = MidiEvent::now();
+    uint64_t anchorMediaNs = 0;
+    double anchorSpeed = speed();
+    bool paused = false;
+
+    MidiEvent event;
+    bool pending = m_source->readNext(event);
+
+    while (m_running.load(std::memory_order_acquire)) {
+        const uint64_t seekNs = m_seekRequestNs.exchange(NO_SEEK, std::memory_order_acq_rel);
+        if (seekNs != NO_SEEK) {
+            // 最寄りのキーフレームから状態を復元し、その位置から再生を続ける
+            PadStateModel state;
+            m_source->seek(seekNs, state);
+            emit stateRestored(state);
+            m_positionNs.store(seekNs, std::memory_order_relaxed);
+            anchorWallNs = MidiEvent::now();
+            anchorMediaNs = seekNs;
+            pending = m_source->readNext(event);
+        }
+
+        if (!pending) {
+            break;
+        }
+
+        if (m_paused.load(std::memory_order_acquire)) {
+            if (!paused) {
+                // 一時停止した瞬間の再生位置で止め、再開時はそこから進める
+                const uint64_t nowNs = MidiEvent::now();
+                anchorMediaNs = mediaTimeAt(anchorMediaNs, anchorWallNs, anchorSpeed, nowNs, event.timestampNs);
+                m_positionNs.store(anchorMediaNs, std::memory_order_relaxed);
+                paused = true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            anchorWallNs = MidiEvent::now();
+            continue;
+        }
+        paused = false;
+
+        const double currentSpeed = speed();
+        if (currentSpeed != anchorSpeed) {
+            // 旧速度で進んだ分を含めた現在の再生位置を新しい対応点にする
+            const uint64_t nowNs = MidiEvent::now();
+            anchorMediaNs = mediaTimeAt(anchorMediaNs, anchorWallNs, anchorSpeed, nowNs, event.timestampNs);
+            anchorWallNs = nowNs;
+            anchorSpeed = currentSpeed;
+        }
+
+        if (currentSpeed != AS_FAST_AS_POSSIBLE) {
+            const uint64_t mediaDelta = event.timestampNs > anchorMediaNs
+                ? event.timestampNs - anchorMediaNs : 0;
+            const uint64_t deadline = anchorWallNs + static_cast<uint64_t>(mediaDelta / currentSpeed);
+            if (!waitUntil(deadline, currentSpeed)) {
+                continue;  // 中断された場合は状態を確認し直す
+            }
+        }
+
+        // 最速再生では時間で再生位置が進まないため、送出したイベントの時刻を対応点にする
+        if (currentSpeed == AS_FAST_AS_POSSIBLE) {
+            anchorMediaNs = event.timestampNs;
+        }
+
+        // ライブ入力と同様に、送出時刻をキャプチャ時刻として扱う
+        m_positionNs.store(event.timestampNs, std::memory_order_relaxed);
+        MidiEvent live = event;
+        live.timestampNs = MidiEvent::now();
+        m_target->injectEvent(live);
+
+        pending = m_source->readNext(event);
+    }
+
+    if (!pending) {
+        m_running.store(false, std::memory_order_release);
+        m_positionNs.store(m_durationNs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        emit playbackFinished();
+    }
+}
+
+uint64_t SessionPlayer::mediaTimeAt(uint64_t anchorMediaNs, uint64_t anchorWallNs, double speed,
+                                    uint64_t wallNs, uint64_t limitNs)
+{
+    if (speed == AS_FAST_AS_POSSIBLE || wallNs <= anchorWallNs) {
+        return anchorMediaNs;
+    }
+
+    const uint64_t mediaNs = anchorMediaNs + static_cast<uint64_t>((wallNs - anchorWallNs) * speed);
+    return std::max(anchorMediaNs, std::min(mediaNs, limitNs));
+}
+
+bool SessionPlayer::waitUntil(uint64_t deadlineNs, double speed) const
+{
+    for (;;) {
+        if (!m_running.load(std::memory_order_acquire)
+            || m_paused.load(std::memory_order_acquire)
+            || m_seekRequestNs.load(std::memory_order_acquire) != NO_SEEK
+            || m_speed.load(std::memory_order_acquire) != speed) {
+            return false;
+        }
+
+        const uint64_t now = MidiEvent::now();
+        if (now >= deadlineNs) {
+            return true;
+        }
+
+        const uint64_t remaining = deadlineNs - now;
+        if (remaining > SPIN_THRESHOLD_NS) {
+            // OSのスリープ精度を考慮し、スピン区間を残して眠る
+            const uint64_t sleepNs = std::min(remaining - SPIN_THRESHOLD_NS / 2, MAX_SLEEP_NS);
+            std::this_thread::sleep_for(std::chrono::nanoseconds(sleepNs));
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,152 @@
+#ifndef SESSION_PLAYER_H
+#define SESSION_PLAYER_H
+
+#include <QObject>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "PlaybackSource.h"
+#include "../model/PadStateModel.h"
+
+class MidiManager;
+
+Q_DECLARE_METATYPE(PadStateModel)
+
+/**
+ * @brief 記録済みセッションをライブ入力と同じ経路で再生するクラス
+ * 専用スレッドで高分解能のスケジューリングを行い、各イベントを
+ * MidiManager::injectEvent に渡す。QTimerは使用しない
+ */
+class SessionPlayer : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr double MIN_SPEED = 0.1;              // 最低再生速度
+    static constexpr double MAX_SPEED = 100.0;            // 最高再生速度
+    static constexpr double AS_FAST_AS_POSSIBLE = 0.0;    // 待ち時間なしで再生する速度指定
+
+    /**
+     * @brief コンストラクタ
+     * @param target イベントの送り先
+     * @param parent 親オブジェクト
+     */
+    explicit SessionPlayer(MidiManager* target, QObject *parent = nullptr);
+    ~SessionPlayer();
+
+    /**
+     * @brief 記録ファイルを開いてイベント供給元を作成
+     * 拡張子が .mid/.midi の場合はStandard MIDI File、それ以外はセッション形式として開く
+     * @param filePath ファイルパス
+     * @return 開けなかった場合nullptr
+     */
+    static std::unique_ptr<PlaybackSource> openSource(const QString& filePath);
+
+    /**
+     * @brief 再生を開始
+     * @param source 再生するイベント供給元（所有権を受け取る）
+     * @return 開始に成功した場合true
+     */
+    bool start(std::unique_ptr<PlaybackSource> source);
+
+    /**
+     * @brief 再生を停止
+     */
+    void stop();
+
+    /**
+     * @brief 一時停止状態を設定
+     * @param paused 一時停止する場合true
+     */
+    void setPaused(bool paused);
+
+    /**
+     * @brief 再生速度を設定
+     * @param speed 倍率 (0.1-100)。AS_FAST_AS_POSSIBLEの場合は待ち時間なし
+     */
+    void setSpeed(double speed);
+
+    /**
+     * @brief 現在の再生速度を取得
+     */
+    double speed() const;
+
+    /**
+     * @brief 再生中かどうか
+     */
+    bool isPlaying() const;
+
+    /**
+     * @brief 再生位置を移動
+     * 再生スレッドで最寄りのキーフレームから状態を復元し、stateRestoredを発行する
+     * @param positionNs セッション開始からの時刻 (ナノ秒)
+     */
+    void seek(uint64_t positionNs);
+
+    /**
+     * @brief 再生中のセッションの長さを取得
+     * @return 長さ (ナノ秒)
+     */
+    uint64_t durationNs() const;
+
+    /**
+     * @brief 現在の再生位置を取得
+     * @return セッション開始からの経過時間 (ナノ秒)
+     */
+    uint64_t positionNs() const;
+
+signals:
+    /**
+     * @brief 最後のイベントまで再生したときに発生するシグナル
+     */
+    void playbackFinished();
+
+    /**
+     * @brief シークによりパッド状態が復元されたときに発生するシグナル
+     * @param state シーク位置でのパッド状態
+     */
+    void stateRestored(const PadStateModel& state);
+
+private:
+    /**
+     * @brief 再生スレッドの本体
+     */
+    void playbackLoop();
+
+    /**
+     * @brief 対応点から求めた、指定時刻における再生位置
+     * @param anchorMediaNs 対応点の再生位置
+     * @param anchorWallNs 対応点の実時刻
+     * @param speed 対応点以降の再生速度
+     * @param wallNs 求める実時刻
+     * @param limitNs 再生位置の上限 (未送出の次イベントの時刻)
+     * @return 再生位置 (ナノ秒)。最速再生では対応点（最後に送出したイベントの時刻）
+     */
+    static uint64_t mediaTimeAt(uint64_t anchorMediaNs, uint64_t anchorWallNs, double speed,
+                                uint64_t wallNs, uint64_t limitNs);
+
+    /**
+     * @brief 指定時刻まで待機
+     * 終盤はスピンして1ms未満の精度で起床する
+     * @param deadlineNs 起床時刻 (steady_clock基準)
+     * @param speed 待機開始時の再生速度
+     * @return 時刻に達した場合true、停止・一時停止・速度変更・シークで中断した場合false
+     */
+    bool waitUntil(uint64_t deadlineNs, double speed) const;
+
+private:
+    static constexpr uint64_t SPIN_THRESHOLD_NS = 2000000;  // この時間を切ったらスピン待機 (2ms)
+    static constexpr uint64_t MAX_SLEEP_NS = 10000000;      // 1回のスリープの上限 (10ms)
+    static constexpr uint64_t NO_SEEK = UINT64_MAX;         // シーク要求なし
+
+    MidiManager* m_target;                    // イベントの送り先
+    std::unique_ptr<PlaybackSource> m_source; // 再生中の供給元
+    std::thread m_thread;                     // 再生スレッド
+    std::atomic<bool> m_running;              // 再生スレッド継続フラグ
+    std::atomic<bool> m_paused;               // 一時停止フラグ
+    std::atomic<double> m_speed;              // 再生速度
+    std::atomic<uint64_t> m_positionNs;       // 再生位置
+    std::atomic<uint64_t> m_seekRequestNs;    // シーク要求 (NO_SEEKなら要求なし)
+    std::atomic<uint64_t> m_durationNs;       // セッションの長さ
+};
+
+#endif // SESSION_PLAYER_H
@@ -0,0 +1,299 @@
+#include "SessionReader.h"
+#include "SessionFormat.h"
+#include <QDebug>
+#include <cstring>
+
+SessionReader::SessionReader()
+    : m_begin(nullptr)
+    , m_records(nullptr)
+    , m_end(nullptr)
+    , m_cursor(nullptr)
+    , m_timeUs(0)
+    , m_runningStatus(0)
+    , m_startEpochMs(0)
+    , m_version(0)
+    , m_keyframes(false)
+    , m_index(nullptr)
+    , m_indexCount(0)
+    , m_durationUs(0)
+{
+}
+
+SessionReader::~SessionReader()
+{
+    close();
+}
+
+bool SessionReader::open(const QString& filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "セッションファイルを開けません:" << filePath << m_file.errorString();
+        return false;
+    }
+
+    const qint64 fileSize = m_file.size();
+    if (fileSize < static_cast<qint64>(SessionFormat::HEADER_SIZE)) {
+        qWarning() << "セッションファイルが短すぎます:" << filePath;
+        m_file.close();
+        return false;
+    }
+
+    const unsigned char* data = m_file.map(0, fileSize);
+    if (!data) {
+        qWarning() << "セッションファイルをマップできません:" << filePath << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    // ヘッダーの検証
+    if (std::memcmp(data, SessionFormat::MAGIC, sizeof(SessionFormat::MAGIC)) != 0
+        || SessionFormat::readU16(data + 4) > SessionFormat::VERSION) {
+        qWarning() << "未対応のセッションファイルです:" << filePath;
+        m_file.unmap(const_cast<unsigned char*>(data));
+        m_file.close();
+        return false;
+    }
+
+    m_begin = data;
+    m_records = data + SessionFormat::HEADER_SIZE;
+    m_end = data + fileSize;
+    m_startEpochMs = static_cast<qint64>(SessionFormat::readU64(data + 8));
+    m_version = SessionFormat::readU16(data + 4);
+    m_keyframes = m_version >= SessionFormat::KEYFRAME_VERSION;
+    loadTrailer(fileSize);
+    if (!m_index) {
+        m_durationUs = scanDuration();
+    }
+    rewind();
+    return true;
+}
+
+void SessionReader::close()
+{
+    if (m_begin) {
+        m_file.unmap(const_cast<unsigned char*>(m_begin));
+    }
+    m_file.close();
+
+    m_begin = nullptr;
+    m_records = nullptr;
+    m_end = nullptr;
+    m_cursor = nullptr;
+    m_index = nullptr;
+    m_indexCount = 0;
+    m_durationUs = 0;
+}
+
+bool SessionReader::isOpen() const
+{
+    return m_begin != nullptr;
+}
+
+qint64 SessionReader::startEpochMs() const
+{
+    return m_startEpochMs;
+}
+
+uint16_t SessionReader::version() const
+{
+    return m_version;
+}
+
+bool SessionReader::hasIndex() const
+{
+    return m_index != nullptr;
+}
+
+void SessionReader::loadTrailer(qint64 fileSize)
+{
+    m_index = nullptr;
+    m_indexCount = 0;
+    m_durationUs = 0;
+
+    const qint64 minSize = static_cast<qint64>(SessionFormat::HEADER_SIZE + SessionFormat::TRAILER_SIZE);
+    if (!m_keyframes || fileSize < minSize) {
+        return;
+    }
+
+    const unsigned char* trailer = m_begin + fileSize - SessionFormat::TRAILER_SIZE;
+    if (std::memcmp(trailer + 20, SessionFormat::TRAILER_MAGIC, sizeof(SessionFormat::TRAILER_MAGIC)) != 0) {
+        return;  // 正常に閉じられていないファイル
+    }
+
+    const uint64_t indexOffset = SessionFormat::readU64(trailer);
+    const uint32_t count = SessionFormat::readU32(trailer + 16);
+    const uint64_t indexEnd = static_cast<uint64_t>(fileSize) - SessionFormat::TRAILER_SIZE;
+    if (indexOffset < SessionFormat::HEADER_SIZE || indexOffset > indexEnd
+        || (indexEnd - indexOffset) != static_cast<uint64_t>(count) * SessionFormat::INDEX_ENTRY_SIZE) {
+        qWarning() << "セッションファイルのインデックスが不正です。インデックスなしで読み込みます";
+        return;
+    }
+
+    m_end = m_begin + indexOffset;
+    m_index = m_begin + indexOffset;
+    m_indexCount = count;
+    m_durationUs = SessionFormat::readU64(trailer + 8);
+}
+
+uint64_t SessionReader::scanDuration()
+{
+    rewind();
+    MidiEvent event;
+    uint64_t lastNs = 0;
+    while (readNext(event)) {
+        lastNs = event.timestampNs;
+    }
+    return lastNs / 1000;
+}
+
+bool SessionReader::readNext(MidiEvent& event)
+{
+    if (!m_cursor) {
+        return false;
+    }
+
+    const unsigned char* p = m_cursor;
+    uint64_t deltaUs = 0;
+    for (;;) {
+        if (p >= m_end) {
+            return false;
+        }
+        if (!SessionFormat::readVarint(p, m_end, deltaUs) || p >= m_end) {
+            return false;  // 末尾のレコードが途中で切れている
+        }
+        if (*p != SessionFormat::KEYFRAME_STATUS || !m_keyframes) {
+            break;
+        }
+
+        // キーフレームは通常の読み出しでは読み飛ばす
+        if (static_cast<std::size_t>(m_end - p) < 1 + PadStateModel::SNAPSHOT_SIZE) {
+            return false;
+        }
+        p += 1 + PadStateModel::SNAPSHOT_SIZE;
+        m_timeUs += deltaUs;
+        m_runningStatus = 0;
+        m_cursor = p;
+    }
+
+    // ステータスバイト (データバイトならランニングステータス)
+    unsigned char status = *p;
+    if (status < 0x80) {
+        if (m_runningStatus == 0) {
+            return false;  // 不正なデータ
+        }
+        status = m_runningStatus;
+    } else {
+        ++p;
+    }
+
+    const int length = midiMessageLength(status);
+    if (length == 0 || m_end - p < length - 1) {
+        return false;
+    }
+
+    event.data[0] = status;
+    event.data[1] = length > 1 ? p[0] : 0;
+    event.data[2] = length > 2 ? p[1] : 0;
+    event.size = static_cast<unsigned char>(length);
+    p += length - 1;
+
+    if (status < 0xF0) {
+        m_runningStatus = status;
+    }
+
+    m_timeUs += deltaUs;
+    event.timestampNs = m_timeUs * 1000;
+    m_cursor = p;
+    return true;
+}
+
+void SessionReader::rewind()
+{
+    m_cursor = m_records;
+    m_timeUs = 0;
+    m_runningStatus = 0;
+}
+
+bool SessionReader::seek(uint64_t targetNs, PadStateModel& state)
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    state.reset();
+    rewind();
+
+    // 目標時刻以前で最後のキーフレームを二分探索
+    const uint64_t targetUs = targetNs / 1000;
+    uint32_t lo = 0;
+    uint32_t hi = m_indexCount;
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (indexTimeUs(mid) <= targetUs) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo > 0 && !restoreKeyframe(lo - 1, state)) {
+        state.reset();
+        rewind();
+    }
+
+    // キーフレームから目標時刻の直前までを状態に適用
+    MidiEvent event;
+    for (;;) {
+        const unsigned char* cursor = m_cursor;
+        const uint64_t timeUs = m_timeUs;
+        const unsigned char runningStatus = m_runningStatus;
+
+        if (!readNext(event)) {
+            break;
+        }
+        if (event.timestampNs >= targetNs) {
+            // 目標時刻以降のイベントは次のreadNextで返す
+            m_cursor = cursor;
+            m_timeUs = timeUs;
+            m_runningStatus = runningStatus;
+            break;
+        }
+        state.applyEvent(event);
+    }
+    return true;
+}
+
+uint64_t SessionReader::durationNs() const
+{
+    return m_durationUs * 1000;
+}
+
+bool SessionReader::restoreKeyframe(uint32_t entry, PadStateModel& state)
+{
+    const unsigned char* entryData = m_index + static_cast<std::size_t>(entry) * SessionFormat::INDEX_ENTRY_SIZE;
+    const uint64_t offset = SessionFormat::readU64(entryData + 8);
+    if (offset < SessionFormat::HEADER_SIZE || offset >= static_cast<uint64_t>(m_end - m_begin)) {
+        return false;
+    }
+
+    const unsigned char* p = m_begin + offset;
+    uint64_t deltaUs = 0;
+    if (!SessionFormat::readVarint(p, m_end, deltaUs)
+        || static_cast<std::size_t>(m_end - p) < 1 + PadStateModel::SNAPSHOT_SIZE
+        || *p != SessionFormat::KEYFRAME_STATUS) {
+        return false;
+    }
+
+    state.deserialize(p + 1);
+    m_cursor = p + 1 + PadStateModel::SNAPSHOT_SIZE;
+    m_timeUs = indexTimeUs(entry);
+    m_runningStatus = 0;
+    return true;
+}
+
+uint64_t SessionReader::indexTimeUs(uint32_t entry) const
+{
+    return SessionFormat::readU64(m_index + static_cast<std::size_t>(entry) * SessionFormat::INDEX_ENTRY_SIZE);
+}
@@ -0,0 +1,99 @@
+#ifndef SESSION_READER_H
+#define SESSION_READER_H
+
+#include <QString>
+#include <QFile>
+#include "PlaybackSource.h"
+
+/**
+ * @brief セッション記録ファイル (.lpvs) の読み出しクラス
+ * ファイルをメモリマップし、マップ領域から直接レコードをデコードする。
+ * イベントごとの動的確保やコピーは行わない。
+ * キーフレームのインデックスがあればシークは二分探索で最寄りのキーフレームへ
+ * 移動し、そこから目標時刻までのイベントのみを再生する
+ */
+class SessionReader : public PlaybackSource {
+public:
+    SessionReader();
+    ~SessionReader() override;
+
+    /**
+     * @brief セッションファイルを開く
+     * @param filePath ファイルパス
+     * @return ヘッダーが有効で、マップに成功した場合true
+     */
+    bool open(const QString& filePath);
+
+    /**
+     * @brief ファイルを閉じる
+     */
+    void close();
+
+    /**
+     * @brief ファイルが開いているかどうか
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief 記録開始時刻を取得
+     * @return UNIXエポックからのミリ秒
+     */
+    qint64 startEpochMs() const;
+
+    /**
+     * @brief ヘッダーのフォーマットバージョンを取得
+     */
+    uint16_t version() const;
+
+    /**
+     * @brief キーフレームのインデックスを持っているか
+     */
+    bool hasIndex() const;
+
+    bool readNext(MidiEvent& event) override;
+    void rewind() override;
+    bool seek(uint64_t targetNs, PadStateModel& state) override;
+    uint64_t durationNs() const override;
+
+private:
+    /**
+     * @brief トレーラーを読み込み、インデックスとレコード列の範囲を設定
+     * @param fileSize ファイルサイズ
+     */
+    void loadTrailer(qint64 fileSize);
+
+    /**
+     * @brief 全レコードを走査してセッションの長さを求める（インデックスがない場合）
+     */
+    uint64_t scanDuration();
+
+    /**
+     * @brief インデックスのキーフレームから状態を復元し、読み出し位置をその直後にする
+     * @param entry インデックスのエントリ番号
+     * @param state 出力パッド状態
+     * @return 成功した場合true
+     */
+    bool restoreKeyframe(uint32_t entry, PadStateModel& state);
+
+    /**
+     * @brief インデックスのエントリの時刻を取得
+     */
+    uint64_t indexTimeUs(uint32_t entry) const;
+
+private:
+    QFile m_file;                   // マップ元のファイル
+    const unsigned char* m_begin;   // マップ領域の先頭
+    const unsigned char* m_records; // 最初のレコード位置
+    const unsigned char* m_end;     // レコード列の終端
+    const unsigned char* m_cursor;  // 現在の読み出し位置
+    uint64_t m_timeUs;              // 現在の時刻 (開始からのマイクロ秒)
+    unsigned char m_runningStatus;  // ランニングステータス (0は無効)
+    qint64 m_startEpochMs;          // 記録開始時刻
+    uint16_t m_version;             // ヘッダーのフォーマットバージョン
+    bool m_keyframes;               // キーフレームレコードを解釈するか
+    const unsigned char* m_index;   // キーフレームのインデックス (なければnullptr)
+    uint32_t m_indexCount;          // インデックスのエントリ数
+    uint64_t m_durationUs;          // セッションの長さ (マイクロ秒)
+};
+
+#endif // SESSION_READER_H
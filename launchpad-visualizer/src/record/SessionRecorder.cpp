@@ -0,0 +1,141 @@
+#include "SessionRecorder.h"
+#include "../diag/TraceRecorder.h"
+#include <QDebug>
+#include <chrono>
+
+SessionRecorder::SessionRecorder()
+    : m_recording(false)
+    , m_writerRunning(false)
+    , m_recordedCount(0)
+    , m_droppedCount(0)
+    , m_queueHighWater(0)
+    , m_startTimeNs(0)
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    stop();
+}
+
+bool SessionRecorder::start(std::unique_ptr<RecordingWriter> writer)
+{
+    if (isRecording()) {
+        stop();
+    }
+
+    if (!writer) {
+        return false;
+    }
+    m_writer = std::move(writer);
+
+    // 前回の記録の残りを捨てる
+    MidiEvent discarded;
+    while (m_queue.tryPop(discarded)) {
+    }
+
+    m_startTimeNs = MidiEvent::now();
+    m_recordedCount.store(0, std::memory_order_relaxed);
+    m_droppedCount.store(0, std::memory_order_relaxed);
+    m_queueHighWater.store(0, std::memory_order_relaxed);
+
+    m_writerRunning.store(true, std::memory_order_release);
+    m_writerThread = std::thread(&SessionRecorder::writerLoop, this);
+    m_recording.store(true, std::memory_order_release);
+
+    qInfo() << "記録を開始しました。";
+    return true;
+}
+
+void SessionRecorder::stop()
+{
+    if (!m_writerThread.joinable()) {
+        return;
+    }
+
+    m_recording.store(false, std::memory_order_release);
+    m_writerRunning.store(false, std::memory_order_release);
+    m_writerThread.join();
+
+    if (!m_writer->close()) {
+        qWarning() << "記録ファイルを正常に閉じられませんでした";
+    }
+    m_writer.reset();
+    qInfo() << "記録を停止しました。イベント数:" << m_recordedCount.load()
+            << "破棄:" << m_droppedCount.load();
+}
+
+bool SessionRecorder::isRecording() const
+{
+    return m_recording.load(std::memory_order_acquire);
+}
+
+uint64_t SessionRecorder::recordedEventCount() const
+{
+    return m_recordedCount.load(std::memory_order_relaxed);
+}
+
+uint64_t SessionRecorder::droppedEventCount() const
+{
+    return m_droppedCount.load(std::memory_order_relaxed);
+}
+
+std::size_t SessionRecorder::queuedEventCount() const
+{
+    return m_queue.size();
+}
+
+std::size_t SessionRecorder::queueHighWater() const
+{
+    return m_queueHighWater.load(std::memory_order_relaxed);
+}
+
+void SessionRecorder::midiEventCaptured(const MidiEvent& event)
+{
+    if (!m_recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // キャプチャスレッドではキューへの追加のみ行う
+    if (!m_queue.tryPush(event)) {
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // 書き込みはこのスレッドだけなので、比較して上書きするだけでよい
+    const std::size_t depth = m_queue.size();
+    if (depth > m_queueHighWater.load(std::memory_order_relaxed)) {
+        m_queueHighWater.store(depth, std::memory_order_relaxed);
+    }
+}
+
+void SessionRecorder::writerLoop()
+{
+    TRACE_THREAD_NAME("記録");
+
+    while (m_writerRunning.load(std::memory_order_acquire)) {
+        drainQueue();
+        std::this_thread::sleep_for(std::chrono::milliseconds(DRAIN_INTERVAL_MS));
+    }
+
+    // 停止時に残りをすべてエンコードする
+    drainQueue();
+}
+
+void SessionRecorder::drainQueue()
+{
+    // 空のときは記録しない（確認は短い間隔で繰り返されるため）
+    if (m_queue.size() == 0) {
+        return;
+    }
+    TRACE_SCOPE("recorder.drain");
+
+    MidiEvent event;
+    while (m_queue.tryPop(event)) {
+        const uint64_t timeUs = event.timestampNs > m_startTimeNs
+            ? (event.timestampNs - m_startTimeNs) / 1000 : 0;
+        if (m_writer->writeEvent(event, timeUs)) {
+            m_recordedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef SESSION_RECORDER_H
+#define SESSION_RECORDER_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "../midi/MidiInputListener.h"
+#include "../util/SpscRingBuffer.h"
+#include "RecordingWriter.h"
+
+/**
+ * @brief MIDIイベントを記録ファイルに追記するレコーダー
+ * キャプチャスレッドではリングバッファへの追加のみを行い、
+ * エンコードとファイル書き込み（RecordingWriter）はバックグラウンドスレッドでまとめて行う
+ */
+class SessionRecorder : public MidiInputListener {
+public:
+    SessionRecorder();
+    ~SessionRecorder() override;
+
+    /**
+     * @brief 記録を開始
+     * @param writer 開いた状態の記録先（所有権を受け取る）
+     * @return 開始に成功した場合true
+     */
+    bool start(std::unique_ptr<RecordingWriter> writer);
+
+    /**
+     * @brief 記録を停止し、未書き込みのデータをすべてファイルに書き出す
+     */
+    void stop();
+
+    /**
+     * @brief 記録中かどうかを取得
+     */
+    bool isRecording() const;
+
+    /**
+     * @brief 記録したイベント数を取得
+     */
+    uint64_t recordedEventCount() const;
+
+    /**
+     * @brief リングバッファが満杯で破棄したイベント数を取得
+     */
+    uint64_t droppedEventCount() const;
+
+    /**
+     * @brief 書き込み待ちのイベント数を取得
+     */
+    std::size_t queuedEventCount() const;
+
+    /**
+     * @brief 記録開始からのキューの深さの最大値
+     */
+    std::size_t queueHighWater() const;
+
+    /**
+     * @brief キャプチャスレッドから呼ばれるイベント受信処理
+     */
+    void midiEventCaptured(const MidiEvent& event) override;
+
+private:
+    /**
+     * @brief バックグラウンド書き込みスレッドの本体
+     */
+    void writerLoop();
+
+    /**
+     * @brief リングバッファのイベントをすべてエンコード
+     */
+    void drainQueue();
+
+private:
+    static constexpr std::size_t QUEUE_CAPACITY = 65536;  // リングバッファ容量 (イベント数)
+    static constexpr int DRAIN_INTERVAL_MS = 5;           // キューの確認間隔 (ミリ秒)
+
+    SpscRingBuffer<MidiEvent, QUEUE_CAPACITY> m_queue;  // キャプチャ→書き込みスレッドのキュー
+    std::atomic<bool> m_recording;                      // 記録中フラグ（キャプチャスレッド参照）
+    std::atomic<bool> m_writerRunning;                  // 書き込みスレッド継続フラグ
+    std::atomic<uint64_t> m_recordedCount;              // 記録済みイベント数
+    std::atomic<uint64_t> m_droppedCount;               // 破棄したイベント数
+    std::atomic<std::size_t> m_queueHighWater;          // キューの深さの最大値（キャプチャスレッドが書き込む）
+    std::thread m_writerThread;                         // 書き込みスレッド
+
+    // 以下は記録中、書き込みスレッドのみが触る
+    std::unique_ptr<RecordingWriter> m_writer;  // 記録先
+    uint64_t m_startTimeNs;   // 記録開始時刻
+};
+
+#endif // SESSION_RECORDER_H
@@ -0,0 +1,184 @@
+#include "SessionWriter.h"
+#include "SessionFormat.h"
+#include <QDebug>
+#include <cstring>
+
+SessionWriter::SessionWriter()
+    : m_fileOffset(0)
+    , m_lastTimeUs(0)
+    , m_runningStatus(0)
+    , m_writeError(false)
+    , m_keyframeIntervalUs(DEFAULT_KEYFRAME_INTERVAL_US)
+    , m_keyframeEvents(DEFAULT_KEYFRAME_EVENTS)
+    , m_lastKeyframeUs(0)
+    , m_eventsSinceKeyframe(0)
+{
+}
+
+SessionWriter::~SessionWriter()
+{
+    close();
+}
+
+bool SessionWriter::open(const QString& filePath, qint64 startEpochMs)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        qWarning() << "記録ファイルを開けません:" << filePath << m_file.errorString();
+        return false;
+    }
+
+    m_buffer.clear();
+    m_buffer.reserve(WRITE_CHUNK_SIZE + 1024);
+    m_fileOffset = 0;
+    m_lastTimeUs = 0;
+    m_runningStatus = 0;
+    m_writeError = false;
+    m_state.reset();
+    m_index.clear();
+    m_lastKeyframeUs = 0;
+    m_eventsSinceKeyframe = 0;
+
+    // ヘッダーを書き込む
+    unsigned char header[SessionFormat::HEADER_SIZE] = {};
+    std::memcpy(header, SessionFormat::MAGIC, sizeof(SessionFormat::MAGIC));
+    SessionFormat::writeU16(SessionFormat::VERSION, header + 4);
+    SessionFormat::writeU64(static_cast<uint64_t>(startEpochMs), header + 8);
+    append(header, sizeof(header));
+    return true;
+}
+
+bool SessionWriter::writeEvent(const MidiEvent& event, uint64_t timeUs)
+{
+    const unsigned char status = event.status();
+    const int length = midiMessageLength(status);
+    if (!m_file.isOpen() || length == 0 || event.size < length
+        || status == SessionFormat::KEYFRAME_STATUS) {
+        return false;  // 可変長や不完全なメッセージは記録しない
+    }
+
+    // 時刻が戻った場合は直前の時刻に揃える
+    if (timeUs < m_lastTimeUs) {
+        timeUs = m_lastTimeUs;
+    }
+
+    // イベントを書く前の状態をキーフレームとして残す
+    if (m_eventsSinceKeyframe > 0
+        && (timeUs - m_lastKeyframeUs >= m_keyframeIntervalUs
+            || m_eventsSinceKeyframe >= m_keyframeEvents)) {
+        writeKeyframe(timeUs);
+    }
+
+    writeDelta(timeUs);
+
+    unsigned char record[3];
+    std::size_t n = 0;
+    if (status < 0xF0) {
+        // チャンネルメッセージはランニングステータスを適用
+        if (status != m_runningStatus) {
+            record[n++] = status;
+            m_runningStatus = status;
+        }
+    } else {
+        record[n++] = status;
+    }
+    for (int i = 1; i < length; ++i) {
+        record[n++] = event.data[i];
+    }
+    append(record, n);
+
+    m_state.applyEvent(event);
+    ++m_eventsSinceKeyframe;
+    return true;
+}
+
+bool SessionWriter::close()
+{
+    if (!m_file.isOpen()) {
+        return false;
+    }
+
+    // インデックスとトレーラー
+    const uint64_t indexOffset = m_fileOffset;
+    unsigned char entry[SessionFormat::INDEX_ENTRY_SIZE];
+    for (const IndexEntry& e : m_index) {
+        SessionFormat::writeU64(e.timeUs, entry);
+        SessionFormat::writeU64(e.offset, entry + 8);
+        append(entry, sizeof(entry));
+    }
+
+    unsigned char trailer[SessionFormat::TRAILER_SIZE];
+    SessionFormat::writeU64(indexOffset, trailer);
+    SessionFormat::writeU64(m_lastTimeUs, trailer + 8);
+    SessionFormat::writeU32(static_cast<uint32_t>(m_index.size()), trailer + 16);
+    std::memcpy(trailer + 20, SessionFormat::TRAILER_MAGIC, sizeof(SessionFormat::TRAILER_MAGIC));
+    append(trailer, sizeof(trailer));
+
+    flushBuffer();
+    m_file.close();
+    m_index.clear();
+    m_index.shrink_to_fit();
+    return !m_writeError;
+}
+
+bool SessionWriter::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+void SessionWriter::setKeyframeInterval(uint64_t intervalUs, uint32_t eventCount)
+{
+    m_keyframeIntervalUs = intervalUs;
+    m_keyframeEvents = eventCount > 0 ? eventCount : 1;
+}
+
+void SessionWriter::writeKeyframe(uint64_t timeUs)
+{
+    m_index.push_back({timeUs, m_fileOffset});
+
+    writeDelta(timeUs);
+
+    unsigned char record[1 + PadStateModel::SNAPSHOT_SIZE];
+    record[0] = SessionFormat::KEYFRAME_STATUS;
+    m_state.serialize(record + 1);
+    append(record, sizeof(record));
+
+    // キーフレームから復元したときに前の状態に依存しないよう、ランニングステータスを切る
+    m_runningStatus = 0;
+    m_lastKeyframeUs = timeUs;
+    m_eventsSinceKeyframe = 0;
+}
+
+void SessionWriter::writeDelta(uint64_t timeUs)
+{
+    unsigned char varint[SessionFormat::MAX_VARINT_SIZE];
+    const std::size_t n = SessionFormat::writeVarint(timeUs - m_lastTimeUs, varint);
+    append(varint, n);
+    m_lastTimeUs = timeUs;
+}
+
+void SessionWriter::append(const unsigned char* data, std::size_t size)
+{
+    m_buffer.insert(m_buffer.end(), data, data + size);
+    m_fileOffset += size;
+    if (m_buffer.size() >= WRITE_CHUNK_SIZE) {
+        flushBuffer();
+    }
+}
+
+void SessionWriter::flushBuffer()
+{
+    if (m_buffer.empty()) {
+        return;
+    }
+
+    const qint64 written = m_file.write(reinterpret_cast<const char*>(m_buffer.data()),
+                                        static_cast<qint64>(m_buffer.size()));
+    if (written != static_cast<qint64>(m_buffer.size())) {
+        qWarning() << "記録ファイルの書き込みエラー:" << m_file.errorString();
+        m_writeError = true;
+    }
+    m_buffer.clear();
+}
@@ -0,0 +1,104 @@
+#ifndef SESSION_WRITER_H
+#define SESSION_WRITER_H
+
+#include <QString>
+#include <QFile>
+#include <vector>
+#include "../midi/MidiEvent.h"
+#include "../model/PadStateModel.h"
+#include "RecordingWriter.h"
+
+/**
+ * @brief セッション記録ファイル (.lpvs) のエンコーダー
+ * レコードをメモリ上のバッファにエンコードし、一定量ごとにまとめて書き込む。
+ * 書き込んだイベントからパッド状態を追跡し、一定時間または一定イベント数ごとに
+ * キーフレームを挿入する。close() でキーフレームのインデックスを書き出す。
+ * スレッドセーフではない
+ */
+class SessionWriter : public RecordingWriter {
+public:
+    static constexpr uint64_t DEFAULT_KEYFRAME_INTERVAL_US = 5000000;  // キーフレーム間隔 (5秒)
+    static constexpr uint32_t DEFAULT_KEYFRAME_EVENTS = 20000;         // キーフレーム間の最大イベント数
+
+    SessionWriter();
+    ~SessionWriter() override;
+
+    /**
+     * @brief ファイルを作成してヘッダーを書き込む
+     * @param filePath 出力ファイルパス（既存のファイルは上書き）
+     * @param startEpochMs 記録開始時刻 (UNIXエポックからのミリ秒)
+     * @return 成功した場合true
+     */
+    bool open(const QString& filePath, qint64 startEpochMs);
+
+    /**
+     * @brief イベントを1件書き込む
+     * @param event 書き込むイベント
+     * @param timeUs セッション開始からの時刻 (マイクロ秒、単調増加)
+     * @return 記録対象のイベントだった場合true
+     */
+    bool writeEvent(const MidiEvent& event, uint64_t timeUs) override;
+
+    /**
+     * @brief インデックスとトレーラーを書き込んでファイルを閉じる
+     * @return すべての書き込みに成功した場合true
+     */
+    bool close() override;
+
+    /**
+     * @brief ファイルが開いているかどうか
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief キーフレームの挿入条件を設定
+     * @param intervalUs キーフレーム間の最大時間 (マイクロ秒)
+     * @param eventCount キーフレーム間の最大イベント数
+     */
+    void setKeyframeInterval(uint64_t intervalUs, uint32_t eventCount);
+
+private:
+    struct IndexEntry {
+        uint64_t timeUs;  // キーフレームの時刻
+        uint64_t offset;  // キーフレームレコードのファイルオフセット
+    };
+
+    /**
+     * @brief 現在のパッド状態をキーフレームとして書き込む
+     */
+    void writeKeyframe(uint64_t timeUs);
+
+    /**
+     * @brief レコード先頭の経過時間を書き込む
+     */
+    void writeDelta(uint64_t timeUs);
+
+    /**
+     * @brief バッファにデータを追加し、必要ならファイルに書き出す
+     */
+    void append(const unsigned char* data, std::size_t size);
+
+    /**
+     * @brief バッファの内容をファイルに書き出す
+     */
+    void flushBuffer();
+
+private:
+    static constexpr std::size_t WRITE_CHUNK_SIZE = 256 * 1024;  // 1回の書き込みサイズ (バイト)
+
+    QFile m_file;                        // 出力ファイル
+    std::vector<unsigned char> m_buffer; // エンコード済みデータ
+    uint64_t m_fileOffset;               // 書き込み済み + バッファ中のバイト数
+    uint64_t m_lastTimeUs;               // 直前のレコードの時刻
+    unsigned char m_runningStatus;       // ランニングステータス (0は無効)
+    bool m_writeError;                   // 書き込みエラーが発生したか
+
+    PadStateModel m_state;               // キーフレーム用に追跡するパッド状態
+    std::vector<IndexEntry> m_index;     // キーフレームのインデックス
+    uint64_t m_keyframeIntervalUs;       // キーフレーム間の最大時間
+    uint32_t m_keyframeEvents;           // キーフレーム間の最大イベント数
+    uint64_t m_lastKeyframeUs;           // 直前のキーフレームの時刻
+    uint32_t m_eventsSinceKeyframe;      // 直前のキーフレーム以降のイベント数
+};
+
+#endif // SESSION_WRITER_H
@@ -0,0 +1,107 @@
+#ifndef SMF_FORMAT_H
+#define SMF_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Standard MIDI File (.mid) の読み書きに使う定義
+ * 数値はすべてビッグエンディアン、デルタタイムは可変長数値 (VLQ)
+ */
+namespace SmfFormat {
+
+constexpr char HEADER_MAGIC[4] = {'M', 'T', 'h', 'd'};
+constexpr char TRACK_MAGIC[4] = {'M', 'T', 'r', 'k'};
+constexpr std::size_t CHUNK_HEADER_SIZE = 8;   // チャンクID + 長さ
+constexpr uint32_t HEADER_LENGTH = 6;          // MThdのデータ長
+constexpr std::size_t MAX_VLQ_SIZE = 4;        // VLQの最大バイト数 (28ビット)
+
+constexpr unsigned char META_EVENT = 0xFF;     // メタイベント
+constexpr unsigned char META_TEMPO = 0x51;     // テンポ (4分音符あたりのマイクロ秒)
+constexpr unsigned char META_TIME_SIGNATURE = 0x58;
+constexpr unsigned char META_END_OF_TRACK = 0x2F;
+
+/**
+ * @brief 可変長数値を書き込む
+ * @param value 値 (0x0FFFFFFF以下)
+ * @param out 出力先 (MAX_VLQ_SIZEバイト以上の空きが必要)
+ * @return 書き込んだバイト数
+ */
+inline std::size_t writeVlq(uint32_t value, unsigned char* out)
+{
+    unsigned char reversed[MAX_VLQ_SIZE];
+    std::size_t n = 0;
+    value &= 0x0FFFFFFF;
+    do {
+        reversed[n++] = static_cast<unsigned char>(value & 0x7F);
+        value >>= 7;
+    } while (value > 0 && n < MAX_VLQ_SIZE);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = reversed[n - 1 - i] | (i + 1 < n ? 0x80 : 0x00);
+    }
+    return n;
+}
+
+/**
+ * @brief 可変長数値を読み込む
+ * @param data 読み込み位置（成功時は読み込んだ分だけ進める）
+ * @param end データ終端
+ * @param value 出力値
+ * @return 成功した場合true
+ */
+inline bool readVlq(const unsigned char*& data, const unsigned char* end, uint32_t& value)
+{
+    uint32_t result = 0;
+    const unsigned char* p = data;
+    for (std::size_t i = 0; i < MAX_VLQ_SIZE && p < end; ++i, ++p) {
+        result = (result << 7) | (*p & 0x7F);
+        if ((*p & 0x80) == 0) {
+            data = p + 1;
+            value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 16ビット値をビッグエンディアンで書き込む
+ */
+inline void writeU16(uint16_t value, unsigned char* out)
+{
+    out[0] = static_cast<unsigned char>(value >> 8);
+    out[1] = static_cast<unsigned char>(value);
+}
+
+/**
+ * @brief 32ビット値をビッグエンディアンで書き込む
+ */
+inline void writeU32(uint32_t value, unsigned char* out)
+{
+    out[0] = static_cast<unsigned char>(value >> 24);
+    out[1] = static_cast<unsigned char>(value >> 16);
+    out[2] = static_cast<unsigned char>(value >> 8);
+    out[3] = static_cast<unsigned char>(value);
+}
+
+/**
+ * @brief ビッグエンディアンの16ビット値を読み込む
+ */
+inline uint16_t readU16(const unsigned char* in)
+{
+    return static_cast<uint16_t>((in[0] << 8) | in[1]);
+}
+
+/**
+ * @brief ビッグエンディアンの32ビット値を読み込む
+ */
+inline uint32_t readU32(const unsigned char* in)
+{
+    return (static_cast<uint32_t>(in[0]) << 24) | (static_cast<uint32_t>(in[1]) << 16)
+        | (static_cast<uint32_t>(in[2]) << 8) | in[3];
+}
+
+} // namespace SmfFormat
+
+#endif // SMF_FORMAT_H
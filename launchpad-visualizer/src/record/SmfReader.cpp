@@ -0,0 +1,282 @@
+#include "SmfReader.h"
+#include "SmfFormat.h"
+#include <QDebug>
+#include <cstring>
+
+namespace {
+constexpr uint32_t DEFAULT_TEMPO_US_PER_QUARTER = 500000;  // SMFの既定テンポ (120 BPM)
+}
+
+SmfReader::SmfReader()
+    : m_begin(nullptr)
+    , m_division(480)
+    , m_smpte(false)
+    , m_smpteTicksPerSecond(0)
+    , m_tempoUsPerQuarter(DEFAULT_TEMPO_US_PER_QUARTER)
+    , m_tempoTick(0)
+    , m_tempoUs(0)
+    , m_peeked{}
+    , m_hasPeeked(false)
+    , m_durationUs(0)
+{
+}
+
+SmfReader::~SmfReader()
+{
+    close();
+}
+
+bool SmfReader::open(const QString& filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "MIDIファイルを開けません:" << filePath << m_file.errorString();
+        return false;
+    }
+
+    const qint64 fileSize = m_file.size();
+    const qint64 minSize = static_cast<qint64>(SmfFormat::CHUNK_HEADER_SIZE + SmfFormat::HEADER_LENGTH);
+    const unsigned char* data = fileSize >= minSize ? m_file.map(0, fileSize) : nullptr;
+    if (!data) {
+        qWarning() << "MIDIファイルを読み込めません:" << filePath;
+        m_file.close();
+        return false;
+    }
+    m_begin = data;
+    const unsigned char* end = data + fileSize;
+
+    // MThd
+    const uint16_t format = SmfFormat::readU16(data + 8);
+    const uint16_t division = SmfFormat::readU16(data + 12);
+    if (std::memcmp(data, SmfFormat::HEADER_MAGIC, sizeof(SmfFormat::HEADER_MAGIC)) != 0
+        || SmfFormat::readU32(data + 4) < SmfFormat::HEADER_LENGTH || format > 1 || division == 0) {
+        qWarning() << "未対応のMIDIファイルです:" << filePath;
+        close();
+        return false;
+    }
+
+    if (division & 0x8000) {
+        // SMPTE形式: 上位バイトが負のフレームレート、下位バイトがフレームあたりのティック数
+        const int fps = -static_cast<signed char>(division >> 8);
+        m_smpte = true;
+        m_smpteTicksPerSecond = static_cast<uint32_t>(fps == 29 ? 30 : fps) * (division & 0xFF);
+    } else {
+        m_smpte = false;
+        m_division = division;
+    }
+
+    // トラックチャンクの位置だけを集める（未知のチャンクは読み飛ばす）
+    const unsigned char* p = data + SmfFormat::CHUNK_HEADER_SIZE + SmfFormat::readU32(data + 4);
+    while (p && end - p >= static_cast<std::ptrdiff_t>(SmfFormat::CHUNK_HEADER_SIZE)) {
+        const uint32_t length = SmfFormat::readU32(p + 4);
+        const unsigned char* chunkData = p + SmfFormat::CHUNK_HEADER_SIZE;
+        const unsigned char* chunkEnd = static_cast<uint64_t>(end - chunkData) < length ? end : chunkData + length;
+        if (std::memcmp(p, SmfFormat::TRACK_MAGIC, sizeof(SmfFormat::TRACK_MAGIC)) == 0) {
+            m_tracks.push_back({chunkData, chunkEnd, chunkData, 0, 0, false});
+        }
+        p = chunkEnd;
+    }
+
+    if (m_tracks.empty()) {
+        qWarning() << "MIDIファイルにトラックがありません:" << filePath;
+        close();
+        return false;
+    }
+
+    // 長さを求めるため一度最後まで読む
+    rewind();
+    MidiEvent event;
+    uint64_t lastNs = 0;
+    while (readNext(event)) {
+        lastNs = event.timestampNs;
+    }
+    m_durationUs = lastNs / 1000;
+    rewind();
+    return true;
+}
+
+void SmfReader::close()
+{
+    if (m_begin) {
+        m_file.unmap(const_cast<unsigned char*>(m_begin));
+    }
+    m_file.close();
+
+    m_begin = nullptr;
+    m_tracks.clear();
+    m_hasPeeked = false;
+    m_durationUs = 0;
+}
+
+bool SmfReader::isOpen() const
+{
+    return m_begin != nullptr;
+}
+
+int SmfReader::trackCount() const
+{
+    return static_cast<int>(m_tracks.size());
+}
+
+bool SmfReader::readNext(MidiEvent& event)
+{
+    if (m_hasPeeked) {
+        event = m_peeked;
+        m_hasPeeked = false;
+        return true;
+    }
+
+    for (;;) {
+        // 次のイベントが最も早いトラックを選ぶ（同時刻ならトラック番号順）
+        TrackCursor* next = nullptr;
+        for (TrackCursor& track : m_tracks) {
+            if (!track.finished && (!next || track.tick < next->tick)) {
+                next = &track;
+            }
+        }
+        if (!next) {
+            return false;
+        }
+
+        TrackCursor& track = *next;
+        const unsigned char* p = track.pos;
+        if (p >= track.end) {
+            track.finished = true;
+            continue;
+        }
+
+        unsigned char status = *p;
+        if (status < 0x80) {
+            if (track.runningStatus == 0) {
+                track.finished = true;  // 不正なデータ
+                continue;
+            }
+            status = track.runningStatus;
+        } else {
+            ++p;
+        }
+
+        if (status == SmfFormat::META_EVENT) {
+            // メタイベント: 種類 + 長さ + データ
+            uint32_t length = 0;
+            if (p >= track.end) {
+                track.finished = true;
+                continue;
+            }
+            const unsigned char type = *p++;
+            if (!SmfFormat::readVlq(p, track.end, length) || static_cast<uint64_t>(track.end - p) < length) {
+                track.finished = true;
+                continue;
+            }
+            if (type == SmfFormat::META_TEMPO && length >= 3 && !m_smpte) {
+                // テンポ変更点を更新
+                m_tempoUs = tickToUs(track.tick);
+                m_tempoTick = track.tick;
+                m_tempoUsPerQuarter = (static_cast<uint32_t>(p[0]) << 16) | (p[1] << 8) | p[2];
+            }
+            track.runningStatus = 0;
+            track.pos = p + length;
+            if (type == SmfFormat::META_END_OF_TRACK) {
+                track.finished = true;
+            } else {
+                advance(track);
+            }
+            continue;
+        }
+
+        if (status == 0xF0 || status == 0xF7) {
+            // SysEx: 長さ + データ
+            uint32_t length = 0;
+            if (!SmfFormat::readVlq(p, track.end, length) || static_cast<uint64_t>(track.end - p) < length) {
+                track.finished = true;
+                continue;
+            }
+            track.runningStatus = 0;
+            track.pos = p + length;
+            advance(track);
+            continue;
+        }
+
+        const int length = midiMessageLength(status);
+        if (status > 0xF0 || length == 0 || track.end - p < length - 1) {
+            track.finished = true;  // トラック内にシステムメッセージは現れない
+            continue;
+        }
+
+        event.data[0] = status;
+        event.data[1] = length > 1 ? p[0] : 0;
+        event.data[2] = length > 2 ? p[1] : 0;
+        event.size = static_cast<unsigned char>(length);
+        event.timestampNs = tickToUs(track.tick) * 1000;
+
+        track.runningStatus = status;
+        track.pos = p + length - 1;
+        advance(track);
+        return true;
+    }
+}
+
+void SmfReader::rewind()
+{
+    for (TrackCursor& track : m_tracks) {
+        track.pos = track.begin;
+        track.tick = 0;
+        track.runningStatus = 0;
+        track.finished = false;
+        advance(track);
+    }
+
+    m_tempoUsPerQuarter = DEFAULT_TEMPO_US_PER_QUARTER;
+    m_tempoTick = 0;
+    m_tempoUs = 0;
+    m_hasPeeked = false;
+}
+
+bool SmfReader::seek(uint64_t targetNs, PadStateModel& state)
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    // SMFにはキーフレームがないため、先頭から目標時刻まで状態を再構築する
+    state.reset();
+    rewind();
+
+    MidiEvent event;
+    while (readNext(event)) {
+        if (event.timestampNs >= targetNs) {
+            m_peeked = event;
+            m_hasPeeked = true;
+            break;
+        }
+        state.applyEvent(event);
+    }
+    return true;
+}
+
+uint64_t SmfReader::durationNs() const
+{
+    return m_durationUs * 1000;
+}
+
+void SmfReader::advance(TrackCursor& track)
+{
+    uint32_t delta = 0;
+    if (track.pos >= track.end || !SmfFormat::readVlq(track.pos, track.end, delta)) {
+        track.finished = true;
+        return;
+    }
+    track.tick += delta;
+}
+
+uint64_t SmfReader::tickToUs(uint64_t tick) const
+{
+    if (m_smpte) {
+        return m_smpteTicksPerSecond ? tick * 1000000 / m_smpteTicksPerSecond : 0;
+    }
+
+    const uint64_t ticks = tick > m_tempoTick ? tick - m_tempoTick : 0;
+    return m_tempoUs + ticks * m_tempoUsPerQuarter / m_division;
+}
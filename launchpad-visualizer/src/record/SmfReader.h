@@ -0,0 +1,90 @@
+#ifndef SMF_READER_H
+#define SMF_READER_H
+
+#include <QString>
+#include <QFile>
+#include <vector>
+#include "PlaybackSource.h"
+
+/**
+ * @brief Standard MIDI File (.mid) を再生用に読み出すクラス
+ * ファイルをメモリマップし、各トラックはイベントを必要になった時点で
+ * マップ領域から直接デコードする。フォーマット1では全トラックを時刻順に
+ * マージし、テンポ変更を反映してマイクロ秒に変換する。
+ * チャンネルメッセージのみを返し、SysExとメタイベントは読み飛ばす
+ */
+class SmfReader : public PlaybackSource {
+public:
+    SmfReader();
+    ~SmfReader() override;
+
+    /**
+     * @brief MIDIファイルを開く
+     * トラックの位置の確認と長さの算出のため、開くときに一度全体を走査する
+     * @param filePath ファイルパス
+     * @return フォーマット0/1の有効なファイルの場合true
+     */
+    bool open(const QString& filePath);
+
+    /**
+     * @brief ファイルを閉じる
+     */
+    void close();
+
+    /**
+     * @brief ファイルが開いているかどうか
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief トラック数を取得
+     */
+    int trackCount() const;
+
+    bool readNext(MidiEvent& event) override;
+    void rewind() override;
+    bool seek(uint64_t targetNs, PadStateModel& state) override;
+    uint64_t durationNs() const override;
+
+private:
+    /**
+     * @brief トラックの読み出し状態
+     */
+    struct TrackCursor {
+        const unsigned char* begin;  // トラックデータの先頭
+        const unsigned char* end;    // トラックデータの終端
+        const unsigned char* pos;    // 次のイベントのデルタタイム直後の位置
+        uint64_t tick;               // 次のイベントの絶対ティック
+        unsigned char runningStatus; // ランニングステータス (0は無効)
+        bool finished;               // 終端に達したか
+    };
+
+    /**
+     * @brief トラックの次のイベントのデルタタイムを読み、tickを進める
+     */
+    static void advance(TrackCursor& track);
+
+    /**
+     * @brief ティックをマイクロ秒に変換（テンポ変更点からの差分で計算）
+     */
+    uint64_t tickToUs(uint64_t tick) const;
+
+private:
+    QFile m_file;                       // マップ元のファイル
+    const unsigned char* m_begin;       // マップ領域の先頭
+    std::vector<TrackCursor> m_tracks;  // トラックごとの読み出し状態
+    uint16_t m_division;                // 4分音符あたりのティック数
+    bool m_smpte;                       // SMPTE形式の時間単位か
+    uint32_t m_smpteTicksPerSecond;     // SMPTE形式の1秒あたりのティック数
+
+    // テンポマップの現在区間
+    uint32_t m_tempoUsPerQuarter;       // 現在のテンポ
+    uint64_t m_tempoTick;               // 現在のテンポの開始ティック
+    uint64_t m_tempoUs;                 // 現在のテンポの開始時刻
+
+    MidiEvent m_peeked;                 // シークで先読みしたイベント
+    bool m_hasPeeked;                   // 先読みしたイベントがあるか
+    uint64_t m_durationUs;              // ファイルの長さ
+};
+
+#endif // SMF_READER_H
@@ -0,0 +1,190 @@
+#include "SmfWriter.h"
+#include "SmfFormat.h"
+#include <QDebug>
+#include <cstring>
+
+SmfWriter::SmfWriter()
+    : m_fileOffset(0)
+    , m_trackStart(0)
+    , m_lastTick(0)
+    , m_runningStatus(0)
+    , m_writeError(false)
+{
+}
+
+SmfWriter::~SmfWriter()
+{
+    close();
+}
+
+bool SmfWriter::open(const QString& filePath, Format format)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        qWarning() << "MIDIファイルを開けません:" << filePath << m_file.errorString();
+        return false;
+    }
+
+    m_buffer.clear();
+    m_buffer.reserve(WRITE_CHUNK_SIZE + 64);
+    m_fileOffset = 0;
+    m_lastTick = 0;
+    m_runningStatus = 0;
+    m_writeError = false;
+
+    // MThd
+    unsigned char header[SmfFormat::CHUNK_HEADER_SIZE + SmfFormat::HEADER_LENGTH];
+    std::memcpy(header, SmfFormat::HEADER_MAGIC, sizeof(SmfFormat::HEADER_MAGIC));
+    SmfFormat::writeU32(SmfFormat::HEADER_LENGTH, header + 4);
+    SmfFormat::writeU16(static_cast<uint16_t>(format), header + 8);
+    SmfFormat::writeU16(format == Format::SingleTrack ? 1 : 2, header + 10);
+    SmfFormat::writeU16(TICKS_PER_QUARTER, header + 12);
+    append(header, sizeof(header));
+
+    if (format == Format::MultiTrack) {
+        // テンポトラックは内容が固定なので長さを先に確定できる
+        const uint64_t lengthOffset = m_fileOffset + 4;
+        writeTrackHeader(0);
+        const uint64_t start = m_fileOffset;
+        writeTempoMap();
+        const unsigned char endOfTrack[] = {SmfFormat::META_EVENT, SmfFormat::META_END_OF_TRACK, 0x00};
+        writeTrackEvent(0, endOfTrack, sizeof(endOfTrack));
+        SmfFormat::writeU32(static_cast<uint32_t>(m_fileOffset - start),
+                            m_buffer.data() + (lengthOffset - (m_fileOffset - m_buffer.size())));
+    }
+
+    // イベントトラック（長さはclose()で書き戻す）
+    writeTrackHeader(0);
+    m_trackStart = m_fileOffset;
+    if (format == Format::SingleTrack) {
+        writeTempoMap();
+    }
+    return true;
+}
+
+bool SmfWriter::writeEvent(const MidiEvent& event, uint64_t timeUs)
+{
+    const unsigned char status = event.status();
+    const int length = midiMessageLength(status);
+    if (!m_file.isOpen() || status >= 0xF0 || length == 0 || event.size < length) {
+        return false;  // SMFのトラックにはチャンネルメッセージのみ記録する
+    }
+
+    // マイクロ秒からティックに変換（絶対時刻から変換して誤差の蓄積を防ぐ）
+    uint64_t tick = (timeUs * TICKS_PER_QUARTER + TEMPO_US_PER_QUARTER / 2) / TEMPO_US_PER_QUARTER;
+    if (tick < m_lastTick) {
+        tick = m_lastTick;
+    }
+    uint64_t delta = tick - m_lastTick;
+
+    // VLQで表せない長い空白は空のメタイベントで分割する
+    while (delta > 0x0FFFFFFF) {
+        const unsigned char marker[] = {SmfFormat::META_EVENT, 0x06, 0x00};  // 空のマーカー
+        writeTrackEvent(0x0FFFFFFF, marker, sizeof(marker));
+        delta -= 0x0FFFFFFF;
+    }
+    m_lastTick = tick;
+
+    unsigned char data[3];
+    std::size_t n = 0;
+    if (status != m_runningStatus) {
+        data[n++] = status;
+        m_runningStatus = status;
+    }
+    for (int i = 1; i < length; ++i) {
+        data[n++] = event.data[i];
+    }
+    writeTrackEvent(static_cast<uint32_t>(delta), data, n);
+    return true;
+}
+
+bool SmfWriter::close()
+{
+    if (!m_file.isOpen()) {
+        return false;
+    }
+
+    const unsigned char endOfTrack[] = {SmfFormat::META_EVENT, SmfFormat::META_END_OF_TRACK, 0x00};
+    writeTrackEvent(0, endOfTrack, sizeof(endOfTrack));
+    flushBuffer();
+
+    // イベントトラックの長さを書き戻す
+    unsigned char length[4];
+    SmfFormat::writeU32(static_cast<uint32_t>(m_fileOffset - m_trackStart), length);
+    if (!m_file.seek(static_cast<qint64>(m_trackStart - 4))
+        || m_file.write(reinterpret_cast<const char*>(length), sizeof(length)) != sizeof(length)) {
+        qWarning() << "MIDIファイルのトラック長を書き込めません:" << m_file.errorString();
+        m_writeError = true;
+    }
+
+    m_file.close();
+    return !m_writeError;
+}
+
+bool SmfWriter::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+void SmfWriter::writeTrackHeader(uint32_t length)
+{
+    unsigned char header[SmfFormat::CHUNK_HEADER_SIZE];
+    std::memcpy(header, SmfFormat::TRACK_MAGIC, sizeof(SmfFormat::TRACK_MAGIC));
+    SmfFormat::writeU32(length, header + 4);
+    append(header, sizeof(header));
+}
+
+void SmfWriter::writeTempoMap()
+{
+    const unsigned char tempo[] = {
+        SmfFormat::META_EVENT, SmfFormat::META_TEMPO, 0x03,
+        static_cast<unsigned char>(TEMPO_US_PER_QUARTER >> 16),
+        static_cast<unsigned char>(TEMPO_US_PER_QUARTER >> 8),
+        static_cast<unsigned char>(TEMPO_US_PER_QUARTER)
+    };
+    writeTrackEvent(0, tempo, sizeof(tempo));
+
+    // 4/4拍子、メトロノーム24クロック、32分音符8個/4分音符
+    const unsigned char timeSignature[] = {
+        SmfFormat::META_EVENT, SmfFormat::META_TIME_SIGNATURE, 0x04, 0x04, 0x02, 0x18, 0x08
+    };
+    writeTrackEvent(0, timeSignature, sizeof(timeSignature));
+}
+
+void SmfWriter::writeTrackEvent(uint32_t delta, const unsigned char* data, std::size_t size)
+{
+    unsigned char vlq[SmfFormat::MAX_VLQ_SIZE];
+    append(vlq, SmfFormat::writeVlq(delta, vlq));
+    append(data, size);
+
+    // メタイベントの後はランニングステータスを使わない
+    if (size > 0 && data[0] == SmfFormat::META_EVENT) {
+        m_runningStatus = 0;
+    }
+}
+
+void SmfWriter::append(const unsigned char* data, std::size_t size)
+{
+    m_buffer.insert(m_buffer.end(), data, data + size);
+    m_fileOffset += size;
+    if (m_buffer.size() >= WRITE_CHUNK_SIZE) {
+        flushBuffer();
+    }
+}
+
+void SmfWriter::flushBuffer()
+{
+    if (m_buffer.empty()) {
+        return;
+    }
+
+    const qint64 written = m_file.write(reinterpret_cast<const char*>(m_buffer.data()),
+                                        static_cast<qint64>(m_buffer.size()));
+    if (written != static_cast<qint64>(m_buffer.size())) {
+        qWarning() << "MIDIファイルの書き込みエラー:" << m_file.errorString();
+        m_writeError = true;
+    }
+    m_buffer.clear();
+}
@@ -0,0 +1,86 @@
+#ifndef SMF_WRITER_H
+#define SMF_WRITER_H
+
+#include <QString>
+#include <QFile>
+#include <vector>
+#include "RecordingWriter.h"
+
+/**
+ * @brief イベント列をStandard MIDI Fileとして逐次書き出すクラス
+ * エンコード済みのデータは一定量ごとにファイルへ書き出し、トラック長は
+ * close() でヘッダーを書き戻すため、記録時間に関わらずメモリ使用量は一定。
+ * チャンネルメッセージのみを記録し、リアルタイムメッセージ等は書き込まない
+ */
+class SmfWriter : public RecordingWriter {
+public:
+    /**
+     * @brief SMFのフォーマット
+     */
+    enum class Format {
+        SingleTrack = 0,  // フォーマット0: テンポ情報とイベントを1トラックに格納
+        MultiTrack = 1    // フォーマット1: テンポトラック + イベントトラック
+    };
+
+    static constexpr uint16_t TICKS_PER_QUARTER = 960;         // 分解能
+    static constexpr uint32_t TEMPO_US_PER_QUARTER = 500000;   // テンポ (120 BPM)
+
+    SmfWriter();
+    ~SmfWriter() override;
+
+    /**
+     * @brief ファイルを作成してヘッダーを書き込む
+     * @param filePath 出力ファイルパス（既存のファイルは上書き）
+     * @param format SMFのフォーマット
+     * @return 成功した場合true
+     */
+    bool open(const QString& filePath, Format format = Format::MultiTrack);
+
+    bool writeEvent(const MidiEvent& event, uint64_t timeUs) override;
+    bool close() override;
+
+    /**
+     * @brief ファイルが開いているかどうか
+     */
+    bool isOpen() const;
+
+private:
+    /**
+     * @brief トラックチャンクのヘッダーを書き込む
+     * @param length トラック長（不明な場合は0を書き、後で書き戻す）
+     */
+    void writeTrackHeader(uint32_t length);
+
+    /**
+     * @brief テンポと拍子のメタイベントを書き込む
+     */
+    void writeTempoMap();
+
+    /**
+     * @brief デルタタイム付きのデータを書き込む
+     */
+    void writeTrackEvent(uint32_t delta, const unsigned char* data, std::size_t size);
+
+    /**
+     * @brief バッファにデータを追加し、必要ならファイルに書き出す
+     */
+    void append(const unsigned char* data, std::size_t size);
+
+    /**
+     * @brief バッファの内容をファイルに書き出す
+     */
+    void flushBuffer();
+
+private:
+    static constexpr std::size_t WRITE_CHUNK_SIZE = 256 * 1024;  // 1回の書き込みサイズ (バイト)
+
+    QFile m_file;                        // 出力ファイル
+    std::vector<unsigned char> m_buffer; // エンコード済みデータ
+    uint64_t m_fileOffset;               // 書き込み済み + バッファ中のバイト数
+    uint64_t m_trackStart;               // イベントトラックのデータ開始位置
+    uint64_t m_lastTick;                 // 直前のイベントのティック
+    unsigned char m_runningStatus;       // ランニングステータス (0は無効)
+    bool m_writeError;                   // 書き込みエラーが発生したか
+};
+
+#endif // SMF_WRITER_H
@@ -0,0 +1,212 @@
+#include "OfflineRenderer.h"
+#include "../gui/LaunchpadGrid.h"
+#include "../model/PadEnvelope.h"
+#include "../model/PadStateModel.h"
+#include "../record/PlaybackSource.h"
+#include <QIODevice>
+#include <QDebug>
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+OfflineRenderer::OfflineRenderer(const Options& options)
+    : m_options(options)
+    , m_threadCount(options.threads > 0 ? options.threads
+                                        : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+    , m_layout(options.gridSize)
+    , m_rasterizers(m_threadCount)
+    , m_framesWritten(0)
+{
+    m_options.fps = qBound(1, m_options.fps, 1000);
+    m_options.gridSize = m_layout.gridSize();
+    m_layout.setSize(m_options.size);
+    for (PadRasterizer& rasterizer : m_rasterizers) {
+        rasterizer.resize(m_options.size, 1.0);
+    }
+}
+
+bool OfflineRenderer::render(PlaybackSource& source, QIODevice& output)
+{
+    m_framesWritten = 0;
+    if (m_options.size.isEmpty()) {
+        qWarning() << "フレームのサイズが不正です";
+        return false;
+    }
+    if (!writeHeader(output)) {
+        qWarning() << "出力に書き込めません:" << output.errorString();
+        return false;
+    }
+
+    source.rewind();
+
+    // 最後のイベントの後、残光が消えるまで描画する
+    const uint64_t endNs = source.durationNs() + static_cast<uint64_t>(m_options.releaseMs) * 1000000ULL;
+    const uint64_t frameCount = endNs * m_options.fps / 1000000000ULL + 1;
+
+    const int gridSize = m_layout.gridSize();
+    const int padCount = m_layout.padCount();
+    const int deviceSize = std::min(gridSize, static_cast<int>(PadStateModel::GRID_SIZE));
+
+    PadStateModel state;
+    PadEnvelope envelope(padCount);
+    envelope.setTimes(0, 0, 1.0f, m_options.releaseMs);
+    PadMask changed;
+
+    MidiEvent event;
+    bool hasEvent = source.readNext(event);
+
+    // フレームの状態は確保したものを使い回す（表面に描かないパッドは消灯のまま）
+    const size_t batchSize = static_cast<size_t>(m_threadCount) * FRAMES_PER_THREAD;
+    std::vector<FrameState> batch(batchSize);
+    for (FrameState& snapshot : batch) {
+        snapshot.rgb.assign(padCount, 0);
+        snapshot.glow.assign(padCount, 0);
+    }
+    size_t batchCount = 0;
+
+    for (uint64_t frame = 0; frame < frameCount; ++frame) {
+        const uint64_t frameNs = frame * 1000000000ULL / m_options.fps;
+
+        // フレーム時刻までのイベントを時刻順に適用する
+        while (hasEvent && event.timestampNs <= frameNs) {
+            int x, y;
+            if (state.applyEvent(event) && PadStateModel::eventToXY(event, x, y)
+                && x < deviceSize && y < deviceSize) {
+                if (state.isActive(x, y)) {
+                    envelope.noteOn(y * gridSize + x, event.timestampNs);
+                } else {
+                    envelope.noteOff(y * gridSize + x, event.timestampNs);
+                }
+            }
+            hasEvent = source.readNext(event);
+        }
+        envelope.advance(frameNs, changed);
+
+        // フレームの描画に必要な状態だけをスナップショットとして取り出す
+        FrameState& snapshot = batch[batchCount++];
+        for (int y = 0; y < deviceSize; ++y) {
+            for (int x = 0; x < deviceSize; ++x) {
+                const int index = y * gridSize + x;
+                snapshot.rgb[index] = state.color(x, y);
+                snapshot.glow[index] = static_cast<uint8_t>(envelope.level(index) * 255 / PadEnvelope::LEVELS);
+            }
+        }
+
+        if (batchCount == batchSize) {
+            if (!flushBatch(batch, batchCount, output)) {
+                return false;
+            }
+            batchCount = 0;
+        }
+    }
+
+    return flushBatch(batch, batchCount, output);
+}
+
+int OfflineRenderer::framesWritten() const
+{
+    return m_framesWritten;
+}
+
+bool OfflineRenderer::flushBatch(const std::vector<FrameState>& states, size_t count, QIODevice& output)
+{
+    if (count == 0) {
+        return true;
+    }
+
+    // スレッドiはi, i+N, i+2N... 番目のフレームを描画する
+    std::vector<QByteArray> frames(count);
+    const int workerCount = std::min(m_threadCount, static_cast<int>(count));
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (int worker = 0; worker < workerCount; ++worker) {
+        workers.emplace_back(&OfflineRenderer::renderWorker, this, worker, workerCount,
+                             std::cref(states), std::ref(frames));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // フレーム順に書き込む
+    for (const QByteArray& frame : frames) {
+        if (output.write(frame) != frame.size()) {
+            qWarning() << "出力に書き込めません:" << output.errorString();
+            return false;
+        }
+        ++m_framesWritten;
+    }
+    return true;
+}
+
+void OfflineRenderer::renderWorker(int worker, int workerCount, const std::vector<FrameState>& states,
+                                   std::vector<QByteArray>& frames)
+{
+    for (size_t i = worker; i < frames.size(); i += workerCount) {
+        renderFrame(m_rasterizers[worker], states[i], frames[i]);
+    }
+}
+
+void OfflineRenderer::renderFrame(PadRasterizer& rasterizer, const FrameState& state, QByteArray& out) const
+{
+    const QColor borderColor = LaunchpadGrid::borderColor(0.0);
+
+    rasterizer.fill(Qt::black);
+    for (int index = 0; index < m_layout.padCount(); ++index) {
+        rasterizer.drawPad(m_layout.padRect(index), QColor::fromRgb(state.rgb[index]),
+                           state.glow[index], borderColor, m_layout.isRound(index));
+    }
+
+    const QImage& image = rasterizer.image();
+    const int width = m_options.size.width();
+    const int height = m_options.size.height();
+    const int planeSize = width * height;
+
+    if (m_options.format == Format::Rgb24) {
+        out.resize(planeSize * 3);
+        unsigned char* dst = reinterpret_cast<unsigned char*>(out.data());
+        for (int y = 0; y < height; ++y) {
+            const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+            for (int x = 0; x < width; ++x) {
+                *dst++ = static_cast<unsigned char>(qRed(line[x]));
+                *dst++ = static_cast<unsigned char>(qGreen(line[x]));
+                *dst++ = static_cast<unsigned char>(qBlue(line[x]));
+            }
+        }
+        return;
+    }
+
+    // Y4M: "FRAME\n" の後にY, U, Vの各平面 (BT.601、リミテッドレンジ)
+    static const char FRAME_MARKER[] = "FRAME\n";
+    const int markerSize = static_cast<int>(sizeof(FRAME_MARKER)) - 1;
+    out.resize(markerSize + planeSize * 3);
+    std::copy(FRAME_MARKER, FRAME_MARKER + markerSize, out.data());
+    unsigned char* yPlane = reinterpret_cast<unsigned char*>(out.data()) + markerSize;
+    unsigned char* uPlane = yPlane + planeSize;
+    unsigned char* vPlane = uPlane + planeSize;
+    for (int y = 0; y < height; ++y) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const int r = qRed(line[x]);
+            const int g = qGreen(line[x]);
+            const int b = qBlue(line[x]);
+            const int offset = y * width + x;
+            yPlane[offset] = static_cast<unsigned char>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+            uPlane[offset] = static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            vPlane[offset] = static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}
+
+bool OfflineRenderer::writeHeader(QIODevice& output) const
+{
+    if (m_options.format != Format::Y4m) {
+        return true;
+    }
+
+    const QByteArray header = QString("YUV4MPEG2 W%1 H%2 F%3:1 Ip A1:1 C444\n")
+        .arg(m_options.size.width())
+        .arg(m_options.size.height())
+        .arg(m_options.fps)
+        .toLatin1();
+    return output.write(header) == header.size();
+}
@@ -0,0 +1,110 @@
+#ifndef OFFLINE_RENDERER_H
+#define OFFLINE_RENDERER_H
+
+#include <QSize>
+#include <QByteArray>
+#include <cstdint>
+#include <vector>
+#include "../gui/PadDisplayModel.h"
+#include "../gui/PadLayout.h"
+#include "../gui/PadRasterizer.h"
+
+class PlaybackSource;
+class QIODevice;
+
+/**
+ * @brief 記録済みセッションを固定フレームレートの映像フレームに描画するクラス
+ * イベントを時刻順にパッドの状態と残光へ適用し、各フレーム時刻の状態を
+ * スナップショットとして取り出す。各フレームはスナップショットだけで決まるため、
+ * 描画は複数のスレッドで並列に行い、出力はフレーム順に並べ直して書き込む。
+ * 描画にはLaunchpadGridのRaster方式と同じPadRasterizerを使う。
+ * 表面のサイズは設定で変えられ、記録したデバイスのパッドは左下の9x9に描く
+ */
+class OfflineRenderer {
+public:
+    /**
+     * @brief 出力形式
+     */
+    enum class Format {
+        Y4m,    // YUV4MPEG2 (4:4:4)
+        Rgb24   // ヘッダーなしのRGB24の連続
+    };
+
+    /**
+     * @brief 描画の設定
+     */
+    struct Options {
+        int fps = 60;                                           // フレームレート
+        QSize size = QSize(1080, 1080);                         // フレームのサイズ
+        Format format = Format::Y4m;                            // 出力形式
+        int threads = 0;                                        // 描画スレッド数 (0はCPUコア数)
+        int releaseMs = PadDisplayModel::DEFAULT_RELEASE_MS;    // 残光の長さ
+        int gridSize = PadDisplayModel::DEFAULT_GRID_SIZE;      // 表面の1辺のパッド数
+    };
+
+    explicit OfflineRenderer(const Options& options);
+
+    /**
+     * @brief セッション全体を描画して出力
+     * 最後のイベントの後も残光が消えるまでフレームを出力する
+     * @param source イベント供給元（先頭から読み出す）
+     * @param output 出力先
+     * @return 成功した場合true
+     */
+    bool render(PlaybackSource& source, QIODevice& output);
+
+    /**
+     * @brief 出力したフレーム数を取得
+     */
+    int framesWritten() const;
+
+private:
+    static constexpr int FRAMES_PER_THREAD = 4;  // 1回にまとめて描画するスレッドあたりのフレーム数
+
+    /**
+     * @brief 1フレーム分のパッドの状態
+     */
+    struct FrameState {
+        std::vector<uint32_t> rgb;  // パッドの色 (0x00RRGGBB)
+        std::vector<uint8_t> glow;  // パッドの明るさ (0-255)
+    };
+
+    /**
+     * @brief 描画スレッドの処理（担当するフレームを順に描画）
+     * @param worker スレッド番号
+     * @param workerCount スレッド数
+     * @param states まとめたフレームの状態
+     * @param frames 出力先（statesと同じ順序、要素数が描画するフレーム数）
+     */
+    void renderWorker(int worker, int workerCount, const std::vector<FrameState>& states,
+                      std::vector<QByteArray>& frames);
+
+    /**
+     * @brief 1フレームを描画して出力形式のバイト列に変換
+     * @param rasterizer 描画に使うラスタライザ（スレッドごと）
+     * @param state フレームの状態
+     * @param out 出力先
+     */
+    void renderFrame(PadRasterizer& rasterizer, const FrameState& state, QByteArray& out) const;
+
+    /**
+     * @brief ストリームのヘッダーを書き込む
+     */
+    bool writeHeader(QIODevice& output) const;
+
+    /**
+     * @brief まとめたフレームを並列に描画し、順番に書き込む
+     * @param states まとめたフレームの状態（再利用のため確保済み）
+     * @param count statesの先頭から描画するフレーム数
+     * @param output 出力先
+     */
+    bool flushBatch(const std::vector<FrameState>& states, size_t count, QIODevice& output);
+
+    Options m_options;                        // 描画の設定
+    int m_threadCount;                        // 描画スレッド数
+    PadLayout m_layout;                       // パッドの配置（全フレーム共通）
+    std::vector<PadRasterizer> m_rasterizers; // スレッドごとのラスタライザ
+    int m_framesWritten;                      // 出力したフレーム数
+};
+
+#endif // OFFLINE_RENDERER_H
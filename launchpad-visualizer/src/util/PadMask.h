@@ -0,0 +1,127 @@
+#ifndef PAD_MASK_H
+#define PAD_MASK_H
+
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * @brief パッドインデックスの集合を表す固定長のビットマスク
+ * 再描画が必要なパッドの蓄積などに使い、立っているビットだけを走査できる。
+ * 最大64x64パッド（複数台を並べた表示を含む）。走査と消去はビットを立てた
+ * 範囲のワードだけを対象にするため、9x9の表面では2ワード分のコストで済む
+ */
+class PadMask {
+public:
+    static constexpr int MAX_GRID_SIZE = 64;                         // 扱える表面の最大サイズ
+    static constexpr int CAPACITY = MAX_GRID_SIZE * MAX_GRID_SIZE;  // 扱えるパッド数
+
+    PadMask() : m_words{}, m_wordCount(0) {}
+
+    /**
+     * @brief パッドを追加
+     */
+    void set(int index)
+    {
+        const int word = index >> 6;
+        m_words[word] |= uint64_t(1) << (index & 63);
+        if (word >= m_wordCount) {
+            m_wordCount = word + 1;
+        }
+    }
+
+    /**
+     * @brief パッドが含まれているか
+     */
+    bool test(int index) const { return (m_words[index >> 6] >> (index & 63)) & 1; }
+
+    /**
+     * @brief 先頭から count 個のパッドをすべて追加
+     */
+    void setFirst(int count)
+    {
+        if (count > CAPACITY) {
+            count = CAPACITY;
+        }
+        const int words = (count + 63) >> 6;
+        for (int word = 0; word < words; ++word) {
+            const int bits = count - word * 64;
+            m_words[word] |= bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+        }
+        if (words > m_wordCount) {
+            m_wordCount = words;
+        }
+    }
+
+    /**
+     * @brief すべてのパッドを取り除く
+     */
+    void clear()
+    {
+        for (int word = 0; word < m_wordCount; ++word) {
+            m_words[word] = 0;
+        }
+        m_wordCount = 0;
+    }
+
+    /**
+     * @brief パッドが1つでも含まれているか
+     */
+    bool any() const
+    {
+        for (int word = 0; word < m_wordCount; ++word) {
+            if (m_words[word]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    PadMask& operator|=(const PadMask& other)
+    {
+        for (int word = 0; word < other.m_wordCount; ++word) {
+            m_words[word] |= other.m_words[word];
+        }
+        if (other.m_wordCount > m_wordCount) {
+            m_wordCount = other.m_wordCount;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 含まれているパッドのインデックスを昇順に列挙
+     * @param func インデックスを受け取る関数
+     */
+    template <typename Func>
+    void forEach(Func func) const
+    {
+        for (int word = 0; word < m_wordCount; ++word) {
+            uint64_t bits = m_words[word];
+            while (bits) {
+                func(word * 64 + countTrailingZeros(bits));
+                bits &= bits - 1;  // 最下位のビットを落とす
+            }
+        }
+    }
+
+private:
+    static int countTrailingZeros(uint64_t bits)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+private:
+    static constexpr int WORD_COUNT = CAPACITY / 64;
+
+    uint64_t m_words[WORD_COUNT];  // ビット列 (m_wordCount以降は常に0)
+    int m_wordCount;               // ビットを立てたことのある範囲のワード数
+};
+
+#endif // PAD_MASK_H
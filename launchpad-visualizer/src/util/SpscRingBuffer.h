@@ -0,0 +1,85 @@
+#ifndef SPSC_RING_BUFFER_H
+#define SPSC_RING_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief 単一プロデューサー・単一コンシューマー用のロックフリーリングバッファ
+ * キャプチャスレッドとバックグラウンドスレッドの間で固定長の要素を受け渡す。
+ * 容量は2のべき乗で、実際に格納できる要素数は Capacity - 1
+ */
+template <typename T, std::size_t Capacity>
+class SpscRingBuffer {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    /**
+     * @brief 要素を追加（プロデューサー側）
+     * @return 満杯で追加できなかった場合false
+     */
+    bool tryPush(const T& value)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        const std::size_t next = (head + 1) & MASK;
+        if (next == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        m_buffer[head] = value;
+        m_head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 要素を取り出す（コンシューマー側）
+     * @return 空の場合false
+     */
+    bool tryPop(T& value)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = m_buffer[tail];
+        m_tail.store((tail + 1) & MASK, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 先頭の要素を取り出さずに参照（コンシューマー側）
+     * @return 空の場合nullptr
+     */
+    const T* front() const
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &m_buffer[tail];
+    }
+
+    /**
+     * @brief 現在の要素数（概算）
+     */
+    std::size_t size() const
+    {
+        const std::size_t head = m_head.load(std::memory_order_acquire);
+        const std::size_t tail = m_tail.load(std::memory_order_acquire);
+        return (head - tail) & MASK;
+    }
+
+    /**
+     * @brief 格納可能な最大要素数
+     */
+    static constexpr std::size_t capacity() { return Capacity - 1; }
+
+private:
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    alignas(64) std::atomic<std::size_t> m_head{0};  // 書き込み位置（プロデューサー所有）
+    alignas(64) std::atomic<std::size_t> m_tail{0};  // 読み出し位置（コンシューマー所有）
+    alignas(64) std::array<T, Capacity> m_buffer{};
+};
+
+#endif // SPSC_RING_BUFFER_H
@@ -0,0 +1,396 @@
+#include "TestSupport.h"
+#include "LaunchpadVisualizer.h"
+#include "midi/MidiEventTap.h"
+#include "net/EventStreamServer.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLocalSocket>
+#include <functional>
+#include <vector>
+
+using EventStreamFormat::Event;
+using EventStreamFormat::Subscription;
+
+// キューに入るイベント数（リングバッファは1要素を空けておく）
+static constexpr int QUEUE_SLOTS = static_cast<int>(EventStreamServer::CLIENT_QUEUE_CAPACITY) - 1;
+
+/**
+ * @brief 条件が満たされるまでイベントを処理する
+ * @return 時間内に満たされた場合true
+ */
+template <typename Condition>
+static bool waitFor(Condition condition, int timeoutMs = 2000)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition()) {
+        if (timer.elapsed() > timeoutMs) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return true;
+}
+
+/**
+ * @brief 購読してイベントを受け取るクライアント
+ */
+class StreamClient {
+public:
+    bool connectTo(const QString& name)
+    {
+        m_socket.connectToServer(name);
+        return m_socket.waitForConnected(1000);
+    }
+
+    void subscribe(const Subscription& subscription)
+    {
+        unsigned char request[EventStreamFormat::SUBSCRIBE_SIZE];
+        EventStreamFormat::encodeSubscription(subscription, request);
+        m_socket.write(reinterpret_cast<const char*>(request), sizeof(request));
+        m_socket.flush();
+    }
+
+    /**
+     * @brief 届いている分を読み、イベントに分ける
+     */
+    void receive()
+    {
+        m_pending += m_socket.readAll();
+        const int recordSize = static_cast<int>(EventStreamFormat::RECORD_SIZE);
+        int offset = 0;
+        while (m_pending.size() - offset >= recordSize) {
+            Event event;
+            EventStreamFormat::decode(reinterpret_cast<const unsigned char*>(m_pending.constData()) + offset, event);
+            m_events.push_back(event);
+            offset += recordSize;
+        }
+        m_pending.remove(0, offset);
+    }
+
+    std::vector<Event>& events() { return m_events; }
+    QLocalSocket& socket() { return m_socket; }
+
+private:
+    QLocalSocket m_socket;
+    QByteArray m_pending;         // レコードの途中までのデータ
+    std::vector<Event> m_events;  // 受け取ったイベント
+};
+
+/**
+ * @brief キャプチャスレッドの代わりに押下・離上をキューに入れる
+ */
+static void capture(LaunchpadVisualizer& visualizer, int x, int y, int velocity)
+{
+    MidiEvent event;
+    event.timestampNs = MidiEvent::now();
+    event.data[0] = velocity > 0 ? 0x90 : 0x80;
+    event.data[1] = static_cast<unsigned char>((y + 1) * 10 + x + 1);
+    event.data[2] = static_cast<unsigned char>(velocity);
+    event.size = 3;
+    visualizer.eventTap()->midiEventCaptured(event);
+}
+
+static void changeColor(LaunchpadVisualizer& visualizer, int x, int y, uint32_t rgb)
+{
+    const LaunchpadProtocol::PadColor color = {x, y, rgb};
+    visualizer.applyPadColors(&color, 1);
+}
+
+static const EventStreamServer::ClientStats* findStats(const std::vector<EventStreamServer::ClientStats>& stats, int id)
+{
+    for (const EventStreamServer::ClientStats& client : stats) {
+        if (client.id == id) {
+            return &client;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 購読要求がサーバーに届くまで、条件に合う目印のイベントを送り続ける
+ * @param id サーバー側のクライアント番号（接続順）
+ */
+static bool subscribeAndWait(EventStreamServer& server, StreamClient& client, int id,
+                             const Subscription& subscription, const std::function<void()>& marker)
+{
+    client.subscribe(subscription);
+    return waitFor([&] {
+        marker();
+        const std::vector<EventStreamServer::ClientStats> stats = server.clientStats();
+        const EventStreamServer::ClientStats* entry = findStats(stats, id);
+        return entry && entry->sentCount > 0;
+    });
+}
+
+/**
+ * @brief 送信中のイベントを受け取り切ってから捨てる
+ */
+static void settle(const std::vector<StreamClient*>& clients)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < 100) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        for (StreamClient* client : clients) {
+            client->receive();
+        }
+    }
+    for (StreamClient* client : clients) {
+        client->events().clear();
+    }
+}
+
+static bool isEvent(const Event& event, uint8_t type, int x, int y)
+{
+    return event.type == type && event.x == x && event.y == y;
+}
+
+static QString serverName(const char* suffix)
+{
+    return QString("lpv-event-test-%1-%2").arg(QCoreApplication::applicationPid()).arg(suffix);
+}
+
+static void testSubscriptionFilters()
+{
+    LaunchpadVisualizer visualizer;
+    EventStreamServer server(&visualizer);
+    const QString name = serverName("filter");
+    CHECK(server.listen(name));
+
+    // 押下だけ、左下3x3の色だけ、すべての3つのクライアント
+    StreamClient presses;
+    StreamClient corner;
+    StreamClient all;
+    CHECK(presses.connectTo(name));
+    CHECK(corner.connectTo(name));
+    CHECK(all.connectTo(name));
+
+    Subscription pressOnly;
+    pressOnly.typeMask = 1u << (EventStreamFormat::PRESS - 1);
+    Subscription cornerColors;
+    cornerColors.typeMask = 1u << (EventStreamFormat::COLOR - 1);
+    cornerColors.x1 = 2;
+    cornerColors.y1 = 2;
+    CHECK(subscribeAndWait(server, presses, 1, pressOnly, [&] { capture(visualizer, 0, 0, 1); }));
+    CHECK(subscribeAndWait(server, corner, 2, cornerColors, [&] { changeColor(visualizer, 0, 0, 1); }));
+    CHECK(subscribeAndWait(server, all, 3, Subscription(), [&] { changeColor(visualizer, 0, 0, 1); }));
+    settle({&presses, &corner, &all});
+
+    capture(visualizer, 1, 1, 100);
+    changeColor(visualizer, 1, 1, 0x112233);
+    capture(visualizer, 1, 1, 0);
+    capture(visualizer, 5, 5, 50);
+    changeColor(visualizer, 5, 5, 0x445566);
+    capture(visualizer, 5, 5, 0);
+    CHECK(waitFor([&] {
+        all.receive();
+        return all.events().size() >= 6;
+    }));
+    settle({});
+    presses.receive();
+    corner.receive();
+    all.receive();
+
+    // 種類と範囲で絞り込まれ、絞り込まないクライアントには発生順にすべて届く
+    CHECK_EQ(presses.events().size(), static_cast<std::size_t>(2));
+    if (presses.events().size() == 2) {
+        CHECK(isEvent(presses.events()[0], EventStreamFormat::PRESS, 1, 1));
+        CHECK_EQ(presses.events()[0].value, 100);
+        CHECK(isEvent(presses.events()[1], EventStreamFormat::PRESS, 5, 5));
+        CHECK_EQ(presses.events()[1].value, 50);
+    }
+    CHECK_EQ(corner.events().size(), static_cast<std::size_t>(1));
+    if (corner.events().size() == 1) {
+        CHECK(isEvent(corner.events()[0], EventStreamFormat::COLOR, 1, 1));
+        CHECK_EQ(corner.events()[0].data, 0x112233u);
+    }
+    CHECK_EQ(all.events().size(), static_cast<std::size_t>(6));
+    if (all.events().size() == 6) {
+        CHECK(isEvent(all.events()[0], EventStreamFormat::PRESS, 1, 1));
+        CHECK(isEvent(all.events()[1], EventStreamFormat::COLOR, 1, 1));
+        CHECK(isEvent(all.events()[2], EventStreamFormat::RELEASE, 1, 1));
+        CHECK(isEvent(all.events()[3], EventStreamFormat::PRESS, 5, 5));
+        CHECK(isEvent(all.events()[4], EventStreamFormat::COLOR, 5, 5));
+        CHECK(isEvent(all.events()[5], EventStreamFormat::RELEASE, 5, 5));
+    }
+    server.close();
+}
+
+static void testPressPrecedesColor()
+{
+    LaunchpadVisualizer visualizer;
+    EventStreamServer server(&visualizer);
+    const QString name = serverName("order");
+    CHECK(server.listen(name));
+
+    StreamClient client;
+    CHECK(client.connectTo(name));
+    CHECK(subscribeAndWait(server, client, 1, Subscription(), [&] { changeColor(visualizer, 0, 0, 1); }));
+    settle({&client});
+
+    // 押下はキャプチャスレッドのキューで配信を待つが、色の変化より先に届く
+    const int pairs = 50;
+    for (int i = 0; i < pairs; ++i) {
+        const int x = i % PadStateModel::GRID_SIZE;
+        const int y = (i / PadStateModel::GRID_SIZE) % PadStateModel::GRID_SIZE;
+        capture(visualizer, x, y, 1 + i);
+        changeColor(visualizer, x, y, static_cast<uint32_t>(i));
+    }
+    CHECK(waitFor([&] {
+        client.receive();
+        return client.events().size() >= static_cast<std::size_t>(pairs * 2);
+    }));
+
+    const std::vector<Event>& events = client.events();
+    CHECK_EQ(events.size(), static_cast<std::size_t>(pairs * 2));
+    uint64_t previousNs = 0;
+    for (std::size_t i = 0; i + 1 < events.size(); i += 2) {
+        const int x = events[i].x;
+        const int y = events[i].y;
+        if (events[i].type != EventStreamFormat::PRESS || !isEvent(events[i + 1], EventStreamFormat::COLOR, x, y)
+            || events[i].timestampNs < previousNs || events[i + 1].timestampNs < events[i].timestampNs) {
+            TestSupport::fail(__FILE__, __LINE__, "押下、その色の変化の順に届く");
+            break;
+        }
+        previousNs = events[i + 1].timestampNs;
+    }
+    server.close();
+}
+
+static void testGapAfterOverflow()
+{
+    LaunchpadVisualizer visualizer;
+    EventStreamServer server(&visualizer);
+    const QString name = serverName("gap");
+    CHECK(server.listen(name));
+
+    StreamClient client;
+    CHECK(client.connectTo(name));
+    CHECK(subscribeAndWait(server, client, 1, Subscription(), [&] { changeColor(visualizer, 0, 0, 1); }));
+    settle({&client});
+
+    // 送信の間を与えずにキューの容量より多く発生させると、溢れた分は捨てられる
+    const int overflow = 100;
+    for (int i = 0; i < QUEUE_SLOTS + overflow; ++i) {
+        changeColor(visualizer, i % PadStateModel::GRID_SIZE, 0, static_cast<uint32_t>(i));
+    }
+    const std::vector<EventStreamServer::ClientStats> stats = server.clientStats();
+    CHECK_EQ(stats.size(), static_cast<std::size_t>(1));
+    if (!stats.empty()) {
+        CHECK_EQ(stats[0].droppedCount, static_cast<uint64_t>(overflow));
+    }
+
+    // キューが空いた後の次のイベントの前に、捨てた数をGAPで知らせる
+    CHECK(waitFor([&] {
+        client.receive();
+        return client.events().size() >= static_cast<std::size_t>(QUEUE_SLOTS);
+    }));
+    changeColor(visualizer, 8, 8, 0xABCDEF);
+    CHECK(waitFor([&] {
+        client.receive();
+        return client.events().size() >= static_cast<std::size_t>(QUEUE_SLOTS + 2);
+    }));
+
+    const std::vector<Event>& events = client.events();
+    CHECK_EQ(events.size(), static_cast<std::size_t>(QUEUE_SLOTS + 2));
+    if (events.size() == static_cast<std::size_t>(QUEUE_SLOTS + 2)) {
+        CHECK_EQ(events[0].data, 0u);
+        CHECK_EQ(events[QUEUE_SLOTS - 1].data, static_cast<uint32_t>(QUEUE_SLOTS - 1));
+        CHECK_EQ(events[QUEUE_SLOTS].type, static_cast<uint8_t>(EventStreamFormat::GAP));
+        CHECK_EQ(events[QUEUE_SLOTS].data, static_cast<uint32_t>(overflow));
+        CHECK(isEvent(events[QUEUE_SLOTS + 1], EventStreamFormat::COLOR, 8, 8));
+        CHECK_EQ(events[QUEUE_SLOTS + 1].data, 0xABCDEFu);
+    }
+    CHECK_EQ(client.socket().state(), QLocalSocket::ConnectedState);
+    CHECK_EQ(server.slowDisconnectCount(), 0u);
+    server.close();
+}
+
+static void testDisconnectOnOverflow()
+{
+    LaunchpadVisualizer visualizer;
+    EventStreamServer server(&visualizer);
+    const QString name = serverName("overflow");
+    CHECK(server.listen(name));
+
+    // 溢れたら切断を要求したクライアントと、GAPで知らせるクライアント
+    StreamClient strict;
+    StreamClient lenient;
+    CHECK(strict.connectTo(name));
+    CHECK(lenient.connectTo(name));
+    Subscription disconnectOnOverflow;
+    disconnectOnOverflow.flags = EventStreamFormat::FLAG_DISCONNECT_ON_OVERFLOW;
+    CHECK(subscribeAndWait(server, strict, 1, disconnectOnOverflow, [&] { changeColor(visualizer, 0, 0, 1); }));
+    CHECK(subscribeAndWait(server, lenient, 2, Subscription(), [&] { changeColor(visualizer, 0, 0, 1); }));
+    settle({&strict, &lenient});
+
+    for (int i = 0; i < QUEUE_SLOTS + 1; ++i) {
+        changeColor(visualizer, i % PadStateModel::GRID_SIZE, 0, static_cast<uint32_t>(i));
+    }
+    CHECK_EQ(server.slowDisconnectCount(), 1u);
+    const std::vector<EventStreamServer::ClientStats> stats = server.clientStats();
+    CHECK(findStats(stats, 1) == nullptr);
+    CHECK(findStats(stats, 2) != nullptr);
+
+    CHECK(waitFor([&] { return strict.socket().state() == QLocalSocket::UnconnectedState; }));
+    CHECK_EQ(lenient.socket().state(), QLocalSocket::ConnectedState);
+    server.close();
+}
+
+static void testLaggingClientIsDisconnected()
+{
+    LaunchpadVisualizer visualizer;
+    EventStreamServer server(&visualizer);
+    const QString name = serverName("lag");
+    CHECK(server.listen(name));
+
+    // 読まないクライアントは受信バッファを1レコードに制限し、カーネルのバッファが埋まったら止まる
+    StreamClient stalled;
+    StreamClient reader;
+    stalled.socket().setReadBufferSize(static_cast<qint64>(EventStreamFormat::RECORD_SIZE));
+    CHECK(stalled.connectTo(name));
+    CHECK(reader.connectTo(name));
+    CHECK(subscribeAndWait(server, stalled, 1, Subscription(), [&] { changeColor(visualizer, 0, 0, 1); }));
+    CHECK(subscribeAndWait(server, reader, 2, Subscription(), [&] { changeColor(visualizer, 0, 0, 1); }));
+
+    // ソケットに書けなくなり、サーバーのキューにイベントが残るまで送る
+    QElapsedTimer sinceFirstEvent;
+    sinceFirstEvent.start();
+    int sent = 0;
+    const bool stalledQueue = waitFor([&] {
+        for (int i = 0; i < 256; ++i, ++sent) {
+            changeColor(visualizer, sent % PadStateModel::GRID_SIZE, 1, static_cast<uint32_t>(sent));
+        }
+        reader.receive();
+        const std::vector<EventStreamServer::ClientStats> stats = server.clientStats();
+        const EventStreamServer::ClientStats* entry = findStats(stats, 1);
+        return entry && entry->queueDepth > 0 && entry->socketBacklog >= EventStreamServer::MAX_SOCKET_BACKLOG;
+    }, 10000);
+    CHECK(stalledQueue);
+
+    // 先頭のイベントの遅れがMAX_LAG_MSを超えた時点で切断され、読んでいるクライアントは残る
+    CHECK(waitFor([&] {
+        reader.receive();
+        return server.slowDisconnectCount() >= 1;
+    }, EventStreamServer::MAX_LAG_MS + 3000));
+    CHECK(sinceFirstEvent.elapsed() >= EventStreamServer::MAX_LAG_MS);
+    CHECK_EQ(server.slowDisconnectCount(), 1u);
+
+    const std::vector<EventStreamServer::ClientStats> stats = server.clientStats();
+    CHECK(findStats(stats, 1) == nullptr);
+    CHECK(findStats(stats, 2) != nullptr);
+    CHECK_EQ(reader.socket().state(), QLocalSocket::ConnectedState);
+    server.close();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    testSubscriptionFilters();
+    testPressPrecedesColor();
+    testGapAfterOverflow();
+    testDisconnectOnOverflow();
+    testLaggingClientIsDisconnected();
+    return TEST_RESULT();
+}
@@ -0,0 +1,327 @@
+#include "TestSupport.h"
+#include "LaunchpadVisualizer.h"
+#include "net/MetricsServer.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QList>
+#include <QTcpSocket>
+#include <map>
+#include <set>
+
+/**
+ * @brief 解析したPrometheusのテキスト形式
+ */
+struct Exposition {
+    std::map<QByteArray, QByteArray> types;     // メトリクス名 → TYPE
+    std::set<QByteArray> helps;                 // HELPのあるメトリクス名
+    std::map<QByteArray, double> samples;       // 名前とラベル → 値
+    std::map<QByteArray, QByteArray> families;  // 名前とラベル → 属するメトリクス名
+};
+
+/**
+ * @brief サンプル名が属するメトリクス名を取得（summaryの _sum/_count を含む）
+ */
+static QByteArray familyOf(const QByteArray& name, const std::map<QByteArray, QByteArray>& types)
+{
+    if (types.count(name)) {
+        return name;
+    }
+    for (const QByteArray suffix : {QByteArray("_sum"), QByteArray("_count")}) {
+        if (name.endsWith(suffix)) {
+            const QByteArray base = name.left(name.size() - suffix.size());
+            const auto type = types.find(base);
+            if (type != types.end() && type->second == "summary") {
+                return base;
+            }
+        }
+    }
+    return QByteArray();
+}
+
+/**
+ * @brief テキスト形式を解析し、サンプルの前にHELPとTYPEがあることを検査
+ */
+static Exposition parse(const QByteArray& text)
+{
+    Exposition result;
+    CHECK(text.endsWith('\n'));
+
+    for (const QByteArray& line : text.split('\n')) {
+        if (line.isEmpty()) {
+            continue;
+        }
+        if (line.startsWith("# HELP ")) {
+            const QList<QByteArray> fields = line.split(' ');
+            CHECK(fields.size() > 3);
+            result.helps.insert(fields.value(2));
+            continue;
+        }
+        if (line.startsWith("# TYPE ")) {
+            const QList<QByteArray> fields = line.split(' ');
+            CHECK_EQ(fields.size(), 4);
+            const QByteArray name = fields.value(2);
+            // 同じメトリクスのTYPEは1回だけ、HELPの直後に置く
+            CHECK(!result.types.count(name));
+            CHECK(result.helps.count(name));
+            result.types[name] = fields.value(3);
+            continue;
+        }
+        CHECK(!line.startsWith('#'));
+
+        const int space = line.lastIndexOf(' ');
+        CHECK(space > 0);
+        const QByteArray key = line.left(space);
+        const int brace = key.indexOf('{');
+        const QByteArray name = brace < 0 ? key : key.left(brace);
+        if (brace >= 0) {
+            CHECK(key.endsWith('}'));
+        }
+
+        bool ok = false;
+        const double value = line.mid(space + 1).toDouble(&ok);
+        CHECK(ok);
+
+        const QByteArray family = familyOf(name, result.types);
+        if (family.isEmpty()) {
+            TestSupport::fail(__FILE__, __LINE__, line.constData());
+            continue;
+        }
+        CHECK(!result.samples.count(key));
+        result.samples[key] = value;
+        result.families[key] = family;
+    }
+    return result;
+}
+
+/**
+ * @brief カウンターとsummaryの件数・合計かどうかを判定
+ */
+static bool isMonotonic(const Exposition& exposition, const QByteArray& key)
+{
+    const QByteArray type = exposition.types.at(exposition.families.at(key));
+    if (type == "counter") {
+        return true;
+    }
+    return type == "summary" && !key.contains("quantile=");
+}
+
+/**
+ * @brief 条件が満たされるまでイベントを処理する（サーバーも同じスレッドで動く）
+ * @return 時間内に満たされた場合true
+ */
+template <typename Condition>
+static bool waitFor(Condition condition, int timeoutMs = 2000)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition()) {
+        if (timer.elapsed() > timeoutMs) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return true;
+}
+
+/**
+ * @brief 解析したHTTPの応答
+ */
+struct Response {
+    QByteArray statusLine;
+    std::map<QByteArray, QByteArray> headers;  // 名前（小文字） → 値
+    QByteArray body;
+    bool closed = false;  // サーバーが接続を閉じたかどうか
+
+    QByteArray header(const char* name) const
+    {
+        const auto found = headers.find(name);
+        return found != headers.end() ? found->second : QByteArray();
+    }
+};
+
+/**
+ * @brief リクエストを送り、サーバーが接続を閉じるまでに受け取った応答を返す
+ * @param parts 送信するデータ（要素ごとにイベントを処理してから次を送る）
+ */
+static Response request(quint16 port, const QList<QByteArray>& parts)
+{
+    Response response;
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, port);
+    CHECK(waitFor([&] { return socket.state() == QAbstractSocket::ConnectedState; }));
+
+    QByteArray received;
+    for (const QByteArray& part : parts) {
+        socket.write(part);
+        socket.flush();
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        received += socket.readAll();
+    }
+    response.closed = waitFor([&] {
+        received += socket.readAll();
+        return socket.state() == QAbstractSocket::UnconnectedState;
+    });
+    received += socket.readAll();
+
+    const int headerEnd = received.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        return response;
+    }
+    const QList<QByteArray> lines = received.left(headerEnd).split('\n');
+    response.statusLine = lines.value(0).trimmed();
+    for (int i = 1; i < lines.size(); ++i) {
+        const int colon = lines.value(i).indexOf(':');
+        CHECK(colon > 0);
+        response.headers[lines.value(i).left(colon).trimmed().toLower()] = lines.value(i).mid(colon + 1).trimmed();
+    }
+    response.body = received.mid(headerEnd + 4);
+    return response;
+}
+
+static Response request(quint16 port, const QByteArray& data)
+{
+    return request(port, QList<QByteArray>() << data);
+}
+
+static MidiEvent makeEvent(unsigned char status, unsigned char data1, unsigned char data2)
+{
+    MidiEvent event;
+    event.timestampNs = MidiEvent::now();
+    event.data[0] = status;
+    event.data[1] = data1;
+    event.data[2] = data2;
+    event.size = 3;
+    return event;
+}
+
+static void testExpositionFormat(const MetricsServer& server)
+{
+    const Exposition exposition = parse(server.metrics());
+
+    const auto typeOf = [&](const char* name) {
+        const auto type = exposition.types.find(name);
+        return type != exposition.types.end() ? type->second : QByteArray();
+    };
+    CHECK_EQ(typeOf("lpv_midi_events_total"), QByteArray("counter"));
+    CHECK_EQ(typeOf("lpv_frames_rendered_total"), QByteArray("counter"));
+    CHECK_EQ(typeOf("lpv_gui_queue_depth"), QByteArray("gauge"));
+    CHECK_EQ(typeOf("lpv_latency_seconds"), QByteArray("summary"));
+    for (int type = 0; type < Telemetry::EVENT_TYPE_COUNT; ++type) {
+        const QByteArray key = QByteArray("lpv_midi_events_total{type=\"")
+            + Telemetry::eventTypeName(static_cast<Telemetry::EventType>(type)) + "\"}";
+        CHECK(exposition.samples.count(key));
+    }
+
+    // カウンターの名前は _total で終わる
+    for (const auto& type : exposition.types) {
+        if (type.second == "counter") {
+            CHECK(type.first.endsWith("_total"));
+        }
+    }
+
+    // フレームレートはPrometheus側でカウンターから求める
+    CHECK(!exposition.types.count("lpv_render_fps"));
+}
+
+static void testCountersOnlyIncrease(LaunchpadVisualizer& visualizer, const MetricsServer& server)
+{
+    const Exposition before = parse(server.metrics());
+
+    // 読み出しを繰り返しても値は変わらない（スクレイプの間隔に依存しない）
+    const Exposition repeated = parse(server.metrics());
+    for (const auto& sample : before.samples) {
+        if (isMonotonic(before, sample.first)) {
+            CHECK_EQ(repeated.samples.at(sample.first), sample.second);
+        }
+    }
+
+    Telemetry* telemetry = visualizer.telemetry();
+    for (int i = 0; i < 10; ++i) {
+        telemetry->eventDispatched(makeEvent(0x90, 11, 100));
+        telemetry->eventDispatched(makeEvent(0x80, 11, 0));
+        telemetry->eventHandled();
+        telemetry->frameRendered(2000000);
+    }
+
+    const Exposition after = parse(server.metrics());
+    CHECK_EQ(after.types, before.types);
+    for (const auto& sample : before.samples) {
+        if (!isMonotonic(before, sample.first)) {
+            continue;
+        }
+        const auto current = after.samples.find(sample.first);
+        if (current == after.samples.end() || current->second < sample.second) {
+            TestSupport::fail(__FILE__, __LINE__, sample.first.constData());
+        }
+    }
+
+    const auto increase = [&](const char* key) {
+        return after.samples.at(key) - before.samples.at(key);
+    };
+    CHECK_EQ(increase("lpv_frames_rendered_total"), 10.0);
+    CHECK_EQ(increase("lpv_gui_events_handled_total"), 10.0);
+    CHECK_EQ(increase("lpv_midi_events_total{type=\"note_on\"}"), 10.0);
+    CHECK_EQ(increase("lpv_paint_duration_seconds_count"), 10.0);
+}
+
+static void testHttpEndpoint(MetricsServer& server)
+{
+    CHECK(server.listen(0));
+    const quint16 port = server.serverPort();
+    CHECK(port != 0);
+
+    // 本文の長さはContent-Lengthと一致し、送った後に接続を閉じる
+    const Response metrics = request(port, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    CHECK(metrics.closed);
+    CHECK_EQ(metrics.statusLine, QByteArray("HTTP/1.1 200 OK"));
+    CHECK(metrics.header("content-type").startsWith("text/plain; version=0.0.4"));
+    CHECK_EQ(metrics.header("content-length"), QByteArray::number(metrics.body.size()));
+    CHECK_EQ(metrics.header("connection"), QByteArray("close"));
+    CHECK(parse(metrics.body).samples.count("lpv_frames_rendered_total"));
+
+    // クエリ付きや、ヘッダーが分かれて届いた場合も同じ
+    const Response query = request(port, "GET /metrics?name[]=lpv HTTP/1.1\r\n\r\n");
+    CHECK_EQ(query.statusLine, QByteArray("HTTP/1.1 200 OK"));
+    const Response split = request(port, QList<QByteArray>() << "GET /metr" << "ics HTTP/1.1\r\nHost: lo"
+                                                             << "calhost\r\n" << "\r\n");
+    CHECK_EQ(split.statusLine, QByteArray("HTTP/1.1 200 OK"));
+    CHECK_EQ(split.header("content-length"), QByteArray::number(split.body.size()));
+    CHECK(!split.body.isEmpty());
+
+    // 他のパスとGET以外は本文なしで返す
+    const Response notFound = request(port, "GET /foo HTTP/1.1\r\n\r\n");
+    CHECK(notFound.closed);
+    CHECK_EQ(notFound.statusLine, QByteArray("HTTP/1.1 404 Not Found"));
+    CHECK_EQ(notFound.header("content-length"), QByteArray("0"));
+    CHECK(notFound.body.isEmpty());
+    const Response prefix = request(port, "GET /metricsfoo HTTP/1.1\r\n\r\n");
+    CHECK_EQ(prefix.statusLine, QByteArray("HTTP/1.1 404 Not Found"));
+
+    const Response post = request(port, "POST /metrics HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+    CHECK(post.closed);
+    CHECK_EQ(post.statusLine, QByteArray("HTTP/1.1 405 Method Not Allowed"));
+    CHECK_EQ(post.header("content-length"), QByteArray("0"));
+    CHECK(post.body.isEmpty());
+
+    // ヘッダーが終わらないまま上限を超えたら応答せずに切断する
+    const QByteArray oversized = "GET /metrics HTTP/1.1\r\nX-Padding: "
+        + QByteArray(MetricsServer::MAX_REQUEST_SIZE, 'x');
+    const Response aborted = request(port, oversized);
+    CHECK(aborted.closed);
+    CHECK(aborted.statusLine.isEmpty());
+
+    // 切断した後も次のリクエストを受け付ける
+    CHECK_EQ(request(port, "GET /metrics HTTP/1.1\r\n\r\n").statusLine, QByteArray("HTTP/1.1 200 OK"));
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    LaunchpadVisualizer visualizer;
+    MetricsServer server(&visualizer);
+
+    testExpositionFormat(server);
+    testCountersOnlyIncrease(visualizer, server);
+    testHttpEndpoint(server);
+    return TEST_RESULT();
+}
@@ -0,0 +1,182 @@
+#include "TestSupport.h"
+#include "LaunchpadVisualizer.h"
+#include "net/OscBridge.h"
+#include "net/OscCodec.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QUdpSocket>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief 条件が満たされるまでイベントを処理する
+ * @return 時間内に満たされた場合true
+ */
+template <typename Condition>
+static bool waitFor(Condition condition, int timeoutMs = 2000)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition()) {
+        if (timer.elapsed() > timeoutMs) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return true;
+}
+
+/**
+ * @brief 色の指定を1つ書き込む（整数は0-255、浮動小数点数は0.0-1.0）
+ */
+static bool writeColor(OscWriter& writer, int x, int y, const char* typeTags, const float* values)
+{
+    char address[32];
+    std::snprintf(address, sizeof(address), "/pad/%d/%d/color", x, y);
+    writer.beginMessage(address, typeTags);
+    for (int i = 0; i < 3; ++i) {
+        if (typeTags[i] == 'f') {
+            writer.addFloat(values[i]);
+        } else {
+            writer.addInt(static_cast<int32_t>(values[i]));
+        }
+    }
+    return writer.endMessage();
+}
+
+static void testWriterSplitsAtBufferLimit()
+{
+    // "/pad/x/y/color" (16) + ",iii" (8) + 引数 (12) + 要素のサイズ (4) = 40バイト
+    unsigned char buffer[16 + 40 * 3 + 20];
+    OscWriter writer(buffer, sizeof(buffer));
+    CHECK(writer.beginBundle());
+
+    const float values[] = {255.0f, 128.0f, 0.0f};
+    int written = 0;
+    while (writeColor(writer, written % PadStateModel::GRID_SIZE, 0, "iii", values)) {
+        ++written;
+    }
+
+    // 入りきらなかったメッセージは取り消され、書き込んだ分は正しいバンドルのまま残る
+    CHECK_EQ(written, 3);
+    CHECK_EQ(writer.messageCount(), 3);
+    CHECK_EQ(writer.size(), static_cast<std::size_t>(16 + 40 * 3));
+    int parsed = 0;
+    const bool valid = OscReader::parse(buffer, writer.size(), [&](const OscMessage& message) {
+        CHECK_EQ(std::strcmp(message.typeTags, "iii"), 0);
+        ++parsed;
+    });
+    CHECK(valid);
+    CHECK_EQ(parsed, 3);
+
+    // 空のバンドルに書き直せば取り消したメッセージも入る
+    writer.reset();
+    CHECK(writer.beginBundle());
+    CHECK(writeColor(writer, 3, 0, "iii", values));
+    CHECK_EQ(writer.messageCount(), 1);
+}
+
+static void testReceivedBundleIsAppliedInOneBatch()
+{
+    LaunchpadVisualizer visualizer;
+    OscBridge bridge(&visualizer);
+    CHECK(bridge.listen(0));
+
+    std::vector<LaunchpadProtocol::PadColor> applied;
+    QObject::connect(&visualizer, &LaunchpadVisualizer::padColorChanged, [&](int x, int y, uint32_t rgb) {
+        applied.push_back({x, y, rgb});
+    });
+
+    unsigned char packet[OscBridge::MAX_PACKET_SIZE];
+    OscWriter writer(packet, sizeof(packet));
+    CHECK(writer.beginBundle());
+    const float red[] = {255.0f, 0.0f, 0.0f};
+    const float green[] = {0.0f, 1.0f, 0.0f};
+    const float half[] = {0.5f, 0.5f, 0.5f};
+    const float clamped[] = {300.0f, -5.0f, 16.0f};
+    CHECK(writeColor(writer, 0, 0, "iii", red));
+    CHECK(writeColor(writer, 8, 8, "fff", green));
+    CHECK(writeColor(writer, 4, 2, "fff", half));
+    CHECK(writeColor(writer, 1, 7, "iii", clamped));
+    writer.beginMessage("/pad/9/0/color", "iii");  // 範囲外の座標は無視する
+    writer.addInt(1);
+    writer.addInt(2);
+    writer.addInt(3);
+    CHECK(writer.endMessage());
+
+    QUdpSocket sender;
+    CHECK_EQ(sender.writeDatagram(reinterpret_cast<const char*>(packet), static_cast<qint64>(writer.size()),
+                                  QHostAddress::LocalHost, bridge.localPort()),
+             static_cast<qint64>(writer.size()));
+
+    CHECK(waitFor([&] { return bridge.messagesReceived() >= 4; }));
+    CHECK_EQ(bridge.messagesReceived(), 4u);
+    CHECK_EQ(bridge.batchesApplied(), 1u);
+    CHECK_EQ(bridge.messagesSent(), 0u);
+
+    CHECK_EQ(applied.size(), static_cast<std::size_t>(4));
+    if (applied.size() == 4) {
+        CHECK_EQ(applied[0].rgb, 0xFF0000u);
+        CHECK_EQ(applied[1].x, 8);
+        CHECK_EQ(applied[1].rgb, 0x00FF00u);
+        CHECK_EQ(applied[2].rgb, 0x808080u);
+        CHECK_EQ(applied[3].rgb, 0xFF0010u);
+    }
+}
+
+static void testSentEventsAreSplitIntoDatagrams()
+{
+    LaunchpadVisualizer visualizer;
+    OscBridge bridge(&visualizer);
+
+    QUdpSocket receiver;
+    CHECK(receiver.bind(QHostAddress::LocalHost, 0));
+    bridge.addTarget(QHostAddress::LocalHost, receiver.localPort());
+
+    // 全パッドの色の変化は1つのバンドルに入りきらない
+    std::vector<LaunchpadProtocol::PadColor> colors;
+    for (int index = 0; index < PadStateModel::PAD_COUNT; ++index) {
+        colors.push_back({index % PadStateModel::GRID_SIZE, index / PadStateModel::GRID_SIZE,
+                          static_cast<uint32_t>(index) * 0x010101u});
+    }
+    visualizer.applyPadColors(colors.data(), colors.size());
+
+    int datagrams = 0;
+    int messages = 0;
+    std::vector<unsigned char> datagram(OscBridge::MAX_RECEIVE_SIZE);
+    const auto receive = [&] {
+        while (receiver.hasPendingDatagrams()) {
+            const qint64 size = receiver.readDatagram(reinterpret_cast<char*>(datagram.data()),
+                                                      static_cast<qint64>(datagram.size()));
+            CHECK(size > 0 && size <= OscBridge::MAX_PACKET_SIZE);
+            ++datagrams;
+
+            // 分割してもパッドの順に届く
+            const bool valid = OscReader::parse(datagram.data(), static_cast<std::size_t>(size),
+                                                [&](const OscMessage& message) {
+                char expected[32];
+                std::snprintf(expected, sizeof(expected), "/pad/%d/%d/color",
+                              messages % PadStateModel::GRID_SIZE, messages / PadStateModel::GRID_SIZE);
+                CHECK_EQ(std::strcmp(message.address, expected), 0);
+                ++messages;
+            });
+            CHECK(valid);
+        }
+        return messages >= PadStateModel::PAD_COUNT;
+    };
+    CHECK(waitFor(receive));
+
+    CHECK_EQ(messages, PadStateModel::PAD_COUNT);
+    CHECK(datagrams > 1);
+    CHECK_EQ(bridge.messagesSent(), static_cast<uint64_t>(PadStateModel::PAD_COUNT));
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    testWriterSplitsAtBufferLimit();
+    testReceivedBundleIsAppliedInOneBatch();
+    testSentEventsAreSplitIntoDatagrams();
+    return TEST_RESULT();
+}
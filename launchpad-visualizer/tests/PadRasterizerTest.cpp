@@ -0,0 +1,138 @@
+#include "TestSupport.h"
+#include "gui/PadRasterizer.h"
+#include "gui/PadSpriteCache.h"
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <cstdio>
+#include <cstdlib>
+
+// 角の円弧はQPainterのベジェ近似・カバレッジ計算と一致しないため、
+// 1ピクセルの境界線の輪郭付近で最大で約1/3の差を許す
+static constexpr int MAX_CORNER_DIFFERENCE = 96;
+// 直線部分の境界線は同じ位置・同じ幅なので丸め誤差だけが残る
+static constexpr int MAX_EDGE_DIFFERENCE = 2;
+static constexpr int PAD_OFFSET = 4;  // 画像の端からパッドまでの論理ピクセル数
+
+/**
+ * @brief 境界線が背景・パッド本体と区別できる配色にする
+ */
+static const QColor BACKGROUND(0, 0, 0);
+static const QColor BORDER(255, 255, 255);
+
+/**
+ * @brief 2つの画像の指定範囲の、チャンネルごとの差の最大値
+ */
+static int maxDifference(const QImage& a, const QImage& b, const QRect& area)
+{
+    int worst = 0;
+    for (int y = area.top(); y <= area.bottom(); ++y) {
+        const QRgb* left = reinterpret_cast<const QRgb*>(a.constScanLine(y));
+        const QRgb* right = reinterpret_cast<const QRgb*>(b.constScanLine(y));
+        for (int x = area.left(); x <= area.right(); ++x) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                const int difference = std::abs(static_cast<int>((left[x] >> shift) & 0xFF)
+                                                - static_cast<int>((right[x] >> shift) & 0xFF));
+                worst = qMax(worst, difference);
+            }
+        }
+    }
+    return worst;
+}
+
+/**
+ * @brief 同じパッドをrenderPad（QPainter）とPadRasterizerで描き、見た目が揃っていることを検査
+ */
+static void checkPad(int padSize, qreal devicePixelRatio, bool round, const QColor& color, int glow)
+{
+    const int logicalSize = padSize + PAD_OFFSET * 2;
+    const QRect padRect(PAD_OFFSET, PAD_OFFSET, padSize, padSize);
+
+    PadRasterizer rasterizer;
+    rasterizer.resize(QSize(logicalSize, logicalSize), devicePixelRatio);
+    rasterizer.fill(BACKGROUND);
+    rasterizer.drawPad(padRect, color, glow, BORDER, round);
+    const QImage& raster = rasterizer.image();
+
+    QImage painted(raster.size(), QImage::Format_ARGB32_Premultiplied);
+    painted.setDevicePixelRatio(devicePixelRatio);
+    painted.fill(BACKGROUND);
+    {
+        QPainter painter(&painted);
+        painter.setRenderHint(QPainter::Antialiasing);
+        PadSpriteCache::renderPad(painter, padRect, color, glow, BORDER, round);
+    }
+
+    const int worst = maxDifference(painted, raster, painted.rect());
+    // 角丸の四角は縦横の中央の行・列が直線部分の境界線を横切る
+    const int center = painted.width() / 2;
+    const int edge = qMax(maxDifference(painted, raster, QRect(0, center, painted.width(), 1)),
+                          maxDifference(painted, raster, QRect(center, 0, 1, painted.height())));
+
+    if (worst > MAX_CORNER_DIFFERENCE || (!round && edge > MAX_EDGE_DIFFERENCE)) {
+        char message[128];
+        std::snprintf(message, sizeof(message), "size %d, ratio %.1f, %s, glow %d: difference %d (edge %d)",
+                      padSize, devicePixelRatio, round ? "round" : "square", glow, worst, edge);
+        TestSupport::fail(__FILE__, __LINE__, message);
+    }
+}
+
+static void testMatchesRenderPad()
+{
+    const struct {
+        QColor color;
+        int glow;
+    } states[] = {
+        {QColor(0, 0, 0), 0},        // 消灯
+        {QColor(255, 0, 0), 0},      // 点灯
+        {QColor(0, 200, 255), 255},  // 押下中
+        {QColor(255, 255, 0), 128},  // 押下後の減衰中
+    };
+    const int padSizes[] = {20, 37, 48, 64};
+    const qreal ratios[] = {1.0, 2.0};
+
+    for (qreal ratio : ratios) {
+        for (int padSize : padSizes) {
+            for (bool round : {false, true}) {
+                for (const auto& state : states) {
+                    checkPad(padSize, ratio, round, state.color, state.glow);
+                }
+            }
+        }
+    }
+}
+
+static void testRedrawDoesNotAccumulate()
+{
+    // 境界線はパッドの外側へはみ出すので、LaunchpadGridと同じくMARGINを含めて消去してから描き直す
+    const QRect padRect(PAD_OFFSET, PAD_OFFSET, 37, 37);
+    const QRect clearRect = padRect.adjusted(-PadSpriteCache::MARGIN, -PadSpriteCache::MARGIN,
+                                             PadSpriteCache::MARGIN, PadSpriteCache::MARGIN);
+    const QSize size(37 + PAD_OFFSET * 2, 37 + PAD_OFFSET * 2);
+
+    for (qreal ratio : {1.0, 2.0}) {
+        PadRasterizer rasterizer;
+        rasterizer.resize(size, ratio);
+        rasterizer.fill(BACKGROUND);
+        rasterizer.drawPad(padRect, QColor(255, 0, 0), 0, BORDER, false);
+        const QImage first = rasterizer.image().copy();
+
+        for (int i = 0; i < 3; ++i) {
+            rasterizer.clearRect(clearRect, BACKGROUND);
+            rasterizer.drawPad(padRect, QColor(255, 0, 0), 0, BORDER, false);
+        }
+        CHECK(rasterizer.image() == first);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // 表示のない環境でも動くよう、QT_QPA_PLATFORMが未設定ならoffscreenを使う
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+    testMatchesRenderPad();
+    testRedrawDoesNotAccumulate();
+    return TEST_RESULT();
+}
@@ -0,0 +1,144 @@
+#include "TestSupport.h"
+#include "model/PadStateModel.h"
+#include "model/PadEnvelope.h"
+#include "util/PadMask.h"
+
+/**
+ * @brief MIDIイベントを作る
+ */
+static MidiEvent makeEvent(unsigned char status, unsigned char data1, unsigned char data2)
+{
+    MidiEvent event;
+    event.timestampNs = 0;
+    event.data[0] = status;
+    event.data[1] = data1;
+    event.data[2] = data2;
+    event.size = 3;
+    return event;
+}
+
+static void testCoordinates()
+{
+    int x, y;
+    CHECK(PadStateModel::noteToXY(11, x, y));
+    CHECK_EQ(x, 0);
+    CHECK_EQ(y, 0);
+    CHECK(PadStateModel::noteToXY(88, x, y));
+    CHECK_EQ(x, 7);
+    CHECK_EQ(y, 7);
+    CHECK(!PadStateModel::noteToXY(10, x, y));
+
+    // 上段と右端のボタンはコントロールチェンジ
+    CHECK(PadStateModel::controlToXY(91, x, y));
+    CHECK_EQ(x, 0);
+    CHECK_EQ(y, 8);
+    CHECK(PadStateModel::controlToXY(19, x, y));
+    CHECK_EQ(x, 8);
+    CHECK_EQ(y, 0);
+}
+
+static void testApplyEvent()
+{
+    PadStateModel state;
+    CHECK(state.applyEvent(makeEvent(0x90, 45, 100)));
+    CHECK(state.isActive(4, 3));
+    CHECK_EQ(state.velocity(4, 3), 100);
+    CHECK_EQ(state.color(4, 3), PadStateModel::velocityToRgb(100));
+
+    // ベロシティ0のNote Onは離上（色は残る）
+    CHECK(state.applyEvent(makeEvent(0x90, 45, 0)));
+    CHECK(!state.isActive(4, 3));
+    CHECK_EQ(state.color(4, 3), PadStateModel::velocityToRgb(100));
+
+    CHECK(!state.applyEvent(makeEvent(0x90, 5, 100)));
+}
+
+static void testSerialize()
+{
+    PadStateModel state;
+    state.press(1, 2, 64);
+    state.setColor(8, 8, 0x123456);
+
+    unsigned char snapshot[PadStateModel::SNAPSHOT_SIZE];
+    state.serialize(snapshot);
+    PadStateModel restored;
+    restored.deserialize(snapshot);
+    for (int y = 0; y < PadStateModel::GRID_SIZE; ++y) {
+        for (int x = 0; x < PadStateModel::GRID_SIZE; ++x) {
+            CHECK_EQ(restored.color(x, y), state.color(x, y));
+            CHECK_EQ(restored.isActive(x, y), state.isActive(x, y));
+            CHECK_EQ(restored.velocity(x, y), state.velocity(x, y));
+        }
+    }
+}
+
+static void testPadMask()
+{
+    PadMask mask;
+    CHECK(!mask.any());
+    mask.set(0);
+    mask.set(80);
+    int count = 0;
+    int last = -1;
+    mask.forEach([&](int index) {
+        CHECK(index > last);
+        last = index;
+        ++count;
+    });
+    CHECK_EQ(count, 2);
+    CHECK(mask.test(80));
+    CHECK(!mask.test(79));
+
+    PadMask all;
+    all.setFirst(PadStateModel::PAD_COUNT);
+    count = 0;
+    all.forEach([&](int) { ++count; });
+    CHECK_EQ(count, PadStateModel::PAD_COUNT);
+}
+
+static void testLargeGrid()
+{
+    // 64x64の表面でも末尾のパッドまで扱える
+    PadMask mask;
+    mask.set(PadMask::CAPACITY - 1);
+    CHECK(mask.any());
+    CHECK(mask.test(PadMask::CAPACITY - 1));
+    CHECK(!mask.test(0));
+
+    PadMask all;
+    all.setFirst(PadMask::CAPACITY);
+    int count = 0;
+    all.forEach([&](int) { ++count; });
+    CHECK_EQ(count, PadMask::CAPACITY);
+    all.clear();
+    CHECK(!all.any());
+
+    PadMask merged;
+    merged.set(3);
+    merged |= mask;
+    count = 0;
+    merged.forEach([&](int) { ++count; });
+    CHECK_EQ(count, 2);
+
+    // エンベロープの配列は表面のパッド数だけ確保する
+    const int padCount = 64 * 64;
+    PadEnvelope envelope(padCount);
+    CHECK_EQ(envelope.padCount(), padCount);
+    envelope.noteOn(padCount - 1, 1000);
+    envelope.noteOn(padCount, 1000);
+    PadMask changed;
+    envelope.advance(2000, changed);
+    CHECK(changed.test(padCount - 1));
+    CHECK_EQ(envelope.level(padCount - 1), PadEnvelope::LEVELS);
+    CHECK_EQ(envelope.level(padCount), 0);
+}
+
+int main()
+{
+    testCoordinates();
+    testApplyEvent();
+    testSerialize();
+    testPadMask();
+    testLargeGrid();
+    return TEST_RESULT();
+}
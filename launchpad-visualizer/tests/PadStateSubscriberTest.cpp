@@ -0,0 +1,176 @@
+#include "TestSupport.h"
+#include "net/PadStateSubscriber.h"
+#include "net/StreamFormat.h"
+#include <QCoreApplication>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief 配信側を模して、パッドを1つずつ変えながらパケットを作る
+ */
+class PacketSource {
+public:
+    PacketSource() : m_session(1), m_sequence(0) {}
+
+    /**
+     * @brief パッドの色を変えて差分のパケットを作る
+     */
+    std::vector<unsigned char> delta(int x, int y, uint32_t rgb)
+    {
+        m_state.setColor(x, y, rgb);
+        PadMask changed;
+        changed.set(PadStateModel::index(x, y));
+        return encode(changed, false);
+    }
+
+    /**
+     * @brief 現在の状態のキーフレームを作る
+     */
+    std::vector<unsigned char> keyframe()
+    {
+        return encode(PadMask(), true);
+    }
+
+    /**
+     * @brief 配信側の再起動を模してセッションIDを変え、シーケンス番号を0に戻す
+     */
+    void restart()
+    {
+        ++m_session;
+        m_sequence = 0;
+    }
+
+    const PadStateModel& state() const { return m_state; }
+
+private:
+    std::vector<unsigned char> encode(const PadMask& changed, bool keyframe)
+    {
+        std::vector<unsigned char> packet(StreamFormat::MAX_PACKET_SIZE);
+        packet.resize(StreamFormat::encode(m_state, changed, keyframe, m_session, m_sequence++, packet.data()));
+        return packet;
+    }
+
+    PadStateModel m_state;
+    uint32_t m_session;
+    uint32_t m_sequence;
+};
+
+static bool deliver(PadStateSubscriber& subscriber, const std::vector<unsigned char>& packet)
+{
+    return subscriber.processPacket(packet.data(), packet.size());
+}
+
+static bool sameState(const PadStateModel& a, const PadStateModel& b)
+{
+    unsigned char left[PadStateModel::SNAPSHOT_SIZE];
+    unsigned char right[PadStateModel::SNAPSHOT_SIZE];
+    a.serialize(left);
+    b.serialize(right);
+    return std::memcmp(left, right, sizeof(left)) == 0;
+}
+
+static void testLossAndReorder()
+{
+    PacketSource source;
+    PadStateSubscriber subscriber;
+
+    const std::vector<unsigned char> key0 = source.keyframe();
+    const std::vector<unsigned char> delta1 = source.delta(0, 0, 0xFF0000);
+    const std::vector<unsigned char> delta2 = source.delta(1, 0, 0x00FF00);
+    const std::vector<unsigned char> delta3 = source.delta(2, 0, 0x0000FF);
+    source.delta(3, 0, 0xFFFF00);  // 取りこぼすパケット
+    const std::vector<unsigned char> delta5 = source.delta(4, 0, 0x00FFFF);
+    const std::vector<unsigned char> key6 = source.keyframe();
+
+    CHECK(deliver(subscriber, key0));
+    CHECK(subscriber.isSynchronized());
+    CHECK(deliver(subscriber, delta1));
+    CHECK_EQ(subscriber.packetsLost(), 0u);
+
+    // 2と3が入れ替わって届く: 3で1つの飛びを数え、遅れた2は捨てる
+    CHECK(deliver(subscriber, delta3));
+    CHECK_EQ(subscriber.packetsLost(), 1u);
+    CHECK(!subscriber.isSynchronized());
+    CHECK(!deliver(subscriber, delta2));
+    CHECK_EQ(subscriber.state().color(1, 0), 0u);
+
+    // 4を取りこぼす
+    CHECK(deliver(subscriber, delta5));
+    CHECK_EQ(subscriber.packetsLost(), 2u);
+    CHECK_EQ(subscriber.packetsReceived(), 4u);
+    CHECK_EQ(subscriber.state().color(2, 0), 0x0000FFu);
+    CHECK_EQ(subscriber.state().color(4, 0), 0x00FFFFu);
+    CHECK(!sameState(subscriber.state(), source.state()));
+
+    // キーフレームで欠けた分が揃う
+    CHECK(deliver(subscriber, key6));
+    CHECK(subscriber.isSynchronized());
+    CHECK_EQ(subscriber.packetsLost(), 2u);
+    CHECK(sameState(subscriber.state(), source.state()));
+
+    // 同じセッションで遅れて届いた古いキーフレームは捨て、状態も番号も戻さない
+    CHECK(deliver(subscriber, source.delta(5, 0, 0xFFFFFF)));
+    CHECK(!deliver(subscriber, key6));
+    CHECK_EQ(subscriber.state().color(5, 0), 0xFFFFFFu);
+    CHECK(sameState(subscriber.state(), source.state()));
+    CHECK(deliver(subscriber, source.delta(6, 0, 0x808080)));
+    CHECK_EQ(subscriber.packetsLost(), 2u);
+    CHECK(subscriber.isSynchronized());
+    CHECK(sameState(subscriber.state(), source.state()));
+}
+
+static void testKeyframeResyncsAfterRestart()
+{
+    PacketSource source;
+    PadStateSubscriber subscriber;
+
+    CHECK(deliver(subscriber, source.keyframe()));
+    for (int i = 0; i < 20; ++i) {
+        CHECK(deliver(subscriber, source.delta(i % PadStateModel::GRID_SIZE, 1, 0x100000u * i)));
+    }
+    CHECK(sameState(subscriber.state(), source.state()));
+
+    const std::vector<unsigned char> lateKeyframe = source.keyframe();
+    CHECK(deliver(subscriber, lateKeyframe));
+
+    // 再起動した配信側は別のセッションで番号0から送り直す:
+    // 新しいセッションの差分はキーフレームが届くまで捨て、キーフレームで合わせ直す
+    source.restart();
+    CHECK(!deliver(subscriber, source.delta(0, 2, 0x123456)));
+    CHECK(deliver(subscriber, source.keyframe()));
+    CHECK(subscriber.isSynchronized());
+    CHECK(sameState(subscriber.state(), source.state()));
+
+    // 切り替えた後に前のセッションのキーフレームが遅れて届いても戻らない
+    CHECK(!deliver(subscriber, lateKeyframe));
+    CHECK(sameState(subscriber.state(), source.state()));
+
+    // 以後の差分は新しい番号で続けて採用される
+    CHECK(deliver(subscriber, source.delta(1, 2, 0x654321)));
+    CHECK(deliver(subscriber, source.delta(2, 2, 0xABCDEF)));
+    CHECK(subscriber.isSynchronized());
+    CHECK_EQ(subscriber.packetsLost(), 0u);
+    CHECK(sameState(subscriber.state(), source.state()));
+}
+
+static void testMalformedPacketIsIgnored()
+{
+    PacketSource source;
+    PadStateSubscriber subscriber;
+
+    std::vector<unsigned char> packet = source.keyframe();
+    packet[0] = 'X';
+    CHECK(!deliver(subscriber, packet));
+    CHECK(!deliver(subscriber, std::vector<unsigned char>(3, 0)));
+    CHECK_EQ(subscriber.packetsReceived(), 0u);
+    CHECK(!subscriber.isSynchronized());
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    testLossAndReorder();
+    testKeyframeResyncsAfterRestart();
+    testMalformedPacketIsIgnored();
+    return TEST_RESULT();
+}
@@ -0,0 +1,182 @@
+#include "TestSupport.h"
+#include "record/SessionPlayer.h"
+#include "midi/MidiManager.h"
+#include "midi/MidiInputListener.h"
+#include <QCoreApplication>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+static constexpr uint64_t MS = 1000000;
+
+/**
+ * @brief メモリ上のイベント列を返す供給元
+ */
+class VectorSource : public PlaybackSource {
+public:
+    explicit VectorSource(const std::vector<uint64_t>& timestamps) : m_timestamps(timestamps), m_next(0) {}
+
+    bool readNext(MidiEvent& event) override
+    {
+        if (m_next >= m_timestamps.size()) {
+            return false;
+        }
+        event.timestampNs = m_timestamps[m_next++];
+        event.data[0] = 0x90;
+        event.data[1] = 11;
+        event.data[2] = 100;
+        event.size = 3;
+        return true;
+    }
+
+    void rewind() override { m_next = 0; }
+
+    bool seek(uint64_t targetNs, PadStateModel& state) override
+    {
+        state.reset();
+        m_next = 0;
+        while (m_next < m_timestamps.size() && m_timestamps[m_next] < targetNs) {
+            ++m_next;
+        }
+        return true;
+    }
+
+    uint64_t durationNs() const override { return m_timestamps.empty() ? 0 : m_timestamps.back(); }
+
+private:
+    std::vector<uint64_t> m_timestamps;
+    std::size_t m_next;
+};
+
+/**
+ * @brief 送出されたイベントの実時刻を記録し、指定した番号で処理を差し込むリスナー
+ */
+class DispatchRecorder : public MidiInputListener {
+public:
+    static constexpr int MAX_EVENTS = 64;
+
+    DispatchRecorder() : m_count(0) {}
+
+    /**
+     * @brief イベントを記録した直後に呼ぶ処理を設定（再生スレッドで呼ばれる）
+     */
+    void setHook(std::function<void(int)> hook) { m_hook = std::move(hook); }
+
+    void midiEventCaptured(const MidiEvent& event) override
+    {
+        const int index = m_count.load(std::memory_order_relaxed);
+        if (index >= MAX_EVENTS) {
+            return;
+        }
+        m_wallNs[index] = event.timestampNs;
+        if (m_hook) {
+            m_hook(index);
+        }
+        m_count.store(index + 1, std::memory_order_release);
+    }
+
+    int count() const { return m_count.load(std::memory_order_acquire); }
+    uint64_t wallNs(int index) const { return m_wallNs[index]; }
+
+private:
+    std::function<void(int)> m_hook;
+    std::atomic<int> m_count;
+    uint64_t m_wallNs[MAX_EVENTS] = {};
+};
+
+/**
+ * @brief 1秒間隔で10個、その50ms後に1個のイベントを持つ列
+ * 最初の10個は最速で再生し、10個目を送った時点で等速に切り替える
+ */
+static std::vector<uint64_t> fastForwardTimeline()
+{
+    std::vector<uint64_t> timestamps;
+    for (int i = 0; i < 10; ++i) {
+        timestamps.push_back(static_cast<uint64_t>(i) * 1000 * MS);
+    }
+    timestamps.push_back(9050 * MS);
+    return timestamps;
+}
+
+static bool waitForCount(const DispatchRecorder& recorder, int count, int timeoutMs)
+{
+    for (int waited = 0; waited < timeoutMs; ++waited) {
+        if (recorder.count() >= count) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return recorder.count() >= count;
+}
+
+static void testFastToRealTimeKeepsPosition(MidiManager& manager)
+{
+    DispatchRecorder recorder;
+    manager.addInputListener(&recorder);
+
+    SessionPlayer player(&manager);
+    player.setSpeed(SessionPlayer::AS_FAST_AS_POSSIBLE);
+    recorder.setHook([&](int index) {
+        if (index == 9) {
+            player.setSpeed(1.0);
+        }
+    });
+    CHECK(player.start(std::make_unique<VectorSource>(fastForwardTimeline())));
+
+    // 切り替え後の次のイベントは自身の間隔 (50ms) で送られる。
+    // 最速再生で進んだ位置を失うと9秒待つことになる
+    CHECK(waitForCount(recorder, 11, 2000));
+    player.stop();
+    manager.removeInputListener(&recorder);
+
+    if (recorder.count() == 11) {
+        const uint64_t gapNs = recorder.wallNs(10) - recorder.wallNs(9);
+        CHECK(gapNs >= 40 * MS);
+        CHECK(gapNs < 500 * MS);
+    }
+}
+
+static void testPauseAfterFastThenRealTime(MidiManager& manager)
+{
+    DispatchRecorder recorder;
+    manager.addInputListener(&recorder);
+
+    SessionPlayer player(&manager);
+    player.setSpeed(SessionPlayer::AS_FAST_AS_POSSIBLE);
+    recorder.setHook([&](int index) {
+        if (index == 9) {
+            player.setPaused(true);
+        }
+    });
+    CHECK(player.start(std::make_unique<VectorSource>(fastForwardTimeline())));
+    CHECK(waitForCount(recorder, 10, 2000));
+
+    // 一時停止中に速度を変えてから再開する
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    player.setSpeed(1.0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK_EQ(recorder.count(), 10);
+    const uint64_t resumeNs = MidiEvent::now();
+    player.setPaused(false);
+
+    CHECK(waitForCount(recorder, 11, 2000));
+    player.stop();
+    manager.removeInputListener(&recorder);
+
+    if (recorder.count() == 11) {
+        const uint64_t gapNs = recorder.wallNs(10) - resumeNs;
+        CHECK(gapNs >= 40 * MS);
+        CHECK(gapNs < 500 * MS);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    MidiManager manager;
+    testFastToRealTimeKeepsPosition(manager);
+    testPauseAfterFastThenRealTime(manager);
+    return TEST_RESULT();
+}
@@ -0,0 +1,115 @@
+#include "TestSupport.h"
+#include "record/SessionFormat.h"
+#include "record/SessionReader.h"
+#include "record/SessionWriter.h"
+#include "model/PadStateModel.h"
+#include <QFile>
+
+/**
+ * @brief MIDIイベントを作る
+ */
+static MidiEvent makeEvent(unsigned char status, unsigned char data1, unsigned char data2)
+{
+    MidiEvent event;
+    event.timestampNs = 0;
+    event.data[0] = status;
+    event.data[1] = data1;
+    event.data[2] = data2;
+    event.size = 3;
+    return event;
+}
+
+/**
+ * @brief 指定バージョンのヘッダーとレコード列だけのファイルを書き込む
+ */
+static bool writeRawSession(const QString& path, uint16_t version, const unsigned char* records, std::size_t size)
+{
+    unsigned char header[SessionFormat::HEADER_SIZE] = {};
+    for (int i = 0; i < 4; ++i) {
+        header[i] = static_cast<unsigned char>(SessionFormat::MAGIC[i]);
+    }
+    SessionFormat::writeU16(version, header + 4);
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records), static_cast<qint64>(size));
+    return true;
+}
+
+static void testVersion1TreatsFdAsEvent()
+{
+    // バージョン1の0xFDは1バイトのシステムメッセージとして読み出す
+    const unsigned char records[] = {0x00, 0xFD, 0x0A, 0x90, 45, 100, 0x05, 45, 0};
+    const QString path("SessionReaderTest_v1.lpvs");
+    CHECK(writeRawSession(path, 1, records, sizeof(records)));
+
+    SessionReader reader;
+    CHECK(reader.open(path));
+    CHECK_EQ(reader.version(), 1);
+    CHECK(!reader.hasIndex());
+
+    MidiEvent event;
+    CHECK(reader.readNext(event));
+    CHECK_EQ(event.data[0], 0xFD);
+    CHECK_EQ(event.size, 1);
+    CHECK(reader.readNext(event));
+    CHECK_EQ(event.data[0], 0x90);
+    CHECK_EQ(event.data[1], 45);
+    CHECK_EQ(event.timestampNs, 10000u);
+    CHECK(reader.readNext(event));
+    CHECK_EQ(event.data[2], 0);
+    CHECK(!reader.readNext(event));
+
+    reader.close();
+    QFile::remove(path);
+}
+
+static void testKeyframesAreSkippedAndSeekable()
+{
+    const QString path("SessionReaderTest_v2.lpvs");
+    SessionWriter writer;
+    CHECK(writer.open(path, 0));
+    writer.setKeyframeInterval(1000, 4);
+    for (int i = 0; i < 20; ++i) {
+        CHECK(writer.writeEvent(makeEvent(0x90, static_cast<unsigned char>(11 + i), 100), i * 500));
+    }
+    CHECK(writer.close());
+
+    SessionReader reader;
+    CHECK(reader.open(path));
+    CHECK_EQ(reader.version(), SessionFormat::VERSION);
+    CHECK(reader.hasIndex());
+
+    // 通常の読み出しではキーフレームは見えない
+    MidiEvent event;
+    int count = 0;
+    while (reader.readNext(event)) {
+        CHECK(event.data[0] != SessionFormat::KEYFRAME_STATUS);
+        ++count;
+    }
+    CHECK_EQ(count, 20);
+
+    // シーク後は目標時刻より前のイベントがすべて状態に反映される
+    PadStateModel state;
+    CHECK(reader.seek(7000000, state));
+    int x, y;
+    CHECK(PadStateModel::noteToXY(11 + 13, x, y));
+    CHECK(state.isActive(x, y));
+    CHECK(PadStateModel::noteToXY(11 + 14, x, y));
+    CHECK(!state.isActive(x, y));
+    CHECK(reader.readNext(event));
+    CHECK_EQ(event.data[1], 11 + 14);
+
+    reader.close();
+    QFile::remove(path);
+}
+
+int main()
+{
+    testVersion1TreatsFdAsEvent();
+    testKeyframesAreSkippedAndSeekable();
+    return TEST_RESULT();
+}
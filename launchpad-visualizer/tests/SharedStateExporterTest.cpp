@@ -0,0 +1,204 @@
+#include "TestSupport.h"
+#include "LaunchpadVisualizer.h"
+#include "net/SharedStateExporter.h"
+#include <QCoreApplication>
+#include <QString>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @brief テストごとに重ならない共有メモリの名前
+ */
+static QString segmentName(const char* suffix)
+{
+    return QString("/lpv-test-%1-%2").arg(static_cast<int>(getpid())).arg(suffix);
+}
+
+/**
+ * @brief 共有メモリをマップする（読み出し側は読み取り専用）
+ * @return 失敗した場合nullptr
+ */
+static lpv_shm_segment* mapSegment(const QString& name, bool create)
+{
+    const QByteArray path = name.toLocal8Bit();
+    const int fd = create ? shm_open(path.constData(), O_CREAT | O_RDWR, 0600)
+                          : shm_open(path.constData(), O_RDONLY, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (create && ftruncate(fd, sizeof(lpv_shm_segment)) != 0) {
+        close(fd);
+        return nullptr;
+    }
+    void* mapped = mmap(nullptr, sizeof(lpv_shm_segment), create ? PROT_READ | PROT_WRITE : PROT_READ,
+                        MAP_SHARED, fd, 0);
+    close(fd);
+    return mapped == MAP_FAILED ? nullptr : static_cast<lpv_shm_segment*>(mapped);
+}
+
+/**
+ * @brief 全パッドの色と押下状態をステップごとに変えた状態
+ */
+static PadStateModel steppedState(int step)
+{
+    PadStateModel state;
+    for (int y = 0; y < PadStateModel::GRID_SIZE; ++y) {
+        for (int x = 0; x < PadStateModel::GRID_SIZE; ++x) {
+            const int index = PadStateModel::index(x, y);
+            if ((index + step) % 3 == 0) {
+                state.press(x, y, static_cast<uint8_t>(1 + (index * 7 + step) % 127));
+            }
+            state.setColor(x, y, static_cast<uint32_t>(index * 0x010203 + step * 0x0A0B0C) & 0xFFFFFFu);
+        }
+    }
+    return state;
+}
+
+/**
+ * @brief 読み出した状態がビジュアライザーのパッドの状態と一致するか
+ */
+static bool matchesVisualizer(const lpv_shm_snapshot& snapshot, const LaunchpadVisualizer& visualizer)
+{
+    const PadStateModel& state = visualizer.padState();
+    for (int y = 0; y < PadStateModel::GRID_SIZE; ++y) {
+        for (int x = 0; x < PadStateModel::GRID_SIZE; ++x) {
+            const uint32_t expected = LPV_SHM_PAD_VALUE(state.isActive(x, y), state.velocity(x, y),
+                                                        state.color(x, y));
+            if (snapshot.pads[PadStateModel::index(x, y)] != expected) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void testConcurrentReaderSeesConsistentState()
+{
+    const QString name = segmentName("concurrent");
+    LaunchpadVisualizer visualizer;
+    SharedStateExporter exporter(&visualizer);
+    CHECK(exporter.start(name));
+
+    const lpv_shm_segment* segment = mapSegment(name, false);
+    CHECK(segment != nullptr);
+    if (!segment) {
+        return;
+    }
+    CHECK(lpv_shm_is_valid(segment));
+
+    // 読み出し側のスレッドはlpv_shm_readだけで読み、チェックサムと番号の進み方を確かめる。
+    // 更新が続いて読めなかった回は読み直すだけなので数えない
+    std::atomic<bool> running(true);
+    std::atomic<uint64_t> reads(0);
+    uint64_t torn = 0;
+    uint64_t backwards = 0;
+    std::thread reader([&] {
+        uint32_t previousSequence = 0;
+        uint64_t previousUpdates = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            lpv_shm_snapshot snapshot;
+            if (!lpv_shm_read(segment, &snapshot, 1000)) {
+                continue;
+            }
+            if (lpv_shm_checksum(snapshot.pads) != snapshot.checksum || (snapshot.sequence & 1u)) {
+                ++torn;
+            }
+            if (static_cast<int32_t>(snapshot.sequence - previousSequence) < 0
+                || snapshot.updates < previousUpdates) {
+                ++backwards;
+            }
+            previousSequence = snapshot.sequence;
+            previousUpdates = snapshot.updates;
+            reads.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    // シークでの状態の復元と同じ経路で、1回に多数のパッドを変える
+    while (reads.load(std::memory_order_relaxed) == 0) {
+        std::this_thread::yield();
+    }
+    for (int step = 0; step < 2000; ++step) {
+        visualizer.onPadStateRestored(steppedState(step));
+    }
+    running.store(false);
+    reader.join();
+
+    CHECK(reads.load() > 0);
+    CHECK_EQ(torn, 0u);
+    CHECK_EQ(backwards, 0u);
+
+    // 書き込みを終えた後は、最後の状態がそのまま読める
+    lpv_shm_snapshot snapshot;
+    CHECK(lpv_shm_read(segment, &snapshot, 1));
+    CHECK_EQ(lpv_shm_checksum(snapshot.pads), snapshot.checksum);
+    CHECK(matchesVisualizer(snapshot, visualizer));
+    CHECK_EQ(snapshot.updates, exporter.updateCount());
+
+    exporter.stop();
+    CHECK(!lpv_shm_is_valid(segment));
+    munmap(const_cast<lpv_shm_segment*>(segment), sizeof(lpv_shm_segment));
+}
+
+static void testRestartRecoversOddSequence()
+{
+    // 前回の書き込み側が更新の途中で終了し、sequenceが奇数のまま残ったセグメントを作る
+    const QString name = segmentName("stale");
+    lpv_shm_segment* stale = mapSegment(name, true);
+    CHECK(stale != nullptr);
+    if (!stale) {
+        return;
+    }
+    stale->version = LPV_SHM_VERSION;
+    stale->size = sizeof(lpv_shm_segment);
+    stale->sequence = 41;
+    stale->updates = 20;
+    for (int i = 0; i < LPV_SHM_PAD_COUNT; ++i) {
+        stale->pads[i] = 0xDEADBEEFu;
+    }
+    stale->checksum = 0;
+    __atomic_store_n(&stale->magic, LPV_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    // 更新中のままなので、読み出し側は読めない
+    lpv_shm_snapshot snapshot;
+    CHECK(lpv_shm_is_valid(stale));
+    CHECK(!lpv_shm_read(stale, &snapshot, 100));
+
+    // 再起動した書き込み側は同じセグメントを引き継ぎ、偶数に戻してから全パッドを書き直す
+    LaunchpadVisualizer visualizer;
+    visualizer.onPadStateRestored(steppedState(5));
+    SharedStateExporter exporter(&visualizer);
+    CHECK(exporter.start(name));
+
+    // 再起動前からマップしていた読み出し側も、そのまま新しい状態を読める
+    CHECK(lpv_shm_is_valid(stale));
+    CHECK(lpv_shm_read(stale, &snapshot, 1));
+    CHECK_EQ(snapshot.sequence % 2, 0u);
+    CHECK(static_cast<int32_t>(snapshot.sequence - 41u) > 0);
+    CHECK_EQ(lpv_shm_checksum(snapshot.pads), snapshot.checksum);
+    CHECK(matchesVisualizer(snapshot, visualizer));
+
+    // 以後の更新も1回ごとに偶数で公開される
+    const uint32_t restartedSequence = snapshot.sequence;
+    visualizer.onPadStateRestored(steppedState(6));
+    CHECK(lpv_shm_read(stale, &snapshot, 1));
+    CHECK_EQ(snapshot.sequence % 2, 0u);
+    CHECK(snapshot.sequence > restartedSequence);
+    CHECK_EQ(lpv_shm_checksum(snapshot.pads), snapshot.checksum);
+    CHECK(matchesVisualizer(snapshot, visualizer));
+
+    exporter.stop();
+    CHECK(!lpv_shm_is_valid(stale));
+    munmap(stale, sizeof(lpv_shm_segment));
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    testConcurrentReaderSeesConsistentState();
+    testRestartRecoversOddSequence();
+    return TEST_RESULT();
+}
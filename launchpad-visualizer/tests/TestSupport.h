@@ -0,0 +1,44 @@
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <cstdio>
+
+/**
+ * @brief テスト用の最小限の検査マクロ
+ * 失敗しても続行し、失敗した箇所をすべて表示する。
+ * main() の最後で TEST_RESULT() を返すと、失敗があった場合に終了コード1になる
+ * (NDEBUGでも無効にならないよう assert は使わない)
+ */
+namespace TestSupport {
+
+inline int& failureCount()
+{
+    static int count = 0;
+    return count;
+}
+
+inline void fail(const char* file, int line, const char* expression)
+{
+    std::fprintf(stderr, "%s:%d: 失敗: %s\n", file, line, expression);
+    ++failureCount();
+}
+
+} // namespace TestSupport
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            TestSupport::fail(__FILE__, __LINE__, #condition); \
+        } \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        if (!((actual) == (expected))) { \
+            TestSupport::fail(__FILE__, __LINE__, #actual " == " #expected); \
+        } \
+    } while (0)
+
+#define TEST_RESULT() (TestSupport::failureCount() == 0 ? 0 : 1)
+
+#endif // TEST_SUPPORT_H
@@ -0,0 +1,142 @@
+#include "TestSupport.h"
+#include "diag/TraceRecorder.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static constexpr uint64_t CAPACITY = TraceRecorder::BUFFER_CAPACITY;
+
+/**
+ * @brief 書き出したトレースから読み取った内容
+ */
+struct Trace {
+    std::vector<double> starts;  // 区間ごとの開始時刻 (マイクロ秒)
+    long long droppedScopes = -1;
+};
+
+/**
+ * @brief 数値のフィールドを読み取る（"key":値）
+ */
+static bool readNumber(const QByteArray& line, const char* key, double& value)
+{
+    const QByteArray pattern = QByteArray("\"") + key + "\":";
+    const int position = line.indexOf(pattern);
+    if (position < 0) {
+        return false;
+    }
+    int end = position + pattern.size();
+    while (end < line.size() && line[end] != ',' && line[end] != '}') {
+        ++end;
+    }
+    bool ok = false;
+    value = line.mid(position + pattern.size(), end - position - pattern.size()).toDouble(&ok);
+    return ok;
+}
+
+/**
+ * @brief トレースを保存して読み戻す（区間は1行に1つ）
+ */
+static Trace writeAndRead(const QString& path)
+{
+    Trace trace;
+    CHECK(TraceRecorder::writeChromeTrace(path));
+    QFile file(path);
+    CHECK(file.open(QIODevice::ReadOnly));
+    const QByteArray json = file.readAll();
+    file.close();
+    QFile::remove(path);
+
+    for (const QByteArray& line : json.split('\n')) {
+        if (line.contains("\"ph\":\"X\"")) {
+            double ts = 0;
+            CHECK(readNumber(line, "ts", ts));
+            trace.starts.push_back(ts);
+        }
+        double dropped = 0;
+        if (readNumber(line, "droppedScopes", dropped)) {
+            trace.droppedScopes = static_cast<long long>(dropped);
+        }
+    }
+    return trace;
+}
+
+static void testKeepsNewestScopes()
+{
+    // 容量より100個多く記録すると、最も古い100個が上書きされる
+    for (uint64_t i = 0; i < CAPACITY + 100; ++i) {
+        TraceRecorder::record("test.scope", i * 1000, i * 1000 + 500);
+    }
+    CHECK_EQ(TraceRecorder::droppedCount(), 100u);
+
+    const Trace trace = writeAndRead("TraceRecorderTest_full.json");
+    CHECK_EQ(trace.starts.size(), static_cast<std::size_t>(CAPACITY));
+    CHECK_EQ(trace.droppedScopes, 100);
+    if (!trace.starts.empty()) {
+        CHECK_EQ(trace.starts.front(), 100.0);
+        CHECK_EQ(trace.starts.back(), static_cast<double>(CAPACITY + 99));
+    }
+
+    // 読み出した区間は取り除かれ、上書きの数は累計で残る
+    for (uint64_t i = 0; i < 10; ++i) {
+        TraceRecorder::record("test.scope", i * 1000, i * 1000 + 500);
+    }
+    const Trace next = writeAndRead("TraceRecorderTest_next.json");
+    CHECK_EQ(next.starts.size(), static_cast<std::size_t>(10));
+    CHECK_EQ(next.droppedScopes, 0);
+    CHECK_EQ(TraceRecorder::droppedCount(), 100u);
+}
+
+static void testWriteWhileRecording()
+{
+    // 別スレッドが記録し続けている間に書き出しても、書き換え中の区間は混ざらない
+    const uint64_t droppedBefore = TraceRecorder::droppedCount();
+    std::atomic<bool> running(true);
+    std::atomic<uint64_t> recorded(0);
+    std::thread writer([&] {
+        uint64_t i = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            TraceRecorder::record("test.worker", i * 1000, i * 1000 + 1);
+            ++i;
+        }
+        recorded.store(i);
+    });
+
+    std::vector<Trace> traces;
+    for (int i = 0; i < 20; ++i) {
+        traces.push_back(writeAndRead("TraceRecorderTest_concurrent.json"));
+    }
+    running.store(false);
+    writer.join();
+    traces.push_back(writeAndRead("TraceRecorderTest_concurrent.json"));
+
+    // 記録スレッドの区間は番号順に並び、書き出しをまたいで重複しない
+    uint64_t written = 0;
+    uint64_t dropped = 0;
+    double previous = -1;
+    for (const Trace& trace : traces) {
+        CHECK(trace.starts.size() <= static_cast<std::size_t>(CAPACITY));
+        for (std::size_t i = 0; i < trace.starts.size(); ++i) {
+            if (trace.starts[i] <= previous) {
+                TestSupport::fail(__FILE__, __LINE__, "trace.starts[i] > previous");
+                break;
+            }
+            previous = trace.starts[i];
+        }
+        written += trace.starts.size();
+        dropped += static_cast<uint64_t>(trace.droppedScopes);
+    }
+
+    // 記録した区間は、書き出されたか上書きで失われたかのどちらかで数えられる
+    CHECK_EQ(written + dropped, recorded.load());
+    CHECK_EQ(TraceRecorder::droppedCount() - droppedBefore, dropped);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    testKeepsNewestScopes();
+    testWriteWhileRecording();
+    return TEST_RESULT();
+}